@@ -0,0 +1,263 @@
+#define _GNU_SOURCE
+
+#include "bench.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+/******************************************************************************
+ *                                                                            *
+ *                                   State                                    *
+ *                                                                            *
+ ******************************************************************************/
+
+static bool __bench_latency = true;
+static bool __bench_perf = false;
+static double __bench_ns_per_tick = 0.0;
+
+static const char* const __bench_perf_names[BENCH_PERF_COUNTERS] = {
+    "cycles", "instructions", "L1D-miss", "LLC-miss", "branch-miss", "dTLB-miss",
+};
+
+/******************************************************************************
+ *                                                                            *
+ *                              Inner Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+// measures how many nanoseconds one `bench_ticks` unit lasts
+static void __bench_calibrate(void);
+// opens and starts the hardware counters of `run` (all `-1` if unavailable)
+static void __bench_perf_open(BenchRun* run);
+// stops the counters of `run`, prints them per operation and closes them
+static void __bench_perf_close(BenchRun* run);
+
+/******************************************************************************
+ *                                                                            *
+ *                                   Setup                                    *
+ *                                                                            *
+ ******************************************************************************/
+
+size_t bench_init(int argc, char** argv, size_t default_n) {
+    size_t n = default_n;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--no-latency") == 0) {
+            __bench_latency = false;
+        } else if (strcmp(argv[i], "--perf") == 0) {
+            __bench_perf = true;
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            n = (size_t)strtoull(argv[++i], NULL, 10);
+        }
+    }
+
+    __bench_calibrate();
+
+    return n;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                   Timing                                   *
+ *                                                                            *
+ ******************************************************************************/
+
+uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t bench_ticks_to_ns(uint64_t ticks) {
+    return (uint64_t)((double)ticks * __bench_ns_per_tick);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                Measurement                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+void bench_begin(BenchRun* run, const char* name) {
+    if (__bench_ns_per_tick == 0.0) __bench_calibrate();
+
+    run->name = name;
+    run->ops = 0;
+    run->elapsed_ns = 0;
+    run->latency = __bench_latency ? hdr_new(7) : NULL;
+
+    __bench_perf_open(run);
+
+    run->start_ns = bench_now_ns();
+}
+
+void bench_end(BenchRun* run, uint64_t ops) {
+    run->elapsed_ns = bench_now_ns() - run->start_ns;
+    run->ops = ops;
+
+#ifdef __linux__
+    for (size_t i = 0; i < BENCH_PERF_COUNTERS; i++) {
+        if (run->perf_fds[i] >= 0) ioctl(run->perf_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+#endif
+
+    double ns_per_op = ops ? (double)run->elapsed_ns / (double)ops : 0.0;
+
+    printf("%-28s %12lu %10.1f", run->name, run->ops, ns_per_op);
+
+    if (run->latency && hdr_count(run->latency)) {
+        printf(" %9lu %9lu %9lu %11lu",
+               hdr_percentile(run->latency, 50.0),
+               hdr_percentile(run->latency, 99.0),
+               hdr_percentile(run->latency, 99.9),
+               hdr_max(run->latency));
+    }
+
+    printf("\n");
+
+    __bench_perf_close(run);
+
+    hdr_free(run->latency);
+    run->latency = NULL;
+}
+
+void bench_header(const char* title) {
+    printf("== %s ==\n", title);
+    printf("%-28s %12s %10s", "benchmark", "ops", "ns/op");
+
+    if (__bench_latency) printf(" %9s %9s %9s %11s", "p50(ns)", "p99(ns)", "p99.9(ns)", "max(ns)");
+
+    printf("\n");
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                      Inner Functions Implementation                        *
+ *                                                                            *
+ ******************************************************************************/
+
+static void __bench_calibrate(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    const uint64_t start_ns = bench_now_ns();
+    const uint64_t start_ticks = bench_ticks();
+
+    while (bench_now_ns() - start_ns < 20000000ULL);  // 20 ms
+
+    const uint64_t ns = bench_now_ns() - start_ns;
+    const uint64_t ticks = bench_ticks() - start_ticks;
+
+    __bench_ns_per_tick = ticks ? (double)ns / (double)ticks : 1.0;
+#else
+    __bench_ns_per_tick = 1.0;
+#endif
+}
+
+static void __bench_perf_open(BenchRun* run) {
+    for (size_t i = 0; i < BENCH_PERF_COUNTERS; i++) run->perf_fds[i] = -1;
+
+    if (!__bench_perf) return;
+
+#ifdef __linux__
+    const uint64_t cache_read_miss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+    const struct {
+        uint32_t type;
+        uint64_t config;
+    } events[BENCH_PERF_COUNTERS] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | cache_read_miss},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | cache_read_miss},
+    };
+
+    size_t opened = 0;
+
+    for (size_t i = 0; i < BENCH_PERF_COUNTERS; i++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+
+        attr.size = sizeof(attr);
+        attr.type = events[i].type;
+        attr.config = events[i].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;  // user-space only: allowed with perf_event_paranoid <= 2
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // Independent events (no group), so one missing counter does not disable the others.
+        long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+
+        if (fd >= 0) {
+            run->perf_fds[i] = (int)fd;
+            opened++;
+        }
+    }
+
+    if (opened == 0) {
+        fprintf(stderr, "bench: perf_event counters unavailable (permissions or no PMU), continuing without them\n");
+        __bench_perf = false;
+        return;
+    }
+
+    for (size_t i = 0; i < BENCH_PERF_COUNTERS; i++) {
+        if (run->perf_fds[i] < 0) continue;
+
+        ioctl(run->perf_fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(run->perf_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#else
+    fprintf(stderr, "bench: perf_event counters are only supported on Linux, continuing without them\n");
+    __bench_perf = false;
+#endif
+}
+
+static void __bench_perf_close(BenchRun* run) {
+    double values[BENCH_PERF_COUNTERS];
+    bool valid[BENCH_PERF_COUNTERS];
+    bool any = false;
+
+    for (size_t i = 0; i < BENCH_PERF_COUNTERS; i++) {
+        valid[i] = false;
+        values[i] = 0.0;
+
+        if (run->perf_fds[i] < 0) continue;
+
+        // value, time enabled, time running
+        uint64_t data[3];
+
+        if (read(run->perf_fds[i], data, sizeof(data)) == (ssize_t)sizeof(data) && data[2] > 0) {
+            // Scale up if the kernel multiplexed the counter.
+            values[i] = (double)data[0] * ((double)data[1] / (double)data[2]);
+            valid[i] = true;
+            any = true;
+        }
+
+        close(run->perf_fds[i]);
+        run->perf_fds[i] = -1;
+    }
+
+    if (!any) return;
+
+    const double ops = run->ops ? (double)run->ops : 1.0;
+
+    printf("%-28s", "  perf (per op)");
+
+    for (size_t i = 0; i < BENCH_PERF_COUNTERS; i++) {
+        if (valid[i]) printf(" %s=%.2f", __bench_perf_names[i], values[i] / ops);
+    }
+
+    if (valid[0] && valid[1] && values[0] > 0.0) printf(" IPC=%.2f", values[1] / values[0]);
+
+    printf("\n");
+}
@@ -0,0 +1,97 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "histogram.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Nomenclature used (to avoid collisions): <data_type>_<method_name>
+// Minimal benchmark harness shared by `bench/*_bench.c` (built with `make bench-all` / `make bench-<name>`).
+
+/// Number of hardware counters sampled with `--perf`: cycles, instructions, L1D read misses, LLC misses, branch misses and dTLB read misses.
+#define BENCH_PERF_COUNTERS 6
+
+/**
+ * @brief A single benchmark measurement.
+ *
+ * Brackets a loop of operations with `bench_begin` / `bench_end`. Inside the
+ * loop, each operation may be timed individually with `bench_ticks` and
+ * `bench_record`, which feed the per-operation latency histogram.
+ */
+typedef struct BenchRun BenchRun;
+
+struct BenchRun {
+    const char* name;     ///< Name printed in the report.
+    uint64_t ops;         ///< Number of operations performed (set by `bench_end`).
+    uint64_t start_ns;    ///< Wall-clock start.
+    uint64_t elapsed_ns;  ///< Wall-clock duration (set by `bench_end`).
+    HdrHist* latency;     ///< Per-operation latencies in ns, or `NULL` when per-operation timing is disabled.
+
+    int perf_fds[BENCH_PERF_COUNTERS];  ///< `perf_event` file descriptors (`-1` for counters that are unavailable or disabled).
+};
+
+/// @brief Parses the common command line options of a benchmark binary.
+/// @details Supported options: `-n <count>` to override the default operation count, `--no-latency` to disable per-operation timing (whose own cost is otherwise included in ns/op and in the counters), and `--perf` to sample hardware counters with Linux `perf_event` around every measurement. The counters are user-space only; if they cannot be opened (no permission, no PMU, or not Linux) a note is printed once and the benchmarks run without them.
+/// @param argc Argument count from `main`.
+/// @param argv Argument vector from `main`.
+/// @param default_n Operation count used when `-n` is absent.
+/// @return The operation count to use.
+size_t bench_init(int argc, char** argv, size_t default_n);
+
+/// @brief Gets a monotonic timestamp.
+/// @return Nanoseconds from an arbitrary origin.
+uint64_t bench_now_ns(void);
+
+/// @brief Converts a difference of `bench_ticks` values to nanoseconds.
+/// @param ticks Tick count.
+/// @return The duration in nanoseconds.
+uint64_t bench_ticks_to_ns(uint64_t ticks);
+
+/// @brief Reads the cheapest available timestamp counter (`rdtsc` on x86, the monotonic clock elsewhere).
+/// @return The current tick count.
+static inline uint64_t bench_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return bench_now_ns();
+#endif
+}
+
+/// @brief Starts a benchmark measurement.
+/// @param run Pointer to the measurement to initialize.
+/// @param name Name printed in the report.
+void bench_begin(BenchRun* run, const char* name);
+
+/// @brief Records the latency of one operation started at `start_ticks`.
+/// @param run Pointer to the running measurement.
+/// @param start_ticks Value of `bench_ticks()` taken right before the operation.
+static inline void bench_record(BenchRun* run, uint64_t start_ticks) {
+    uint64_t end_ticks = bench_ticks();
+
+    if (run->latency) hdr_record(run->latency, bench_ticks_to_ns(end_ticks - start_ticks));
+}
+
+/// @brief Stops a benchmark measurement and prints its report line.
+/// @details With `--perf`, a second line reports the counters normalized per operation (cycles/op, instructions/op, IPC and misses/op), scaled for multiplexing.
+/// @param run Pointer to the running measurement (its resources are released).
+/// @param ops Number of operations performed.
+void bench_end(BenchRun* run, uint64_t ops);
+
+/// @brief Prints the column header matching the report lines of `bench_end`.
+/// @param title Title of the benchmark suite.
+void bench_header(const char* title);
+
+/// @brief Prevents the compiler from optimizing away a computed value.
+/// @param p Pointer to the value.
+static inline void bench_escape(const void* p) {
+    __asm__ volatile("" : : "g"(p) : "memory");
+}
+
+#endif  // BENCH_H
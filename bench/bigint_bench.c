@@ -0,0 +1,96 @@
+#include "bench.h"
+#include "bigint.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+static uint64_t rng_state = 88172645463325252ULL;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+// a random value of about `digits` decimal digits (19.27 per limb)
+static BigInt* random_bi(size_t digits) {
+    BigInt* a = bi_new();
+    const size_t limbs = digits * 100 / 1927 + 1;
+
+    for (size_t i = 0; i < limbs; i++) {
+        uint64_t limb = rng_next() | (i == limbs - 1);
+        da_push(a->limbs, &limb);
+    }
+
+    return a;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Benchmarks                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+int main(int argc, char** argv) {
+    // `n` is the operand size in decimal digits
+    const size_t n = bench_init(argc, argv, 1000000);
+
+    bench_header("Big Integers");
+
+    BenchRun run;
+    char name[64];
+    int64_t sink = 0;
+
+    // Multiplication across the schoolbook, Karatsuba and Toom-3 ranges
+    for (size_t digits = n / 10000 < 100 ? 100 : n / 10000; digits <= n; digits *= 10) {
+        BigInt *a = random_bi(digits), *b = random_bi(digits);
+        const size_t reps = n / digits < 1000 ? n / digits : 1000;
+
+        snprintf(name, sizeof(name), "bi_mul (%zu digits)", digits);
+        bench_begin(&run, name);
+        for (size_t i = 0; i < reps; i++) {
+            BigInt* p = bi_mul(a, b);
+            sink += (int64_t)bi_bits(p);
+            bi_free(p);
+        }
+        bench_end(&run, reps);
+
+        bi_free(a);
+        bi_free(b);
+    }
+
+    BigInt *a = random_bi(2 * n), *b = random_bi(n);
+
+    bench_begin(&run, "bi_divmod (2n / n digits)");
+    BigInt *q = NULL, *r = NULL;
+    bi_divmod(a, b, &q, &r);
+    bench_end(&run, 1);
+    sink += (int64_t)bi_bits(q) + (int64_t)bi_bits(r);
+
+    bench_begin(&run, "bi_to_string (n digits)");
+    char* s = bi_to_string(b);
+    bench_end(&run, 1);
+
+    bench_begin(&run, "bi_from_string (n digits)");
+    BigInt* parsed = bi_from_string(s);
+    bench_end(&run, 1);
+    sink += bi_cmp(parsed, b);
+
+    bench_escape(&sink);
+
+    free(s);
+    bi_free(a);
+    bi_free(b);
+    bi_free(q);
+    bi_free(r);
+    bi_free(parsed);
+
+    return 0;
+}
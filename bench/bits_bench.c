@@ -0,0 +1,80 @@
+#include "bench.h"
+#include "bits.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+static uint64_t rng_state = 88172645463325252ULL;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Benchmarks                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+int main(int argc, char** argv) {
+    // `n` is the bitmap size in 64-bit words (ops are words, so ns/op * 8 = ns/byte)
+    const size_t n = bench_init(argc, argv, 1 << 20);
+    const size_t bytes = n * sizeof(uint64_t);
+    const size_t rounds = 16;
+
+    bench_header("Bits");
+
+    uint64_t* a = malloc(bytes);
+    uint64_t* b = malloc(bytes);
+    for (size_t i = 0; i < n; i++) {
+        a[i] = rng_next();
+        b[i] = rng_next();
+    }
+
+    const BitsKernel kernels[] = {BITS_KERNEL_PORTABLE, BITS_KERNEL_POPCNT, BITS_KERNEL_AVX2};
+    const char* names[] = {"portable", "popcnt", "avx2"};
+
+    BenchRun run;
+    char name[64];
+    uint64_t sink = 0;
+
+    for (size_t k = 0; k < 3; k++) {
+        if (!bits_use_kernel(kernels[k])) continue;
+
+        snprintf(name, sizeof(name), "bits_popcount_buf (%s)", names[k]);
+        bench_begin(&run, name);
+        for (size_t r = 0; r < rounds; r++) sink += bits_popcount_buf(a, bytes);
+        bench_end(&run, n * rounds);
+
+        snprintf(name, sizeof(name), "bits_popcount_and (%s)", names[k]);
+        bench_begin(&run, name);
+        for (size_t r = 0; r < rounds; r++) sink += bits_popcount_and(a, b, bytes);
+        bench_end(&run, n * rounds);
+    }
+
+    bits_use_kernel(BITS_KERNEL_AUTO);
+
+    bench_begin(&run, "bits_npo2");
+    for (size_t i = 0; i < n; i++) sink += bits_npo2(a[i] >> (a[i] & 63));
+    bench_end(&run, n);
+
+    bench_begin(&run, "bits_select");
+    for (size_t i = 0; i < n; i++) sink += bits_select(a[i], (unsigned)(b[i] & 31));
+    bench_end(&run, n);
+
+    bench_escape(&sink);
+
+    free(a);
+    free(b);
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include "bench.h"
+#include "darray.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+int int_cmp(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+void int_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(int));
+}
+
+static uint64_t rng_state = 88172645463325252ULL;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Benchmarks                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+int main(int argc, char** argv) {
+    const size_t n = bench_init(argc, argv, 1000000);
+
+    bench_header("DArray");
+
+    BenchRun run;
+    DArray* da = da_new(sizeof(int));
+    da->copier = int_copier;
+
+    // Includes the copy spikes of every capacity doubling.
+    bench_begin(&run, "da_push");
+    for (size_t i = 0; i < n; i++) {
+        int v = (int)i;
+        uint64_t t = bench_ticks();
+        da_push(da, &v);
+        bench_record(&run, t);
+    }
+    bench_end(&run, n);
+
+    bench_begin(&run, "da_get (random)");
+    long sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        size_t index = (size_t)(rng_next() % n);
+        uint64_t t = bench_ticks();
+        sum += *(int*)da_get(da, index);
+        bench_record(&run, t);
+    }
+    bench_escape(&sum);
+    bench_end(&run, n);
+
+    bench_begin(&run, "da_set (random)");
+    for (size_t i = 0; i < n; i++) {
+        size_t index = (size_t)(rng_next() % n);
+        int v = (int)(rng_next() & 0x7FFFFFFF);
+        uint64_t t = bench_ticks();
+        da_set(da, index, &v);
+        bench_record(&run, t);
+    }
+    bench_end(&run, n);
+
+    bench_begin(&run, "da_sort");
+    da_sort(da, int_cmp);
+    bench_end(&run, 1);
+
+    bench_begin(&run, "da_binary_search");
+    for (size_t i = 0; i < n; i++) {
+        int key = (int)(rng_next() & 0x7FFFFFFF);
+        uint64_t t = bench_ticks();
+        size_t index = da_binary_search(da, &key, int_cmp);
+        bench_record(&run, t);
+        bench_escape(&index);
+    }
+    bench_end(&run, n);
+
+    bench_begin(&run, "da_pop");
+    for (size_t i = 0; i < n; i++) {
+        uint64_t t = bench_ticks();
+        void* v = da_pop(da);
+        bench_record(&run, t);
+        free(v);
+    }
+    bench_end(&run, n);
+
+    // Front insertion is O(n) per operation: keep it smaller.
+    const size_t front_n = n / 50 ? n / 50 : 1;
+
+    bench_begin(&run, "da_push_front");
+    for (size_t i = 0; i < front_n; i++) {
+        int v = (int)i;
+        uint64_t t = bench_ticks();
+        da_push_front(da, &v);
+        bench_record(&run, t);
+    }
+    bench_end(&run, front_n);
+
+    da_free(da);
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "bench.h"
+#include "geometry.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+void point_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(Point2d));
+}
+
+static uint64_t rng_state = 88172645463325252ULL;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double rng_coord(void) {
+    return (double)(rng_next() >> 11) / (double)(1ULL << 53);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Benchmarks                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+int main(int argc, char** argv) {
+    const size_t n = bench_init(argc, argv, 1000000);
+
+    bench_header("Geometry");
+
+    BenchRun run;
+
+    DArray* points = da_new_with_capacity(sizeof(Point2d), n);
+    points->copier = point_copier;
+
+    for (size_t i = 0; i < n; i++) {
+        Point2d p = {rng_coord(), rng_coord()};
+        da_push(points, &p);
+    }
+
+    DArray* sorted = da_new_with_capacity(sizeof(Point2d), n);
+    sorted->copier = point_copier;
+    memcpy(sorted->arr, points->arr, n * sizeof(Point2d));
+    sorted->length = n;
+
+    bench_begin(&run, "geo_sort (radix)");
+    geo_sort(sorted);
+    bench_end(&run, n);
+
+    bench_begin(&run, "geo_convex_hull");
+    DArray* hull = geo_convex_hull(points);
+    bench_end(&run, n);
+    bench_escape(hull);
+
+    size_t i, j;
+    double d2;
+
+    bench_begin(&run, "geo_closest_pair");
+    geo_closest_pair(points, &i, &j, &d2);
+    bench_end(&run, n);
+    bench_escape(&d2);
+
+    double* out = malloc(n * sizeof(double));
+    const Point2d* pts = (const Point2d*)points->arr;
+    const Point2d a = {0.1, 0.2}, b = {0.9, 0.7};
+
+    bench_begin(&run, "geo_orient_batch_d");
+    geo_orient_batch_d(&a, &b, pts, n, out);
+    bench_end(&run, n);
+    bench_escape(out);
+
+    int signs = 0;
+
+    bench_begin(&run, "geo_orient2d (exact)");
+    for (size_t k = 0; k < n; k++) signs += geo_orient2d(&a, &b, pts + k);
+    bench_end(&run, n);
+    bench_escape(&signs);
+
+    free(out);
+    da_free(hull);
+    da_free(sorted);
+    da_free(points);
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "bench.h"
+#include "hash.h"
+#include "hashset.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+int int_cmp(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+uint64_t int_hasher(const void* k, uint64_t seed_0, uint64_t seed_1) {
+    return hash_sip(k, sizeof(int), seed_0, seed_1);
+}
+
+void int_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(int));
+}
+
+void int_deallocator(void* k) {
+    free(k);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Benchmarks                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+int main(int argc, char** argv) {
+    const size_t n = bench_init(argc, argv, 500000);
+
+    bench_header("HSet");
+
+    BenchRun run;
+    HSet* hs = hs_new(sizeof(int), int_cmp, int_hasher, int_copier, int_deallocator);
+
+    // Includes the rehash pauses of every `__hs_resize`.
+    bench_begin(&run, "hs_insert");
+    for (size_t i = 0; i < n; i++) {
+        int v = (int)i;
+        uint64_t t = bench_ticks();
+        hs_insert(hs, &v);
+        bench_record(&run, t);
+    }
+    bench_end(&run, n);
+
+    bench_begin(&run, "hs_contains (hit)");
+    size_t found = 0;
+    for (size_t i = 0; i < n; i++) {
+        int v = (int)((i * 7919) % n);
+        uint64_t t = bench_ticks();
+        found += hs_contains(hs, &v);
+        bench_record(&run, t);
+    }
+    bench_escape(&found);
+    bench_end(&run, n);
+
+    bench_begin(&run, "hs_contains (miss)");
+    for (size_t i = 0; i < n; i++) {
+        int v = (int)(n + i);
+        uint64_t t = bench_ticks();
+        found += hs_contains(hs, &v);
+        bench_record(&run, t);
+    }
+    bench_escape(&found);
+    bench_end(&run, n);
+
+    bench_begin(&run, "hs_remove");
+    for (size_t i = 0; i < n; i++) {
+        int v = (int)i;
+        uint64_t t = bench_ticks();
+        hs_remove(hs, &v);
+        bench_record(&run, t);
+    }
+    bench_end(&run, n);
+
+    hs_free(hs);
+
+    // Pre-sized: no resize pauses left in the tail.
+    hs = hs_new_with_capacity(sizeof(int), int_cmp, int_hasher, int_copier, int_deallocator, n * 2);
+
+    bench_begin(&run, "hs_insert (presized)");
+    for (size_t i = 0; i < n; i++) {
+        int v = (int)i;
+        uint64_t t = bench_ticks();
+        hs_insert(hs, &v);
+        bench_record(&run, t);
+    }
+    bench_end(&run, n);
+
+    hs_free(hs);
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "bench.h"
+#include "itree.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+typedef struct {
+    int64_t start;
+    int64_t end;
+} Span;
+
+void span_bounds(const void* e, int64_t* start, int64_t* end) {
+    *start = ((const Span*)e)->start;
+    *end = ((const Span*)e)->end;
+}
+
+void span_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(Span));
+}
+
+static uint64_t rng_state = 88172645463325252ULL;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+bool count_visit(int64_t start, int64_t end, size_t id, void* ctx) {
+    (void)start;
+    (void)end;
+    (void)id;
+    (*(size_t*)ctx)++;
+    return true;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Benchmarks                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+int main(int argc, char** argv) {
+    const size_t n = bench_init(argc, argv, 1000000);
+    const size_t queries = 10000;
+
+    // Reads of ~150 bases over a genome-sized coordinate space, sorted like the input files
+    const int64_t span = (int64_t)n * 100;
+
+    DArray* spans = da_new(sizeof(Span));
+    spans->copier = span_copier;
+
+    for (size_t i = 0; i < n; i++) {
+        Span s;
+        s.start = (int64_t)(rng_next() % (uint64_t)span);
+        s.end = s.start + 100 + (int64_t)(rng_next() % 100);
+        da_push(spans, &s);
+    }
+
+    bench_header("Interval Tree & Index");
+
+    BenchRun run;
+    size_t hits = 0;
+
+    bench_begin(&run, "linear scan overlap");
+    for (size_t q = 0; q < queries / 100; q++) {
+        int64_t lo = (int64_t)(rng_next() % (uint64_t)span), hi = lo + 1000;
+        uint64_t t = bench_ticks();
+        const Span* arr = (const Span*)spans->arr;
+        for (size_t i = 0; i < n; i++) hits += arr[i].start < hi && lo < arr[i].end;
+        bench_record(&run, t);
+    }
+    bench_end(&run, queries / 100);
+
+    ITree* it = itree_new(0, NULL, NULL);
+
+    bench_begin(&run, "itree_insert");
+    for (size_t i = 0; i < n; i++) {
+        const Span* s = (const Span*)da_get(spans, i);
+        uint64_t t = bench_ticks();
+        itree_insert(it, s->start, s->end, NULL);
+        bench_record(&run, t);
+    }
+    bench_end(&run, n);
+
+    bench_begin(&run, "itree_count_overlap");
+    for (size_t q = 0; q < queries; q++) {
+        int64_t lo = (int64_t)(rng_next() % (uint64_t)span), hi = lo + 1000;
+        uint64_t t = bench_ticks();
+        hits += itree_count_overlap(it, lo, hi);
+        bench_record(&run, t);
+    }
+    bench_end(&run, queries);
+
+    itree_free(it);
+
+    uint64_t start = bench_now_ns();
+    IIndex* idx = iidx_new(spans, span_bounds);
+    printf("iidx_new (unsorted): %.1f ms\n", (double)(bench_now_ns() - start) / 1e6);
+
+    bench_begin(&run, "iidx_overlap");
+    for (size_t q = 0; q < queries; q++) {
+        int64_t lo = (int64_t)(rng_next() % (uint64_t)span), hi = lo + 1000;
+        uint64_t t = bench_ticks();
+        iidx_overlap(idx, lo, hi, count_visit, &hits);
+        bench_record(&run, t);
+    }
+    bench_end(&run, queries);
+
+    bench_begin(&run, "iidx_count_overlap");
+    for (size_t q = 0; q < queries; q++) {
+        int64_t lo = (int64_t)(rng_next() % (uint64_t)span), hi = lo + 1000;
+        uint64_t t = bench_ticks();
+        hits += iidx_count_overlap(idx, lo, hi);
+        bench_record(&run, t);
+    }
+    bench_end(&run, queries);
+
+    iidx_free(idx);
+
+    bench_escape(&hits);
+    da_free(spans);
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include "bench.h"
+#include "kdtree.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+static size_t point_bytes = 0;
+
+void point_copier(void* dest, const void* src) {
+    memcpy(dest, src, point_bytes);
+}
+
+static uint64_t rng_state = 88172645463325252ULL;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static float rng_coord(void) {
+    return (float)(rng_next() >> 40) / (float)(1 << 24);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Benchmarks                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+int main(int argc, char** argv) {
+    const size_t n = bench_init(argc, argv, 1000000);
+    const size_t queries = 10000;
+    const size_t dims[] = {3, 8};
+
+    bench_header("k-d Tree");
+
+    BenchRun run;
+    KDNeighbor out[16];
+
+    for (size_t di = 0; di < 2; di++) {
+        const size_t dim = dims[di];
+        char name[64];
+
+        point_bytes = dim * sizeof(float);
+        DArray* points = da_new_with_capacity(point_bytes, n);
+        points->copier = point_copier;
+
+        float p[KD_MAX_DIM];
+        for (size_t i = 0; i < n; i++) {
+            for (size_t d = 0; d < dim; d++) p[d] = rng_coord();
+            da_push(points, p);
+        }
+
+        size_t threads[] = {1, 4};
+        KDTree* kd = NULL;
+
+        for (size_t t = 0; t < 2; t++) {
+            kd_free(kd);
+
+            snprintf(name, sizeof(name), "kd_new (%zuD, %zuT)", dim, threads[t]);
+            bench_begin(&run, name);
+            kd = kd_new(points, dim, threads[t]);
+            bench_end(&run, n);
+        }
+
+        float* qs = malloc(queries * dim * sizeof(float));
+        for (size_t i = 0; i < queries * dim; i++) qs[i] = rng_coord();
+
+        size_t ks[] = {1, 16};
+        for (size_t ki = 0; ki < 2; ki++) {
+            snprintf(name, sizeof(name), "kd_knn (%zuD, k=%zu)", dim, ks[ki]);
+            bench_begin(&run, name);
+            for (size_t q = 0; q < queries; q++) {
+                uint64_t t = bench_ticks();
+                kd_knn(kd, qs + q * dim, ks[ki], out);
+                bench_record(&run, t);
+                bench_escape(out);
+            }
+            bench_end(&run, queries);
+        }
+
+        // Radius holding ~32 points on average for uniform data in the unit cube (3D only, 8D needs huge radii)
+        if (dim == 3) {
+            const float r = cbrtf(32.0f * 3.0f / (4.0f * 3.14159265f * (float)n));
+            size_t hits = 0;
+
+            bench_begin(&run, "kd_radius (3D, ~32 hits)");
+            for (size_t q = 0; q < queries; q++) {
+                uint64_t t = bench_ticks();
+                hits += kd_radius(kd, qs + q * dim, r, NULL, NULL);
+                bench_record(&run, t);
+            }
+            bench_end(&run, queries);
+            bench_escape(&hits);
+        }
+
+        KDNeighbor* batch = malloc(queries * 16 * sizeof(KDNeighbor));
+
+        snprintf(name, sizeof(name), "kd_knn_batch (%zuD, k=16, 4T)", dim);
+        bench_begin(&run, name);
+        kd_knn_batch(kd, qs, queries, 16, batch, 4);
+        bench_end(&run, queries);
+
+        free(batch);
+        free(qs);
+        kd_free(kd);
+        da_free(points);
+    }
+
+    return 0;
+}
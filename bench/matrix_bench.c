@@ -0,0 +1,130 @@
+#include "bench.h"
+#include "matrix.h"
+
+#include <stdio.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+static uint64_t rng_state = 88172645463325252ULL;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static Matrix* random_matrix(size_t rows, size_t cols) {
+    Matrix* m = mat_new(rows, cols);
+
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) mat_set(m, i, j, (double)(rng_next() >> 11) * 0x1p-52 - 1.0);
+    }
+
+    return m;
+}
+
+// naive `i-k-j` loop, the baseline the blocked kernels are measured against
+static void naive_mul(const Matrix* a, const Matrix* b, Matrix* c) {
+    for (size_t i = 0; i < a->rows; i++) {
+        double* row = c->data + i * c->stride;
+        for (size_t j = 0; j < c->cols; j++) row[j] = 0.0;
+
+        for (size_t p = 0; p < a->cols; p++) {
+            const double x = a->data[i * a->stride + p];
+            const double* brow = b->data + p * b->stride;
+
+            for (size_t j = 0; j < c->cols; j++) row[j] += x * brow[j];
+        }
+    }
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Benchmarks                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+int main(int argc, char** argv) {
+    // `n` is the largest matrix side; each run is one product (`2 side^3` flops)
+    const size_t n = bench_init(argc, argv, 1024);
+
+    bench_header("Matrices");
+
+    BenchRun run;
+    char name[64];
+    double sink = 0.0;
+
+    const MatKernel kernels[] = {MAT_KERNEL_PORTABLE, MAT_KERNEL_AVX2};
+    const char* names[] = {"portable", "avx2"};
+
+    for (size_t side = n / 4 < 64 ? 64 : n / 4; side <= n; side *= 2) {
+        Matrix *a = random_matrix(side, side), *b = random_matrix(side, side), *c = mat_new(side, side);
+
+        snprintf(name, sizeof(name), "naive i-k-j (%zu)", side);
+        bench_begin(&run, name);
+        naive_mul(a, b, c);
+        bench_end(&run, 1);
+        sink += mat_get(c, side - 1, side - 1);
+
+        for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+            if (!mat_use_kernel(kernels[k])) continue;
+
+            snprintf(name, sizeof(name), "mat_gemm %s (%zu)", names[k], side);
+            bench_begin(&run, name);
+            mat_gemm(1.0, a, b, 0.0, c, 1);
+            bench_end(&run, 1);
+            sink += mat_get(c, 0, 0);
+        }
+        mat_use_kernel(MAT_KERNEL_AUTO);
+
+        snprintf(name, sizeof(name), "mat_gemm 4 threads (%zu)", side);
+        bench_begin(&run, name);
+        mat_gemm(1.0, a, b, 0.0, c, 4);
+        bench_end(&run, 1);
+        sink += mat_get(c, 0, 0);
+
+        snprintf(name, sizeof(name), "mat_mul_strassen (%zu)", side);
+        bench_begin(&run, name);
+        Matrix* p = mat_mul_strassen(a, b, 1);
+        bench_end(&run, 1);
+        sink += mat_get(p, 0, 0);
+
+        mat_free(p);
+        mat_free(a);
+        mat_free(b);
+        mat_free(c);
+    }
+
+    // Chain planning on a badly shaped chain: left to right costs far more than the planned order
+    const size_t dims[] = {n, n / 16, n, n / 16, n};
+    Matrix* ms[4];
+    for (size_t i = 0; i < 4; i++) ms[i] = random_matrix(dims[i], dims[i + 1]);
+
+    bench_begin(&run, "mat_chain_mul (4 factors)");
+    Matrix* chain = mat_chain_mul((const Matrix* const*)ms, 4, 1);
+    bench_end(&run, 1);
+    sink += mat_get(chain, 0, 0);
+
+    bench_begin(&run, "left to right (4 factors)");
+    Matrix* left = mat_mul(ms[0], ms[1], 1);
+    for (size_t i = 2; i < 4; i++) {
+        Matrix* next = mat_mul(left, ms[i], 1);
+        mat_free(left);
+        left = next;
+    }
+    bench_end(&run, 1);
+    sink += mat_get(left, 0, 0);
+
+    bench_escape(&sink);
+
+    for (size_t i = 0; i < 4; i++) mat_free(ms[i]);
+    mat_free(chain);
+    mat_free(left);
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "bench.h"
+#include "ntheory.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+static uint64_t rng_state = 88172645463325252ULL;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Benchmarks                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+int main(int argc, char** argv) {
+    // `n` is the sieve limit; the per-operation benchmarks run `n / 100` times
+    const size_t n = bench_init(argc, argv, 1000000000);
+    const size_t ops = n / 100 < 100000 ? 100000 : n / 100;
+
+    bench_header("Number Theory");
+
+    BenchRun run;
+    char name[64];
+    uint64_t sink = 0;
+
+    size_t threads[] = {1, 4};
+    for (size_t t = 0; t < 2; t++) {
+        snprintf(name, sizeof(name), "nt_prime_count (%zuT)", threads[t]);
+        bench_begin(&run, name);
+        sink += nt_prime_count(0, n, threads[t]);
+        bench_end(&run, n);
+    }
+
+    bench_begin(&run, "nt_primes (1T)");
+    DArray* primes = nt_primes(0, n / 10, 1);
+    bench_end(&run, n / 10);
+    da_free(primes);
+
+    const uint64_t mod = (1ULL << 61) - 1;
+    uint64_t* values = malloc(ops * sizeof(uint64_t));
+    uint64_t* inverses = malloc(ops * sizeof(uint64_t));
+    for (size_t i = 0; i < ops; i++) values[i] = rng_next() % (mod - 1) + 1;
+
+    NTMont m;
+    NTBarrett b;
+    nt_mont_init(&m, mod);
+    nt_barrett_init(&b, mod);
+
+    uint64_t acc = nt_mont_to(&m, 3);
+    bench_begin(&run, "nt_mont_mul");
+    for (size_t i = 0; i < ops; i++) acc = nt_mont_mul(&m, acc, values[i]);
+    bench_end(&run, ops);
+    sink += acc;
+
+    acc = 3;
+    bench_begin(&run, "nt_barrett_mul");
+    for (size_t i = 0; i < ops; i++) acc = nt_barrett_mul(&b, acc, values[i]);
+    bench_end(&run, ops);
+    sink += acc;
+
+    acc = 3;
+    bench_begin(&run, "nt_mulmod (128-bit %)");
+    for (size_t i = 0; i < ops; i++) acc = nt_mulmod(acc, values[i], mod);
+    bench_end(&run, ops);
+    sink += acc;
+
+    bench_begin(&run, "nt_powmod (61-bit)");
+    for (size_t i = 0; i < ops / 100; i++) sink += nt_powmod(values[i], values[i + 1], mod);
+    bench_end(&run, ops / 100);
+
+    bench_begin(&run, "nt_is_prime (random 64-bit)");
+    for (size_t i = 0; i < ops / 10; i++) sink += nt_is_prime(rng_next() | 1);
+    bench_end(&run, ops / 10);
+
+    bench_begin(&run, "nt_invmod");
+    for (size_t i = 0; i < ops / 10; i++) sink += nt_invmod(values[i], mod);
+    bench_end(&run, ops / 10);
+
+    bench_begin(&run, "nt_invmod_batch");
+    nt_invmod_batch(values, ops, mod, inverses);
+    bench_end(&run, ops);
+    sink += inverses[ops / 2];
+
+    bench_escape(&sink);
+
+    free(values);
+    free(inverses);
+
+    return 0;
+}
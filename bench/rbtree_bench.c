@@ -0,0 +1,124 @@
+#include "bench.h"
+#include "rbtree.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+int u64_cmp(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+void u64_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(uint64_t));
+}
+
+void noop_deallocator(void* k) {
+    (void)k;
+}
+
+static uint64_t rng_state = 88172645463325252ULL;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Benchmarks                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+int main(int argc, char** argv) {
+    const size_t n = bench_init(argc, argv, 1000000);
+
+    bench_header("RBTree");
+
+    BenchRun run;
+    RBTree* rb = rb_new_with_order_stats(sizeof(uint64_t), u64_cmp, u64_copier, noop_deallocator);
+
+    uint64_t* keys = (uint64_t*)malloc(n * sizeof(uint64_t));
+    for (size_t i = 0; i < n; i++) keys[i] = rng_next();
+
+    bench_begin(&run, "rb_insert (random)");
+    for (size_t i = 0; i < n; i++) {
+        uint64_t t = bench_ticks();
+        rb_insert(rb, &keys[i]);
+        bench_record(&run, t);
+    }
+    bench_end(&run, n);
+
+    bench_begin(&run, "rb_find (hit)");
+    for (size_t i = 0; i < n; i++) {
+        const uint64_t* k = &keys[rng_next() % n];
+        uint64_t t = bench_ticks();
+        void* e = rb_find(rb, k);
+        bench_record(&run, t);
+        bench_escape(e);
+    }
+    bench_end(&run, n);
+
+    bench_begin(&run, "rb_lower_bound (random)");
+    for (size_t i = 0; i < n; i++) {
+        uint64_t k = rng_next();
+        uint64_t t = bench_ticks();
+        void* e = rb_lower_bound(rb, &k);
+        bench_record(&run, t);
+        bench_escape(e);
+    }
+    bench_end(&run, n);
+
+    bench_begin(&run, "rb_select (random)");
+    for (size_t i = 0; i < n; i++) {
+        size_t idx = (size_t)(rng_next() % n);
+        uint64_t t = bench_ticks();
+        void* e = rb_select(rb, idx);
+        bench_record(&run, t);
+        bench_escape(e);
+    }
+    bench_end(&run, n);
+
+    // In-order scan through the parent pointers: one op per element, so no per-op latency.
+    bench_begin(&run, "rb_next (scan)");
+    uint64_t sum = 0;
+    for (const uint64_t* e = (const uint64_t*)rb_first(rb); e; e = (const uint64_t*)rb_next(rb, e)) sum += *e;
+    bench_escape(&sum);
+    bench_end(&run, n);
+
+    bench_begin(&run, "rb_remove (random order)");
+    for (size_t i = 0; i < n; i++) {
+        uint64_t t = bench_ticks();
+        rb_remove(rb, &keys[i]);
+        bench_record(&run, t);
+    }
+    bench_end(&run, n);
+
+    rb_free(rb);
+
+    // Bulk build from sorted input vs n insertions.
+    DArray* sorted = da_new_with_capacity(sizeof(uint64_t), n);
+    sorted->copier = u64_copier;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t v = (uint64_t)i;
+        da_push(sorted, &v);
+    }
+
+    bench_begin(&run, "rb_new_from_sorted");
+    rb = rb_new_from_sorted(sorted, u64_cmp, noop_deallocator, true);
+    bench_end(&run, n);
+    rb_free(rb);
+
+    da_free(sorted);
+    free(keys);
+
+    return 0;
+}
@@ -0,0 +1,158 @@
+#include "bench.h"
+#include "strdist.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+static uint64_t rng_state = 88172645463325252ULL;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static void random_string(char* s, size_t n) {
+    for (size_t i = 0; i < n; i++) s[i] = (char)('a' + rng_next() % 26);
+}
+
+// a copy of `src` with `edits` random substitutions, insertions or deletions
+static size_t mutate(char* dst, const char* src, size_t n, size_t edits) {
+    size_t len = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        const uint64_t r = rng_next();
+
+        if (r % n >= edits) dst[len++] = src[i];
+        else if (r % 3 == 0) dst[len++] = (char)('a' + (r >> 8) % 26);
+        else if (r % 3 == 1) {
+            dst[len++] = src[i];
+            dst[len++] = (char)('a' + (r >> 8) % 26);
+        }
+    }
+
+    return len;
+}
+
+// the O(n * m) two-row DP, the baseline
+static size_t naive_levenshtein(const char* a, size_t m, const char* b, size_t n, size_t* row) {
+    for (size_t j = 0; j <= n; j++) row[j] = j;
+
+    for (size_t i = 1; i <= m; i++) {
+        size_t diag = row[0];
+        row[0] = i;
+
+        for (size_t j = 1; j <= n; j++) {
+            const size_t up = row[j];
+            size_t best = diag + (a[i - 1] != b[j - 1]);
+            if (up + 1 < best) best = up + 1;
+            if (row[j - 1] + 1 < best) best = row[j - 1] + 1;
+
+            row[j] = best;
+            diag = up;
+        }
+    }
+
+    return row[n];
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Benchmarks                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+int main(int argc, char** argv) {
+    // `n` is the number of short pairs (fuzzy dedup of 40 to 120 byte records, a few edits apart)
+    const size_t n = bench_init(argc, argv, 200000);
+
+    bench_header("String Distances");
+
+    BenchRun run;
+    size_t sink = 0;
+
+    char* text = malloc(n * 256);
+    SDPair* pairs = malloc(n * sizeof(SDPair));
+    size_t* out = malloc(n * sizeof(size_t));
+    size_t* row = malloc(512 * sizeof(size_t));
+
+    for (size_t i = 0; i < n; i++) {
+        char *a = text + i * 256, *b = a + 128;
+        const size_t len = 40 + rng_next() % 81;
+        random_string(a, len);
+
+        pairs[i] = (SDPair){a, len, b, mutate(b, a, len, rng_next() % 8)};
+    }
+
+    bench_begin(&run, "naive DP (short pairs)");
+    for (size_t i = 0; i < n; i++) {
+        sink += naive_levenshtein(pairs[i].a, pairs[i].a_len, pairs[i].b, pairs[i].b_len, row);
+    }
+    bench_end(&run, n);
+
+    bench_begin(&run, "sd_levenshtein (short pairs)");
+    for (size_t i = 0; i < n; i++) sink += sd_levenshtein(pairs[i].a, pairs[i].a_len, pairs[i].b, pairs[i].b_len);
+    bench_end(&run, n);
+
+    bench_begin(&run, "bounded k=3");
+    for (size_t i = 0; i < n; i++) {
+        sink += sd_levenshtein_bounded(pairs[i].a, pairs[i].a_len, pairs[i].b, pairs[i].b_len, 3);
+    }
+    bench_end(&run, n);
+
+    bench_begin(&run, "batch k=3");
+    sd_levenshtein_batch(pairs, n, 3, out, 1);
+    bench_end(&run, n);
+    sink += out[n - 1];
+
+    bench_begin(&run, "batch k=3 (4 threads)");
+    sd_levenshtein_batch(pairs, n, 3, out, 4);
+    bench_end(&run, n);
+    sink += out[n - 1];
+
+    bench_begin(&run, "sd_lcs (short pairs)");
+    for (size_t i = 0; i < n; i++) sink += sd_lcs(pairs[i].a, pairs[i].a_len, pairs[i].b, pairs[i].b_len);
+    bench_end(&run, n);
+
+    // Long strings: multi-word columns, exact and banded
+    const size_t len = 20000;
+    char *a = malloc(len), *b = malloc(2 * len);
+    random_string(a, len);
+    const size_t blen = mutate(b, a, len, 200);
+    size_t* long_row = malloc((blen + 1) * sizeof(size_t));
+
+    bench_begin(&run, "naive DP (20000 bytes)");
+    sink += naive_levenshtein(a, len, b, blen, long_row);
+    bench_end(&run, 1);
+
+    bench_begin(&run, "sd_levenshtein (20000 bytes)");
+    sink += sd_levenshtein(a, len, b, blen);
+    bench_end(&run, 1);
+
+    bench_begin(&run, "bounded k=500 (20000 bytes)");
+    sink += sd_levenshtein_bounded(a, len, b, blen, 500);
+    bench_end(&run, 1);
+
+    bench_begin(&run, "sd_lcs (20000 bytes)");
+    sink += sd_lcs(a, len, b, blen);
+    bench_end(&run, 1);
+
+    bench_escape(&sink);
+
+    free(text);
+    free(pairs);
+    free(out);
+    free(row);
+    free(a);
+    free(b);
+    free(long_row);
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include "bench.h"
+#include "treap.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+int u64_cmp(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+void u64_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(uint64_t));
+}
+
+void noop_deallocator(void* k) {
+    (void)k;
+}
+
+static uint64_t rng_state = 88172645463325252ULL;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static Treap* random_treap(size_t n) {
+    Treap* tp = tp_new(sizeof(uint64_t), u64_cmp, u64_copier, noop_deallocator);
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t k = rng_next();
+        tp_insert(tp, &k);
+    }
+
+    return tp;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Benchmarks                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+int main(int argc, char** argv) {
+    const size_t n = bench_init(argc, argv, 1000000);
+
+    bench_header("Treap");
+
+    BenchRun run;
+    Treap* tp = tp_new(sizeof(uint64_t), u64_cmp, u64_copier, noop_deallocator);
+
+    bench_begin(&run, "tp_insert (random)");
+    for (size_t i = 0; i < n; i++) {
+        uint64_t k = rng_next();
+        uint64_t t = bench_ticks();
+        tp_insert(tp, &k);
+        bench_record(&run, t);
+    }
+    bench_end(&run, n);
+
+    bench_begin(&run, "tp_find (random)");
+    for (size_t i = 0; i < n; i++) {
+        uint64_t k = rng_next();
+        uint64_t t = bench_ticks();
+        void* e = tp_find(tp, &k);
+        bench_record(&run, t);
+        bench_escape(e);
+    }
+    bench_end(&run, n);
+
+    // Cut out and put back a random range: two splits and two merges each way.
+    bench_begin(&run, "tp_extract_range + tp_union");
+    for (size_t i = 0; i < n / 100; i++) {
+        uint64_t lo = rng_next(), hi = lo + (UINT64_MAX >> 4);
+        if (hi < lo) hi = UINT64_MAX;
+
+        uint64_t t = bench_ticks();
+        Treap* range = tp_extract_range(tp, &lo, &hi);
+        tp_union(tp, range);
+        bench_record(&run, t);
+
+        tp_free(range);
+    }
+    bench_end(&run, n / 100);
+
+    tp_free(tp);
+
+    // Bulk union of two large treaps, sequential vs threaded.
+    size_t threads[] = {1, 2, 4, 8};
+    const char* names[] = {"tp_union (1 thread)", "tp_union_parallel (2 threads)", "tp_union_parallel (4 threads)", "tp_union_parallel (8 threads)"};
+
+    for (size_t t = 0; t < 4; t++) {
+        Treap* a = random_treap(n / 2);
+        Treap* b = random_treap(n / 2);
+
+        bench_begin(&run, names[t]);
+        tp_union_parallel(a, b, threads[t]);
+        bench_end(&run, n);
+
+        tp_free(a);
+        tp_free(b);
+    }
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include "bench.h"
+#include "hash.h"
+#include "typed_darray.h"
+#include "typed_hashset.h"
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+#define INT_CMP(a, b) (((a) > (b)) - ((a) < (b)))
+
+static inline uint64_t int_hash(int k, uint64_t seed_0, uint64_t seed_1) {
+    return hash_sip(&k, sizeof(int), seed_0, seed_1);
+}
+
+static inline bool int_eq(int a, int b) {
+    return a == b;
+}
+
+DEFINE_DARRAY(IntArr, int)
+DEFINE_DARRAY_CMP(IntArr, int, INT_CMP)
+
+DEFINE_HSET(IntSet, int, int_hash, int_eq)
+
+static uint64_t rng_state = 88172645463325252ULL;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Benchmarks                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+// Same workloads as darray_bench / hashset_bench, through the typed containers.
+int main(int argc, char** argv) {
+    const size_t n = bench_init(argc, argv, 1000000);
+
+    bench_header("Typed containers");
+
+    BenchRun run;
+    IntArr* da = IntArr_new();
+
+    bench_begin(&run, "IntArr_push");
+    for (size_t i = 0; i < n; i++) {
+        uint64_t t = bench_ticks();
+        IntArr_push(da, (int)i);
+        bench_record(&run, t);
+    }
+    bench_end(&run, n);
+
+    for (size_t i = 0; i < n; i++) da->arr[i] = (int)(rng_next() & 0x7FFFFFFF);
+
+    bench_begin(&run, "IntArr_sort");
+    IntArr_sort(da);
+    bench_end(&run, 1);
+
+    bench_begin(&run, "IntArr_binary_search");
+    for (size_t i = 0; i < n; i++) {
+        int key = (int)(rng_next() & 0x7FFFFFFF);
+        uint64_t t = bench_ticks();
+        size_t index = IntArr_binary_search(da, key);
+        bench_record(&run, t);
+        bench_escape(&index);
+    }
+    bench_end(&run, n);
+
+    IntArr_free(da);
+
+    const size_t set_n = n / 2;
+    IntSet* hs = IntSet_new();
+
+    bench_begin(&run, "IntSet_insert");
+    for (size_t i = 0; i < set_n; i++) {
+        uint64_t t = bench_ticks();
+        IntSet_insert(hs, (int)i);
+        bench_record(&run, t);
+    }
+    bench_end(&run, set_n);
+
+    bench_begin(&run, "IntSet_contains (hit)");
+    size_t found = 0;
+    for (size_t i = 0; i < set_n; i++) {
+        int v = (int)((i * 7919) % set_n);
+        uint64_t t = bench_ticks();
+        found += IntSet_contains(hs, v);
+        bench_record(&run, t);
+    }
+    bench_escape(&found);
+    bench_end(&run, set_n);
+
+    bench_begin(&run, "IntSet_contains (miss)");
+    for (size_t i = 0; i < set_n; i++) {
+        uint64_t t = bench_ticks();
+        found += IntSet_contains(hs, (int)(set_n + i));
+        bench_record(&run, t);
+    }
+    bench_escape(&found);
+    bench_end(&run, set_n);
+
+    bench_begin(&run, "IntSet_remove");
+    for (size_t i = 0; i < set_n; i++) {
+        uint64_t t = bench_ticks();
+        IntSet_remove(hs, (int)i);
+        bench_record(&run, t);
+    }
+    bench_end(&run, set_n);
+
+    IntSet_free(hs);
+
+    return 0;
+}
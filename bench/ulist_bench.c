@@ -0,0 +1,128 @@
+#include "bench.h"
+#include "darray.h"
+#include "ulist.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+void int_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(int));
+}
+
+static uint64_t rng_state = 88172645463325252ULL;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Benchmarks                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+int main(int argc, char** argv) {
+    const size_t n = bench_init(argc, argv, 1000000);
+
+    bench_header("ULList");
+
+    BenchRun run;
+    ULList* ul = ul_new(sizeof(int));
+
+    bench_begin(&run, "ul_push_back");
+    for (size_t i = 0; i < n; i++) {
+        int v = (int)i;
+        uint64_t t = bench_ticks();
+        ul_push_back(ul, &v);
+        bench_record(&run, t);
+    }
+    bench_end(&run, n);
+
+    // Whole-sequence scans: one op per element, so no per-op latency.
+    bench_begin(&run, "ul_iter_next (scan)");
+    ULIterator it;
+    ul_iter_init(&it, ul);
+    long sum = 0;
+    for (int* e; (e = (int*)ul_iter_next(&it));) sum += *e;
+    bench_escape(&sum);
+    bench_end(&run, n);
+
+    bench_begin(&run, "ul_iter_next_block (scan)");
+    ul_iter_init(&it, ul);
+    sum = 0;
+    size_t count;
+    for (int* block; (block = (int*)ul_iter_next_block(&it, &count));) {
+        for (size_t i = 0; i < count; i++) sum += block[i];
+    }
+    bench_escape(&sum);
+    bench_end(&run, n);
+
+    DArray* da = da_new_with_capacity(sizeof(int), n);
+    da->copier = int_copier;
+    for (size_t i = 0; i < n; i++) {
+        int v = (int)i;
+        da_push(da, &v);
+    }
+
+    bench_begin(&run, "da scan (baseline)");
+    sum = 0;
+    const int* arr = (const int*)da_raw(da);
+    for (size_t i = 0; i < n; i++) sum += arr[i];
+    bench_escape(&sum);
+    bench_end(&run, n);
+
+    // Random-position insertion: O(n / node_capacity) walk + one node shift, vs an O(n) shift.
+    const size_t mid_n = n / 50 ? n / 50 : 1;
+
+    bench_begin(&run, "ul_insert_at (random)");
+    for (size_t i = 0; i < mid_n; i++) {
+        int v = (int)i;
+        size_t index = (size_t)(rng_next() % ul_length(ul));
+        uint64_t t = bench_ticks();
+        ul_insert_at(ul, index, &v);
+        bench_record(&run, t);
+    }
+    bench_end(&run, mid_n);
+
+    bench_begin(&run, "da_insert_at (random)");
+    for (size_t i = 0; i < mid_n; i++) {
+        int v = (int)i;
+        size_t index = (size_t)(rng_next() % da->length);
+        uint64_t t = bench_ticks();
+        da_insert_at(da, index, &v);
+        bench_record(&run, t);
+    }
+    bench_end(&run, mid_n);
+
+    bench_begin(&run, "ul_remove_at (random)");
+    for (size_t i = 0; i < mid_n; i++) {
+        size_t index = (size_t)(rng_next() % ul_length(ul));
+        uint64_t t = bench_ticks();
+        ul_remove_at(ul, index, NULL);
+        bench_record(&run, t);
+    }
+    bench_end(&run, mid_n);
+
+    bench_begin(&run, "ul_pop_front");
+    for (size_t i = 0; i < n; i++) {
+        int v;
+        uint64_t t = bench_ticks();
+        ul_pop_front(ul, &v);
+        bench_record(&run, t);
+    }
+    bench_end(&run, n);
+
+    da_free(da);
+    ul_free(ul);
+
+    return 0;
+}
@@ -0,0 +1,1158 @@
+#include "bigint.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bits.h"
+
+/// Limb counts below which schoolbook multiplication beats Karatsuba, and Karatsuba beats Toom-3.
+#define __BI_KARATSUBA_THRESHOLD 24
+#define __BI_TOOM3_THRESHOLD 240
+
+/// Divisor limb count from which division multiplies by a Newton reciprocal instead of running algorithm D.
+#define __BI_NEWTON_THRESHOLD 64
+
+/// Limb count below which decimal conversion runs the quadratic loop over `10^19` chunks.
+#define __BI_DEC_THRESHOLD 32
+
+/// Largest power of ten in a limb, and its number of digits.
+#define __BI_DEC_BASE 10000000000000000000ull
+#define __BI_DEC_DIGITS 19
+
+/// Most powers `10^(19 * 2^k)` a conversion may need (far beyond any addressable size).
+#define __BI_MAX_POWERS 48
+
+/******************************************************************************
+ *                                                                            *
+ *                              Inner Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+__extension__ typedef unsigned __int128 bi_u128;
+
+/// A divisor prepared once for many divisions: normalized so its top bit is set, with its reciprocal when large.
+typedef struct BIDivisor {
+    BigInt* norm;    ///< The divisor shifted left by `shift` (unshifted when it is a single limb).
+    unsigned shift;
+    BigInt* inv;     ///< About `B^(2n) / norm` for an `n`-limb `norm`, `NULL` below the Newton threshold.
+} BIDivisor;
+
+/// The powers `10^(19 * 2^k)` used by decimal conversion, built on demand.
+typedef struct BIPowers {
+    BigInt* pow[__BI_MAX_POWERS];
+    BIDivisor div[__BI_MAX_POWERS];  ///< Prepared on demand (by `bi_to_string`).
+    size_t count;
+} BIPowers;
+
+static void __bi_limb_copier(void* dest, const void* src);
+// a non-negative `BigInt` of `n` limbs with unspecified contents
+static BigInt* __bi_alloc(size_t n);
+static BigInt* __bi_from_limbs(const uint64_t* d, size_t n);
+inline static uint64_t* __bi_limbs(const BigInt* a);
+inline static size_t __bi_size(const BigInt* a);
+// drops leading zero limbs (and the sign of zero)
+static void __bi_trim(BigInt* a);
+// frees `*dst` and replaces it by `v`
+inline static void __bi_set(BigInt** dst, BigInt* v);
+// `|a| += 1` and `|a| -= 1` (`|a| > 0`), in place
+static bool __bi_inc(BigInt* a);
+static void __bi_dec(BigInt* a);
+// `a / 3`, exact, in place
+static void __bi_divexact_3(BigInt* a);
+
+// Raw limb arithmetic; `r` may alias the inputs unless stated otherwise
+inline static size_t __bi_len(const uint64_t* a, size_t n);
+static int __bi_cmp(const uint64_t* a, size_t an, const uint64_t* b, size_t bn);
+static uint64_t __bi_add_n(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n);
+static uint64_t __bi_add_1(uint64_t* r, const uint64_t* a, size_t n, uint64_t c);
+// `an >= bn`
+static uint64_t __bi_add(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn);
+static uint64_t __bi_sub_n(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n);
+static uint64_t __bi_sub_1(uint64_t* r, const uint64_t* a, size_t n, uint64_t c);
+// `an >= bn`
+static uint64_t __bi_sub(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn);
+// `r = |x - y|` over `xn >= yn` limbs, returns whether `x < y`
+static bool __bi_abs_diff(uint64_t* r, const uint64_t* x, size_t xn, const uint64_t* y, size_t yn);
+static uint64_t __bi_mul_1(uint64_t* r, const uint64_t* a, size_t n, uint64_t b);
+static uint64_t __bi_addmul_1(uint64_t* r, const uint64_t* a, size_t n, uint64_t b);
+static uint64_t __bi_submul_1(uint64_t* r, const uint64_t* a, size_t n, uint64_t b);
+static uint64_t __bi_div_1(uint64_t* q, const uint64_t* a, size_t n, uint64_t d);
+
+// Multiplication into `r` of `an + bn` limbs, which must not alias the inputs
+static void __bi_mul_basecase(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn);
+static bool __bi_mul_n(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n);
+static bool __bi_karatsuba(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n);
+static bool __bi_toom3(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n);
+static bool __bi_mul(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn);
+
+// Division of magnitudes
+// algorithm D: `u` has `an + 1` limbs (the top one may be zero), `v` is normalized with `bn >= 2` limbs and `an >= bn`;
+// the quotient goes to `q` (`an - bn + 1` limbs) and the remainder is left in `u[0..bn)`
+static void __bi_div_basecase(uint64_t* q, uint64_t* u, size_t an, const uint64_t* v, size_t bn);
+static BigInt* __bi_recip(const BigInt* b);
+static bool __bi_divisor_init(BIDivisor* dv, const BigInt* b);
+static void __bi_divisor_free(BIDivisor* dv);
+// `x < B^(2n)` by the prepared `n`-limb divisor, through its reciprocal
+static bool __bi_div_2n(const BigInt* x, const BIDivisor* dv, BigInt** q, BigInt** r);
+// `|a|` by the prepared divisor, non-negative results
+static bool __bi_divmod_with(const BigInt* a, const BIDivisor* dv, BigInt** q, BigInt** r);
+
+// Decimal conversion
+static bool __bi_powers_reach(BIPowers* pw, size_t k);
+static void __bi_powers_free(BIPowers* pw);
+static BigInt* __bi_from_dec(const char* s, size_t len, BIPowers* pw);
+// writes exactly `width` digits (a multiple of 19) of `x`, zero-padded
+static bool __bi_to_dec_basecase(const BigInt* x, char* out, size_t width);
+// writes exactly `38 * 2^k` digits of `x < pow[k]^2`
+static bool __bi_to_dec(const BigInt* x, size_t k, BIPowers* pw, char* out);
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+BigInt* bi_new(void) {
+    return __bi_alloc(0);
+}
+
+BigInt* bi_from_u64(uint64_t v) {
+    return __bi_from_limbs(&v, 1);
+}
+
+BigInt* bi_from_i64(int64_t v) {
+    BigInt* a = bi_from_u64(v < 0 ? 0 - (uint64_t)v : (uint64_t)v);
+    if (a) a->negative = v < 0;
+
+    return a;
+}
+
+BigInt* bi_from_string(const char* str) {
+    if (!str) return NULL;
+
+    const bool negative = *str == '-';
+    if (*str == '-' || *str == '+') str++;
+
+    size_t len = strlen(str);
+    if (!len) return NULL;
+
+    for (size_t i = 0; i < len; i++) {
+        if (str[i] < '0' || str[i] > '9') return NULL;
+    }
+
+    while (len > 1 && *str == '0') str++, len--;
+
+    BIPowers pw = {0};
+    BigInt* a = __bi_from_dec(str, len, &pw);
+    __bi_powers_free(&pw);
+
+    if (a && __bi_size(a)) a->negative = negative;
+
+    return a;
+}
+
+BigInt* bi_copy(const BigInt* a) {
+    if (!a) return NULL;
+
+    BigInt* copy = __bi_from_limbs(__bi_limbs(a), __bi_size(a));
+    if (copy) copy->negative = a->negative;
+
+    return copy;
+}
+
+void bi_free(BigInt* a) {
+    if (!a) return;
+
+    // Limbs own nothing: skip the per-element deallocator calls
+    a->limbs->length = 0;
+    da_free(a->limbs);
+    free(a);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                   Access                                   *
+ *                                                                            *
+ ******************************************************************************/
+
+char* bi_to_string(const BigInt* a) {
+    if (!a) return NULL;
+
+    const size_t n = __bi_size(a);
+    BIPowers pw = {0};
+    size_t k = 0, width = __BI_DEC_DIGITS * (n + n / 64 + 2);
+
+    // Above the threshold, the smallest `k` with `a < pow[k]^2` sets the width `38 * 2^k`
+    if (n > __BI_DEC_THRESHOLD) {
+        while (true) {
+            if (!__bi_powers_reach(&pw, k)) {
+                __bi_powers_free(&pw);
+                return NULL;
+            }
+            if (2 * __bi_size(pw.pow[k]) - 1 > n) break;
+            k++;
+        }
+        width = (size_t)2 * __BI_DEC_DIGITS << k;
+    }
+
+    char* buffer = malloc(width + 2);
+    BigInt* mag = bi_copy(a);
+    bool ok = buffer && mag;
+
+    if (ok) {
+        mag->negative = false;
+        ok = n > __BI_DEC_THRESHOLD ? __bi_to_dec(mag, k, &pw, buffer + 1) : __bi_to_dec_basecase(mag, buffer + 1, width);
+    }
+
+    bi_free(mag);
+    __bi_powers_free(&pw);
+
+    if (!ok) {
+        free(buffer);
+        return NULL;
+    }
+
+    size_t skip = 1;
+    while (skip < width && buffer[skip] == '0') skip++;
+
+    if (a->negative) buffer[--skip] = '-';
+
+    memmove(buffer, buffer + skip, width + 1 - skip);
+    buffer[width + 1 - skip] = '\0';
+
+    return buffer;
+}
+
+bool bi_to_u64(const BigInt* a, uint64_t* out) {
+    if (!a || !out || a->negative || __bi_size(a) > 1) return false;
+
+    *out = __bi_size(a) ? __bi_limbs(a)[0] : 0;
+
+    return true;
+}
+
+bool bi_is_zero(const BigInt* a) {
+    return !a || !__bi_size(a);
+}
+
+int bi_sign(const BigInt* a) {
+    if (bi_is_zero(a)) return 0;
+
+    return a->negative ? -1 : 1;
+}
+
+size_t bi_bits(const BigInt* a) {
+    if (bi_is_zero(a)) return 0;
+
+    const size_t n = __bi_size(a);
+
+    return 64 * n - bits_clz(__bi_limbs(a)[n - 1]);
+}
+
+int bi_cmp(const BigInt* a, const BigInt* b) {
+    const int sa = bi_sign(a), sb = bi_sign(b);
+    if (sa != sb) return sa < sb ? -1 : 1;
+
+    const int c = bi_cmp_abs(a, b);
+
+    return sa < 0 ? -c : c;
+}
+
+int bi_cmp_abs(const BigInt* a, const BigInt* b) {
+    if (!a || !b) return 0;
+
+    return __bi_cmp(__bi_limbs(a), __bi_size(a), __bi_limbs(b), __bi_size(b));
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Arithmetic                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+BigInt* bi_neg(const BigInt* a) {
+    BigInt* r = bi_copy(a);
+    if (r && __bi_size(r)) r->negative = !a->negative;
+
+    return r;
+}
+
+BigInt* bi_add(const BigInt* a, const BigInt* b) {
+    if (!a || !b) return NULL;
+
+    if (__bi_size(a) < __bi_size(b)) {
+        const BigInt* t = a;
+        a = b;
+        b = t;
+    }
+
+    const size_t an = __bi_size(a), bn = __bi_size(b);
+    const uint64_t *x = __bi_limbs(a), *y = __bi_limbs(b);
+
+    BigInt* r = __bi_alloc(an + 1);
+    if (!r) return NULL;
+
+    uint64_t* d = __bi_limbs(r);
+
+    if (a->negative == b->negative) {
+        d[an] = __bi_add(d, x, an, y, bn);
+        r->negative = a->negative;
+    } else {
+        // Subtract the smaller magnitude from the larger, the result takes the larger one's sign
+        d[an] = 0;
+        r->negative = __bi_abs_diff(d, x, an, y, bn) ? b->negative : a->negative;
+    }
+
+    __bi_trim(r);
+
+    return r;
+}
+
+BigInt* bi_sub(const BigInt* a, const BigInt* b) {
+    if (!a || !b) return NULL;
+
+    // `a - b = a + (-b)` on a shallow copy that shares the limbs of `b`
+    BigInt negated = *b;
+    negated.negative = __bi_size(b) && !b->negative;
+
+    return bi_add(a, &negated);
+}
+
+BigInt* bi_mul(const BigInt* a, const BigInt* b) {
+    if (!a || !b) return NULL;
+
+    const size_t an = __bi_size(a), bn = __bi_size(b);
+    if (!an || !bn) return bi_new();
+
+    BigInt* r = __bi_alloc(an + bn);
+    if (!r) return NULL;
+
+    if (!__bi_mul(__bi_limbs(r), __bi_limbs(a), an, __bi_limbs(b), bn)) {
+        bi_free(r);
+        return NULL;
+    }
+
+    r->negative = a->negative != b->negative;
+    __bi_trim(r);
+
+    return r;
+}
+
+bool bi_divmod(const BigInt* a, const BigInt* b, BigInt** q, BigInt** r) {
+    if (!a || bi_is_zero(b)) return false;
+
+    BIDivisor dv;
+    if (!__bi_divisor_init(&dv, b)) return false;
+
+    BigInt *quot = NULL, *rem = NULL;
+    const bool ok = __bi_divmod_with(a, &dv, &quot, &rem);
+    __bi_divisor_free(&dv);
+
+    if (!ok) return false;
+
+    // Truncated division: the quotient takes the sign of `a * b` and the remainder the sign of `a`
+    if (__bi_size(quot)) quot->negative = a->negative != b->negative;
+    if (__bi_size(rem)) rem->negative = a->negative;
+
+    if (q) *q = quot;
+    else bi_free(quot);
+
+    if (r) *r = rem;
+    else bi_free(rem);
+
+    return true;
+}
+
+BigInt* bi_div(const BigInt* a, const BigInt* b) {
+    BigInt* q = NULL;
+
+    return bi_divmod(a, b, &q, NULL) ? q : NULL;
+}
+
+BigInt* bi_mod(const BigInt* a, const BigInt* b) {
+    BigInt* r = NULL;
+
+    return bi_divmod(a, b, NULL, &r) ? r : NULL;
+}
+
+BigInt* bi_shl(const BigInt* a, size_t bits) {
+    if (!a) return NULL;
+
+    const size_t n = __bi_size(a), limbs = bits / 64;
+    const unsigned shift = (unsigned)(bits % 64);
+    if (!n) return bi_new();
+
+    BigInt* r = __bi_alloc(n + limbs + 1);
+    if (!r) return NULL;
+
+    const uint64_t* x = __bi_limbs(a);
+    uint64_t* d = __bi_limbs(r);
+
+    memset(d, 0, limbs * sizeof(uint64_t));
+    if (shift) {
+        d[n + limbs] = x[n - 1] >> (64 - shift);
+        for (size_t i = n - 1; i > 0; i--) d[i + limbs] = (x[i] << shift) | (x[i - 1] >> (64 - shift));
+        d[limbs] = x[0] << shift;
+    } else {
+        memcpy(d + limbs, x, n * sizeof(uint64_t));
+        d[n + limbs] = 0;
+    }
+
+    r->negative = a->negative;
+    __bi_trim(r);
+
+    return r;
+}
+
+BigInt* bi_shr(const BigInt* a, size_t bits) {
+    if (!a) return NULL;
+
+    const size_t n = __bi_size(a), limbs = bits / 64;
+    const unsigned shift = (unsigned)(bits % 64);
+    if (limbs >= n) return bi_new();
+
+    const size_t rn = n - limbs;
+    BigInt* r = __bi_alloc(rn);
+    if (!r) return NULL;
+
+    const uint64_t* x = __bi_limbs(a) + limbs;
+    uint64_t* d = __bi_limbs(r);
+
+    if (shift) {
+        for (size_t i = 0; i + 1 < rn; i++) d[i] = (x[i] >> shift) | (x[i + 1] << (64 - shift));
+        d[rn - 1] = x[rn - 1] >> shift;
+    } else {
+        memcpy(d, x, rn * sizeof(uint64_t));
+    }
+
+    r->negative = a->negative;
+    __bi_trim(r);
+
+    return r;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                       Inner Functions Implementation                       *
+ *                                                                            *
+ ******************************************************************************/
+
+static void __bi_limb_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(uint64_t));
+}
+
+static BigInt* __bi_alloc(size_t n) {
+    BigInt* a = malloc(sizeof(BigInt));
+    if (!a) return NULL;
+
+    a->limbs = da_new_with_capacity(sizeof(uint64_t), n ? n : 1);
+    if (!a->limbs) {
+        free(a);
+        return NULL;
+    }
+
+    a->limbs->copier = __bi_limb_copier;
+    a->limbs->length = n;
+    a->negative = false;
+
+    return a;
+}
+
+static BigInt* __bi_from_limbs(const uint64_t* d, size_t n) {
+    BigInt* a = __bi_alloc(n);
+    if (!a) return NULL;
+
+    if (n) memcpy(__bi_limbs(a), d, n * sizeof(uint64_t));
+    __bi_trim(a);
+
+    return a;
+}
+
+inline static uint64_t* __bi_limbs(const BigInt* a) {
+    return (uint64_t*)a->limbs->arr;
+}
+
+inline static size_t __bi_size(const BigInt* a) {
+    return a->limbs->length;
+}
+
+static void __bi_trim(BigInt* a) {
+    a->limbs->length = __bi_len(__bi_limbs(a), __bi_size(a));
+    if (!a->limbs->length) a->negative = false;
+}
+
+inline static void __bi_set(BigInt** dst, BigInt* v) {
+    bi_free(*dst);
+    *dst = v;
+}
+
+static bool __bi_inc(BigInt* a) {
+    const size_t n = __bi_size(a);
+    uint64_t* d = __bi_limbs(a);
+
+    if (!__bi_add_1(d, d, n, 1)) return true;
+
+    if (!da_reserve(a->limbs, n + 1)) return false;
+
+    __bi_limbs(a)[n] = 1;
+    a->limbs->length = n + 1;
+
+    return true;
+}
+
+static void __bi_dec(BigInt* a) {
+    uint64_t* d = __bi_limbs(a);
+
+    __bi_sub_1(d, d, __bi_size(a), 1);
+    __bi_trim(a);
+}
+
+static void __bi_divexact_3(BigInt* a) {
+    // Hensel division from the low limb: `q = (x - borrow) * 3^-1 mod 2^64`, and `3q` overflows into the next borrow
+    const uint64_t inv3 = 0xAAAAAAAAAAAAAAABull;
+    uint64_t* d = __bi_limbs(a);
+    uint64_t borrow = 0;
+
+    for (size_t i = 0; i < __bi_size(a); i++) {
+        const uint64_t s = d[i] - borrow, under = d[i] < borrow;
+        d[i] = s * inv3;
+        borrow = under + (uint64_t)(((bi_u128)d[i] * 3) >> 64);
+    }
+
+    __bi_trim(a);
+}
+
+inline static size_t __bi_len(const uint64_t* a, size_t n) {
+    while (n && !a[n - 1]) n--;
+
+    return n;
+}
+
+static int __bi_cmp(const uint64_t* a, size_t an, const uint64_t* b, size_t bn) {
+    an = __bi_len(a, an);
+    bn = __bi_len(b, bn);
+    if (an != bn) return an < bn ? -1 : 1;
+
+    for (size_t i = an; i-- > 0;) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+
+    return 0;
+}
+
+static uint64_t __bi_add_n(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n) {
+    uint64_t carry = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        const bi_u128 s = (bi_u128)a[i] + b[i] + carry;
+        r[i] = (uint64_t)s;
+        carry = (uint64_t)(s >> 64);
+    }
+
+    return carry;
+}
+
+static uint64_t __bi_add_1(uint64_t* r, const uint64_t* a, size_t n, uint64_t c) {
+    size_t i = 0;
+
+    for (; i < n && c; i++) {
+        r[i] = a[i] + c;
+        c = r[i] < c;
+    }
+    if (r != a && i < n) memcpy(r + i, a + i, (n - i) * sizeof(uint64_t));
+
+    return c;
+}
+
+static uint64_t __bi_add(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn) {
+    const uint64_t carry = __bi_add_n(r, a, b, bn);
+
+    return __bi_add_1(r + bn, a + bn, an - bn, carry);
+}
+
+static uint64_t __bi_sub_n(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n) {
+    uint64_t borrow = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        const bi_u128 s = (bi_u128)a[i] - b[i] - borrow;
+        r[i] = (uint64_t)s;
+        borrow = (uint64_t)(s >> 64) & 1;
+    }
+
+    return borrow;
+}
+
+static uint64_t __bi_sub_1(uint64_t* r, const uint64_t* a, size_t n, uint64_t c) {
+    size_t i = 0;
+
+    for (; i < n && c; i++) {
+        const uint64_t v = a[i];
+        r[i] = v - c;
+        c = v < c;
+    }
+    if (r != a && i < n) memcpy(r + i, a + i, (n - i) * sizeof(uint64_t));
+
+    return c;
+}
+
+static uint64_t __bi_sub(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn) {
+    const uint64_t borrow = __bi_sub_n(r, a, b, bn);
+
+    return __bi_sub_1(r + bn, a + bn, an - bn, borrow);
+}
+
+static bool __bi_abs_diff(uint64_t* r, const uint64_t* x, size_t xn, const uint64_t* y, size_t yn) {
+    if (__bi_cmp(x, xn, y, yn) >= 0) {
+        __bi_sub(r, x, xn, y, yn);
+        return false;
+    }
+
+    // `x < y < B^yn`, so the top limbs of `x` are zero
+    __bi_sub_n(r, y, x, yn);
+    memset(r + yn, 0, (xn - yn) * sizeof(uint64_t));
+
+    return true;
+}
+
+static uint64_t __bi_mul_1(uint64_t* r, const uint64_t* a, size_t n, uint64_t b) {
+    uint64_t carry = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        const bi_u128 p = (bi_u128)a[i] * b + carry;
+        r[i] = (uint64_t)p;
+        carry = (uint64_t)(p >> 64);
+    }
+
+    return carry;
+}
+
+static uint64_t __bi_addmul_1(uint64_t* r, const uint64_t* a, size_t n, uint64_t b) {
+    uint64_t carry = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        const bi_u128 p = (bi_u128)a[i] * b + r[i] + carry;
+        r[i] = (uint64_t)p;
+        carry = (uint64_t)(p >> 64);
+    }
+
+    return carry;
+}
+
+static uint64_t __bi_submul_1(uint64_t* r, const uint64_t* a, size_t n, uint64_t b) {
+    uint64_t borrow = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        const bi_u128 p = (bi_u128)a[i] * b + borrow;
+        const uint64_t lo = (uint64_t)p;
+        borrow = (uint64_t)(p >> 64) + (r[i] < lo);
+        r[i] -= lo;
+    }
+
+    return borrow;
+}
+
+static uint64_t __bi_div_1(uint64_t* q, const uint64_t* a, size_t n, uint64_t d) {
+    uint64_t rem = 0;
+
+    for (size_t i = n; i-- > 0;) {
+        const bi_u128 num = ((bi_u128)rem << 64) | a[i];
+        q[i] = (uint64_t)(num / d);
+        rem = (uint64_t)(num % d);
+    }
+
+    return rem;
+}
+
+static void __bi_mul_basecase(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn) {
+    r[an] = __bi_mul_1(r, a, an, b[0]);
+    for (size_t j = 1; j < bn; j++) r[an + j] = __bi_addmul_1(r + j, a, an, b[j]);
+}
+
+static bool __bi_mul_n(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n) {
+    if (n < __BI_KARATSUBA_THRESHOLD) {
+        __bi_mul_basecase(r, a, n, b, n);
+        return true;
+    }
+
+    return n < __BI_TOOM3_THRESHOLD ? __bi_karatsuba(r, a, b, n) : __bi_toom3(r, a, b, n);
+}
+
+static bool __bi_karatsuba(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n) {
+    // `a = a1 B^h + a0` with `h >= l` limbs in the low half, and `a b = z2 B^2h + (z0 + z2 - (a0-a1)(b0-b1)) B^h + z0`
+    const size_t h = (n + 1) / 2, l = n - h;
+
+    uint64_t* t = malloc((6 * h + 1) * sizeof(uint64_t));
+    if (!t) return false;
+
+    uint64_t *da = t, *db = t + h, *d = t + 2 * h, *mid = t + 4 * h;
+    const bool na = __bi_abs_diff(da, a, h, a + h, l);
+    const bool nb = __bi_abs_diff(db, b, h, b + h, l);
+
+    if (!__bi_mul_n(r, a, b, h) || !__bi_mul_n(r + 2 * h, a + h, b + h, l) || !__bi_mul_n(d, da, db, h)) {
+        free(t);
+        return false;
+    }
+
+    mid[2 * h] = __bi_add(mid, r, 2 * h, r + 2 * h, 2 * l);
+    if (na == nb) __bi_sub(mid, mid, 2 * h + 1, d, 2 * h);
+    else __bi_add(mid, mid, 2 * h + 1, d, 2 * h);
+
+    // The middle term `a0 b1 + a1 b0 < 2 B^n` always fits above `h`
+    __bi_add(r + h, r + h, 2 * n - h, mid, __bi_len(mid, 2 * h + 1));
+
+    free(t);
+
+    return true;
+}
+
+static bool __bi_toom3(uint64_t* r, const uint64_t* a, const uint64_t* b, size_t n) {
+    // Split into three `k`-limb parts, evaluate at 0, 1, -1, -2 and infinity, multiply pointwise and interpolate
+    // with Bodrato's sequence (two exact halvings and one exact division by 3)
+    const size_t k = (n + 2) / 3, s = n - 2 * k;
+
+    BigInt *a0 = __bi_from_limbs(a, k), *a1 = __bi_from_limbs(a + k, k), *a2 = __bi_from_limbs(a + 2 * k, s);
+    BigInt *b0 = __bi_from_limbs(b, k), *b1 = __bi_from_limbs(b + k, k), *b2 = __bi_from_limbs(b + 2 * k, s);
+
+    BigInt *pa = bi_add(a0, a2), *pb = bi_add(b0, b2);
+    BigInt *pa1 = bi_add(pa, a1), *pb1 = bi_add(pb, b1);
+    BigInt *pam1 = bi_sub(pa, a1), *pbm1 = bi_sub(pb, b1);
+
+    __bi_set(&pa, bi_add(pam1, a2));
+    __bi_set(&pa, bi_shl(pa, 1));
+    __bi_set(&pa, bi_sub(pa, a0));
+    __bi_set(&pb, bi_add(pbm1, b2));
+    __bi_set(&pb, bi_shl(pb, 1));
+    __bi_set(&pb, bi_sub(pb, b0));
+
+    BigInt *r0 = bi_mul(a0, b0), *r1 = bi_mul(pa1, pb1), *rm1 = bi_mul(pam1, pbm1);
+    BigInt *rm2 = bi_mul(pa, pb), *rinf = bi_mul(a2, b2);
+
+    // c3 = (r(-2) - r(1)) / 3, c1 = (r(1) - r(-1)) / 2, c2 = r(-1) - r(0)
+    BigInt* c3 = bi_sub(rm2, r1);
+    if (c3) __bi_divexact_3(c3);
+    BigInt* c1 = bi_sub(r1, rm1);
+    __bi_set(&c1, bi_shr(c1, 1));
+    BigInt* c2 = bi_sub(rm1, r0);
+
+    // c3 = (c2 - c3) / 2 + 2 r(inf), c2 = c2 + c1 - r(inf), c1 = c1 - c3
+    __bi_set(&c3, bi_sub(c2, c3));
+    __bi_set(&c3, bi_shr(c3, 1));
+    __bi_set(&rm2, bi_shl(rinf, 1));
+    __bi_set(&c3, bi_add(c3, rm2));
+    __bi_set(&c2, bi_add(c2, c1));
+    __bi_set(&c2, bi_sub(c2, rinf));
+    __bi_set(&c1, bi_sub(c1, c3));
+
+    const bool ok = a0 && a1 && a2 && b0 && b1 && b2 && pa1 && pb1 && pam1 && pbm1 && r0 && r1 && rinf && c1 && c2 && c3;
+
+    if (ok) {
+        // All coefficients are non-negative: place c0 and c4, then add c1 to c3 at their offsets
+        const BigInt* c[5] = {r0, c1, c2, c3, rinf};
+
+        memset(r, 0, 2 * n * sizeof(uint64_t));
+        memcpy(r, __bi_limbs(r0), __bi_size(r0) * sizeof(uint64_t));
+        memcpy(r + 4 * k, __bi_limbs(rinf), __bi_size(rinf) * sizeof(uint64_t));
+
+        for (size_t i = 1; i < 4; i++) {
+            const size_t at = i * k;
+            __bi_add(r + at, r + at, 2 * n - at, __bi_limbs(c[i]), __bi_size(c[i]));
+        }
+    }
+
+    BigInt* temps[] = {a0, a1, a2, b0, b1, b2, pa, pb, pa1, pb1, pam1, pbm1, r0, r1, rm1, rm2, rinf, c1, c2, c3};
+    for (size_t i = 0; i < sizeof(temps) / sizeof(temps[0]); i++) bi_free(temps[i]);
+
+    return ok;
+}
+
+static bool __bi_mul(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn) {
+    if (an < bn) {
+        const uint64_t* t = a;
+        a = b;
+        b = t;
+
+        const size_t tn = an;
+        an = bn;
+        bn = tn;
+    }
+
+    if (bn < __BI_KARATSUBA_THRESHOLD) {
+        __bi_mul_basecase(r, a, an, b, bn);
+        return true;
+    }
+    if (an == bn) return __bi_mul_n(r, a, b, an);
+
+    // Unbalanced: multiply `bn`-limb slices of `a` by `b` and accumulate
+    uint64_t* t = malloc(2 * bn * sizeof(uint64_t));
+    if (!t) return false;
+
+    memset(r, 0, (an + bn) * sizeof(uint64_t));
+    for (size_t at = 0; at < an; at += bn) {
+        const size_t len = an - at < bn ? an - at : bn;
+
+        if (!__bi_mul(t, a + at, len, b, bn)) {
+            free(t);
+            return false;
+        }
+        __bi_add(r + at, r + at, an + bn - at, t, len + bn);
+    }
+
+    free(t);
+
+    return true;
+}
+
+static void __bi_div_basecase(uint64_t* q, uint64_t* u, size_t an, const uint64_t* v, size_t bn) {
+    const uint64_t vt = v[bn - 1], vs = v[bn - 2];
+
+    for (size_t j = an - bn + 1; j-- > 0;) {
+        // Estimate from the top two limbs, refined with the third: at most one too large afterwards
+        const bi_u128 num = ((bi_u128)u[j + bn] << 64) | u[j + bn - 1];
+        bi_u128 qhat = num / vt, rhat = num % vt;
+
+        while ((qhat >> 64) || qhat * vs > ((rhat << 64) | u[j + bn - 2])) {
+            qhat--;
+            rhat += vt;
+            if (rhat >> 64) break;
+        }
+
+        const uint64_t borrow = __bi_submul_1(u + j, v, bn, (uint64_t)qhat), top = u[j + bn];
+        u[j + bn] = top - borrow;
+
+        if (top < borrow) {
+            qhat--;
+            u[j + bn] += __bi_add_n(u + j, u + j, v, bn);
+        }
+
+        q[j] = (uint64_t)qhat;
+    }
+}
+
+static BigInt* __bi_recip(const BigInt* b) {
+    const size_t n = __bi_size(b);
+
+    if (n < __BI_NEWTON_THRESHOLD) {
+        // Algorithm D on `B^(2n)`
+        BigInt* v = __bi_alloc(n + 2);
+        uint64_t* u = calloc(2 * n + 2, sizeof(uint64_t));
+
+        if (!v || !u) {
+            bi_free(v);
+            free(u);
+            return NULL;
+        }
+
+        u[2 * n] = 1;
+        __bi_div_basecase(__bi_limbs(v), u, 2 * n + 1, __bi_limbs(b), n);
+        __bi_trim(v);
+        free(u);
+
+        return v;
+    }
+
+    // The reciprocal `v` of the top `h > n / 2` limbs gives `x = v B^(n-h)`, and one Newton step `x += x e / B^(2n)` with
+    // `e = B^(2n) - b x` squares its relative error. Only the top limbs of `e` matter, so the result may be a few units
+    // off either way (divisions correct their quotients)
+    const size_t h = n / 2 + 1, low = 64 * (n - h);
+
+    BigInt* top = bi_shr(b, low);
+    BigInt* v = __bi_recip(top);
+    BigInt* one = bi_from_u64(1);
+    BigInt* scale = bi_shl(one, 64 * (n + h));
+
+    // `e / B^(n-2) = (B^(n+h) - b v) / B^(h-2)`
+    BigInt* e = bi_mul(b, v);
+    __bi_set(&e, bi_sub(scale, e));
+    __bi_set(&e, bi_shr(e, 64 * (h - 2)));
+    __bi_set(&e, bi_mul(v, e));
+    __bi_set(&e, bi_shr(e, 64 * (h + 2)));
+
+    BigInt* x = bi_shl(v, low);
+    __bi_set(&x, bi_add(x, e));
+
+    bi_free(top);
+    bi_free(v);
+    bi_free(one);
+    bi_free(scale);
+
+    if (!e) {
+        bi_free(x);
+        return NULL;
+    }
+    bi_free(e);
+
+    return x;
+}
+
+static bool __bi_divisor_init(BIDivisor* dv, const BigInt* b) {
+    const size_t n = __bi_size(b);
+
+    dv->shift = n > 1 ? bits_clz(__bi_limbs(b)[n - 1]) : 0;
+    dv->inv = NULL;
+    dv->norm = bi_shl(b, dv->shift);
+    if (!dv->norm) return false;
+
+    dv->norm->negative = false;
+    if (n < __BI_NEWTON_THRESHOLD) return true;
+
+    dv->inv = __bi_recip(dv->norm);
+    if (!dv->inv) {
+        bi_free(dv->norm);
+        return false;
+    }
+
+    return true;
+}
+
+static void __bi_divisor_free(BIDivisor* dv) {
+    bi_free(dv->norm);
+    bi_free(dv->inv);
+}
+
+static bool __bi_div_2n(const BigInt* x, const BIDivisor* dv, BigInt** q, BigInt** r) {
+    // With `x` cut to its top `n + 1` limbs, `floor(x inv / B^(2n))` is within a few units of the quotient
+    const size_t n = __bi_size(dv->norm);
+
+    BigInt* quot = bi_shr(x, 64 * (n - 1));
+    __bi_set(&quot, bi_mul(quot, dv->inv));
+    __bi_set(&quot, bi_shr(quot, 64 * (n + 1)));
+
+    BigInt* rem = bi_mul(quot, dv->norm);
+    __bi_set(&rem, bi_sub(x, rem));
+
+    bool ok = quot && rem;
+
+    while (ok && rem->negative) {
+        __bi_dec(quot);
+        __bi_set(&rem, bi_add(rem, dv->norm));
+        ok = rem != NULL;
+    }
+    while (ok && bi_cmp(rem, dv->norm) >= 0) {
+        ok = __bi_inc(quot);
+        __bi_set(&rem, bi_sub(rem, dv->norm));
+        ok = ok && rem;
+    }
+
+    if (!ok) {
+        bi_free(quot);
+        bi_free(rem);
+        return false;
+    }
+
+    *q = quot;
+    *r = rem;
+
+    return true;
+}
+
+static bool __bi_divmod_with(const BigInt* a, const BIDivisor* dv, BigInt** q, BigInt** r) {
+    const size_t an = __bi_size(a), bn = __bi_size(dv->norm);
+
+    if (bn == 1) {
+        BigInt* quot = __bi_alloc(an);
+        if (!quot) return false;
+
+        const uint64_t rem = __bi_div_1(__bi_limbs(quot), __bi_limbs(a), an, __bi_limbs(dv->norm)[0]);
+        __bi_trim(quot);
+
+        *q = quot;
+        *r = bi_from_u64(rem);
+    } else {
+        BigInt* u = bi_shl(a, dv->shift);
+        if (!u) return false;
+
+        u->negative = false;
+        const size_t un = __bi_size(u);
+
+        BigInt *quot = NULL, *rem = NULL;
+
+        if (un < bn) {
+            quot = bi_new();
+            rem = bi_copy(u);
+        } else if (!dv->inv || un - bn < __BI_NEWTON_THRESHOLD) {
+            // Algorithm D, in place on `u` widened by one limb
+            quot = __bi_alloc(un - bn + 1);
+            if (quot && da_reserve(u->limbs, un + 1)) {
+                __bi_limbs(u)[un] = 0;
+                __bi_div_basecase(__bi_limbs(quot), __bi_limbs(u), un, __bi_limbs(dv->norm), bn);
+                __bi_trim(quot);
+
+                u->limbs->length = bn;
+                __bi_trim(u);
+                rem = u;
+                u = NULL;
+            }
+        } else if (un <= 2 * bn) {
+            __bi_div_2n(u, dv, &quot, &rem);
+        } else {
+            // Schoolbook in base `B^bn`: each `bn`-limb chunk of `u` below the running remainder is one `2n / n` step
+            const size_t chunks = (un + bn - 1) / bn;
+
+            quot = __bi_alloc(chunks * bn);
+            rem = bi_new();
+
+            bool ok = quot && rem;
+            if (ok) memset(__bi_limbs(quot), 0, chunks * bn * sizeof(uint64_t));
+
+            for (size_t i = chunks; ok && i-- > 0;) {
+                const size_t len = i == chunks - 1 ? un - i * bn : bn;
+
+                const size_t rn = __bi_size(rem);
+                BigInt* x = __bi_alloc(bn + rn);
+                ok = x != NULL;
+                if (ok) {
+                    uint64_t* d = __bi_limbs(x);
+                    memcpy(d, __bi_limbs(u) + i * bn, len * sizeof(uint64_t));
+                    memset(d + len, 0, (bn - len) * sizeof(uint64_t));
+                    memcpy(d + bn, __bi_limbs(rem), rn * sizeof(uint64_t));
+                    __bi_trim(x);
+                }
+
+                BigInt* qi = NULL;
+                __bi_set(&rem, NULL);
+                ok = ok && __bi_div_2n(x, dv, &qi, &rem);
+                if (ok) memcpy(__bi_limbs(quot) + i * bn, __bi_limbs(qi), __bi_size(qi) * sizeof(uint64_t));
+
+                bi_free(x);
+                bi_free(qi);
+            }
+
+            if (ok) __bi_trim(quot);
+            else {
+                bi_free(quot);
+                bi_free(rem);
+                quot = rem = NULL;
+            }
+        }
+
+        bi_free(u);
+
+        if (!quot || !rem) {
+            bi_free(quot);
+            bi_free(rem);
+            return false;
+        }
+
+        *q = quot;
+        *r = bi_shr(rem, dv->shift);
+        bi_free(rem);
+    }
+
+    if (!*q || !*r) {
+        bi_free(*q);
+        bi_free(*r);
+        return false;
+    }
+
+    (*q)->negative = (*r)->negative = false;
+
+    return true;
+}
+
+static bool __bi_powers_reach(BIPowers* pw, size_t k) {
+    if (k >= __BI_MAX_POWERS) return false;
+
+    while (pw->count <= k) {
+        BigInt* p = pw->count ? bi_mul(pw->pow[pw->count - 1], pw->pow[pw->count - 1]) : bi_from_u64(__BI_DEC_BASE);
+        if (!p) return false;
+
+        pw->div[pw->count].norm = NULL;
+        pw->div[pw->count].inv = NULL;
+        pw->pow[pw->count++] = p;
+    }
+
+    return true;
+}
+
+static void __bi_powers_free(BIPowers* pw) {
+    for (size_t i = 0; i < pw->count; i++) {
+        bi_free(pw->pow[i]);
+        __bi_divisor_free(&pw->div[i]);
+    }
+    pw->count = 0;
+}
+
+static BigInt* __bi_from_dec(const char* s, size_t len, BIPowers* pw) {
+    if (len <= __BI_DEC_DIGITS * __BI_DEC_THRESHOLD) {
+        // Horner's rule on 19-digit chunks, the first one shorter when needed
+        BigInt* a = __bi_alloc(len / __BI_DEC_DIGITS + 1);
+        if (!a) return NULL;
+
+        uint64_t* d = __bi_limbs(a);
+        size_t n = 0, at = 0, chunk = len % __BI_DEC_DIGITS ? len % __BI_DEC_DIGITS : __BI_DEC_DIGITS;
+
+        for (; at < len; at += chunk, chunk = __BI_DEC_DIGITS) {
+            uint64_t value = 0;
+            for (size_t i = 0; i < chunk; i++) value = value * 10 + (uint64_t)(s[at + i] - '0');
+
+            uint64_t carry = __bi_mul_1(d, d, n, __BI_DEC_BASE);
+            if (carry) d[n++] = carry;
+
+            // Over zero limbs the whole `value` comes back as the carry
+            carry = __bi_add_1(d, d, n, value);
+            if (carry) d[n++] = carry;
+        }
+
+        a->limbs->length = n;
+        __bi_trim(a);
+
+        return a;
+    }
+
+    // Split off the low `19 * 2^k` digits, the largest such block shorter than the string: `hi * pow[k] + lo`
+    size_t k = 0;
+    while (((size_t)__BI_DEC_DIGITS << (k + 1)) < len) k++;
+    if (!__bi_powers_reach(pw, k)) return NULL;
+
+    const size_t low = (size_t)__BI_DEC_DIGITS << k;
+
+    BigInt* hi = __bi_from_dec(s, len - low, pw);
+    BigInt* lo = __bi_from_dec(s + len - low, low, pw);
+    BigInt* a = bi_mul(hi, pw->pow[k]);
+    __bi_set(&a, bi_add(a, lo));
+
+    bi_free(hi);
+    bi_free(lo);
+
+    return a;
+}
+
+static bool __bi_to_dec_basecase(const BigInt* x, char* out, size_t width) {
+    size_t n = __bi_size(x);
+    uint64_t* t = malloc((n ? n : 1) * sizeof(uint64_t));
+    if (!t) return false;
+
+    if (n) memcpy(t, __bi_limbs(x), n * sizeof(uint64_t));
+
+    for (size_t end = width; end > 0; end -= __BI_DEC_DIGITS) {
+        uint64_t chunk = n ? __bi_div_1(t, t, n, __BI_DEC_BASE) : 0;
+        n = __bi_len(t, n);
+
+        for (size_t i = 0; i < __BI_DEC_DIGITS; i++, chunk /= 10) out[end - 1 - i] = (char)('0' + chunk % 10);
+    }
+
+    free(t);
+
+    return true;
+}
+
+static bool __bi_to_dec(const BigInt* x, size_t k, BIPowers* pw, char* out) {
+    const size_t half = (size_t)__BI_DEC_DIGITS << k;
+
+    if (__bi_size(x) <= __BI_DEC_THRESHOLD) return __bi_to_dec_basecase(x, out, 2 * half);
+
+    BIDivisor* dv = &pw->div[k];
+    if (!dv->norm && !__bi_divisor_init(dv, pw->pow[k])) return false;
+
+    BigInt *q = NULL, *r = NULL;
+    if (!__bi_divmod_with(x, dv, &q, &r)) return false;
+
+    const bool ok = __bi_to_dec(q, k - 1, pw, out) && __bi_to_dec(r, k - 1, pw, out + half);
+
+    bi_free(q);
+    bi_free(r);
+
+    return ok;
+}
@@ -0,0 +1,175 @@
+#ifndef BIGINT_H
+#define BIGINT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "darray.h"
+
+// Nomenclature used (to avoid collisions): bi_<method_name>
+// Warning: This implementation is not thread-safe, and is for educational purposes only.
+//
+// Every operation returns a new `BigInt` (or `NULL` on allocation failure) and leaves its operands untouched, so the
+// same value may be passed as several operands.
+
+/**
+ * @brief Arbitrary-Precision Integer
+ *
+ * Sign and magnitude; the magnitude is a `DArray` of `uint64_t` limbs, least significant first, without leading zero
+ * limbs (zero has no limbs and is never negative).
+ *
+ * Multiplication picks schoolbook, Karatsuba or Toom-3 by operand size (unbalanced operands are cut into balanced
+ * pieces). Division is schoolbook (Knuth's algorithm D) for small operands and otherwise multiplies by a Newton
+ * reciprocal of the divisor. Decimal conversion splits by squared powers of `10^19` (divide and conquer), so it costs a
+ * few multiplications of the full size instead of a quadratic loop.
+ */
+typedef struct BigInteger BigInt;
+
+struct BigInteger {
+    DArray* limbs;  ///< Magnitude, `uint64_t` limbs from least to most significant.
+    bool negative;  ///< Sign (always `false` for zero).
+};
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Creates a `BigInt` equal to zero.
+/// @return Pointer to the new value, or `NULL` on allocation failure.
+BigInt* bi_new(void);
+
+/// @brief Creates a `BigInt` from an unsigned machine integer.
+/// @param v The value.
+/// @return Pointer to the new value, or `NULL` on allocation failure.
+BigInt* bi_from_u64(uint64_t v);
+
+/// @brief Creates a `BigInt` from a signed machine integer.
+/// @param v The value.
+/// @return Pointer to the new value, or `NULL` on allocation failure.
+BigInt* bi_from_i64(int64_t v);
+
+/// @brief Parses a decimal string: an optional sign followed by at least one digit.
+/// @param str The string (`NULL` terminated).
+/// @return Pointer to the new value, or `NULL` on a malformed string or allocation failure.
+BigInt* bi_from_string(const char* str);
+
+/// @brief Copies a `BigInt`.
+/// @param a Pointer to the value.
+/// @return Pointer to the copy, or `NULL` on allocation failure.
+BigInt* bi_copy(const BigInt* a);
+
+/// @brief Frees a `BigInt`.
+/// @param a Pointer to the value (may be `NULL`).
+void bi_free(BigInt* a);
+
+/******************************************************************************
+ *                                                                            *
+ *                                   Access                                   *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Formats in decimal.
+/// @param a Pointer to the value.
+/// @return A new `NULL` terminated string (free it with `free`), or `NULL` on allocation failure.
+char* bi_to_string(const BigInt* a);
+
+/// @brief Converts to an unsigned machine integer.
+/// @param a Pointer to the value.
+/// @param out Receives the value.
+/// @return `true` if `a` is in `[0, 2^64)`.
+bool bi_to_u64(const BigInt* a, uint64_t* out);
+
+/// @brief Checks whether the value is zero.
+/// @param a Pointer to the value.
+/// @return `true` if `a` is zero.
+bool bi_is_zero(const BigInt* a);
+
+/// @brief Sign of the value.
+/// @param a Pointer to the value.
+/// @return `-1`, `0` or `1`.
+int bi_sign(const BigInt* a);
+
+/// @brief Number of significant bits of the magnitude.
+/// @param a Pointer to the value.
+/// @return The bit length (`0` for zero).
+size_t bi_bits(const BigInt* a);
+
+/// @brief Compares two values.
+/// @param a Pointer to the first value.
+/// @param b Pointer to the second value.
+/// @return `<0`, `0` or `>0` as `a` is less than, equal to or greater than `b`.
+int bi_cmp(const BigInt* a, const BigInt* b);
+
+/// @brief Compares two magnitudes.
+/// @param a Pointer to the first value.
+/// @param b Pointer to the second value.
+/// @return `<0`, `0` or `>0` as `|a|` is less than, equal to or greater than `|b|`.
+int bi_cmp_abs(const BigInt* a, const BigInt* b);
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Arithmetic                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Negates.
+/// @param a Pointer to the value.
+/// @return `-a`, or `NULL` on allocation failure.
+BigInt* bi_neg(const BigInt* a);
+
+/// @brief Adds. O(n), one carry chain.
+/// @param a Pointer to the first value.
+/// @param b Pointer to the second value.
+/// @return `a + b`, or `NULL` on allocation failure.
+BigInt* bi_add(const BigInt* a, const BigInt* b);
+
+/// @brief Subtracts. O(n), one borrow chain.
+/// @param a Pointer to the first value.
+/// @param b Pointer to the second value.
+/// @return `a - b`, or `NULL` on allocation failure.
+BigInt* bi_sub(const BigInt* a, const BigInt* b);
+
+/// @brief Multiplies: schoolbook, Karatsuba O(n^1.58) or Toom-3 O(n^1.46) by size.
+/// @param a Pointer to the first value.
+/// @param b Pointer to the second value.
+/// @return `a * b`, or `NULL` on allocation failure.
+BigInt* bi_mul(const BigInt* a, const BigInt* b);
+
+/// @brief Divides with truncation toward zero (like C's `/` and `%`).
+/// @details Small divisors use schoolbook division; large ones a Newton reciprocal, so the cost is a few
+/// multiplications.
+/// @param a Pointer to the dividend.
+/// @param b Pointer to the divisor.
+/// @param q Receives `a / b` (may be `NULL`).
+/// @param r Receives `a % b`, with the sign of `a` (may be `NULL`).
+/// @return `true` on success, `false` if `b` is zero or on allocation failure.
+bool bi_divmod(const BigInt* a, const BigInt* b, BigInt** q, BigInt** r);
+
+/// @brief Quotient, truncated toward zero.
+/// @param a Pointer to the dividend.
+/// @param b Pointer to the divisor.
+/// @return `a / b`, or `NULL` if `b` is zero or on allocation failure.
+BigInt* bi_div(const BigInt* a, const BigInt* b);
+
+/// @brief Remainder, with the sign of the dividend.
+/// @param a Pointer to the dividend.
+/// @param b Pointer to the divisor.
+/// @return `a % b`, or `NULL` if `b` is zero or on allocation failure.
+BigInt* bi_mod(const BigInt* a, const BigInt* b);
+
+/// @brief Shifts the magnitude left (multiplies by `2^bits`), keeping the sign.
+/// @param a Pointer to the value.
+/// @param bits Shift amount.
+/// @return The shifted value, or `NULL` on allocation failure.
+BigInt* bi_shl(const BigInt* a, size_t bits);
+
+/// @brief Shifts the magnitude right (divides `|a|` by `2^bits`, truncating), keeping the sign.
+/// @param a Pointer to the value.
+/// @param bits Shift amount.
+/// @return The shifted value, or `NULL` on allocation failure.
+BigInt* bi_shr(const BigInt* a, size_t bits);
+
+#endif  // BIGINT_H
@@ -0,0 +1,316 @@
+#include "bits.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define __BITS_X86 1
+#endif
+
+/// Bytes per Harley-Seal block of the portable kernel (16 words).
+#define __BITS_HS_WORD_BLOCK (16 * sizeof(uint64_t))
+
+/// Bytes per Harley-Seal block of the AVX2 kernel (16 vectors).
+#define __BITS_HS_VEC_BLOCK (16 * sizeof(__bits_v4u))
+
+/******************************************************************************
+ *                                                                            *
+ *                              Inner Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+typedef uint64_t __bits_v4u __attribute__((vector_size(32)));
+
+/// How the two inputs of a kernel are combined before counting.
+typedef enum BitsOp {
+    BITS_OP_NONE,  ///< Only `a` is read.
+    BITS_OP_AND,
+    BITS_OP_XOR,
+} BitsOp;
+
+typedef uint64_t (*BitsKernelFn)(const uint8_t* a, const uint8_t* b, size_t bytes, BitsOp op);
+
+/// Active kernel, `BITS_KERNEL_AUTO` until first resolved.
+static _Atomic int __bits_active = BITS_KERNEL_AUTO;
+
+static BitsKernel __bits_resolve(void);
+static bool __bits_supported(BitsKernel kernel);
+inline static uint64_t __bits_count(const void* a, const void* b, size_t bytes, BitsOp op);
+inline static uint64_t __bits_load(const uint8_t* a, const uint8_t* b, size_t i, BitsOp op);
+inline static uint64_t __bits_swar(uint64_t x);
+// counts the bytes past the last whole word
+inline static uint64_t __bits_tail(const uint8_t* a, const uint8_t* b, size_t from, size_t bytes, BitsOp op);
+static uint64_t __bits_portable(const uint8_t* a, const uint8_t* b, size_t bytes, BitsOp op);
+#ifdef __BITS_X86
+static uint64_t __bits_popcnt(const uint8_t* a, const uint8_t* b, size_t bytes, BitsOp op);
+static uint64_t __bits_avx2(const uint8_t* a, const uint8_t* b, size_t bytes, BitsOp op);
+inline static __bits_v4u __bits_load_v(const uint8_t* a, const uint8_t* b, size_t i, BitsOp op);
+inline static uint64_t __bits_swar_v(__bits_v4u x);
+#endif
+
+/// Carry-save adder: adds the bits of `a`, `b`, `c` lane by lane into the sum `l` and carry `h`.
+#define __BITS_CSA(h, l, a, b, c)                                                    \
+    do {                                                                             \
+        const __typeof__(a) __csa_a = (a), __csa_b = (b), __csa_c = (c);             \
+        const __typeof__(a) __csa_u = __csa_a ^ __csa_b;                             \
+        h = (__csa_a & __csa_b) | (__csa_u & __csa_c);                               \
+        l = __csa_u ^ __csa_c;                                                       \
+    } while (0)
+
+/******************************************************************************
+ *                                                                            *
+ *                               Bulk Popcount                                *
+ *                                                                            *
+ ******************************************************************************/
+
+bool bits_use_kernel(BitsKernel kernel) {
+    if (kernel == BITS_KERNEL_AUTO) kernel = __bits_resolve();
+    if (!__bits_supported(kernel)) return false;
+
+    atomic_store_explicit(&__bits_active, (int)kernel, memory_order_relaxed);
+
+    return true;
+}
+
+BitsKernel bits_kernel(void) {
+    int kernel = atomic_load_explicit(&__bits_active, memory_order_relaxed);
+
+    if (kernel == BITS_KERNEL_AUTO) {
+        kernel = (int)__bits_resolve();
+        atomic_store_explicit(&__bits_active, kernel, memory_order_relaxed);
+    }
+
+    return (BitsKernel)kernel;
+}
+
+uint64_t bits_popcount_buf(const void* data, size_t bytes) {
+    if (!data) return 0;
+
+    return __bits_count(data, data, bytes, BITS_OP_NONE);
+}
+
+uint64_t bits_popcount_and(const void* a, const void* b, size_t bytes) {
+    if (!a || !b) return 0;
+
+    return __bits_count(a, b, bytes, BITS_OP_AND);
+}
+
+uint64_t bits_popcount_xor(const void* a, const void* b, size_t bytes) {
+    if (!a || !b) return 0;
+
+    return __bits_count(a, b, bytes, BITS_OP_XOR);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                      Inner Functions Implementation                        *
+ *                                                                            *
+ ******************************************************************************/
+
+static BitsKernel __bits_resolve(void) {
+#ifdef __BITS_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) return BITS_KERNEL_AVX2;
+    if (__builtin_cpu_supports("popcnt")) return BITS_KERNEL_POPCNT;
+#endif
+
+    return BITS_KERNEL_PORTABLE;
+}
+
+static bool __bits_supported(BitsKernel kernel) {
+    switch (kernel) {
+        case BITS_KERNEL_PORTABLE:
+            return true;
+#ifdef __BITS_X86
+        case BITS_KERNEL_POPCNT:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("popcnt");
+        case BITS_KERNEL_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#endif
+        default:
+            return false;
+    }
+}
+
+inline static uint64_t __bits_count(const void* a, const void* b, size_t bytes, BitsOp op) {
+    BitsKernelFn fn = __bits_portable;
+
+#ifdef __BITS_X86
+    switch (bits_kernel()) {
+        case BITS_KERNEL_AVX2:
+            fn = __bits_avx2;
+            break;
+        case BITS_KERNEL_POPCNT:
+            fn = __bits_popcnt;
+            break;
+        default:
+            break;
+    }
+#endif
+
+    return fn((const uint8_t*)a, (const uint8_t*)b, bytes, op);
+}
+
+inline static uint64_t __bits_load(const uint8_t* a, const uint8_t* b, size_t i, BitsOp op) {
+    uint64_t x, y;
+    memcpy(&x, a + i * sizeof(uint64_t), sizeof(uint64_t));
+
+    if (op == BITS_OP_NONE) return x;
+
+    memcpy(&y, b + i * sizeof(uint64_t), sizeof(uint64_t));
+
+    return op == BITS_OP_AND ? x & y : x ^ y;
+}
+
+inline static uint64_t __bits_swar(uint64_t x) {
+    x -= (x >> 1) & 0x5555555555555555ULL;
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+
+    return (x * 0x0101010101010101ULL) >> 56;
+}
+
+inline static uint64_t __bits_tail(const uint8_t* a, const uint8_t* b, size_t from, size_t bytes, BitsOp op) {
+    uint64_t x = 0, y = 0;
+
+    memcpy(&x, a + from, bytes - from);
+    if (op == BITS_OP_NONE) return __bits_swar(x);
+
+    memcpy(&y, b + from, bytes - from);
+
+    return __bits_swar(op == BITS_OP_AND ? x & y : x ^ y);
+}
+
+static uint64_t __bits_portable(const uint8_t* a, const uint8_t* b, size_t bytes, BitsOp op) {
+    const size_t blocks = bytes / __BITS_HS_WORD_BLOCK;
+    const size_t words = bytes / sizeof(uint64_t);
+
+    uint64_t total = 0, ones = 0, twos = 0, fours = 0, eights = 0;
+    uint64_t twos_a, twos_b, fours_a, fours_b, eights_a, eights_b, sixteens;
+
+    // Harley-Seal: a tree of carry-save adders folds 16 words into one word of weight 16, so only one popcount is
+    // needed per block instead of 16.
+    for (size_t blk = 0; blk < blocks; blk++) {
+        const size_t w = blk * 16;
+
+        __BITS_CSA(twos_a, ones, ones, __bits_load(a, b, w + 0, op), __bits_load(a, b, w + 1, op));
+        __BITS_CSA(twos_b, ones, ones, __bits_load(a, b, w + 2, op), __bits_load(a, b, w + 3, op));
+        __BITS_CSA(fours_a, twos, twos, twos_a, twos_b);
+        __BITS_CSA(twos_a, ones, ones, __bits_load(a, b, w + 4, op), __bits_load(a, b, w + 5, op));
+        __BITS_CSA(twos_b, ones, ones, __bits_load(a, b, w + 6, op), __bits_load(a, b, w + 7, op));
+        __BITS_CSA(fours_b, twos, twos, twos_a, twos_b);
+        __BITS_CSA(eights_a, fours, fours, fours_a, fours_b);
+        __BITS_CSA(twos_a, ones, ones, __bits_load(a, b, w + 8, op), __bits_load(a, b, w + 9, op));
+        __BITS_CSA(twos_b, ones, ones, __bits_load(a, b, w + 10, op), __bits_load(a, b, w + 11, op));
+        __BITS_CSA(fours_a, twos, twos, twos_a, twos_b);
+        __BITS_CSA(twos_a, ones, ones, __bits_load(a, b, w + 12, op), __bits_load(a, b, w + 13, op));
+        __BITS_CSA(twos_b, ones, ones, __bits_load(a, b, w + 14, op), __bits_load(a, b, w + 15, op));
+        __BITS_CSA(fours_b, twos, twos, twos_a, twos_b);
+        __BITS_CSA(eights_b, fours, fours, fours_a, fours_b);
+        __BITS_CSA(sixteens, eights, eights, eights_a, eights_b);
+
+        total += __bits_swar(sixteens);
+    }
+
+    total = 16 * total + 8 * __bits_swar(eights) + 4 * __bits_swar(fours) + 2 * __bits_swar(twos) + __bits_swar(ones);
+
+    for (size_t w = blocks * 16; w < words; w++) total += __bits_swar(__bits_load(a, b, w, op));
+
+    return total + __bits_tail(a, b, words * sizeof(uint64_t), bytes, op);
+}
+
+#ifdef __BITS_X86
+
+__attribute__((target("popcnt"))) static uint64_t __bits_popcnt(
+    const uint8_t* a, const uint8_t* b, size_t bytes, BitsOp op
+) {
+    const size_t words = bytes / sizeof(uint64_t);
+
+    // Independent accumulators keep `popcnt` (3 cycles latency, 1 per cycle throughput) busy.
+    uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    size_t w = 0;
+
+    for (; w + 4 <= words; w += 4) {
+        c0 += (uint64_t)__builtin_popcountll(__bits_load(a, b, w + 0, op));
+        c1 += (uint64_t)__builtin_popcountll(__bits_load(a, b, w + 1, op));
+        c2 += (uint64_t)__builtin_popcountll(__bits_load(a, b, w + 2, op));
+        c3 += (uint64_t)__builtin_popcountll(__bits_load(a, b, w + 3, op));
+    }
+
+    for (; w < words; w++) c0 += (uint64_t)__builtin_popcountll(__bits_load(a, b, w, op));
+
+    return c0 + c1 + c2 + c3 + __bits_tail(a, b, words * sizeof(uint64_t), bytes, op);
+}
+
+__attribute__((target("avx2"))) inline static __bits_v4u __bits_load_v(
+    const uint8_t* a, const uint8_t* b, size_t i, BitsOp op
+) {
+    __bits_v4u x, y;
+    memcpy(&x, a + i * sizeof(__bits_v4u), sizeof(__bits_v4u));
+
+    if (op == BITS_OP_NONE) return x;
+
+    memcpy(&y, b + i * sizeof(__bits_v4u), sizeof(__bits_v4u));
+
+    return op == BITS_OP_AND ? x & y : x ^ y;
+}
+
+// SWAR popcount of each 64-bit lane, summed; only runs once per block so it needs no byte shuffle.
+__attribute__((target("avx2"))) inline static uint64_t __bits_swar_v(__bits_v4u x) {
+    x -= (x >> 1) & 0x5555555555555555ULL;
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    x += x >> 8;
+    x += x >> 16;
+    x += x >> 32;
+    x &= 0x7F;
+
+    return x[0] + x[1] + x[2] + x[3];
+}
+
+__attribute__((target("avx2,popcnt"))) static uint64_t __bits_avx2(
+    const uint8_t* a, const uint8_t* b, size_t bytes, BitsOp op
+) {
+    const size_t blocks = bytes / __BITS_HS_VEC_BLOCK;
+
+    uint64_t total = 0;
+    __bits_v4u ones = {0}, twos = {0}, fours = {0}, eights = {0};
+    __bits_v4u twos_a, twos_b, fours_a, fours_b, eights_a, eights_b, sixteen;
+
+    // Same adder tree as the portable kernel, 256 bits per lane.
+    for (size_t blk = 0; blk < blocks; blk++) {
+        const size_t v = blk * 16;
+
+        __BITS_CSA(twos_a, ones, ones, __bits_load_v(a, b, v + 0, op), __bits_load_v(a, b, v + 1, op));
+        __BITS_CSA(twos_b, ones, ones, __bits_load_v(a, b, v + 2, op), __bits_load_v(a, b, v + 3, op));
+        __BITS_CSA(fours_a, twos, twos, twos_a, twos_b);
+        __BITS_CSA(twos_a, ones, ones, __bits_load_v(a, b, v + 4, op), __bits_load_v(a, b, v + 5, op));
+        __BITS_CSA(twos_b, ones, ones, __bits_load_v(a, b, v + 6, op), __bits_load_v(a, b, v + 7, op));
+        __BITS_CSA(fours_b, twos, twos, twos_a, twos_b);
+        __BITS_CSA(eights_a, fours, fours, fours_a, fours_b);
+        __BITS_CSA(twos_a, ones, ones, __bits_load_v(a, b, v + 8, op), __bits_load_v(a, b, v + 9, op));
+        __BITS_CSA(twos_b, ones, ones, __bits_load_v(a, b, v + 10, op), __bits_load_v(a, b, v + 11, op));
+        __BITS_CSA(fours_a, twos, twos, twos_a, twos_b);
+        __BITS_CSA(twos_a, ones, ones, __bits_load_v(a, b, v + 12, op), __bits_load_v(a, b, v + 13, op));
+        __BITS_CSA(twos_b, ones, ones, __bits_load_v(a, b, v + 14, op), __bits_load_v(a, b, v + 15, op));
+        __BITS_CSA(fours_b, twos, twos, twos_a, twos_b);
+        __BITS_CSA(eights_b, fours, fours, fours_a, fours_b);
+        __BITS_CSA(sixteen, eights, eights, eights_a, eights_b);
+
+        total += __bits_swar_v(sixteen);
+    }
+
+    total = 16 * total + 8 * __bits_swar_v(eights) + 4 * __bits_swar_v(fours) + 2 * __bits_swar_v(twos)
+          + __bits_swar_v(ones);
+
+    const size_t done = blocks * __BITS_HS_VEC_BLOCK;
+
+    return total + __bits_popcnt(a + done, b + done, bytes - done, op);
+}
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef BITS_H
+#define BITS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Nomenclature used (to avoid collisions): bits_<method_name>
+//
+// The single-word helpers are `static inline` so they compile down to one or two instructions at the call site
+// (`lzcnt`/`tzcnt`/`popcnt`/`pdep`/`pext` when the target has them, e.g. `make release`). The bulk popcounts live in
+// bits.c and pick the widest kernel the running CPU supports.
+
+/******************************************************************************
+ *                                                                            *
+ *                                Single Word                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Counts the leading zero bits.
+/// @param x The word.
+/// @return The count, `64` when `x` is `0`.
+static inline unsigned bits_clz(uint64_t x) {
+    return x ? (unsigned)__builtin_clzll(x) : 64u;
+}
+
+/// @brief Counts the trailing zero bits.
+/// @param x The word.
+/// @return The count, `64` when `x` is `0`.
+static inline unsigned bits_ctz(uint64_t x) {
+    return x ? (unsigned)__builtin_ctzll(x) : 64u;
+}
+
+/// @brief Counts the set bits.
+/// @param x The word.
+/// @return The count.
+static inline unsigned bits_popcount(uint64_t x) {
+    return (unsigned)__builtin_popcountll(x);
+}
+
+/// @brief Checks whether `x` is a power of two.
+/// @param x The word.
+/// @return `true` if exactly one bit is set.
+static inline bool bits_is_pow2(uint64_t x) {
+    return x && !(x & (x - 1));
+}
+
+/// @brief Position of the highest set bit, i.e. `floor(log2(x))`.
+/// @param x The word.
+/// @return The position, `0` when `x` is `0` or `1`.
+static inline unsigned bits_log2(uint64_t x) {
+    return 63u - (unsigned)__builtin_clzll(x | 1);
+}
+
+/// @brief Smallest `k` with `2^k >= x`, i.e. `ceil(log2(x))`.
+/// @param x The word.
+/// @return The exponent, `0` when `x` is `0` or `1`.
+static inline unsigned bits_log2_ceil(uint64_t x) {
+    return 64u - bits_clz(x - (x != 0));
+}
+
+/// @brief Rounds up to the next power of two, without branches.
+/// @param x The word.
+/// @return The smallest power of two `>= x` (`1` for `0`), or `0` if it does not fit in 64 bits (`x > 2^63`).
+static inline uint64_t bits_npo2(uint64_t x) {
+    const unsigned shift = bits_log2_ceil(x);
+
+    return shift < 64 ? (uint64_t)1 << shift : 0;
+}
+
+/// @brief Parallel bit deposit: scatters the low bits of `x` to the set positions of `mask`, lowest first.
+/// @details `pdep` with BMI2, otherwise a loop over the bits of `mask`.
+/// @param x The source bits.
+/// @param mask The target positions.
+/// @return The deposited word.
+static inline uint64_t bits_pdep(uint64_t x, uint64_t mask) {
+#ifdef __BMI2__
+    return __builtin_ia32_pdep_di(x, mask);
+#else
+    uint64_t result = 0;
+
+    for (uint64_t bit = 1; mask; bit <<= 1) {
+        if (x & bit) result |= mask & -mask;
+        mask &= mask - 1;
+    }
+
+    return result;
+#endif
+}
+
+/// @brief Parallel bit extract: gathers the bits of `x` at the set positions of `mask` into the low bits.
+/// @details `pext` with BMI2, otherwise a loop over the bits of `mask`.
+/// @param x The source bits.
+/// @param mask The positions to extract.
+/// @return The extracted bits, packed.
+static inline uint64_t bits_pext(uint64_t x, uint64_t mask) {
+#ifdef __BMI2__
+    return __builtin_ia32_pext_di(x, mask);
+#else
+    uint64_t result = 0;
+
+    for (uint64_t bit = 1; mask; bit <<= 1) {
+        if (x & mask & -mask) result |= bit;
+        mask &= mask - 1;
+    }
+
+    return result;
+#endif
+}
+
+/// @brief Position of the `k`-th set bit (select), counting from `0` at the lowest.
+/// @details A single `pdep` + `tzcnt` with BMI2.
+/// @param x The word.
+/// @param k Rank of the wanted bit.
+/// @return The position, or `64` if `x` has at most `k` set bits.
+static inline unsigned bits_select(uint64_t x, unsigned k) {
+    if (k >= 64) return 64;
+
+    return bits_ctz(bits_pdep((uint64_t)1 << k, x));
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Bulk Popcount                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/**
+ * @brief Bulk popcount implementations, from slowest to fastest.
+ */
+typedef enum BitsKernel {
+    BITS_KERNEL_AUTO,      ///< Fastest one the CPU supports (default).
+    BITS_KERNEL_PORTABLE,  ///< Harley-Seal carry-save adder over 64-bit words with a SWAR popcount.
+    BITS_KERNEL_POPCNT,    ///< Unrolled hardware `popcnt` (x86-64).
+    BITS_KERNEL_AVX2,      ///< Harley-Seal over 256-bit vectors (x86-64 with AVX2).
+} BitsKernel;
+
+/// @brief Selects the bulk popcount kernel (for testing and benchmarks); `BITS_KERNEL_AUTO` restores the default.
+/// @param kernel The kernel to use.
+/// @return `true` on success, `false` if the CPU or the build does not support it (the selection is unchanged).
+bool bits_use_kernel(BitsKernel kernel);
+
+/// @brief Returns the bulk popcount kernel in use (never `BITS_KERNEL_AUTO`).
+/// @return The kernel.
+BitsKernel bits_kernel(void);
+
+/// @brief Counts the set bits of a buffer.
+/// @param data The buffer (any alignment).
+/// @param bytes Its size in bytes.
+/// @return The number of set bits.
+uint64_t bits_popcount_buf(const void* data, size_t bytes);
+
+/// @brief Counts the set bits of `a & b` (intersection cardinality of two bitmaps) without materializing it.
+/// @param a The first buffer.
+/// @param b The second buffer.
+/// @param bytes Size of each buffer in bytes.
+/// @return The number of set bits.
+uint64_t bits_popcount_and(const void* a, const void* b, size_t bytes);
+
+/// @brief Counts the set bits of `a ^ b` (Hamming distance of two bitmaps) without materializing it.
+/// @param a The first buffer.
+/// @param b The second buffer.
+/// @param bytes Size of each buffer in bytes.
+/// @return The number of set bits.
+uint64_t bits_popcount_xor(const void* a, const void* b, size_t bytes);
+
+#endif  // BITS_H
@@ -3,10 +3,21 @@
 #include <signal.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "bits.h"
+#include "random.h"
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+// Offset of the small buffer `da_new_with_inline` places right after the structure (rounded up to `max_align_t`).
+#define __DA_INLINE_OFFSET ((sizeof(DArray) + _Alignof(max_align_t) - 1) / _Alignof(max_align_t) * _Alignof(max_align_t))
+
 /******************************************************************************
  *                                                                            *
  *                              Inner Functions                               *
@@ -56,10 +67,28 @@ inline static void __da_set_raw(DArray* da, size_t idx, const void* e);
 inline static bool __da_upsize(DArray* da);
 
 /// @brief Checks if reallocation is necessary and performs a downsizing (shrink).
-/// @details If `da->length` is less than `da->capacity * da->shrink_factor`, it calls `da_shrink` to resize the array to fit the current length.
+/// @details If `da->length` is less than `da->capacity * da->shrink_factor`, or the elements fit in half of the small buffer, it calls `da_shrink` to resize the array to fit the current length.
 /// @param da Pointer to the dynamic array.
 inline static void __da_downsize(DArray* da);
 
+/// @brief Checks whether the elements currently live in the array's inline buffer.
+/// @param da Pointer to the dynamic array.
+/// @return `true` if `da->arr` is the small buffer.
+inline static bool __da_is_inline(const DArray* da);
+
+/// @brief Computes the heap bytes owned by the array's structure (including a trailing inline buffer), as requested from `malloc`.
+/// @param da Pointer to the dynamic array.
+/// @return 0 for caller-owned (`da_init_inline`) arrays.
+inline static size_t __da_struct_bytes(const DArray* da);
+
+/// @brief Counts an embedded array retired by `da_deinit` / `da_get_raw` as a live container again once it is reused.
+/// @param da Pointer to the dynamic array.
+inline static void __da_revive(DArray* da);
+
+/// @brief Computes the heap bytes of the element storage (0 while it is inline).
+/// @param da Pointer to the dynamic array.
+inline static size_t __da_heap_bytes(const DArray* da);
+
 /// @brief Shifts a block of elements within the array using `memmove`.
 /// @details Used for insertion (`dest_idx > src_idx`) or removal (`dest_idx < src_idx`).
 /// @param da Pointer to the dynamic array.
@@ -67,22 +96,98 @@ inline static void __da_downsize(DArray* da);
 /// @param src_idx The starting index of the source. The number of elements shifted is from `src_idx` to `da->length - 1`.
 inline static void __da_shift(DArray* da, size_t dest_idx, size_t src_idx);
 
-/// @brief Swaps two elements in a raw array using a temporary buffer.
-/// @param arr Pointer to the raw array memory.
-/// @param t Pointer to a temporary buffer of size `element_size`.
-/// @param element_size Size of a single element.
-/// @param i Index of the first element.
-/// @param j Index of the second element.
-inline static void __da_swap(void* arr, char* t, size_t element_size, size_t i, size_t j);
+/// @brief Swaps two non-overlapping blocks of `n` bytes.
+/// @details Works through fixed-size chunks so the compiler can lower every chunk to a few wide loads and stores; no heap allocation is performed.
+/// @param a Pointer to the first block.
+/// @param b Pointer to the second block.
+/// @param n Number of bytes to swap.
+inline static void __da_swap_bytes(void* a, void* b, size_t n);
 
 /// @brief Reverses the order of elements within a specified range in a raw array.
-/// @details Implements a standard in-place reversal algorithm using a temporary buffer for swapping. The `end` index is exclusive in the parameter list but is adjusted internally to be inclusive for the last element.
+/// @details Allocation-free. Elements of 1, 2 and 4 bytes are reversed a whole vector (SSSE3 byte-shuffle) or word (SWAR) at a time; 8 and 16 byte elements use fixed-size swaps; any other size falls back to `__da_swap_bytes`. Both `start` and `end` are inclusive.
 /// @param arr Pointer to the raw array memory.
 /// @param element_size Size of a single element.
 /// @param start The starting index of the range (inclusive).
-/// @param end The ending index of the range (exclusive).
+/// @param end The ending index of the range (inclusive).
 static void __da_reverse(void* arr, size_t element_size, size_t start, size_t end);
 
+/// @brief Rotates the byte range `[A | B]` into `[B | A]` in-place.
+/// @details Gries-Mills block swaps: the smaller block is swapped into its final place and the remaining sub-problem shrinks, until one side fits in a small stack buffer, at which point the rotation finishes with a single `memmove`. Every byte is moved a constant number of times and no heap allocation is performed.
+/// @param arr Pointer to the start of block `A`.
+/// @param left Size of block `A` in bytes.
+/// @param right Size of block `B` in bytes.
+static void __da_rotate(void* arr, size_t left, size_t right);
+
+/// @brief Open-addressed scratch table used by the deduplication and grouping methods.
+/// @details `slots` holds `group + 1` (0 marks an empty slot). Every group caches its hash and the index of its representative element, so the table needs a single allocation for the whole call and none per element.
+typedef struct {
+    size_t* slots;     /// Open-addressed slots, linear probing, power of two in length.
+    uint64_t* hashes;  /// Cached hash of every group.
+    size_t* reps;      /// Index of the representative element of every group.
+    size_t mask;       /// `len(slots) - 1`.
+    size_t groups;     /// Number of groups discovered so far.
+    uint64_t seed_0;   /// First seed passed to the hasher.
+    uint64_t seed_1;   /// Second seed passed to the hasher.
+} DAScratch;
+
+/// @brief Allocates a scratch table able to hold up to `n` groups.
+/// @param t Pointer to the scratch table to initialize.
+/// @param n Maximum number of groups (usually the array's length).
+/// @return `true` on success, `false` on allocation failure.
+static bool __da_scratch_init(DAScratch* t, size_t n);
+
+/// @brief Frees the storage of a scratch table.
+/// @param t Pointer to the scratch table.
+inline static void __da_scratch_free(DAScratch* t);
+
+/// @brief Looks up the group of `e`, creating a new group represented by `rep` if none matches.
+/// @param t Pointer to the scratch table.
+/// @param da Array holding the representatives (`reps` index into it).
+/// @param e Pointer to the element to classify.
+/// @param rep Index (in `da`) the element will be found at if it starts a new group.
+/// @param cmp Pointer to the comparator function.
+/// @param hasher Pointer to the hashing function.
+/// @param inserted Output: set to `true` if a new group was created.
+/// @return The group id of the element.
+inline static size_t __da_scratch_probe(
+    DAScratch* t,
+    const DArray* da,
+    const void* e,
+    size_t rep,
+    int (*cmp)(const void* a, const void* b),
+    uint64_t (*hasher)(const void* k, uint64_t seed_0, uint64_t seed_1),
+    bool* inserted  //
+);
+
+/// @brief Copier for `size_t` elements, used by the offset and count arrays.
+inline static void __da_size_copier(void* dest, const void* src);
+
+/// @brief Printer for `size_t` elements, used by the offset and count arrays.
+inline static void __da_size_printer(FILE* file, const void* k);
+
+/// @brief Tournament (loser) tree over `k` sorted inputs.
+/// @details Leaf `s` sits at virtual position `s + k`; internal node `t` (`1 <= t < k`) stores the loser of the match played there and `tree[0]` stores the overall winner. An exhausted input has a `NULL` head and loses every match; ties are broken by input index, which keeps merges stable.
+typedef struct {
+    const void** heads;                         /// Current head of every input, `NULL` once exhausted.
+    size_t* tree;                               /// `tree[0]` is the winner, `tree[1..k)` the losers.
+    size_t k;                                   /// Number of inputs.
+    int (*cmp)(const void* a, const void* b);  /// Element comparator.
+} DALoserTree;
+
+/// @brief Checks whether input `a` wins a match against input `b`.
+/// @details The index `k` is a virtual input that beats everyone; it is only used while building the tree.
+inline static bool __da_lt_beats(const DALoserTree* lt, size_t a, size_t b);
+
+/// @brief Replays the matches from leaf `s` up to the root after its head changed.
+static void __da_lt_adjust(DALoserTree* lt, size_t s);
+
+/// @brief Plays the initial tournament over the current heads.
+static void __da_lt_build(DALoserTree* lt);
+
+/// @brief Finds the best input other than the winner (the best loser on the winner's path).
+/// @return Index of the runner-up, or `k` if there is only one input.
+inline static size_t __da_lt_runner_up(const DALoserTree* lt);
+
 /******************************************************************************
  *                                                                            *
  *                               Intialization                                *
@@ -103,6 +208,11 @@ DArray* da_new_with_capacity(const size_t element_size, const size_t capacity) {
         return NULL;
     }
 
+    da->_inline_buf = NULL;
+    da->_inline_capacity = 0;
+    da->_embedded = false;
+    da->_registered = true;
+
     da->length = 0;
     da->capacity = capacity;
     da->element_size = element_size;
@@ -114,9 +224,54 @@ DArray* da_new_with_capacity(const size_t element_size, const size_t capacity) {
     da->deallocator = __da_default_deallocator;
     da->printer = __da_default_printer;
 
+    ms_track(MS_DARRAY, 1, (int64_t)(sizeof(DArray) + capacity * element_size));
+
+    return da;
+}
+
+DArray* da_new_with_inline(const size_t element_size, const size_t inline_capacity) {
+    if (element_size == 0) return NULL;
+
+    DArray* da = malloc(__DA_INLINE_OFFSET + inline_capacity * element_size);
+    if (!da) return NULL;
+
+    da_init_inline(da, element_size, (char*)da + __DA_INLINE_OFFSET, inline_capacity * element_size);
+
+    da->_embedded = false;
+
+    // da_init_inline counted the container; add the allocation it lives in.
+    ms_track(MS_DARRAY, 0, (int64_t)__da_struct_bytes(da));
+
     return da;
 }
 
+bool da_init_inline(DArray* da, const size_t element_size, void* buffer, const size_t buffer_bytes) {
+    if (!da || element_size == 0) return false;
+
+    const size_t inline_capacity = buffer ? buffer_bytes / element_size : 0;
+
+    da->arr = inline_capacity ? buffer : NULL;
+    da->length = 0;
+    da->capacity = inline_capacity;
+    da->element_size = element_size;
+
+    da->growth_factor = 2.0;
+    da->shrink_factor = 0.2;
+
+    da->copier = __da_default_copier;
+    da->deallocator = __da_default_deallocator;
+    da->printer = __da_default_printer;
+
+    da->_inline_buf = inline_capacity ? buffer : NULL;
+    da->_inline_capacity = inline_capacity;
+    da->_embedded = true;
+    da->_registered = true;
+
+    ms_track(MS_DARRAY, 1, 0);
+
+    return true;
+}
+
 DArray* da_new_from_array(const size_t element_size, const size_t length, const void* arr, void (*copier)(void* dest, const void* src)) {
     DArray* da = da_new_with_capacity(element_size, length);
     if (!da) return NULL;
@@ -163,12 +318,33 @@ DArray* da_copy(const DArray* da) {
 }
 
 void da_free(DArray* da) {
+    if (!da) return;
+
+    if (da->_embedded) {
+        da_deinit(da);
+        return;
+    }
+
     if (!da_clear(da)) return;
 
-    free(da->arr);
+    ms_track(MS_DARRAY, -1, -(int64_t)(__da_struct_bytes(da) + __da_heap_bytes(da)));
+
+    if (!__da_is_inline(da)) free(da->arr);
     free(da);
 }
 
+void da_deinit(DArray* da) {
+    if (!da_clear(da)) return;
+
+    ms_track(MS_DARRAY, da->_registered ? -1 : 0, -(int64_t)__da_heap_bytes(da));
+    da->_registered = false;
+
+    if (!__da_is_inline(da)) free(da->arr);
+
+    da->arr = da->_inline_buf;
+    da->capacity = da->_inline_capacity;
+}
+
 bool da_clear(DArray* da) {
     if (!da) return false;
 
@@ -254,7 +430,25 @@ void* da_raw(DArray* da) {
 void* da_get_raw(DArray* da) {
     void* arr = da->arr;
 
-    free(da);
+    // Inline storage goes away with the structure: hand out a heap copy instead.
+    if (__da_is_inline(da)) {
+        arr = malloc(da->length ? da->length * da->element_size : 1);
+        if (!arr) return NULL;
+
+        memcpy(arr, da->arr, da->length * da->element_size);
+    }
+
+    // The storage now belongs to the caller.
+    ms_track(MS_DARRAY, da->_registered ? -1 : 0, -(int64_t)(__da_struct_bytes(da) + __da_heap_bytes(da)));
+    da->_registered = false;
+
+    if (da->_embedded) {
+        da->arr = da->_inline_buf;
+        da->length = 0;
+        da->capacity = da->_inline_capacity;
+    } else {
+        free(da);
+    }
 
     return arr;
 }
@@ -407,12 +601,7 @@ bool da_swap(DArray* da, size_t i, size_t j) {
 
     if (i == j) return true;
 
-    char* buffer = (char*)malloc(da->element_size);
-    if (!buffer) return false;
-
-    __da_swap(da->arr, buffer, da->element_size, i, j);
-
-    free(buffer);
+    __da_swap_bytes(da_index(da, i), da_index(da, j), da->element_size);
 
     return true;
 }
@@ -570,20 +759,46 @@ bool da_truncate(DArray* da, size_t new_length) {
 bool da_resize(DArray* da, size_t capacity) {
     if (!da) return false;
 
+    __da_revive(da);
+
     if (da->capacity == capacity) return true;
 
     if (da->length > capacity) {
         if (!da_truncate(da, capacity)) return false;
     }
 
-    void* new_arr = realloc(da->arr, da->element_size * capacity);
+    const size_t old_heap_bytes = __da_heap_bytes(da);
 
-    if (!new_arr && capacity > 0) {
-        return false;
+    if (da->_inline_buf && capacity <= da->_inline_capacity) {
+        // Fits in the small buffer: move back (or stay) there.
+        if (!__da_is_inline(da)) {
+            memcpy(da->_inline_buf, da->arr, da->length * da->element_size);
+            free(da->arr);
+            da->arr = da->_inline_buf;
+        }
+
+        da->capacity = da->_inline_capacity;
+    } else if (__da_is_inline(da)) {
+        // Spill from the small buffer to the heap.
+        void* new_arr = malloc(da->element_size * capacity);
+        if (!new_arr) return false;
+
+        memcpy(new_arr, da->arr, da->length * da->element_size);
+
+        da->arr = new_arr;
+        da->capacity = capacity;
+    } else {
+        void* new_arr = realloc(da->arr, da->element_size * capacity);
+
+        if (!new_arr && capacity > 0) {
+            return false;
+        }
+
+        da->arr = new_arr;
+        da->capacity = capacity;
     }
 
-    da->arr = new_arr;
-    da->capacity = capacity;
+    ms_track(MS_DARRAY, 0, (int64_t)__da_heap_bytes(da) - (int64_t)old_heap_bytes);
 
     return true;
 }
@@ -602,6 +817,41 @@ bool da_shrink(DArray* da) {
     return da_resize(da, da->length);
 }
 
+/******************************************************************************
+ *                                                                            *
+ *                             Memory Accounting                              *
+ *                                                                            *
+ ******************************************************************************/
+
+MemUsage da_memory_usage(const DArray* da, size_t (*owned_size)(const void* k)) {
+    MemUsage mu = {0, 0, 0, 0, 0};
+    if (!da) return mu;
+
+    const size_t storage = da->capacity * da->element_size;
+
+    mu.payload = da->length * da->element_size;
+    mu.slack = storage - mu.payload;
+    mu.metadata = sizeof(DArray);
+
+    // An unused small buffer (after spilling to the heap) is slack as well.
+    if (da->_inline_buf && !__da_is_inline(da)) mu.slack += da->_inline_capacity * da->element_size;
+
+    if (!da->_embedded) {
+        const size_t struct_bytes = __da_struct_bytes(da);
+        mu.overhead += ms_usable_size(da, struct_bytes) - struct_bytes;
+    }
+
+    if (!__da_is_inline(da)) mu.overhead += ms_usable_size(da->arr, storage) - storage;
+
+    if (owned_size) {
+        for (size_t i = 0; i < da->length; i++) {
+            mu.owned += owned_size(__da_index_raw(da, i));
+        }
+    }
+
+    return mu;
+}
+
 /******************************************************************************
  *                                                                            *
  *                               Concatanation                                *
@@ -694,6 +944,105 @@ DArray* da_merge_sorted(const DArray* a, const DArray* b, int (*cmp)(const void*
     return merged;
 }
 
+DArray* da_merge_k(const DArray* const* arrays, size_t k, int (*cmp)(const void* a, const void* b)) {
+    if (!arrays || k == 0 || !cmp) return NULL;
+
+    const DArray* first = NULL;
+    size_t length = 0;
+
+    for (size_t i = 0; i < k; i++) {
+        if (!arrays[i]) continue;
+        if (!first) first = arrays[i];
+        if (arrays[i]->element_size != first->element_size) return NULL;
+
+        length += arrays[i]->length;
+    }
+
+    if (!first) return NULL;
+
+    const size_t es = first->element_size;
+
+    DArray* merged = da_new_with_capacity(es, length);
+    if (!merged) return NULL;
+
+    merged->copier = first->copier;
+    merged->deallocator = first->deallocator;
+    merged->printer = first->printer;
+
+    // One block: [heads: k][tree: k][pos: k]
+    char* block = (char*)malloc(k * (sizeof(void*) + 2 * sizeof(size_t)));
+    if (!block) {
+        da_free(merged);
+        return NULL;
+    }
+
+    DALoserTree lt = {(const void**)block, (size_t*)(block + k * sizeof(void*)), k, cmp};
+    size_t* pos = lt.tree + k;
+
+    for (size_t i = 0; i < k; i++) {
+        pos[i] = 0;
+        lt.heads[i] = (arrays[i] && arrays[i]->length) ? arrays[i]->arr : NULL;
+    }
+
+    __da_lt_build(&lt);
+
+    char* dest = (char*)merged->arr;
+
+    while (lt.heads[lt.tree[0]]) {
+        const size_t w = lt.tree[0];
+        const DArray* src = arrays[w];
+        const char* base = (const char*)src->arr;
+        const size_t n = src->length;
+        const size_t l = __da_lt_runner_up(&lt);
+
+        // Find the end of the run of `w` that still beats the runner-up.
+        size_t end = n;
+
+        if (l != k && lt.heads[l]) {
+            const void* limit = lt.heads[l];
+            const int tie = w < l ? 0 : -1;  // on ties the lower input index wins
+
+            size_t lo = pos[w];  // known to beat `limit`
+            size_t step = 1;
+
+            while (lo + step < n && cmp(base + (lo + step) * es, limit) <= tie) {
+                lo += step;
+                step <<= 1;
+            }
+
+            size_t hi = lo + step < n ? lo + step : n;  // first index known (or assumed) to lose
+
+            while (hi - lo > 1) {
+                size_t mid = lo + (hi - lo) / 2;
+
+                if (cmp(base + mid * es, limit) <= tie) {
+                    lo = mid;
+                } else {
+                    hi = mid;
+                }
+            }
+
+            end = hi;
+        }
+
+        for (const char* e = base + pos[w] * es; e < base + end * es; e += es) {
+            merged->copier(dest, e);
+            dest += es;
+        }
+
+        pos[w] = end;
+        lt.heads[w] = end < n ? base + end * es : NULL;
+
+        __da_lt_adjust(&lt, w);
+    }
+
+    merged->length = length;
+
+    free(block);
+
+    return merged;
+}
+
 /******************************************************************************
  *                                                                            *
  *                        Sorting & Order Manipulation                        *
@@ -707,7 +1056,7 @@ void da_sort(DArray* da, int (*cmp)(const void* a, const void* b)) {
 }
 
 void da_reverse(DArray* da) {
-    if (!da) return;
+    if (!da || da->length < 2) return;
 
     size_t idx = da->length - 1;  // last index
     __da_reverse(da->arr, da->element_size, 0, idx);
@@ -722,11 +1071,8 @@ void da_rotate_left(DArray* da, size_t k) {
     k %= n;
     if (k == 0) return;
 
-    // Standard Three-Reversal Logic: (A B) -> (A^R B^R) -> (B A)
-
-    __da_reverse(da->arr, da->element_size, 0, k - 1);
-    __da_reverse(da->arr, da->element_size, k, n - 1);
-    __da_reverse(da->arr, da->element_size, 0, n - 1);
+    // Block swap: (A B) -> (B A), where |A| = k
+    __da_rotate(da->arr, k * da->element_size, (n - k) * da->element_size);
 }
 
 void da_rotate_right(DArray* da, size_t k) {
@@ -796,6 +1142,188 @@ void da_reduce(const DArray* da, void* acc, void (*reduce_fn)(void* acc, const v
     }
 }
 
+/******************************************************************************
+ *                                                                            *
+ *                          Deduplication & Grouping                          *
+ *                                                                            *
+ ******************************************************************************/
+
+size_t da_unique_sorted(DArray* da, int (*cmp)(const void* a, const void* b)) {
+    if (!da || !cmp) return (size_t)-1;
+    if (da->length < 2) return da->length;
+
+    size_t w = 1;  // write index, [0, w) is the deduplicated prefix
+
+    for (size_t i = 1; i < da->length; i++) {
+        void* curr = da_index(da, i);
+
+        if (cmp(__da_index_raw(da, w - 1), curr) == 0) {
+            da->deallocator(curr);
+            continue;
+        }
+
+        if (w != i) memcpy(da_index(da, w), curr, da->element_size);
+        w++;
+    }
+
+    da->length = w;
+
+    return w;
+}
+
+size_t da_dedup(DArray* da, int (*cmp)(const void* a, const void* b), uint64_t (*hasher)(const void* k, uint64_t seed_0, uint64_t seed_1)) {
+    if (!da || !cmp || !hasher) return (size_t)-1;
+    if (da->length < 2) return da->length;
+
+    DAScratch t;
+    if (!__da_scratch_init(&t, da->length)) return (size_t)-1;
+
+    size_t w = 0;
+
+    for (size_t i = 0; i < da->length; i++) {
+        void* curr = da_index(da, i);
+        bool inserted;
+
+        // Representatives live in the compacted prefix, so a new group is
+        // recorded at the position the element is about to be moved to.
+        __da_scratch_probe(&t, da, curr, w, cmp, hasher, &inserted);
+
+        if (!inserted) {
+            da->deallocator(curr);
+            continue;
+        }
+
+        if (w != i) memcpy(da_index(da, w), curr, da->element_size);
+        w++;
+    }
+
+    __da_scratch_free(&t);
+
+    da->length = w;
+
+    return w;
+}
+
+DArray* da_group_by(const DArray* da, int (*cmp)(const void* a, const void* b), uint64_t (*hasher)(const void* k, uint64_t seed_0, uint64_t seed_1), DArray** offsets) {
+    if (!da || !cmp || !hasher || !offsets) return NULL;
+
+    const size_t n = da->length;
+
+    DAScratch t;
+    if (!__da_scratch_init(&t, n)) return NULL;
+
+    size_t* ids = (size_t*)malloc((n ? n : 1) * sizeof(size_t));
+    if (!ids) {
+        __da_scratch_free(&t);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        bool inserted;
+        ids[i] = __da_scratch_probe(&t, da, __da_index_raw(da, i), i, cmp, hasher, &inserted);
+    }
+
+    const size_t groups = t.groups;
+
+    DArray* offs = da_new_with_capacity(sizeof(size_t), groups + 1);
+    DArray* grouped = da_new_with_capacity(da->element_size, n);
+    if (!offs || !grouped) {
+        da_free(offs);
+        da_free(grouped);
+        free(ids);
+        __da_scratch_free(&t);
+        return NULL;
+    }
+
+    offs->copier = __da_size_copier;
+    offs->printer = __da_size_printer;
+
+    grouped->copier = da->copier;
+    grouped->deallocator = da->deallocator;
+    grouped->printer = da->printer;
+
+    // Histogram of group sizes, then exclusive prefix sum into CSR offsets.
+    size_t* off = (size_t*)offs->arr;
+    memset(off, 0, (groups + 1) * sizeof(size_t));
+
+    for (size_t i = 0; i < n; i++) off[ids[i] + 1]++;
+    for (size_t g = 0; g < groups; g++) off[g + 1] += off[g];
+
+    offs->length = groups + 1;
+
+    // The representatives are no longer needed, reuse them as scatter cursors.
+    size_t* cursor = t.reps;
+    memcpy(cursor, off, groups * sizeof(size_t));
+
+    for (size_t i = 0; i < n; i++) {
+        void* dest = da_index(grouped, cursor[ids[i]]++);
+        da->copier(dest, __da_index_raw(da, i));
+    }
+
+    grouped->length = n;
+
+    free(ids);
+    __da_scratch_free(&t);
+
+    *offsets = offs;
+
+    return grouped;
+}
+
+DArray* da_count_by_key(const DArray* da, int (*cmp)(const void* a, const void* b), uint64_t (*hasher)(const void* k, uint64_t seed_0, uint64_t seed_1), DArray** counts) {
+    if (!da || !cmp || !hasher || !counts) return NULL;
+
+    const size_t n = da->length;
+
+    DAScratch t;
+    if (!__da_scratch_init(&t, n)) return NULL;
+
+    DArray* cnts = da_new_with_capacity(sizeof(size_t), n);
+    if (!cnts) {
+        __da_scratch_free(&t);
+        return NULL;
+    }
+
+    cnts->copier = __da_size_copier;
+    cnts->printer = __da_size_printer;
+
+    size_t* cnt = (size_t*)cnts->arr;
+
+    for (size_t i = 0; i < n; i++) {
+        bool inserted;
+        size_t g = __da_scratch_probe(&t, da, __da_index_raw(da, i), i, cmp, hasher, &inserted);
+
+        if (inserted) cnt[g] = 0;
+        cnt[g]++;
+    }
+
+    const size_t groups = t.groups;
+
+    DArray* keys = da_new_with_capacity(da->element_size, groups);
+    if (!keys) {
+        da_free(cnts);
+        __da_scratch_free(&t);
+        return NULL;
+    }
+
+    keys->copier = da->copier;
+    keys->deallocator = da->deallocator;
+    keys->printer = da->printer;
+
+    for (size_t g = 0; g < groups; g++) {
+        __da_set_raw(keys, g, __da_index_raw(da, t.reps[g]));
+    }
+
+    keys->length = groups;
+    cnts->length = groups;
+
+    __da_scratch_free(&t);
+
+    *counts = cnts;
+
+    return keys;
+}
+
 /******************************************************************************
  *                                                                            *
  *                           Dynamic Array Iterator                           *
@@ -839,6 +1367,107 @@ void dai_free(DAIterator* dai) {
     if (dai) free(dai);
 }
 
+/******************************************************************************
+ *                                                                            *
+ *                          Streaming K-Way Merging                           *
+ *                                                                            *
+ ******************************************************************************/
+
+struct DynamicArrayMergeIterator {
+    DALoserTree lt;          /// Tournament over the heads of the sources.
+    DAMergeSource* sources;  /// Copy of the sources array.
+    size_t limit;            /// Runner-up of the current winner (`k` if none).
+    bool started;            /// Whether `dami_next` has been called yet.
+    bool finished;           /// Whether every source is exhausted.
+};
+
+/// Pull function adapting a `DAIterator` to a `DAMergeSource`.
+static const void* __dai_pull(void* ctx) {
+    DAIterator* dai = (DAIterator*)ctx;
+
+    return dai_next(dai) ? dai_get(dai) : NULL;
+}
+
+DAMergeSource dai_merge_source(DAIterator* dai) {
+    DAMergeSource source = {dai, __dai_pull};
+
+    return source;
+}
+
+DAMergeIterator* da_merge_iterator(const DAMergeSource* sources, size_t k, int (*cmp)(const void* a, const void* b)) {
+    if (!sources || k == 0 || !cmp) return NULL;
+
+    // One block: [iterator][sources: k][heads: k][tree: k]
+    const size_t size = sizeof(DAMergeIterator) + k * (sizeof(DAMergeSource) + sizeof(void*) + sizeof(size_t));
+
+    DAMergeIterator* dami = (DAMergeIterator*)malloc(size);
+    if (!dami) return NULL;
+
+    dami->sources = (DAMergeSource*)(dami + 1);
+    dami->lt.heads = (const void**)(dami->sources + k);
+    dami->lt.tree = (size_t*)(dami->lt.heads + k);
+    dami->lt.k = k;
+    dami->lt.cmp = cmp;
+
+    for (size_t i = 0; i < k; i++) {
+        dami->sources[i] = sources[i];
+        dami->lt.heads[i] = sources[i].pull(sources[i].ctx);
+    }
+
+    __da_lt_build(&dami->lt);
+
+    dami->limit = __da_lt_runner_up(&dami->lt);
+    dami->started = false;
+    dami->finished = false;
+
+    return dami;
+}
+
+bool dami_next(DAMergeIterator* dami) {
+    if (!dami || dami->finished) return false;
+
+    DALoserTree* lt = &dami->lt;
+
+    if (dami->started) {
+        const size_t w = lt->tree[0];
+        DAMergeSource* src = &dami->sources[w];
+
+        lt->heads[w] = src->pull(src->ctx);
+
+        // While the winner keeps beating the runner-up, the other heads are
+        // unchanged and the tree is still valid: no replay needed.
+        if (!lt->heads[w] || (dami->limit != lt->k && !__da_lt_beats(lt, w, dami->limit))) {
+            __da_lt_adjust(lt, w);
+            dami->limit = __da_lt_runner_up(lt);
+        }
+    }
+
+    dami->started = true;
+
+    if (!lt->heads[lt->tree[0]]) {
+        dami->finished = true;
+        return false;
+    }
+
+    return true;
+}
+
+const void* dami_get(const DAMergeIterator* dami) {
+    if (!dami || !dami->started || dami->finished) return NULL;
+
+    return dami->lt.heads[dami->lt.tree[0]];
+}
+
+size_t dami_source(const DAMergeIterator* dami) {
+    if (!dami || !dami->started || dami->finished) return (size_t)-1;
+
+    return dami->lt.tree[0];
+}
+
+void dami_free(DAMergeIterator* dami) {
+    if (dami) free(dami);
+}
+
 /******************************************************************************
  *                                                                            *
  *                       Inner Functions Implementation                       *
@@ -871,6 +1500,8 @@ inline static void __da_set_raw(DArray* da, size_t idx, const void* e) {
 }
 
 inline static bool __da_upsize(DArray* da) {
+    __da_revive(da);
+
     if (da->length == da->capacity) {
         const size_t new_cap = da->capacity ? (size_t)((double)da->capacity * da->growth_factor) : 1;
         if (!da_reserve(da, new_cap)) return false;
@@ -879,9 +1510,36 @@ inline static bool __da_upsize(DArray* da) {
     return true;
 }
 
+inline static bool __da_is_inline(const DArray* da) {
+    return da->_inline_buf && da->arr == da->_inline_buf;
+}
+
+inline static size_t __da_struct_bytes(const DArray* da) {
+    if (da->_embedded) return 0;
+
+    // da_new_with_inline: the small buffer trails the structure in the same allocation.
+    if (da->_inline_buf == (const char*)da + __DA_INLINE_OFFSET) return __DA_INLINE_OFFSET + da->_inline_capacity * da->element_size;
+
+    return sizeof(DArray);
+}
+
+inline static void __da_revive(DArray* da) {
+    if (da->_registered) return;
+
+    ms_track(MS_DARRAY, 1, 0);
+    da->_registered = true;
+}
+
+inline static size_t __da_heap_bytes(const DArray* da) {
+    return __da_is_inline(da) ? 0 : da->capacity * da->element_size;
+}
+
 inline static void __da_downsize(DArray* da) {
     if (da->length < (size_t)((double)da->capacity * da->shrink_factor)) {
         da_shrink(da);
+    } else if (da->_inline_buf && da->length <= da->_inline_capacity / 2 && !__da_is_inline(da)) {
+        // Back into the small buffer once it is half empty, so push/pop at the boundary does not malloc/free each time.
+        da_shrink(da);
     }
 }
 
@@ -898,28 +1556,276 @@ inline static void __da_shift(DArray* da, size_t dest_idx, size_t src_idx) {
     memmove(dest, src, count * da->element_size);
 }
 
-inline static void __da_swap(void* arr, char* t, size_t element_size, size_t i, size_t j) {
-    void* a = (char*)arr + (element_size * i);
-    void* b = (char*)arr + (element_size * j);
+inline static void __da_swap_bytes(void* a, void* b, size_t n) {
+    unsigned char* pa = (unsigned char*)a;
+    unsigned char* pb = (unsigned char*)b;
+    unsigned char ta[64], tb[64];
+
+    while (n >= sizeof(ta)) {
+        memcpy(ta, pa, sizeof(ta));
+        memcpy(tb, pb, sizeof(tb));
+        memcpy(pa, tb, sizeof(tb));
+        memcpy(pb, ta, sizeof(ta));
 
-    // t = *a;
-    memcpy(t, a, element_size);
-    // *a = *b;
-    memcpy(a, b, element_size);
-    // *b = t;
-    memcpy(b, t, element_size);
+        pa += sizeof(ta);
+        pb += sizeof(tb);
+        n -= sizeof(ta);
+    }
+
+    if (n) {
+        memcpy(ta, pa, n);
+        memcpy(tb, pb, n);
+        memcpy(pa, tb, n);
+        memcpy(pb, ta, n);
+    }
+}
+
+/// Reverses the order of the `element_size`-wide lanes of a 64-bit word.
+inline static uint64_t __da_reverse_lanes(uint64_t x, size_t element_size) {
+    switch (element_size) {
+        case 1:
+            return __builtin_bswap64(x);
+        case 2:
+            x = __builtin_bswap64(x);
+            return ((x & 0x00FF00FF00FF00FFULL) << 8) | ((x >> 8) & 0x00FF00FF00FF00FFULL);
+        default:  // 4
+            return (x << 32) | (x >> 32);
+    }
 }
 
+/// Swaps the two fixed-size elements at `lo` and `hi`, walking towards the middle.
+#define __DA_REVERSE_FIXED(lo, hi, T)   \
+    while ((lo) < (hi)) {               \
+        T __x, __y;                     \
+        memcpy(&__x, (lo), sizeof(T));  \
+        memcpy(&__y, (hi), sizeof(T));  \
+        memcpy((lo), &__y, sizeof(T));  \
+        memcpy((hi), &__x, sizeof(T));  \
+        (lo) += sizeof(T);              \
+        (hi) -= sizeof(T);              \
+    }
+
 static void __da_reverse(void* arr, size_t element_size, size_t start, size_t end) {
     if (start >= end) return;
 
-    char* buffer = (char*)malloc(element_size);
-    if (!buffer) return;
+    unsigned char* lo = (unsigned char*)arr + element_size * start;
+    unsigned char* hi = (unsigned char*)arr + element_size * end;  // first byte of the last element
+
+    if (element_size == 1 || element_size == 2 || element_size == 4) {
+        // `top` is one past the last byte; blocks are taken from both ends
+        // and written back lane-reversed into the opposite end.
+        unsigned char* top = hi + element_size;
+
+#ifdef __SSSE3__
+        __m128i mask;
+        if (element_size == 1) {
+            mask = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+        } else if (element_size == 2) {
+            mask = _mm_setr_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+        } else {
+            mask = _mm_setr_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+        }
+
+        while (top - lo >= 32) {
+            __m128i a = _mm_loadu_si128((const __m128i*)lo);
+            __m128i b = _mm_loadu_si128((const __m128i*)(top - 16));
+            _mm_storeu_si128((__m128i*)lo, _mm_shuffle_epi8(b, mask));
+            _mm_storeu_si128((__m128i*)(top - 16), _mm_shuffle_epi8(a, mask));
+            lo += 16;
+            top -= 16;
+        }
+#endif
+
+        while (top - lo >= 16) {
+            uint64_t a, b;
+            memcpy(&a, lo, 8);
+            memcpy(&b, top - 8, 8);
+            a = __da_reverse_lanes(a, element_size);
+            b = __da_reverse_lanes(b, element_size);
+            memcpy(lo, &b, 8);
+            memcpy(top - 8, &a, 8);
+            lo += 8;
+            top -= 8;
+        }
+
+        hi = top - element_size;
+    }
+
+    switch (element_size) {
+        case 1:
+            __DA_REVERSE_FIXED(lo, hi, uint8_t);
+            break;
+        case 2:
+            __DA_REVERSE_FIXED(lo, hi, uint16_t);
+            break;
+        case 4:
+            __DA_REVERSE_FIXED(lo, hi, uint32_t);
+            break;
+        case 8:
+            __DA_REVERSE_FIXED(lo, hi, uint64_t);
+            break;
+        case 16: {
+            typedef struct {
+                uint64_t w[2];
+            } u128;
+            __DA_REVERSE_FIXED(lo, hi, u128);
+            break;
+        }
+        default:
+            while (lo < hi) {
+                __da_swap_bytes(lo, hi, element_size);
+                lo += element_size;
+                hi -= element_size;
+            }
+    }
+}
+
+#undef __DA_REVERSE_FIXED
+
+static void __da_rotate(void* arr, size_t left, size_t right) {
+    unsigned char* p = (unsigned char*)arr;
+    unsigned char buffer[512];
+
+    while (left && right) {
+        // Auxiliary rotation: one side fits on the stack, so a single memmove
+        // of the other side finishes the job.
+        if (left <= sizeof(buffer)) {
+            memcpy(buffer, p, left);
+            memmove(p, p + left, right);
+            memcpy(p + right, buffer, left);
+            return;
+        }
+
+        if (right <= sizeof(buffer)) {
+            memcpy(buffer, p + left, right);
+            memmove(p + right, p, left);
+            memcpy(p, buffer, right);
+            return;
+        }
+
+        if (left <= right) {
+            // [A | B1 B2] -> [B2 B1 | A], with |B2| = |A|; A is now final.
+            __da_swap_bytes(p, p + right, left);
+            right -= left;
+        } else {
+            // [A1 A2 | B] -> [B | A2 A1], with |A1| = |B|; B is now final.
+            __da_swap_bytes(p, p + left, right);
+            p += right;
+            left -= right;
+        }
+    }
+}
+
+static bool __da_scratch_init(DAScratch* t, size_t n) {
+    const size_t cap = n < 4 ? 8 : bits_npo2(2 * n);  // keep the load factor at or below 0.5
+
+    if (n == 0) n = 1;
+
+    // One block: [slots: cap][reps: n][hashes: n]
+    char* block = (char*)malloc(cap * sizeof(size_t) + n * sizeof(size_t) + n * sizeof(uint64_t));
+    if (!block) return false;
+
+    t->slots = (size_t*)block;
+    t->reps = t->slots + cap;
+    t->hashes = (uint64_t*)(t->reps + n);
+    t->mask = cap - 1;
+    t->groups = 0;
+    t->seed_0 = __random_u64();
+    t->seed_1 = __random_u64();
+
+    memset(t->slots, 0, cap * sizeof(size_t));
+
+    return true;
+}
+
+inline static void __da_scratch_free(DAScratch* t) {
+    free(t->slots);
+}
+
+inline static size_t __da_scratch_probe(
+    DAScratch* t,
+    const DArray* da,
+    const void* e,
+    size_t rep,
+    int (*cmp)(const void* a, const void* b),
+    uint64_t (*hasher)(const void* k, uint64_t seed_0, uint64_t seed_1),
+    bool* inserted  //
+) {
+    const uint64_t hash = hasher(e, t->seed_0, t->seed_1);
+    size_t i = (size_t)hash & t->mask;
+
+    while (t->slots[i]) {
+        const size_t g = t->slots[i] - 1;
+
+        if (t->hashes[g] == hash && cmp(__da_index_raw(da, t->reps[g]), e) == 0) {
+            *inserted = false;
+            return g;
+        }
+
+        i = (i + 1) & t->mask;
+    }
+
+    const size_t g = t->groups++;
+
+    t->slots[i] = g + 1;
+    t->hashes[g] = hash;
+    t->reps[g] = rep;
+
+    *inserted = true;
+
+    return g;
+}
+
+inline static void __da_size_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(size_t));
+}
+
+inline static void __da_size_printer(FILE* file, const void* k) {
+    fprintf(file, "%zu", *(const size_t*)k);
+}
+
+inline static bool __da_lt_beats(const DALoserTree* lt, size_t a, size_t b) {
+    if (a == lt->k) return true;
+    if (b == lt->k) return false;
+
+    const void* ha = lt->heads[a];
+    const void* hb = lt->heads[b];
+
+    if (!ha) return !hb && a < b;
+    if (!hb) return true;
+
+    const int c = lt->cmp(ha, hb);
+
+    return c < 0 || (c == 0 && a < b);
+}
+
+static void __da_lt_adjust(DALoserTree* lt, size_t s) {
+    for (size_t t = (s + lt->k) / 2; t > 0; t /= 2) {
+        if (__da_lt_beats(lt, lt->tree[t], s)) {
+            size_t loser = s;
+            s = lt->tree[t];
+            lt->tree[t] = loser;
+        }
+    }
+
+    lt->tree[0] = s;
+}
+
+static void __da_lt_build(DALoserTree* lt) {
+    // Every match starts against the virtual input `k`, which beats everyone and
+    // is pushed out of the tree as the real inputs are played in.
+    for (size_t t = 0; t < lt->k; t++) lt->tree[t] = lt->k;
+
+    for (size_t s = lt->k; s-- > 0;) __da_lt_adjust(lt, s);
+}
+
+inline static size_t __da_lt_runner_up(const DALoserTree* lt) {
+    const size_t k = lt->k;
+    size_t best = k;
 
-    // Use the inclusive 'end' index directly
-    while (start < end) {
-        __da_swap(arr, buffer, element_size, start++, end--);
+    for (size_t t = (lt->tree[0] + k) / 2; t > 0; t /= 2) {
+        if (best == k || __da_lt_beats(lt, lt->tree[t], best)) best = lt->tree[t];
     }
 
-    free(buffer);
+    return best;
 }
@@ -3,8 +3,11 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 
+#include "memstat.h"
+
 // Nomenclature used (to avoid collisions): <data_type>_<method_name>
 // Warning: This implementation is not thread-safe, and is for educational purposes only.
 
@@ -54,6 +57,11 @@ struct DynamicArray {
      * @param k Pointer to the element to be printed.
      */
     void (*printer)(FILE* file, const void* k);
+
+    void* _inline_buf;        /// Small-buffer storage, used while `capacity <= _inline_capacity` (`NULL` if none).
+    size_t _inline_capacity;  /// The number of elements `_inline_buf` can hold.
+    bool _embedded;           /// `true` if the `DArray` itself is caller-owned (see `da_init_inline`).
+    bool _registered;         /// `true` while the array counts as a live container in the memory registry.
 };
 
 /******************************************************************************
@@ -87,6 +95,22 @@ DArray* da_new_from_array(const size_t element_size, const size_t length, const
 /// @return Pointer to the newly constructed copy of `DArray`, or `NULL` on failure.
 DArray* da_copy(const DArray* da);
 
+/// @brief Allocates a dynamic array whose first `inline_capacity` elements live in the same allocation as the structure.
+/// @details Small arrays cost a single `malloc` and no pointer chase to a separate block. The storage moves to the heap only when the array grows past `inline_capacity`, and moves back when it shrinks enough to fit again.
+/// @param element_size Size of the elements to be stored. Must be greater than 0.
+/// @param inline_capacity Number of elements stored inline.
+/// @return Pointer to the newly constructed `DArray`, or `NULL` on allocation failure.
+DArray* da_new_with_inline(const size_t element_size, const size_t inline_capacity);
+
+/// @brief Initializes a caller-owned `DArray` (e.g., a struct member or a local) on top of a caller-provided buffer.
+/// @details Holds up to `buffer_bytes / element_size` elements in `buffer` without any allocation, and spills to the heap only on growth. The array must be released with `da_deinit` (or `da_free`, which then behaves like `da_deinit`), and `buffer` must outlive it and be suitably aligned for the elements.
+/// @param da Pointer to the structure to initialize.
+/// @param element_size Size of the elements to be stored. Must be greater than 0.
+/// @param buffer Inline storage (may be `NULL` if `buffer_bytes` is 0).
+/// @param buffer_bytes Size of `buffer` in bytes.
+/// @return `true` on success, `false` if `da` is `NULL` or `element_size` is 0.
+bool da_init_inline(DArray* da, const size_t element_size, void* buffer, const size_t buffer_bytes);
+
 /******************************************************************************
  *                                                                            *
  *                             Clean Up & Freeing                             *
@@ -98,6 +122,11 @@ DArray* da_copy(const DArray* da);
 /// @param da Pointer to the Dynamic Array to free.
 void da_free(DArray* da);
 
+/// @brief Releases the contents of a `DArray` initialized with `da_init_inline`, without freeing the structure itself.
+/// @details Deallocates the elements, frees any heap storage the array spilled to, and leaves it empty on its inline buffer, ready for reuse. The array stops counting as a live container until it is used again.
+/// @param da Pointer to the dynamic array.
+void da_deinit(DArray* da);
+
 /// @brief Clears the array by setting its length to zero and deallocating its elements.
 /// @details This operation uses the array's `deallocator` for each element. The array's capacity remains unchanged.
 /// @param da Pointer to the dynamic array.
@@ -262,7 +291,7 @@ bool da_set(DArray* da, size_t idx, const void* e);
 /// @param da Pointer to the dynamic array.
 /// @param i First index. Must be $0 \le i < \text{length}$.
 /// @param j Second index. Must be $0 \le j < \text{length}$.
-/// @return `true` on success, `false` on error (e.g., out of bounds or memory allocation failure for temporary buffer).
+/// @return `true` on success, `false` on error (e.g., out of bounds).
 bool da_swap(DArray* da, size_t i, size_t j);
 
 /******************************************************************************
@@ -352,6 +381,19 @@ bool da_reserve(DArray* da, size_t capacity);
 /// @return `true` on success, `false` on reallocation failure.
 bool da_shrink(DArray* da);
 
+/******************************************************************************
+ *                                                                            *
+ *                             Memory Accounting                              *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Reports how much memory the dynamic array uses, broken down by category.
+/// @details `payload` is `length * element_size`, `slack` the unused capacity, `metadata` the `DArray` header and `overhead` what the allocator reserved beyond the requested sizes (measured with `malloc_usable_size` on glibc). Every live array is also counted in the process registry (see `ms_registry_get(MS_DARRAY)`).
+/// @param da Pointer to the dynamic array.
+/// @param owned_size Optional callback returning the heap bytes owned by one element (e.g., fields allocated by `copier`); summed into `owned`. May be `NULL`.
+/// @return The breakdown, zeroed if `da` is `NULL`.
+MemUsage da_memory_usage(const DArray* da, size_t (*owned_size)(const void* k));
+
 /******************************************************************************
  *                                                                            *
  *                               Concatanation                                *
@@ -373,6 +415,14 @@ DArray* da_concat(const DArray* a, const DArray* b);
 /// @return Pointer to the newly merged sorted array, or `NULL` on error (e.g., mismatching element sizes, `cmp` is `NULL`, or allocation failure).
 DArray* da_merge_sorted(const DArray* a, const DArray* b, int (*cmp)(const void* a, const void* b));
 
+/// @brief Merges `k` **sorted** dynamic arrays into a new sorted dynamic array.
+/// @details Uses a tournament (loser) tree, so every output element costs $O(\log k)$ comparisons at most. When one input keeps winning, the end of its run is found by galloping against the runner-up and the whole run is copied in one tight loop without replaying the tree. The merge is stable: equal elements keep the order of their inputs. `NULL` entries in `arrays` are skipped. Elements are copied using the first non-`NULL` array's `copier`.
+/// @param arrays Array of `k` pointers to sorted dynamic arrays, all with the same `element_size`.
+/// @param k Number of arrays.
+/// @param cmp Pointer to the comparator function used for merging.
+/// @return Pointer to the newly merged sorted array, or `NULL` on error (e.g., no arrays, mismatching element sizes, `cmp` is `NULL`, or allocation failure).
+DArray* da_merge_k(const DArray* const* arrays, size_t k, int (*cmp)(const void* a, const void* b));
+
 /******************************************************************************
  *                                                                            *
  *                        Sorting & Order Manipulation                        *
@@ -386,10 +436,12 @@ DArray* da_merge_sorted(const DArray* a, const DArray* b, int (*cmp)(const void*
 void da_sort(DArray* da, int (*cmp)(const void* a, const void* b));
 
 /// @brief Reverses the order of elements in the dynamic array in-place.
+/// @details Allocation-free; 1, 2 and 4 byte elements are reversed a vector/word at a time.
 /// @param da Pointer to the dynamic array.
 void da_reverse(DArray* da);
 
 /// @brief Rotates the elements of the dynamic array `k` steps to the left (counter-clockwise) in-place.
+/// @details Allocation-free block-swap (Gries-Mills) rotation; every element is moved a constant number of times.
 /// @param da Pointer to the dynamic array.
 /// @param k The number of steps to rotate. Rotation is performed modulo $\text{length}$.
 void da_rotate_left(DArray* da, size_t k);
@@ -427,6 +479,45 @@ DArray* da_filter(const DArray* da, bool (*filter_fn)(const void* elem));
 /// @param reduce_fn Pointer to the reduction function: `reduce_fn(acc, elem)`.
 void da_reduce(const DArray* da, void* acc, void (*reduce_fn)(void* acc, const void* elem));
 
+/******************************************************************************
+ *                                                                            *
+ *                          Deduplication & Grouping                          *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Removes consecutive duplicates from a **sorted** dynamic array in-place.
+/// @details Keeps the first element of every run of equal elements; the rest are deallocated using `da->deallocator`. Runs in a single linear pass without allocating. **The caller is responsible for ensuring the array is sorted** (or at least that equal elements are adjacent).
+/// @param da Pointer to the dynamic array.
+/// @param cmp Pointer to the comparator function: returns 0 if elements are equal.
+/// @return The new length of the array, or `(size_t)-1` on error.
+size_t da_unique_sorted(DArray* da, int (*cmp)(const void* a, const void* b));
+
+/// @brief Removes all duplicates from the dynamic array in-place, keeping the first occurrence of each element.
+/// @details The relative order of the kept elements is preserved; removed elements are deallocated using `da->deallocator`. Uses a single internal open-addressed scratch table (one allocation for the whole call, none per element).
+/// @param da Pointer to the dynamic array.
+/// @param cmp Pointer to the comparator function: returns 0 if elements are equal.
+/// @param hasher Pointer to the hashing function (same signature as the `HSet` hasher). Must hash equal elements to equal values.
+/// @return The new length of the array, or `(size_t)-1` on error (e.g., allocation failure of the scratch table).
+size_t da_dedup(DArray* da, int (*cmp)(const void* a, const void* b), uint64_t (*hasher)(const void* k, uint64_t seed_0, uint64_t seed_1));
+
+/// @brief Groups the elements of the dynamic array by key into a new, permuted array (CSR layout).
+/// @details Two elements belong to the same group if `cmp` returns 0 for them (so `cmp` and `hasher` usually look at a key field only). Groups appear in order of their first occurrence and elements keep their relative order within a group. Group `g` occupies indices $[\text{offsets}[g], \text{offsets}[g + 1])$ of the returned array. Elements are copied using the source array's `copier`.
+/// @param da Pointer to the source dynamic array.
+/// @param cmp Pointer to the key comparator function: returns 0 if keys are equal.
+/// @param hasher Pointer to the key hashing function.
+/// @param offsets Output: a new `DArray` of `size_t` with $\text{groups} + 1$ entries. **The caller is responsible for freeing it.**
+/// @return Pointer to the newly grouped array, or `NULL` on error (in which case `*offsets` is left untouched).
+DArray* da_group_by(const DArray* da, int (*cmp)(const void* a, const void* b), uint64_t (*hasher)(const void* k, uint64_t seed_0, uint64_t seed_1), DArray** offsets);
+
+/// @brief Counts the number of elements for every distinct key.
+/// @details Keys appear in order of their first occurrence. The returned array holds a copy (via `copier`) of the first element of every group, and `counts[g]` is the size of group `g`.
+/// @param da Pointer to the source dynamic array.
+/// @param cmp Pointer to the key comparator function: returns 0 if keys are equal.
+/// @param hasher Pointer to the key hashing function.
+/// @param counts Output: a new `DArray` of `size_t` with one entry per distinct key. **The caller is responsible for freeing it.**
+/// @return Pointer to the newly created array of distinct keys, or `NULL` on error (in which case `*counts` is left untouched).
+DArray* da_count_by_key(const DArray* da, int (*cmp)(const void* a, const void* b), uint64_t (*hasher)(const void* k, uint64_t seed_0, uint64_t seed_1), DArray** counts);
+
 /**
  * @brief Dynamic Array Iterator Structure (Generic implementation)
  *
@@ -464,4 +555,67 @@ void* dai_get(DAIterator* dai);
 /// @param dai Pointer to the DAIterator to free.
 void dai_free(DAIterator* dai);
 
+/******************************************************************************
+ *                                                                            *
+ *                          Streaming K-Way Merging                           *
+ *                                                                            *
+ ******************************************************************************/
+
+/**
+ * @brief Pull-based source of sorted elements for the streaming merge.
+ *
+ * `pull` returns a pointer to the next element, or `NULL` once the source is
+ * exhausted. The returned pointer must stay valid until the next `pull` on the
+ * same source, which lets sources stream from files or generators instead of
+ * having all their elements in memory.
+ */
+typedef struct DynamicArrayMergeSource DAMergeSource;
+
+struct DynamicArrayMergeSource {
+    void* ctx;                        /// Opaque state passed to `pull`.
+    const void* (*pull)(void* ctx);  /// Returns the next element, or `NULL` when exhausted.
+};
+
+/**
+ * @brief Streaming K-Way Merge Iterator (opaque).
+ *
+ * Merges `k` sorted `DAMergeSource`s with a loser tree. As long as the current
+ * winner keeps beating the runner-up, elements are served with a single
+ * comparison and no tree replay.
+ */
+typedef struct DynamicArrayMergeIterator DAMergeIterator;
+
+/// @brief Wraps a dynamic array iterator as a merge source.
+/// @param dai Pointer to the iterator; must outlive the merge.
+/// @return The merge source pulling from `dai`.
+DAMergeSource dai_merge_source(DAIterator* dai);
+
+/// @brief Creates a streaming merge over `k` sorted sources.
+/// @details The first element of every source is pulled immediately. The `sources` array is copied.
+/// @param sources Array of `k` merge sources.
+/// @param k Number of sources (at least 1).
+/// @param cmp Pointer to the comparator function.
+/// @return Pointer to the newly allocated merge iterator, or `NULL` on error.
+DAMergeIterator* da_merge_iterator(const DAMergeSource* sources, size_t k, int (*cmp)(const void* a, const void* b));
+
+/// @brief Advances the merge iterator to the next smallest element.
+/// @param dami Pointer to the merge iterator.
+/// @return `true` if there is a next element, `false` once every source is exhausted.
+bool dami_next(DAMergeIterator* dami);
+
+/// @brief Retrieves the current (smallest) element of the merge.
+/// @details The pointer is owned by its source and is only valid until the next `dami_next`.
+/// @param dami Pointer to the merge iterator.
+/// @return Pointer to the current element, or `NULL` if the iterator is not yet advanced or has finished.
+const void* dami_get(const DAMergeIterator* dami);
+
+/// @brief Returns the index of the source the current element was pulled from.
+/// @param dami Pointer to the merge iterator.
+/// @return Index of the source, or `(size_t)-1` if there is no current element.
+size_t dami_source(const DAMergeIterator* dami);
+
+/// @brief Frees the merge iterator. The sources themselves are not touched.
+/// @param dami Pointer to the merge iterator.
+void dami_free(DAMergeIterator* dami);
+
 #endif  // DYNAMICARRAY_H
\ No newline at end of file
@@ -0,0 +1,1018 @@
+#define _GNU_SOURCE
+
+#include "darray_io.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                              Inner Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+/// Preferred size of every merge buffer; smaller buffers are only used when the budget forces it.
+#define DA_IO_MERGE_BUFFER (64 * 1024)
+
+/// @brief A sorted run spilled to an anonymous temporary file.
+typedef struct {
+    int fd;       /// Descriptor of the (already unlinked) temporary file.
+    size_t size;  /// Size of the run in bytes.
+} DARun;
+
+typedef struct DArrayPrefetcher DAPrefetcher;
+
+/// @brief Double-buffered reader over a single run.
+/// @details The merge consumes the `front` buffer while the other one is being refilled. `filled` and `ready` of the back buffer are only touched under the prefetcher lock.
+typedef struct {
+    int fd;                    /// Descriptor of the run.
+    size_t offset;             /// File offset of the next byte to be read into a buffer.
+    size_t size;               /// Size of the run in bytes.
+    size_t capacity;           /// Size of each buffer in bytes (multiple of `element_size`).
+    size_t element_size;       /// Size of a single element.
+    char* buffers[2];          /// The two buffers.
+    size_t filled[2];          /// Number of valid bytes in each buffer.
+    bool ready[2];             /// Whether each buffer holds data that was not consumed yet.
+    int front;                 /// Index of the buffer being consumed.
+    size_t pos;                /// Byte offset of the next element in the front buffer.
+    bool failed;               /// Set on a read error.
+    DAPrefetcher* prefetcher;  /// Background reader, shared by every run of a merge.
+} DARunReader;
+
+/// @brief Pending refill request.
+typedef struct {
+    DARunReader* reader;  /// Reader owning the buffer.
+    int buffer;           /// Index of the buffer to refill.
+} DAPrefetchRequest;
+
+/// @brief Background reader thread refilling run buffers with `pread`.
+/// @details Every run has at most one outstanding request, so a ring of `k` entries never overflows.
+struct DArrayPrefetcher {
+    pthread_t thread;          /// The reader thread.
+    bool running;              /// Whether the thread was started; if not, refills are synchronous.
+    bool stop;                 /// Asks the thread to exit once the queue is drained.
+    pthread_mutex_t lock;      /// Protects the queue and the `ready`/`filled` flags.
+    pthread_cond_t work;       /// Signalled when a request is queued (or on stop).
+    pthread_cond_t done;       /// Signalled when a buffer has been refilled.
+    DAPrefetchRequest* queue;  /// Ring buffer of pending requests.
+    size_t head;               /// Index of the oldest request.
+    size_t count;              /// Number of pending requests.
+    size_t capacity;           /// Length of `queue`.
+};
+
+/// @brief Reads up to `n` bytes, retrying on short reads and `EINTR`.
+/// @return Number of bytes read (less than `n` only at end of file), or `(size_t)-1` on error.
+static size_t __da_read_full(int fd, void* buf, size_t n);
+
+/// @brief `pread`s up to `n` bytes at `offset`, retrying on short reads and `EINTR`.
+/// @return Number of bytes read (less than `n` only at end of file), or `(size_t)-1` on error.
+static size_t __da_pread_full(int fd, void* buf, size_t n, size_t offset);
+
+/// @brief Writes exactly `n` bytes, retrying on short writes and `EINTR`.
+/// @return `true` on success, `false` on error.
+static bool __da_write_full(int fd, const void* buf, size_t n);
+
+/// @brief `pwrite`s exactly `n` bytes at `offset`, retrying on short writes and `EINTR`.
+/// @return `true` on success, `false` on error.
+static bool __da_pwrite_full(int fd, const void* buf, size_t n, size_t offset);
+
+/// @brief Creates an anonymous temporary file in the directory of `near_path`.
+/// @details The file is unlinked right away, so it disappears once its descriptor is closed.
+/// @return The descriptor, or `-1` on error.
+static int __da_temp_fd(const char* near_path);
+
+/// @brief Copier for `DARun` descriptors.
+inline static void __da_run_copier(void* dest, const void* src);
+
+/// @brief Fills buffer `b` of `r` with the next chunk of the run. Called without the lock held.
+static void __da_run_fill(DARunReader* r, int b);
+
+/// @brief Marks buffer `b` of `r` as consumed and schedules its refill.
+static void __da_run_request(DARunReader* r, int b);
+
+/// @brief Waits until buffer `b` of `r` has been refilled.
+/// @return `true` if it holds at least one element.
+static bool __da_run_await(DARunReader* r, int b);
+
+/// @brief Merge-source pull function over a run reader.
+static const void* __da_run_pull(void* ctx);
+
+/// @brief Body of the prefetch thread.
+static void* __da_prefetch_main(void* arg);
+
+/// @brief Merges `n` runs into `out_fd`, using at most `(2n + 1) * buffer_bytes` bytes of buffers.
+/// @return `true` on success, `false` on error.
+static bool __da_merge_runs(const DARun* runs, size_t n, int out_fd, size_t element_size, int (*cmp)(const void* a, const void* b), size_t buffer_bytes);
+
+/// @brief Runs the merge proper once every reader and buffer is allocated.
+/// @details Starts the prefetch thread, streams the loser-tree merge into `out` (flushed to `out_fd` whenever full) and joins the thread.
+/// @return `true` on success, `false` on error.
+static bool __da_merge_readers(
+    DAPrefetcher* p,
+    DARunReader* readers,
+    const DAMergeSource* sources,
+    size_t n,
+    int out_fd,
+    char* out,
+    size_t element_size,
+    int (*cmp)(const void* a, const void* b),
+    size_t buffer_bytes  //
+);
+
+/// Block size used for alignment: the header occupies exactly one block and `O_DIRECT` transfers are multiples of it.
+#define DA_IO_ALIGN 4096
+
+/// Size of a single read/write system call on the save/load paths.
+#define DA_IO_CHUNK (8 * 1024 * 1024)
+
+/// Version of the on-disk format written by `da_save`.
+#define DA_IO_VERSION 1
+
+/// @brief On-disk header of a saved array (padded to `DA_IO_ALIGN` bytes on disk).
+typedef struct {
+    char magic[8];          /// `"DARRAY\0\0"`.
+    uint64_t version;       /// `DA_IO_VERSION`.
+    uint64_t element_size;  /// Size of a single element in bytes.
+    uint64_t length;        /// Number of elements in the payload.
+    uint64_t checksum;      /// `DAChecksum` of the payload.
+} DAFileHeader;
+
+/// @brief Streaming 64-bit checksum (four xxHash64-style lanes over 32-byte stripes).
+/// @details The result does not depend on how the payload is split across `update` calls.
+typedef struct {
+    uint64_t lanes[4];        /// Accumulators, one per 8-byte word of a stripe.
+    uint64_t total;           /// Number of bytes fed so far.
+    unsigned char tail[32];  /// Bytes of an incomplete stripe.
+    size_t tail_len;          /// Number of bytes in `tail`.
+} DAChecksum;
+
+struct DynamicArrayReader {
+    int fd;                /// Descriptor of the file.
+    bool direct;           /// Whether the file was opened with `O_DIRECT`.
+    bool failed;           /// Set on I/O error or checksum mismatch.
+    DAFileHeader header;   /// Header of the file.
+    size_t remaining;      /// Number of payload bytes not yet handed out.
+    size_t offset;         /// File offset of the next read.
+    DAChecksum checksum;   /// Running checksum of the payload handed out so far.
+    unsigned char* bounce; /// Aligned staging buffer (`O_DIRECT` only).
+    size_t bounce_len;     /// Number of valid bytes in `bounce`.
+    size_t bounce_pos;     /// Number of bytes of `bounce` already handed out.
+};
+
+/// @brief Resets a checksum.
+static void __da_checksum_init(DAChecksum* c);
+
+/// @brief Feeds `len` bytes to a checksum.
+static void __da_checksum_update(DAChecksum* c, const void* data, size_t len);
+
+/// @brief Finishes a checksum and returns its value. The state must not be updated afterwards.
+static uint64_t __da_checksum_final(DAChecksum* c);
+
+/// @brief Opens `path`, trying `O_DIRECT` first if requested.
+/// @param direct In: whether `O_DIRECT` is wanted. Out: whether it is in effect.
+/// @return The descriptor, or `-1` on error.
+static int __da_io_open(const char* path, int oflags, bool* direct);
+
+/// @brief Reads and validates the header block (aligned, so it also works with `O_DIRECT`).
+/// @return `true` if the header is valid and matches the file size.
+static bool __da_io_read_header(int fd, DAFileHeader* header);
+
+/// @brief Allocates `n` bytes aligned to `DA_IO_ALIGN`, rounded up to a multiple of it.
+/// @return Pointer to the memory, or `NULL` on failure.
+static void* __da_io_aligned_alloc(size_t n);
+
+/// @brief Rounds `n` up to a multiple of `DA_IO_ALIGN`.
+inline static size_t __da_io_round_up(size_t n);
+
+/******************************************************************************
+ *                                                                            *
+ *                               External Sort                                *
+ *                                                                            *
+ ******************************************************************************/
+
+bool da_external_sort(const char* input_path, const char* output_path, size_t element_size, int (*cmp)(const void* a, const void* b), size_t mem_budget) {
+    if (!input_path || !output_path || !cmp || element_size == 0) return false;
+
+    // Half of the budget holds the run being sorted; glibc's `qsort` may
+    // allocate a temporary of the same size for its merge sort.
+    const size_t run_elements = (mem_budget / 2) / element_size;
+    if (run_elements < 2) return false;
+
+    // Merge buffers: prefer DA_IO_MERGE_BUFFER, shrink down to one element if
+    // the budget is tight. (2 * fan_in + 1) buffers must fit in the budget.
+    size_t buffer_bytes = (DA_IO_MERGE_BUFFER + element_size - 1) / element_size * element_size;
+    if (mem_budget / buffer_bytes < 5) buffer_bytes = (mem_budget / 5) / element_size * element_size;
+    if (buffer_bytes < element_size) return false;
+
+    const size_t fan_in = (mem_budget / buffer_bytes - 1) / 2;
+
+    int in_fd = open(input_path, O_RDONLY);
+    if (in_fd < 0) return false;
+
+    struct stat st;
+    if (fstat(in_fd, &st) != 0 || (size_t)st.st_size % element_size != 0) {
+        close(in_fd);
+        return false;
+    }
+
+    posix_fadvise(in_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    const size_t input_size = (size_t)st.st_size;
+
+    int out_fd = open(output_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out_fd < 0) {
+        close(in_fd);
+        return false;
+    }
+
+    DArray* chunk = da_new_with_capacity(element_size, input_size / element_size < run_elements ? input_size / element_size + 1 : run_elements);
+    DArray* runs = da_new(sizeof(DARun));
+
+    bool ok = chunk && runs;
+
+    if (runs) runs->copier = __da_run_copier;
+
+    // Phase 1: run generation.
+    while (ok) {
+        size_t n = __da_read_full(in_fd, da_raw(chunk), chunk->capacity * element_size);
+
+        if (n == (size_t)-1 || n % element_size != 0) {
+            ok = false;
+            break;
+        }
+
+        if (n == 0) break;
+
+        chunk->length = n / element_size;
+        da_sort(chunk, cmp);
+
+        // The whole input fits in one run: write it straight to the output.
+        if (runs->length == 0 && n == input_size) {
+            ok = __da_write_full(out_fd, da_raw(chunk), n);
+            break;
+        }
+
+        DARun run = {__da_temp_fd(output_path), n};
+
+        if (run.fd < 0) {
+            ok = false;
+            break;
+        }
+
+        if (!__da_write_full(run.fd, da_raw(chunk), n) || !da_push(runs, &run)) {
+            close(run.fd);
+            ok = false;
+        }
+    }
+
+    close(in_fd);
+    da_free(chunk);
+
+    // Phase 2: merge passes until a single pass can finish into the output.
+    size_t first = 0;
+
+    while (ok && runs->length - first > fan_in) {
+        DARun merged = {__da_temp_fd(output_path), 0};
+
+        if (merged.fd < 0) {
+            ok = false;
+            break;
+        }
+
+        const DARun* group = (const DARun*)da_index(runs, first);
+
+        for (size_t i = 0; i < fan_in; i++) merged.size += group[i].size;
+
+        ok = __da_merge_runs(group, fan_in, merged.fd, element_size, cmp, buffer_bytes);
+
+        for (size_t i = 0; i < fan_in; i++) close(group[i].fd);
+        first += fan_in;
+
+        if (!ok || !da_push(runs, &merged)) {
+            close(merged.fd);
+            ok = false;
+        }
+    }
+
+    if (ok && runs->length > first) {
+        ok = __da_merge_runs((const DARun*)da_index(runs, first), runs->length - first, out_fd, element_size, cmp, buffer_bytes);
+    }
+
+    if (runs) {
+        for (size_t i = first; i < runs->length; i++) close(((DARun*)da_index(runs, i))->fd);
+        da_free(runs);
+    }
+
+    if (close(out_fd) != 0) ok = false;
+
+    return ok;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                              Saving & Loading                              *
+ *                                                                            *
+ ******************************************************************************/
+
+bool da_save(const DArray* da, const char* path, int flags) {
+    if (!da || !path) return false;
+
+    bool direct = flags & DA_IO_DIRECT;
+
+    int fd = __da_io_open(path, O_WRONLY | O_CREAT | O_TRUNC, &direct);
+    if (fd < 0) return false;
+
+    const size_t bytes = da->length * da->element_size;
+    const char* src = (const char*)da->arr;
+
+    DAChecksum checksum;
+    __da_checksum_init(&checksum);
+
+    // `O_DIRECT` needs aligned buffers and lengths: stage through an aligned
+    // buffer and trim the padding of the last block at the end.
+    unsigned char* staging = direct ? (unsigned char*)__da_io_aligned_alloc(DA_IO_CHUNK) : NULL;
+
+    bool ok = !direct || staging;
+
+    for (size_t done = 0; ok && done < bytes;) {
+        size_t n = bytes - done < DA_IO_CHUNK ? bytes - done : DA_IO_CHUNK;
+
+        __da_checksum_update(&checksum, src + done, n);
+
+        if (direct) {
+            size_t padded = __da_io_round_up(n);
+
+            memcpy(staging, src + done, n);
+            memset(staging + n, 0, padded - n);
+
+            ok = __da_pwrite_full(fd, staging, padded, DA_IO_ALIGN + done);
+        } else {
+            ok = __da_pwrite_full(fd, src + done, n, DA_IO_ALIGN + done);
+        }
+
+        done += n;
+    }
+
+    unsigned char* header_block = (unsigned char*)__da_io_aligned_alloc(DA_IO_ALIGN);
+
+    if (ok && header_block) {
+        DAFileHeader header = {{'D', 'A', 'R', 'R', 'A', 'Y', 0, 0}, DA_IO_VERSION, da->element_size, da->length, __da_checksum_final(&checksum)};
+
+        memset(header_block, 0, DA_IO_ALIGN);
+        memcpy(header_block, &header, sizeof(header));
+
+        ok = __da_pwrite_full(fd, header_block, DA_IO_ALIGN, 0);
+    } else {
+        ok = false;
+    }
+
+    if (ok && direct) ok = ftruncate(fd, (off_t)(DA_IO_ALIGN + bytes)) == 0;
+
+    free(header_block);
+    free(staging);
+
+    if (close(fd) != 0) ok = false;
+
+    return ok;
+}
+
+DArray* da_load(const char* path, int flags, void (*copier)(void* dest, const void* src)) {
+    if (!path) return NULL;
+
+    bool direct = flags & DA_IO_DIRECT;
+
+    int fd = __da_io_open(path, O_RDONLY, &direct);
+    if (fd < 0) return NULL;
+
+    DAFileHeader header;
+    if (!__da_io_read_header(fd, &header)) {
+        close(fd);
+        return NULL;
+    }
+
+    const size_t es = (size_t)header.element_size;
+    const size_t length = (size_t)header.length;
+    const size_t bytes = es * length;
+
+    // With O_DIRECT the storage must be block-aligned and cover whole blocks,
+    // so it is allocated here and handed over to the array.
+    DArray* da = da_new_with_capacity(es, direct ? 1 : length);
+    void* arr = direct ? __da_io_aligned_alloc(bytes) : NULL;
+
+    if (!da || (direct && !arr)) {
+        da_free(da);
+        free(arr);
+        close(fd);
+        return NULL;
+    }
+
+    if (direct) {
+        free(da->arr);
+        ms_track(MS_DARRAY, 0, ((int64_t)length - (int64_t)da->capacity) * (int64_t)es);
+
+        da->arr = arr;
+        da->capacity = length;
+    }
+
+    if (copier) da->copier = copier;
+
+    DAChecksum checksum;
+    __da_checksum_init(&checksum);
+
+    char* dest = (char*)da->arr;
+    bool ok = true;
+
+    for (size_t done = 0; ok && done < bytes;) {
+        size_t n = bytes - done < DA_IO_CHUNK ? bytes - done : DA_IO_CHUNK;
+        size_t want = direct ? __da_io_round_up(n) : n;
+
+        ok = __da_pread_full(fd, dest + done, want, DA_IO_ALIGN + done) >= n;
+
+        if (ok) __da_checksum_update(&checksum, dest + done, n);
+
+        done += n;
+    }
+
+    close(fd);
+
+    if (!ok || __da_checksum_final(&checksum) != header.checksum) {
+        da_free(da);
+        return NULL;
+    }
+
+    da->length = length;
+
+    return da;
+}
+
+DAReader* da_reader_open(const char* path, int flags) {
+    if (!path) return NULL;
+
+    DAReader* dar = (DAReader*)calloc(1, sizeof(DAReader));
+    if (!dar) return NULL;
+
+    dar->direct = flags & DA_IO_DIRECT;
+    dar->fd = __da_io_open(path, O_RDONLY, &dar->direct);
+
+    if (dar->fd < 0) {
+        free(dar);
+        return NULL;
+    }
+
+    if (!__da_io_read_header(dar->fd, &dar->header) || (dar->direct && !(dar->bounce = (unsigned char*)__da_io_aligned_alloc(DA_IO_CHUNK)))) {
+        close(dar->fd);
+        free(dar);
+        return NULL;
+    }
+
+    dar->remaining = (size_t)(dar->header.element_size * dar->header.length);
+    dar->offset = DA_IO_ALIGN;
+
+    __da_checksum_init(&dar->checksum);
+
+    return dar;
+}
+
+size_t dar_element_size(const DAReader* dar) {
+    return (size_t)dar->header.element_size;
+}
+
+size_t dar_length(const DAReader* dar) {
+    return (size_t)dar->header.length;
+}
+
+bool dar_next_chunk(DAReader* dar, DArray* chunk) {
+    if (!dar || !chunk || dar->failed) return false;
+    if (chunk->element_size != dar->header.element_size || chunk->capacity == 0) return false;
+
+    da_clear(chunk);
+
+    if (dar->remaining == 0) return false;
+
+    size_t n = chunk->capacity * chunk->element_size;
+    if (n > dar->remaining) n = dar->remaining;
+
+    char* dest = (char*)chunk->arr;
+
+    if (!dar->direct) {
+        // Straight into the caller's storage, no staging copy.
+        if (__da_pread_full(dar->fd, dest, n, dar->offset) != n) {
+            dar->failed = true;
+            return false;
+        }
+
+        dar->offset += n;
+    } else {
+        for (size_t done = 0; done < n;) {
+            if (dar->bounce_pos == dar->bounce_len) {
+                size_t got = __da_pread_full(dar->fd, dar->bounce, DA_IO_CHUNK, dar->offset);
+
+                if (got == (size_t)-1 || got == 0) {
+                    dar->failed = true;
+                    return false;
+                }
+
+                dar->offset += got;
+                dar->bounce_len = got;
+                dar->bounce_pos = 0;
+            }
+
+            size_t take = dar->bounce_len - dar->bounce_pos;
+            if (take > n - done) take = n - done;
+
+            memcpy(dest + done, dar->bounce + dar->bounce_pos, take);
+
+            dar->bounce_pos += take;
+            done += take;
+        }
+    }
+
+    __da_checksum_update(&dar->checksum, dest, n);
+
+    dar->remaining -= n;
+    chunk->length = n / chunk->element_size;
+
+    if (dar->remaining == 0 && __da_checksum_final(&dar->checksum) != dar->header.checksum) {
+        dar->failed = true;
+        chunk->length = 0;
+        return false;
+    }
+
+    return true;
+}
+
+bool dar_close(DAReader* dar) {
+    if (!dar) return false;
+
+    bool ok = !dar->failed && dar->remaining == 0;
+
+    close(dar->fd);
+    free(dar->bounce);
+    free(dar);
+
+    return ok;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                       Inner Functions Implementation                       *
+ *                                                                            *
+ ******************************************************************************/
+
+static size_t __da_read_full(int fd, void* buf, size_t n) {
+    size_t done = 0;
+
+    while (done < n) {
+        ssize_t r = read(fd, (char*)buf + done, n - done);
+
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            return (size_t)-1;
+        }
+
+        if (r == 0) break;
+
+        done += (size_t)r;
+    }
+
+    return done;
+}
+
+static size_t __da_pread_full(int fd, void* buf, size_t n, size_t offset) {
+    size_t done = 0;
+
+    while (done < n) {
+        ssize_t r = pread(fd, (char*)buf + done, n - done, (off_t)(offset + done));
+
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            return (size_t)-1;
+        }
+
+        if (r == 0) break;
+
+        done += (size_t)r;
+    }
+
+    return done;
+}
+
+static bool __da_write_full(int fd, const void* buf, size_t n) {
+    size_t done = 0;
+
+    while (done < n) {
+        ssize_t w = write(fd, (const char*)buf + done, n - done);
+
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        done += (size_t)w;
+    }
+
+    return true;
+}
+
+static bool __da_pwrite_full(int fd, const void* buf, size_t n, size_t offset) {
+    size_t done = 0;
+
+    while (done < n) {
+        ssize_t w = pwrite(fd, (const char*)buf + done, n - done, (off_t)(offset + done));
+
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        done += (size_t)w;
+    }
+
+    return true;
+}
+
+static int __da_temp_fd(const char* near_path) {
+    static const char suffix[] = ".run.XXXXXX";
+
+    const size_t len = strlen(near_path);
+
+    char* path = (char*)malloc(len + sizeof(suffix));
+    if (!path) return -1;
+
+    memcpy(path, near_path, len);
+    memcpy(path + len, suffix, sizeof(suffix));
+
+    int fd = mkstemp(path);
+    if (fd >= 0) unlink(path);
+
+    free(path);
+
+    return fd;
+}
+
+inline static void __da_run_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(DARun));
+}
+
+static void __da_run_fill(DARunReader* r, int b) {
+    size_t want = r->size - r->offset;
+    if (want > r->capacity) want = r->capacity;
+
+    size_t got = __da_pread_full(r->fd, r->buffers[b], want, r->offset);
+
+    if (got != want) {
+        r->failed = true;
+        got = 0;
+    }
+
+    r->offset += got;
+    r->filled[b] = got;
+}
+
+static void __da_run_request(DARunReader* r, int b) {
+    DAPrefetcher* p = r->prefetcher;
+
+    pthread_mutex_lock(&p->lock);
+
+    r->ready[b] = false;
+
+    if (r->offset >= r->size || !p->running) {
+        // Nothing left to read, or no reader thread: refill right away.
+        if (r->offset >= r->size) {
+            r->filled[b] = 0;
+        } else {
+            __da_run_fill(r, b);
+        }
+
+        r->ready[b] = true;
+    } else {
+        DAPrefetchRequest* slot = &p->queue[(p->head + p->count) % p->capacity];
+        slot->reader = r;
+        slot->buffer = b;
+        p->count++;
+
+        pthread_cond_signal(&p->work);
+    }
+
+    pthread_mutex_unlock(&p->lock);
+}
+
+static bool __da_run_await(DARunReader* r, int b) {
+    DAPrefetcher* p = r->prefetcher;
+
+    pthread_mutex_lock(&p->lock);
+
+    while (!r->ready[b]) pthread_cond_wait(&p->done, &p->lock);
+
+    bool has_data = r->filled[b] > 0;
+
+    pthread_mutex_unlock(&p->lock);
+
+    return has_data;
+}
+
+static const void* __da_run_pull(void* ctx) {
+    DARunReader* r = (DARunReader*)ctx;
+
+    if (r->pos >= r->filled[r->front]) {
+        const int back = 1 - r->front;
+
+        if (!__da_run_await(r, back)) return NULL;
+
+        // The previously returned element lived in the old front buffer; the
+        // merge source contract allows it to be overwritten now.
+        r->front = back;
+        r->pos = 0;
+
+        __da_run_request(r, 1 - back);
+    }
+
+    const void* e = r->buffers[r->front] + r->pos;
+    r->pos += r->element_size;
+
+    return e;
+}
+
+static void* __da_prefetch_main(void* arg) {
+    DAPrefetcher* p = (DAPrefetcher*)arg;
+
+    pthread_mutex_lock(&p->lock);
+
+    for (;;) {
+        while (p->count == 0 && !p->stop) pthread_cond_wait(&p->work, &p->lock);
+
+        if (p->count == 0) break;
+
+        DAPrefetchRequest req = p->queue[p->head];
+        p->head = (p->head + 1) % p->capacity;
+        p->count--;
+
+        pthread_mutex_unlock(&p->lock);
+        __da_run_fill(req.reader, req.buffer);
+        pthread_mutex_lock(&p->lock);
+
+        req.reader->ready[req.buffer] = true;
+        pthread_cond_broadcast(&p->done);
+    }
+
+    pthread_mutex_unlock(&p->lock);
+
+    return NULL;
+}
+
+static bool __da_merge_runs(const DARun* runs, size_t n, int out_fd, size_t element_size, int (*cmp)(const void* a, const void* b), size_t buffer_bytes) {
+    DAPrefetcher p = {0};
+
+    DARunReader* readers = (DARunReader*)calloc(n, sizeof(DARunReader));
+    DAMergeSource* sources = (DAMergeSource*)malloc(n * sizeof(DAMergeSource));
+    char* out = (char*)malloc(buffer_bytes);
+
+    p.queue = (DAPrefetchRequest*)malloc(n * sizeof(DAPrefetchRequest));
+    p.capacity = n;
+
+    bool ok = readers && sources && out && p.queue;
+
+    for (size_t i = 0; ok && i < n; i++) {
+        DARunReader* r = &readers[i];
+
+        r->fd = runs[i].fd;
+        r->size = runs[i].size;
+        r->capacity = buffer_bytes;
+        r->element_size = element_size;
+        r->prefetcher = &p;
+        r->buffers[0] = (char*)malloc(buffer_bytes);
+        r->buffers[1] = (char*)malloc(buffer_bytes);
+
+        if (!r->buffers[0] || !r->buffers[1]) ok = false;
+
+        posix_fadvise(r->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+        sources[i].ctx = r;
+        sources[i].pull = __da_run_pull;
+    }
+
+    if (ok) ok = __da_merge_readers(&p, readers, sources, n, out_fd, out, element_size, cmp, buffer_bytes);
+
+    if (readers) {
+        for (size_t i = 0; i < n; i++) {
+            free(readers[i].buffers[0]);
+            free(readers[i].buffers[1]);
+        }
+    }
+
+    free(readers);
+    free(sources);
+    free(out);
+    free(p.queue);
+
+    return ok;
+}
+
+static bool __da_merge_readers(
+    DAPrefetcher* p,
+    DARunReader* readers,
+    const DAMergeSource* sources,
+    size_t n,
+    int out_fd,
+    char* out,
+    size_t element_size,
+    int (*cmp)(const void* a, const void* b),
+    size_t buffer_bytes  //
+) {
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->work, NULL);
+    pthread_cond_init(&p->done, NULL);
+
+    // Front buffers are filled synchronously, back buffers are prefetched.
+    for (size_t i = 0; i < n; i++) {
+        __da_run_fill(&readers[i], 0);
+        readers[i].ready[0] = true;
+    }
+
+    p->running = pthread_create(&p->thread, NULL, __da_prefetch_main, p) == 0;
+
+    for (size_t i = 0; i < n; i++) __da_run_request(&readers[i], 1);
+
+    DAMergeIterator* dami = da_merge_iterator(sources, n, cmp);
+    bool ok = dami != NULL;
+
+    size_t used = 0;
+
+    while (ok && dami_next(dami)) {
+        if (used == buffer_bytes) {
+            ok = __da_write_full(out_fd, out, used);
+            used = 0;
+        }
+
+        memcpy(out + used, dami_get(dami), element_size);
+        used += element_size;
+    }
+
+    if (ok && used) ok = __da_write_full(out_fd, out, used);
+
+    dami_free(dami);
+
+    if (p->running) {
+        pthread_mutex_lock(&p->lock);
+        p->stop = true;
+        pthread_cond_signal(&p->work);
+        pthread_mutex_unlock(&p->lock);
+
+        pthread_join(p->thread, NULL);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        if (readers[i].failed) ok = false;
+    }
+
+    pthread_cond_destroy(&p->done);
+    pthread_cond_destroy(&p->work);
+    pthread_mutex_destroy(&p->lock);
+
+    return ok;
+}
+
+#define DA_CHECKSUM_P1 0x9E3779B185EBCA87ULL
+#define DA_CHECKSUM_P2 0xC2B2AE3D27D4EB4FULL
+#define DA_CHECKSUM_P3 0x165667B19E3779F9ULL
+
+inline static uint64_t __da_checksum_round(uint64_t acc, uint64_t word) {
+    acc += word * DA_CHECKSUM_P2;
+    acc = (acc << 31) | (acc >> 33);
+
+    return acc * DA_CHECKSUM_P1;
+}
+
+inline static void __da_checksum_stripe(DAChecksum* c, const unsigned char* p) {
+    for (size_t i = 0; i < 4; i++) {
+        uint64_t word;
+        memcpy(&word, p + 8 * i, 8);
+        c->lanes[i] = __da_checksum_round(c->lanes[i], word);
+    }
+}
+
+static void __da_checksum_init(DAChecksum* c) {
+    c->lanes[0] = DA_CHECKSUM_P1 + DA_CHECKSUM_P2;
+    c->lanes[1] = DA_CHECKSUM_P2;
+    c->lanes[2] = 0;
+    c->lanes[3] = 0 - DA_CHECKSUM_P1;
+    c->total = 0;
+    c->tail_len = 0;
+}
+
+static void __da_checksum_update(DAChecksum* c, const void* data, size_t len) {
+    const unsigned char* p = (const unsigned char*)data;
+
+    c->total += len;
+
+    if (c->tail_len) {
+        size_t take = sizeof(c->tail) - c->tail_len;
+        if (take > len) take = len;
+
+        memcpy(c->tail + c->tail_len, p, take);
+        c->tail_len += take;
+        p += take;
+        len -= take;
+
+        if (c->tail_len < sizeof(c->tail)) return;
+
+        __da_checksum_stripe(c, c->tail);
+        c->tail_len = 0;
+    }
+
+    for (; len >= 32; p += 32, len -= 32) __da_checksum_stripe(c, p);
+
+    memcpy(c->tail, p, len);
+    c->tail_len = len;
+}
+
+static uint64_t __da_checksum_final(DAChecksum* c) {
+    uint64_t h = ((c->lanes[0] << 1) | (c->lanes[0] >> 63)) +
+                 ((c->lanes[1] << 7) | (c->lanes[1] >> 57)) +
+                 ((c->lanes[2] << 12) | (c->lanes[2] >> 52)) +
+                 ((c->lanes[3] << 18) | (c->lanes[3] >> 46));
+
+    // Zero-padded last stripe; the total length disambiguates the padding.
+    if (c->tail_len) {
+        memset(c->tail + c->tail_len, 0, sizeof(c->tail) - c->tail_len);
+
+        for (size_t i = 0; i < 4; i++) {
+            uint64_t word;
+            memcpy(&word, c->tail + 8 * i, 8);
+            h ^= __da_checksum_round(0, word);
+            h = h * DA_CHECKSUM_P1 + DA_CHECKSUM_P3;
+        }
+    }
+
+    h ^= c->total;
+
+    h ^= h >> 33;
+    h *= DA_CHECKSUM_P2;
+    h ^= h >> 29;
+    h *= DA_CHECKSUM_P3;
+    h ^= h >> 32;
+
+    return h;
+}
+
+static int __da_io_open(const char* path, int oflags, bool* direct) {
+    if (*direct) {
+        int fd = open(path, oflags | O_DIRECT, 0644);
+        if (fd >= 0) return fd;
+
+        *direct = false;  // e.g. EINVAL on tmpfs: fall back to buffered I/O
+    }
+
+    int fd = open(path, oflags, 0644);
+
+    if (fd >= 0 && !(oflags & (O_WRONLY | O_RDWR))) posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    return fd;
+}
+
+static bool __da_io_read_header(int fd, DAFileHeader* header) {
+    unsigned char* block = (unsigned char*)__da_io_aligned_alloc(DA_IO_ALIGN);
+    if (!block) return false;
+
+    bool ok = __da_pread_full(fd, block, DA_IO_ALIGN, 0) == DA_IO_ALIGN;
+
+    if (ok) memcpy(header, block, sizeof(*header));
+
+    free(block);
+
+    if (!ok) return false;
+
+    static const char magic[8] = {'D', 'A', 'R', 'R', 'A', 'Y', 0, 0};
+
+    if (memcmp(header->magic, magic, sizeof(magic)) != 0) return false;
+    if (header->version != DA_IO_VERSION || header->element_size == 0) return false;
+
+    // Reject lengths whose byte size would overflow.
+    if (header->length > SIZE_MAX / header->element_size) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) return false;
+
+    return (uint64_t)st.st_size == DA_IO_ALIGN + header->element_size * header->length;
+}
+
+static void* __da_io_aligned_alloc(size_t n) {
+    void* p = NULL;
+
+    if (posix_memalign(&p, DA_IO_ALIGN, n ? __da_io_round_up(n) : DA_IO_ALIGN) != 0) return NULL;
+
+    return p;
+}
+
+inline static size_t __da_io_round_up(size_t n) {
+    return (n + DA_IO_ALIGN - 1) / DA_IO_ALIGN * DA_IO_ALIGN;
+}
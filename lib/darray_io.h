@@ -0,0 +1,90 @@
+#ifndef DYNAMICARRAY_IO_H
+#define DYNAMICARRAY_IO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "darray.h"
+
+// Nomenclature used (to avoid collisions): <data_type>_<method_name>
+// Warning: This implementation is not thread-safe, and is for educational purposes only.
+
+/******************************************************************************
+ *                                                                            *
+ *                               External Sort                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Sorts a binary file of fixed-size elements that may be far larger than memory.
+/// @details The input is a raw sequence of `element_size`-byte elements (no header). Runs of up to half the budget are sorted in memory with `da_sort` (the other half is left to `qsort`'s own temporary buffer) and spilled with one large sequential write each to anonymous temporary files created next to `output_path`. The runs are then combined with the loser-tree merge (`da_merge_iterator`). Every run is double-buffered: while the merge consumes one buffer, a background reader thread refills the other with `pread` (falling back to synchronous `pread` if the thread cannot be started). If there are too many runs for the budget to give every run two reasonably sized buffers, intermediate merge passes reduce the run count first.
+/// @param input_path Path of the unsorted input file. Its size must be a multiple of `element_size`.
+/// @param output_path Path of the sorted output file (created or truncated). Must differ from `input_path`.
+/// @param element_size Size of a single element in bytes.
+/// @param cmp Pointer to the comparator function used for sorting.
+/// @param mem_budget Upper bound, in bytes, for the buffers used by the sort.
+/// @return `true` on success, `false` on error (e.g., I/O failure, malformed input, or a budget too small to hold a handful of elements).
+bool da_external_sort(const char* input_path, const char* output_path, size_t element_size, int (*cmp)(const void* a, const void* b), size_t mem_budget);
+
+/******************************************************************************
+ *                                                                            *
+ *                              Saving & Loading                              *
+ *                                                                            *
+ ******************************************************************************/
+
+/// Flag for `da_save`, `da_load` and `da_reader_open`: bypass the page cache with `O_DIRECT`.
+/// @details Falls back to buffered I/O if the file system refuses `O_DIRECT`.
+#define DA_IO_DIRECT 0x1
+
+/// @brief Writes the dynamic array to `path`.
+/// @details The file starts with a small header (magic, version, `element_size`, `length` and a 64-bit checksum of the payload), padded to one 4 KiB block so the payload stays block-aligned, followed by the raw elements. Elements are written as raw bytes in native byte order, so this is only meaningful for elements that do not own pointers. The payload is written straight from `da->arr` in large chunks; the checksum is computed on the way and the header is written last.
+/// @param da Pointer to the dynamic array.
+/// @param path Path of the file to create or truncate.
+/// @param flags `0` or `DA_IO_DIRECT`.
+/// @return `true` on success, `false` on error.
+bool da_save(const DArray* da, const char* path, int flags);
+
+/// @brief Loads a dynamic array written by `da_save`.
+/// @details The whole payload is read directly into the array's storage, with a single allocation sized from the header, and verified against the stored checksum.
+/// @param path Path of the file to read.
+/// @param flags `0` or `DA_IO_DIRECT`.
+/// @param copier Copier to install in the returned array (may be `NULL` to keep the default).
+/// @return Pointer to the newly loaded `DArray`, or `NULL` on error (e.g., I/O failure, bad header, or checksum mismatch).
+DArray* da_load(const char* path, int flags, void (*copier)(void* dest, const void* src));
+
+/**
+ * @brief Streaming reader over a file written by `da_save` (opaque).
+ *
+ * Fills a caller-provided, reusable `DArray` chunk by chunk so files larger
+ * than memory can be processed with a fixed amount of memory.
+ */
+typedef struct DynamicArrayReader DAReader;
+
+/// @brief Opens a file written by `da_save` for streaming.
+/// @param path Path of the file to read.
+/// @param flags `0` or `DA_IO_DIRECT`.
+/// @return Pointer to the newly allocated reader, or `NULL` on error (e.g., missing file or bad header).
+DAReader* da_reader_open(const char* path, int flags);
+
+/// @brief Gets the element size recorded in the file header.
+/// @param dar Pointer to the reader.
+/// @return The element size in bytes.
+size_t dar_element_size(const DAReader* dar);
+
+/// @brief Gets the number of elements recorded in the file header.
+/// @param dar Pointer to the reader.
+/// @return The number of elements in the file.
+size_t dar_length(const DAReader* dar);
+
+/// @brief Replaces the contents of `chunk` with the next elements of the file.
+/// @details `chunk` is cleared and then filled with up to `chunk->capacity` elements. Without `DA_IO_DIRECT` the data is read straight into `chunk->arr`. The checksum is verified once the last element has been read.
+/// @param dar Pointer to the reader.
+/// @param chunk Reusable dynamic array with the file's `element_size` and a non-zero capacity.
+/// @return `true` if at least one element was read, `false` at the end of the file or on error (see `dar_close`).
+bool dar_next_chunk(DAReader* dar, DArray* chunk);
+
+/// @brief Closes the reader and frees its memory.
+/// @param dar Pointer to the reader.
+/// @return `true` if the whole file was read without I/O errors and matched its checksum, `false` otherwise.
+bool dar_close(DAReader* dar);
+
+#endif  // DYNAMICARRAY_IO_H
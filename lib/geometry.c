@@ -0,0 +1,700 @@
+#include "geometry.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "radix_sort.h"
+
+/// Relative error bound of the rounded orientation determinant (Shewchuk's `ccwerrboundA`, with unit roundoff $2^{-53}$).
+#define __GEO_CCW_ERRBOUND ((3.0 + 8.0 * DBL_EPSILON) * (DBL_EPSILON / 2.0))
+
+/// Points classified per round of the hull pre-filter.
+#define __GEO_FILTER_BLOCK 1024
+
+/// Following strip points compared with each strip point (at most 7 can be closer than the current best).
+#define __GEO_STRIP_LANES 8
+
+/******************************************************************************
+ *                                                                            *
+ *                              Inner Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+typedef float __geo_v8f __attribute__((vector_size(32)));
+typedef double __geo_v4d __attribute__((vector_size(32)));
+typedef int32_t __geo_v8i __attribute__((vector_size(32)));
+typedef int64_t __geo_v4l __attribute__((vector_size(32)));
+
+/// A point being paired, carrying its source position.
+typedef struct GeoClosestRecord {
+    double x;
+    double y;
+    size_t id;
+} GeoCPRec;
+
+/// State of a closest pair search.
+typedef struct GeoClosestState {
+    GeoCPRec* recs;  ///< Sorted by `x`, each range re-sorted by `y` once solved.
+    GeoCPRec* aux;   ///< Merge buffer.
+    double* sx;      ///< Strip coordinates, padded with `__GEO_STRIP_LANES` infinities.
+    double* sy;
+    size_t* sid;
+    double best;
+    size_t a;
+    size_t b;
+} GeoCPState;
+
+// order-preserving maps between floating point values and unsigned integers
+inline static uint32_t __geo_key_f(float v);
+inline static float __geo_unkey_f(uint32_t k);
+inline static uint64_t __geo_key_d(double v);
+inline static double __geo_unkey_d(uint64_t k);
+// sorts a raw array of `Point2f` (`f32`) or `Point2d` by `(x, y)`
+static bool __geo_sort_raw(void* arr, size_t n, bool f32);
+inline static Point2d __geo_load(const void* arr, size_t i, bool f32);
+// exact orientation sign through expansion arithmetic
+static int __geo_orient_exact(double ax, double ay, double bx, double by, double cx, double cy);
+inline static void __geo_two_sum(double a, double b, double* s, double* err);
+inline static void __geo_two_diff(double a, double b, double* d, double* err);
+inline static void __geo_two_product(double a, double b, double* p, double* err);
+// copies the points not certainly inside the quadrilateral of the extreme points into `out`; returns their count
+static size_t __geo_hull_filter(const void* src, size_t n, bool f32, void* out);
+static void __geo_copier_f(void* dest, const void* src);
+static void __geo_copier_d(void* dest, const void* src);
+// solves $[lo, hi)$ of `recs` (sorted by `x`) and leaves it sorted by `y`
+static void __geo_closest(GeoCPState* s, size_t lo, size_t hi);
+inline static void __geo_closest_update(GeoCPState* s, double d2, size_t a, size_t b);
+
+/******************************************************************************
+ *                                                                            *
+ *                                  Sorting                                   *
+ *                                                                            *
+ ******************************************************************************/
+
+bool geo_sort(DArray* pts) {
+    if (!pts) return false;
+
+    if (pts->element_size == sizeof(Point2f)) return __geo_sort_raw(pts->arr, pts->length, true);
+    if (pts->element_size == sizeof(Point2d)) return __geo_sort_raw(pts->arr, pts->length, false);
+
+    return false;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Predicates                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+int geo_orient2d(const Point2d* a, const Point2d* b, const Point2d* c) {
+    const double detleft = (a->x - c->x) * (b->y - c->y);
+    const double detright = (a->y - c->y) * (b->x - c->x);
+    const double det = detleft - detright;
+
+    // With opposite (or zero) signs the subtraction cannot cancel, so the rounded sign is exact
+    double detsum;
+
+    if (detleft > 0.0) {
+        if (detright <= 0.0) return (det > 0.0) - (det < 0.0);
+        detsum = detleft + detright;
+    } else if (detleft < 0.0) {
+        if (detright >= 0.0) return (det > 0.0) - (det < 0.0);
+        detsum = -detleft - detright;
+    } else {
+        return (det > 0.0) - (det < 0.0);
+    }
+
+    const double errbound = __GEO_CCW_ERRBOUND * detsum;
+    if (det >= errbound || -det >= errbound) return (det > 0.0) - (det < 0.0);
+
+    return __geo_orient_exact(a->x, a->y, b->x, b->y, c->x, c->y);
+}
+
+int geo_orient2d_f(const Point2f* a, const Point2f* b, const Point2f* c) {
+    const Point2d ad = {a->x, a->y}, bd = {b->x, b->y}, cd = {c->x, c->y};
+
+    return geo_orient2d(&ad, &bd, &cd);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Batch Kernels                                *
+ *                                                                            *
+ ******************************************************************************/
+
+void geo_orient_batch_f(const Point2f* a, const Point2f* b, const Point2f* pts, size_t n, float* out) {
+    const float abx = b->x - a->x, aby = b->y - a->y;
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        // Two loads of 4 interleaved points, split into 8 x and 8 y lanes
+        __geo_v8f lo, hi;
+        memcpy(&lo, pts + i, sizeof(lo));
+        memcpy(&hi, pts + i + 4, sizeof(hi));
+
+        const __geo_v8f xs = __builtin_shuffle(lo, hi, (__geo_v8i){0, 2, 4, 6, 8, 10, 12, 14});
+        const __geo_v8f ys = __builtin_shuffle(lo, hi, (__geo_v8i){1, 3, 5, 7, 9, 11, 13, 15});
+
+        const __geo_v8f r = abx * (ys - a->y) - aby * (xs - a->x);
+        memcpy(out + i, &r, sizeof(r));
+    }
+
+    for (; i < n; i++) out[i] = abx * (pts[i].y - a->y) - aby * (pts[i].x - a->x);
+}
+
+void geo_orient_batch_d(const Point2d* a, const Point2d* b, const Point2d* pts, size_t n, double* out) {
+    const double abx = b->x - a->x, aby = b->y - a->y;
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __geo_v4d lo, hi;
+        memcpy(&lo, pts + i, sizeof(lo));
+        memcpy(&hi, pts + i + 2, sizeof(hi));
+
+        const __geo_v4d xs = __builtin_shuffle(lo, hi, (__geo_v4l){0, 2, 4, 6});
+        const __geo_v4d ys = __builtin_shuffle(lo, hi, (__geo_v4l){1, 3, 5, 7});
+
+        const __geo_v4d r = abx * (ys - a->y) - aby * (xs - a->x);
+        memcpy(out + i, &r, sizeof(r));
+    }
+
+    for (; i < n; i++) out[i] = abx * (pts[i].y - a->y) - aby * (pts[i].x - a->x);
+}
+
+void geo_dist2_batch_f(const Point2f* q, const Point2f* pts, size_t n, float* out) {
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __geo_v8f lo, hi;
+        memcpy(&lo, pts + i, sizeof(lo));
+        memcpy(&hi, pts + i + 4, sizeof(hi));
+
+        const __geo_v8f dx = __builtin_shuffle(lo, hi, (__geo_v8i){0, 2, 4, 6, 8, 10, 12, 14}) - q->x;
+        const __geo_v8f dy = __builtin_shuffle(lo, hi, (__geo_v8i){1, 3, 5, 7, 9, 11, 13, 15}) - q->y;
+
+        const __geo_v8f r = dx * dx + dy * dy;
+        memcpy(out + i, &r, sizeof(r));
+    }
+
+    for (; i < n; i++) {
+        const float dx = pts[i].x - q->x, dy = pts[i].y - q->y;
+        out[i] = dx * dx + dy * dy;
+    }
+}
+
+void geo_dist2_batch_d(const Point2d* q, const Point2d* pts, size_t n, double* out) {
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __geo_v4d lo, hi;
+        memcpy(&lo, pts + i, sizeof(lo));
+        memcpy(&hi, pts + i + 2, sizeof(hi));
+
+        const __geo_v4d dx = __builtin_shuffle(lo, hi, (__geo_v4l){0, 2, 4, 6}) - q->x;
+        const __geo_v4d dy = __builtin_shuffle(lo, hi, (__geo_v4l){1, 3, 5, 7}) - q->y;
+
+        const __geo_v4d r = dx * dx + dy * dy;
+        memcpy(out + i, &r, sizeof(r));
+    }
+
+    for (; i < n; i++) {
+        const double dx = pts[i].x - q->x, dy = pts[i].y - q->y;
+        out[i] = dx * dx + dy * dy;
+    }
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                Convex Hull                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+DArray* geo_convex_hull(const DArray* pts) {
+    if (!pts) return NULL;
+
+    const size_t es = pts->element_size;
+    const bool f32 = es == sizeof(Point2f);
+    if (!f32 && es != sizeof(Point2d)) return NULL;
+
+    const size_t n = pts->length;
+
+    char* buf = (char*)malloc((n ? n : 1) * es);
+    size_t* hull = (size_t*)malloc((2 * n + 1) * sizeof(size_t));
+
+    if (!buf || !hull) {
+        free(buf);
+        free(hull);
+        return NULL;
+    }
+
+    size_t m = __geo_hull_filter(pts->arr, n, f32, buf);
+
+    // Adding zero turns -0.0 into +0.0, so that equal coordinates sort as equal keys
+    for (size_t i = 0; i < m; i++) {
+        if (f32) {
+            Point2f* p = (Point2f*)buf + i;
+            p->x += 0.0f;
+            p->y += 0.0f;
+        } else {
+            Point2d* p = (Point2d*)buf + i;
+            p->x += 0.0;
+            p->y += 0.0;
+        }
+    }
+
+    if (!__geo_sort_raw(buf, m, f32)) {
+        free(buf);
+        free(hull);
+        return NULL;
+    }
+
+    // Drop repeated points, which are adjacent once sorted
+    size_t unique = 0;
+    for (size_t i = 0; i < m; i++) {
+        if (unique > 0 && memcmp(buf + (unique - 1) * es, buf + i * es, es) == 0) continue;
+        if (unique != i) memcpy(buf + unique * es, buf + i * es, es);
+        unique++;
+    }
+    m = unique;
+
+    // Monotone chain: lower hull left to right, then upper hull right to left, popping non-left turns
+    size_t k = 0;
+
+    if (m < 3) {
+        for (size_t i = 0; i < m; i++) hull[k++] = i;
+    } else {
+        for (size_t i = 0; i < m; i++) {
+            const Point2d p = __geo_load(buf, i, f32);
+
+            while (k >= 2) {
+                const Point2d a = __geo_load(buf, hull[k - 2], f32), b = __geo_load(buf, hull[k - 1], f32);
+                if (geo_orient2d(&a, &b, &p) > 0) break;
+                k--;
+            }
+
+            hull[k++] = i;
+        }
+
+        for (size_t i = m - 1, lower = k + 1; i-- > 0;) {
+            const Point2d p = __geo_load(buf, i, f32);
+
+            while (k >= lower) {
+                const Point2d a = __geo_load(buf, hull[k - 2], f32), b = __geo_load(buf, hull[k - 1], f32);
+                if (geo_orient2d(&a, &b, &p) > 0) break;
+                k--;
+            }
+
+            hull[k++] = i;
+        }
+
+        k--;  // the chain ends where it started
+    }
+
+    DArray* out = da_new_with_capacity(es, k ? k : 1);
+
+    if (out) {
+        out->copier = f32 ? __geo_copier_f : __geo_copier_d;
+        for (size_t i = 0; i < k; i++) da_push(out, buf + hull[i] * es);
+    }
+
+    free(buf);
+    free(hull);
+
+    return out;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                Closest Pair                                *
+ *                                                                            *
+ ******************************************************************************/
+
+bool geo_closest_pair(const DArray* pts, size_t* i, size_t* j, double* dist2) {
+    if (!pts || !i || !j || pts->length < 2) return false;
+
+    const bool f32 = pts->element_size == sizeof(Point2f);
+    if (!f32 && pts->element_size != sizeof(Point2d)) return false;
+
+    const size_t n = pts->length;
+
+    GeoCPState s;
+    s.recs = (GeoCPRec*)malloc(n * sizeof(GeoCPRec));
+    s.aux = (GeoCPRec*)malloc(n * sizeof(GeoCPRec));
+    s.sx = (double*)malloc((n + __GEO_STRIP_LANES) * sizeof(double));
+    s.sy = (double*)malloc((n + __GEO_STRIP_LANES) * sizeof(double));
+    s.sid = (size_t*)malloc(n * sizeof(size_t));
+    s.best = INFINITY;
+    s.a = 0;
+    s.b = 1;
+
+    bool ok = s.recs && s.aux && s.sx && s.sy && s.sid;
+
+    if (ok) {
+        // Sort by x: the key replaces `x` during the sort and is mapped back afterwards
+        for (size_t k = 0; k < n; k++) {
+            const Point2d p = __geo_load(pts->arr, k, f32);
+            const uint64_t key = __geo_key_d(p.x + 0.0);  // folds -0.0 into +0.0
+
+            memcpy(&s.recs[k].x, &key, sizeof(key));
+            s.recs[k].y = p.y;
+            s.recs[k].id = k;
+        }
+
+        ok = __radix_sort(s.recs, n, sizeof(GeoCPRec), 1, 0);
+
+        for (size_t k = 0; k < n; k++) {
+            uint64_t key;
+            memcpy(&key, &s.recs[k].x, sizeof(key));
+            s.recs[k].x = __geo_unkey_d(key);
+        }
+    }
+
+    if (ok) {
+        __geo_closest(&s, 0, n);
+
+        *i = s.a < s.b ? s.a : s.b;
+        *j = s.a < s.b ? s.b : s.a;
+        if (dist2) *dist2 = s.best;
+    }
+
+    free(s.recs);
+    free(s.aux);
+    free(s.sx);
+    free(s.sy);
+    free(s.sid);
+
+    return ok;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                       Inner Functions Implementation                       *
+ *                                                                            *
+ ******************************************************************************/
+
+inline static uint32_t __geo_key_f(float v) {
+    uint32_t u;
+    memcpy(&u, &v, sizeof(u));
+
+    return (u & 0x80000000u) ? ~u : u | 0x80000000u;
+}
+
+inline static float __geo_unkey_f(uint32_t k) {
+    const uint32_t u = (k & 0x80000000u) ? k & 0x7FFFFFFFu : ~k;
+
+    float v;
+    memcpy(&v, &u, sizeof(v));
+
+    return v;
+}
+
+inline static uint64_t __geo_key_d(double v) {
+    uint64_t u;
+    memcpy(&u, &v, sizeof(u));
+
+    return (u & 0x8000000000000000ULL) ? ~u : u | 0x8000000000000000ULL;
+}
+
+inline static double __geo_unkey_d(uint64_t k) {
+    const uint64_t u = (k & 0x8000000000000000ULL) ? k & 0x7FFFFFFFFFFFFFFFULL : ~k;
+
+    double v;
+    memcpy(&v, &u, sizeof(v));
+
+    return v;
+}
+
+static bool __geo_sort_raw(void* arr, size_t n, bool f32) {
+    bool ok;
+
+    // The points are turned into their keys in place, sorted, and turned back
+    if (f32) {
+        Point2f* p = (Point2f*)arr;
+
+        for (size_t i = 0; i < n; i++) {
+            const uint64_t key = (uint64_t)__geo_key_f(p[i].x) << 32 | __geo_key_f(p[i].y);
+            memcpy(&p[i], &key, sizeof(key));
+        }
+
+        ok = __radix_sort(p, n, sizeof(Point2f), 1, 0);
+
+        for (size_t i = 0; i < n; i++) {
+            uint64_t key;
+            memcpy(&key, &p[i], sizeof(key));
+
+            p[i].x = __geo_unkey_f((uint32_t)(key >> 32));
+            p[i].y = __geo_unkey_f((uint32_t)key);
+        }
+    } else {
+        Point2d* p = (Point2d*)arr;
+
+        for (size_t i = 0; i < n; i++) {
+            const uint64_t key[2] = {__geo_key_d(p[i].x), __geo_key_d(p[i].y)};
+            memcpy(&p[i], key, sizeof(key));
+        }
+
+        ok = __radix_sort(p, n, sizeof(Point2d), 2, 0);
+
+        for (size_t i = 0; i < n; i++) {
+            uint64_t key[2];
+            memcpy(key, &p[i], sizeof(key));
+
+            p[i].x = __geo_unkey_d(key[0]);
+            p[i].y = __geo_unkey_d(key[1]);
+        }
+    }
+
+    return ok;
+}
+
+inline static Point2d __geo_load(const void* arr, size_t i, bool f32) {
+    if (f32) {
+        const Point2f* p = (const Point2f*)arr + i;
+        return (Point2d){p->x, p->y};
+    }
+
+    return ((const Point2d*)arr)[i];
+}
+
+inline static void __geo_two_sum(double a, double b, double* s, double* err) {
+    *s = a + b;
+
+    const double bv = *s - a;
+    const double av = *s - bv;
+
+    *err = (a - av) + (b - bv);
+}
+
+inline static void __geo_two_diff(double a, double b, double* d, double* err) {
+    *d = a - b;
+
+    const double bv = a - *d;
+    const double av = *d + bv;
+
+    *err = (a - av) + (bv - b);
+}
+
+inline static void __geo_two_product(double a, double b, double* p, double* err) {
+    *p = a * b;
+    *err = fma(a, b, -*p);
+}
+
+static int __geo_orient_exact(double ax, double ay, double bx, double by, double cx, double cy) {
+    // Every difference is an exact two-term expansion, so the determinant is an exact sum of 16 products
+    double acx[2], bcy[2], acy[2], bcx[2];
+
+    __geo_two_diff(ax, cx, &acx[0], &acx[1]);
+    __geo_two_diff(by, cy, &bcy[0], &bcy[1]);
+    __geo_two_diff(ay, cy, &acy[0], &acy[1]);
+    __geo_two_diff(bx, cx, &bcx[0], &bcx[1]);
+
+    double terms[16];
+    size_t t = 0;
+
+    for (size_t i = 0; i < 2; i++) {
+        for (size_t j = 0; j < 2; j++) {
+            __geo_two_product(acx[i], bcy[j], &terms[t], &terms[t + 1]);
+            t += 2;
+
+            __geo_two_product(-acy[i], bcx[j], &terms[t], &terms[t + 1]);
+            t += 2;
+        }
+    }
+
+    // Grow a nonoverlapping expansion term by term; its sign is that of its largest component
+    double e[17];
+    size_t len = 0;
+
+    for (size_t i = 0; i < 16; i++) {
+        double q = terms[i];
+
+        for (size_t k = 0; k < len; k++) __geo_two_sum(q, e[k], &q, &e[k]);
+
+        e[len++] = q;
+    }
+
+    for (size_t k = len; k-- > 0;) {
+        if (e[k] != 0.0) return e[k] > 0.0 ? 1 : -1;
+    }
+
+    return 0;
+}
+
+static size_t __geo_hull_filter(const void* src, size_t n, bool f32, void* out) {
+    const size_t es = f32 ? sizeof(Point2f) : sizeof(Point2d);
+
+    if (n < 8) {
+        memcpy(out, src, n * es);
+        return n;
+    }
+
+    // Extreme points in counter-clockwise order: leftmost, lowest, rightmost, highest
+    size_t ext[4] = {0, 0, 0, 0};
+    Point2d lo = __geo_load(src, 0, f32), hi = lo;
+
+    for (size_t i = 1; i < n; i++) {
+        const Point2d p = __geo_load(src, i, f32);
+
+        if (p.x < lo.x) {
+            lo.x = p.x;
+            ext[0] = i;
+        }
+        if (p.y < lo.y) {
+            lo.y = p.y;
+            ext[1] = i;
+        }
+        if (p.x > hi.x) {
+            hi.x = p.x;
+            ext[2] = i;
+        }
+        if (p.y > hi.y) {
+            hi.y = p.y;
+            ext[3] = i;
+        }
+    }
+
+    size_t quad[5], corners = 0;
+
+    for (size_t e = 0; e < 4; e++) {
+        const Point2d p = __geo_load(src, ext[e], f32);
+        const Point2d prev = corners ? __geo_load(src, quad[corners - 1], f32) : p;
+
+        if (corners == 0 || p.x != prev.x || p.y != prev.y) quad[corners++] = ext[e];
+    }
+
+    const Point2d first = __geo_load(src, quad[0], f32), last = __geo_load(src, quad[corners - 1], f32);
+    if (corners > 1 && first.x == last.x && first.y == last.y) corners--;
+
+    if (corners < 3) {
+        memcpy(out, src, n * es);
+        return n;
+    }
+
+    quad[corners] = quad[0];
+
+    // Rounded cross products are off by less than a few ulps of (extent)^2: only clear margins count as inside
+    const double extent = fmax(hi.x - lo.x, hi.y - lo.y);
+    const double margin = 8.0 * (f32 ? FLT_EPSILON : DBL_EPSILON) * extent * extent + (f32 ? FLT_MIN : DBL_MIN);
+
+    float cross_f[4][__GEO_FILTER_BLOCK];
+    double cross_d[4][__GEO_FILTER_BLOCK];
+    size_t kept = 0;
+
+    for (size_t base = 0; base < n; base += __GEO_FILTER_BLOCK) {
+        const size_t len = n - base < __GEO_FILTER_BLOCK ? n - base : __GEO_FILTER_BLOCK;
+
+        for (size_t e = 0; e < corners; e++) {
+            if (f32) {
+                const Point2f* p = (const Point2f*)src;
+                geo_orient_batch_f(&p[quad[e]], &p[quad[e + 1]], p + base, len, cross_f[e]);
+            } else {
+                const Point2d* p = (const Point2d*)src;
+                geo_orient_batch_d(&p[quad[e]], &p[quad[e + 1]], p + base, len, cross_d[e]);
+            }
+        }
+
+        for (size_t i = 0; i < len; i++) {
+            bool inside = true;
+
+            for (size_t e = 0; e < corners && inside; e++) {
+                inside = (f32 ? (double)cross_f[e][i] : cross_d[e][i]) > margin;
+            }
+
+            if (!inside) memcpy((char*)out + kept++ * es, (const char*)src + (base + i) * es, es);
+        }
+    }
+
+    return kept;
+}
+
+static void __geo_copier_f(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(Point2f));
+}
+
+static void __geo_copier_d(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(Point2d));
+}
+
+inline static void __geo_closest_update(GeoCPState* s, double d2, size_t a, size_t b) {
+    if (d2 < s->best) {
+        s->best = d2;
+        s->a = a;
+        s->b = b;
+    }
+}
+
+static void __geo_closest(GeoCPState* s, size_t lo, size_t hi) {
+    GeoCPRec* r = s->recs;
+
+    if (hi - lo <= 3) {
+        for (size_t i = lo; i < hi; i++) {
+            for (size_t j = i + 1; j < hi; j++) {
+                const double dx = r[i].x - r[j].x, dy = r[i].y - r[j].y;
+                __geo_closest_update(s, dx * dx + dy * dy, r[i].id, r[j].id);
+            }
+        }
+
+        for (size_t i = lo + 1; i < hi; i++) {
+            const GeoCPRec v = r[i];
+
+            size_t j = i;
+            for (; j > lo && r[j - 1].y > v.y; j--) r[j] = r[j - 1];
+            r[j] = v;
+        }
+
+        return;
+    }
+
+    const size_t mid = lo + (hi - lo) / 2;
+    const double midx = r[mid].x;
+
+    __geo_closest(s, lo, mid);
+    __geo_closest(s, mid, hi);
+
+    // Merge the halves by y
+    size_t i = lo, j = mid, k = lo;
+
+    while (i < mid && j < hi) s->aux[k++] = r[j].y < r[i].y ? r[j++] : r[i++];
+    while (i < mid) s->aux[k++] = r[i++];
+    while (j < hi) s->aux[k++] = r[j++];
+
+    memcpy(r + lo, s->aux + lo, (hi - lo) * sizeof(GeoCPRec));
+
+    // Points within the current best of the dividing line, in y order
+    size_t m = 0;
+
+    for (size_t p = lo; p < hi; p++) {
+        const double dx = r[p].x - midx;
+        if (dx * dx >= s->best) continue;
+
+        s->sx[m] = r[p].x;
+        s->sy[m] = r[p].y;
+        s->sid[m] = r[p].id;
+        m++;
+    }
+
+    for (size_t p = 0; p < __GEO_STRIP_LANES; p++) s->sx[m + p] = s->sy[m + p] = INFINITY;
+
+    // Each strip point only needs the next few in y order; all of them are measured at once
+    for (size_t p = 0; p + 1 < m; p++) {
+        __geo_v4d x0, x1, y0, y1;
+        memcpy(&x0, s->sx + p + 1, sizeof(x0));
+        memcpy(&x1, s->sx + p + 5, sizeof(x1));
+        memcpy(&y0, s->sy + p + 1, sizeof(y0));
+        memcpy(&y1, s->sy + p + 5, sizeof(y1));
+
+        x0 -= s->sx[p], x1 -= s->sx[p];
+        y0 -= s->sy[p], y1 -= s->sy[p];
+
+        const __geo_v4d d0 = x0 * x0 + y0 * y0, d1 = x1 * x1 + y1 * y1;
+
+        for (size_t l = 0; l < 4; l++) {
+            if (p + 1 + l < m) __geo_closest_update(s, d0[l], s->sid[p], s->sid[p + 1 + l]);
+            if (p + 5 + l < m) __geo_closest_update(s, d1[l], s->sid[p], s->sid[p + 5 + l]);
+        }
+    }
+}
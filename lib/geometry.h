@@ -0,0 +1,133 @@
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "darray.h"
+
+// Nomenclature used (to avoid collisions): <data_type>_<method_name>
+//
+// The algorithms take a `DArray` of `Point2f` or `Point2d`, told apart by its `element_size`.
+// Coordinates must be finite.
+
+/**
+ * @brief 2D Point (single precision)
+ */
+typedef struct Point2F Point2f;
+
+struct Point2F {
+    float x;
+    float y;
+};
+
+/**
+ * @brief 2D Point (double precision)
+ */
+typedef struct Point2D Point2d;
+
+struct Point2D {
+    double x;
+    double y;
+};
+
+/******************************************************************************
+ *                                                                            *
+ *                                  Sorting                                   *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Sorts points by `x`, then `y`, with an LSD radix sort on the IEEE-754 bit patterns. O(n).
+/// @details Each coordinate is mapped to an unsigned key of the same order (sign bit flipped for positives, all bits for negatives). Byte positions shared by every key are skipped, so points in a narrow range need fewer passes. `-0.0` sorts before `+0.0`.
+/// @param pts Pointer to a dynamic array of `Point2f` or `Point2d`.
+/// @return `true` on success, `false` on an unsupported element size or allocation failure.
+bool geo_sort(DArray* pts);
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Predicates                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Exact orientation of `c` relative to the directed line from `a` to `b`.
+/// @details Evaluates the determinant in floating point with a forward error bound first, and only falls back to exact expansion arithmetic when the rounded sign cannot be trusted.
+/// @param a Pointer to the first point of the line.
+/// @param b Pointer to the second point of the line.
+/// @param c Pointer to the point to classify.
+/// @return `1` if `a`, `b`, `c` turn counter-clockwise, `-1` if clockwise, `0` if collinear.
+int geo_orient2d(const Point2d* a, const Point2d* b, const Point2d* c);
+
+/// @brief Same as `geo_orient2d` for single precision points (converted exactly).
+/// @param a Pointer to the first point of the line.
+/// @param b Pointer to the second point of the line.
+/// @param c Pointer to the point to classify.
+/// @return `1` if counter-clockwise, `-1` if clockwise, `0` if collinear.
+int geo_orient2d_f(const Point2f* a, const Point2f* b, const Point2f* c);
+
+/******************************************************************************
+ *                                                                            *
+ *                               Batch Kernels                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Computes `(b - a) x (p - a)` for every point, 8 at a time with vector extensions.
+/// @details Rounded results in single precision (not robust): positive means counter-clockwise.
+/// @param a Pointer to the first point of the line.
+/// @param b Pointer to the second point of the line.
+/// @param pts The points.
+/// @param n Number of points.
+/// @param out Receives `n` cross products.
+void geo_orient_batch_f(const Point2f* a, const Point2f* b, const Point2f* pts, size_t n, float* out);
+
+/// @brief Computes `(b - a) x (p - a)` for every point, 4 at a time with vector extensions.
+/// @details Rounded results in double precision (not robust): positive means counter-clockwise.
+/// @param a Pointer to the first point of the line.
+/// @param b Pointer to the second point of the line.
+/// @param pts The points.
+/// @param n Number of points.
+/// @param out Receives `n` cross products.
+void geo_orient_batch_d(const Point2d* a, const Point2d* b, const Point2d* pts, size_t n, double* out);
+
+/// @brief Computes the squared distance from `q` to every point, 8 at a time with vector extensions.
+/// @param q Pointer to the reference point.
+/// @param pts The points.
+/// @param n Number of points.
+/// @param out Receives `n` squared distances.
+void geo_dist2_batch_f(const Point2f* q, const Point2f* pts, size_t n, float* out);
+
+/// @brief Computes the squared distance from `q` to every point, 4 at a time with vector extensions.
+/// @param q Pointer to the reference point.
+/// @param pts The points.
+/// @param n Number of points.
+/// @param out Receives `n` squared distances.
+void geo_dist2_batch_d(const Point2d* q, const Point2d* pts, size_t n, double* out);
+
+/******************************************************************************
+ *                                                                            *
+ *                                Convex Hull                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Computes the convex hull with Andrew's monotone chain. O(n) after the radix sort.
+/// @details Points strictly inside the quadrilateral of the four extreme points are discarded first (Akl-Toussaint) with the batch orientation kernel and a conservative error margin, so usually only a small fraction is sorted. Hull turns use `geo_orient2d`.
+/// @param pts Pointer to a dynamic array of `Point2f` or `Point2d` (not modified).
+/// @return A new array of the same type holding the hull vertices counter-clockwise from the smallest `(x, y)`, without collinear or repeated points, or `NULL` on failure.
+DArray* geo_convex_hull(const DArray* pts);
+
+/******************************************************************************
+ *                                                                            *
+ *                                Closest Pair                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Finds the two closest points by divide and conquer. O(n log n).
+/// @details The points are radix sorted by `x` once, and each level merges its halves by `y`. The strip check compares each point with the next 8 strip points at once with vector extensions. Distances are computed in double precision.
+/// @param pts Pointer to a dynamic array of `Point2f` or `Point2d` (not modified).
+/// @param i Receives the position of one point of the pair.
+/// @param j Receives the position of the other point (`i < j`).
+/// @param dist2 Receives their squared distance (may be `NULL`).
+/// @return `true` on success, `false` with fewer than two points, an unsupported element size, or on allocation failure.
+bool geo_closest_pair(const DArray* pts, size_t* i, size_t* j, double* dist2);
+
+#endif  // GEOMETRY_H
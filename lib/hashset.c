@@ -1,20 +1,24 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "hashset.h"
 
 #include <fcntl.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <unistd.h>
 
+#include "bits.h"
+#include "random.h"
+
 /******************************************************************************
  *                                                                            *
  *                              Inner Functions                               *
  *                                                                            *
  ******************************************************************************/
 
-/// Get next power of `2`, using compiler builtins (count leading zeroes).
-inline static uint64_t __npo2(uint64_t n);
-uint64_t __random_u64(void);
 inline static uint64_t __best_capacity(uint64_t curr_count, double load_factor);
 inline static uint64_t __hs_hash(const HSet* hs, const void* k);
 inline static size_t __hs_index(uint64_t hash, size_t capacity);
@@ -27,6 +31,29 @@ inline static bool __hs_contains(HSet* hs, const void* k, uint64_t hash, size_t
 static bool __hs_resize(HSet* hs, size_t new_capacity);
 inline static HSNode* __hs_new_node(void* k, uint64_t hash);
 inline static void __hs_free_node(HSNode* node, void (*deallocator)(void* k));
+// accounts `n` nodes (with their key copies) being allocated (`n > 0`) or freed (`n < 0`); the process registry only
+// sees them with HS_TRACK_NODES, since its shared atomic counter would otherwise be written on every insert and remove
+inline static void __hs_track_nodes(HSet* hs, int64_t n);
+
+// Statistics hooks: compiled to nothing unless HS_STATS is defined.
+#ifdef HS_STATS
+// records a lookup that examined `probes` nodes
+inline static void __hs_stat_probe(HSet* hs, size_t probes, bool hit);
+// records the length of the chain starting at `head` after an insertion
+inline static void __hs_stat_chain(HSet* hs, const HSNode* head);
+// monotonic clock in nanoseconds, used to time resizes
+inline static uint64_t __hs_stat_now_ns(void);
+
+#define __HS_STAT_PROBE(hs, probes, hit) __hs_stat_probe((HSet*)(hs), (probes), (hit))
+#define __HS_STAT_CHAIN(hs, head) __hs_stat_chain((hs), (head))
+#define __HS_STAT_HASH(hs) (((HSet*)(hs))->_stats->hash_calls++)
+#define __HS_STAT_NODES(hs, n) ((hs)->_stats->node_bytes += (uint64_t)(n) * sizeof(HSNode), (hs)->_stats->key_bytes += (uint64_t)(n) * (hs)->element_size)
+#else
+#define __HS_STAT_PROBE(hs, probes, hit) ((void)(probes))
+#define __HS_STAT_CHAIN(hs, head) ((void)0)
+#define __HS_STAT_HASH(hs) ((void)0)
+#define __HS_STAT_NODES(hs, n) ((void)0)
+#endif
 
 /******************************************************************************
  *                                                                            *
@@ -53,11 +80,12 @@ HSet* hs_new_with_capacity(
     size_t capacity  //
 ) {
     if (element_size == 0 || !cmp || !deallocator || !copier || !hasher) return NULL;
+    if (!bits_npo2(capacity)) return NULL;  // above 2^63
 
     HSet* hs = (HSet*)malloc(sizeof(HSet));
     if (!hs) return NULL;
 
-    capacity = capacity < 4 ? 4 : __npo2(capacity);
+    capacity = capacity < 4 ? 4 : bits_npo2(capacity);
 
     HSNode** buckets = (HSNode**)calloc(capacity, sizeof(HSNode*));
     if (!buckets) {
@@ -71,6 +99,19 @@ HSet* hs_new_with_capacity(
 
     hs->buckets = buckets;
 
+    hs->_stats = NULL;
+#ifdef HS_STATS
+    hs->_stats = (HSStats*)calloc(1, sizeof(HSStats));
+    if (!hs->_stats) {
+        free(buckets);
+        free(hs);
+        return NULL;
+    }
+
+    hs->_stats->enabled = true;
+    hs->_stats->bucket_bytes = capacity * sizeof(HSNode*);
+#endif
+
     uint64_t seed_0 = __random_u64();
     uint64_t seed_1 = __random_u64();
 
@@ -88,6 +129,8 @@ HSet* hs_new_with_capacity(
     hs->_mut_count = 0;
     hs->_collisions = 0;
 
+    ms_track(MS_HSET, 1, (int64_t)(sizeof(HSet) + capacity * sizeof(HSNode*) + (hs->_stats ? sizeof(HSStats) : 0)));
+
     return hs;
 }
 
@@ -125,7 +168,11 @@ void hs_free(HSet* hs) {
     if (!hs) return;
 
     hs_clear(hs);
+
+    ms_track(MS_HSET, -1, -(int64_t)(sizeof(HSet) + hs->capacity * sizeof(HSNode*) + (hs->_stats ? sizeof(HSStats) : 0)));
+
     free(hs->buckets);
+    free(hs->_stats);
     free(hs);
 }
 // inner
@@ -143,10 +190,15 @@ void hs_clear(HSet* hs) {
             hs->deallocator(curr->key);
 
             free(curr);
+            __hs_track_nodes(hs, -1);
 
             curr = next;
         }
+
+        hs->buckets[i] = NULL;
     }
+
+    hs->count = 0;
 }
 
 /******************************************************************************
@@ -328,6 +380,51 @@ void hs_fprint_metadata(FILE* file, const HSet* hs) {
             hs->_collisions);
 }
 
+HSStats hs_stats(const HSet* hs) {
+    HSStats stats;
+    memset(&stats, 0, sizeof(stats));
+
+    if (hs && hs->_stats) stats = *hs->_stats;
+
+    return stats;
+}
+
+void hs_fprint_stats_json(FILE* file, const HSet* hs) {
+    if (!file) file = stdout;
+
+    if (!hs) {
+        fprintf(file, "null");
+        return;
+    }
+
+    HSStats stats = hs_stats(hs);
+
+    fprintf(file, "{\"enabled\": %s, \"count\": %zu, \"capacity\": %zu", stats.enabled ? "true" : "false", hs->count, hs->capacity);
+
+    if (stats.enabled) {
+        fprintf(file, ", \"probe_histogram\": [");
+
+        for (size_t i = 0; i < HS_STATS_PROBE_BUCKETS; i++) {
+            fprintf(file, i ? ", %lu" : "%lu", stats.probe_histogram[i]);
+        }
+
+        fprintf(file,
+                "], \"max_chain\": %lu, \"hits\": %lu, \"misses\": %lu, \"resizes\": %lu, \"resize_ns\": %lu"
+                ", \"node_bytes\": %lu, \"key_bytes\": %lu, \"bucket_bytes\": %lu, \"hash_calls\": %lu",
+                stats.max_chain,
+                stats.hits,
+                stats.misses,
+                stats.resizes,
+                stats.resize_ns,
+                stats.node_bytes,
+                stats.key_bytes,
+                stats.bucket_bytes,
+                stats.hash_calls);
+    }
+
+    fprintf(file, "}");
+}
+
 /******************************************************************************
  *                                                                            *
  *                                   Resize                                   *
@@ -341,11 +438,49 @@ bool hs_resize(HSet* hs, size_t new_capacity) {
 
     if (hs->capacity > new_capacity) return true;
 
-    new_capacity = __npo2(new_capacity);
+    new_capacity = bits_npo2(new_capacity);
+    if (!new_capacity) return false;
 
     return __hs_resize(hs, new_capacity);
 }
 
+/******************************************************************************
+ *                                                                            *
+ *                             Memory Accounting                              *
+ *                                                                            *
+ ******************************************************************************/
+
+MemUsage hs_memory_usage(const HSet* hs, size_t (*owned_size)(const void* k)) {
+    MemUsage mu = {0, 0, 0, 0, 0};
+    if (!hs) return mu;
+
+    const size_t bucket_bytes = hs->capacity * sizeof(HSNode*);
+
+    mu.metadata = sizeof(HSet) + (hs->_stats ? sizeof(HSStats) : 0);
+    mu.overhead = (ms_usable_size(hs, sizeof(HSet)) - sizeof(HSet)) + (ms_usable_size(hs->buckets, bucket_bytes) - bucket_bytes);
+
+    for (size_t i = 0; i < hs->capacity; i++) {
+        HSNode* curr = hs->buckets[i];
+
+        if (!curr) {
+            mu.slack += sizeof(HSNode*);
+            continue;
+        }
+
+        mu.metadata += sizeof(HSNode*);
+
+        for (; curr; curr = curr->next) {
+            mu.payload += hs->element_size;
+            mu.metadata += sizeof(HSNode);
+            mu.overhead += (ms_usable_size(curr, sizeof(HSNode)) - sizeof(HSNode)) + (ms_usable_size(curr->key, hs->element_size) - hs->element_size);
+
+            if (owned_size) mu.owned += owned_size(curr->key);
+        }
+    }
+
+    return mu;
+}
+
 /******************************************************************************
  *                                                                            *
  *                      Insertion, Deletion & Searching                       *
@@ -380,6 +515,9 @@ bool hs_insert(HSet* hs, const void* k) {
 
     hs->count++;
 
+    __hs_track_nodes(hs, 1);
+    __HS_STAT_CHAIN(hs, node);
+
     if ((double)hs->count / (double)hs->capacity > hs->load_factor) __hs_resize(hs, hs->capacity * 2);
 
     return true;
@@ -407,6 +545,7 @@ bool hs_remove(HSet* hs, const void* k) {
     *target_ptr_addr = node_to_remove->next;
 
     free(node_to_remove);
+    __hs_track_nodes(hs, -1);
 
     hs->count--;
 
@@ -437,6 +576,7 @@ void hs_retain(HSet* hs, bool (*predicate)(void* k)) {
 
                 HSNode* node_to_free = curr;
                 free(node_to_free);
+                __hs_track_nodes(hs, -1);
 
                 hs->count--;
             }
@@ -782,10 +922,6 @@ void* hs_iter_get(HSIterator* it) {
  *                                                                            *
  ******************************************************************************/
 
-inline static uint64_t __npo2(uint64_t n) {
-    return n == 1 ? 1 : 1 << (64 - __builtin_clzl(n - 1));
-}
-
 uint64_t __random_u64(void) {
     uint64_t val;
 
@@ -811,11 +947,13 @@ uint64_t __random_u64(void) {
 inline static uint64_t __best_capacity(uint64_t curr_count, double load_factor) {
     double capacity = (double)curr_count / load_factor;
     size_t final_capacity = (size_t)capacity;
-    // final_capacity = __npo2(final_capacity);
+    // final_capacity = bits_npo2(final_capacity);
     return final_capacity;
 }
 
 inline static uint64_t __hs_hash(const HSet* hs, const void* k) {
+    __HS_STAT_HASH(hs);
+
     return hs->hasher(k, hs->seed_0, hs->seed_1);
 }
 
@@ -842,17 +980,22 @@ inline static HSNode* __hs_find(HSet* hs, const void* k) {
 
 inline static HSNode** __hs_find_target_ptr(HSet* hs, const void* k, uint64_t hash, size_t index) {
     HSNode** curr_ptr = &hs->buckets[index];
+    size_t probes = 0;
 
     while (*curr_ptr) {
         HSNode* curr = *curr_ptr;
+        probes++;
 
         if (curr->hash == hash && hs->cmp(curr->key, k) == 0) {
+            __HS_STAT_PROBE(hs, probes, true);
             return curr_ptr;  // Found the address of the pointer pointing to the target node
         }
 
         curr_ptr = &curr->next;
     }
 
+    __HS_STAT_PROBE(hs, probes, false);
+
     return NULL;  // Element not found
 }
 
@@ -869,6 +1012,10 @@ static bool __hs_resize(HSet* hs, size_t new_capacity) {
         return false;  // Can only grow
     }
 
+#ifdef HS_STATS
+    const uint64_t start_ns = __hs_stat_now_ns();
+#endif
+
     // 2. Allocate the new bucket array (initialized to NULL)
     HSNode** new_buckets = (HSNode**)calloc(new_capacity, sizeof(HSNode*));
     if (!new_buckets) {
@@ -896,9 +1043,17 @@ static bool __hs_resize(HSet* hs, size_t new_capacity) {
     // 4. Clean up and update the HSet structure
     free(hs->buckets);  // Free the old bucket array
 
+    ms_track(MS_HSET, 0, ((int64_t)new_capacity - (int64_t)hs->capacity) * (int64_t)sizeof(HSNode*));
+
     hs->buckets = new_buckets;
     hs->capacity = new_capacity;
 
+#ifdef HS_STATS
+    hs->_stats->resizes++;
+    hs->_stats->resize_ns += __hs_stat_now_ns() - start_ns;
+    hs->_stats->bucket_bytes = new_capacity * sizeof(HSNode*);
+#endif
+
     return true;
 }
 
@@ -916,4 +1071,40 @@ inline static HSNode* __hs_new_node(void* k, uint64_t hash) {
 inline static void __hs_free_node(HSNode* node, void (*deallocator)(void* k)) {
     deallocator(node->key);
     free(node);
-}
\ No newline at end of file
+}
+
+inline static void __hs_track_nodes(HSet* hs, int64_t n) {
+#ifdef HS_TRACK_NODES
+    ms_track(MS_HSET, 0, n * (int64_t)(sizeof(HSNode) + hs->element_size));
+#endif
+    __HS_STAT_NODES(hs, n);
+    (void)hs;
+    (void)n;
+}
+
+#ifdef HS_STATS
+inline static void __hs_stat_probe(HSet* hs, size_t probes, bool hit) {
+    hs->_stats->probe_histogram[probes < HS_STATS_PROBE_BUCKETS ? probes : HS_STATS_PROBE_BUCKETS - 1]++;
+
+    if (hit) {
+        hs->_stats->hits++;
+    } else {
+        hs->_stats->misses++;
+    }
+}
+
+inline static void __hs_stat_chain(HSet* hs, const HSNode* head) {
+    uint64_t length = 0;
+
+    for (; head; head = head->next) length++;
+
+    if (length > hs->_stats->max_chain) hs->_stats->max_chain = length;
+}
+
+inline static uint64_t __hs_stat_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+#endif
\ No newline at end of file
@@ -6,9 +6,40 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include "memstat.h"
+
 // Nomenclature used (to avoid collisions): <data_type>_<method_name>
 // Warning: This implementation is not thread-safe, and is for educational purposes only.
 
+/// Number of buckets of the probe-length histogram; the last bucket collects every longer probe.
+#define HS_STATS_PROBE_BUCKETS 16
+
+/**
+ * @brief Hot-path statistics of a Hash Set.
+ *
+ * Only collected when the library is compiled with `-DHS_STATS`; otherwise
+ * every counter stays zero, `enabled` is false and the instrumentation
+ * compiles to nothing. `HSet` always holds a pointer to it, so code built with
+ * and without the flag agrees on the struct layout, but the block itself is
+ * only allocated when statistics are enabled.
+ */
+typedef struct HashSetStats HSStats;
+
+struct HashSetStats {
+    bool enabled;  ///< Whether the library was compiled with `HS_STATS`.
+
+    uint64_t probe_histogram[HS_STATS_PROBE_BUCKETS];  ///< `probe_histogram[i]`: lookups that examined `i` nodes.
+    uint64_t max_chain;                                ///< Longest bucket chain observed after an insertion.
+    uint64_t hits;                                     ///< Lookups that found their key.
+    uint64_t misses;                                   ///< Lookups that did not find their key.
+    uint64_t resizes;                                  ///< Number of bucket array resizes.
+    uint64_t resize_ns;                                ///< Total time spent resizing, in nanoseconds.
+    uint64_t node_bytes;                               ///< Bytes currently allocated for nodes.
+    uint64_t key_bytes;                                ///< Bytes currently allocated for key copies.
+    uint64_t bucket_bytes;                             ///< Bytes currently allocated for the bucket array.
+    uint64_t hash_calls;                               ///< Number of calls to the hasher.
+};
+
 /**
  * @brief Opaque structure for the Generic Hash Set.
  *
@@ -81,6 +112,8 @@ struct HashSet {
 
     uint64_t _mut_count;   ///< Mutation count, incremented on any attempt to change the set structure.
     uint64_t _collisions;  ///< Count of collisions detected during insertion.
+
+    HSStats* _stats;  ///< Hot-path statistics (see `hs_stats`); `NULL` unless the library is compiled with `HS_STATS`.
 };
 
 /******************************************************************************
@@ -254,6 +287,24 @@ void hs_fprint_debug(FILE* file, const HSet* hs);
 /// @param hs Pointer to the Hash Set.
 void hs_fprint_metadata(FILE* file, const HSet* hs);
 
+/// @brief Returns a snapshot of the hot-path statistics of the Hash Set.
+///
+/// Requires the library to be compiled with `-DHS_STATS`; otherwise the returned
+/// struct is zeroed and `enabled` is false.
+///
+/// @param hs Pointer to the Hash Set.
+/// @return The statistics (zeroed if `hs` is NULL).
+HSStats hs_stats(const HSet* hs);
+
+/// @brief Prints the statistics of the Hash Set as a single JSON object.
+///
+/// Always includes `enabled`, `count` and `capacity`; the counters of `HSStats`
+/// are only included when statistics are enabled.
+///
+/// @param file The file stream to print to.
+/// @param hs Pointer to the Hash Set.
+void hs_fprint_stats_json(FILE* file, const HSet* hs);
+
 /******************************************************************************
  *                                                                            *
  *                                   Resize                                   *
@@ -269,6 +320,25 @@ void hs_fprint_metadata(FILE* file, const HSet* hs);
 /// @return true if resizing occurred or if the new capacity was smaller than the old one, false on allocation failure.
 bool hs_resize(HSet* hs, size_t new_capacity);
 
+/******************************************************************************
+ *                                                                            *
+ *                             Memory Accounting                              *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Reports how much memory the Hash Set uses, broken down by category.
+///
+/// `payload` counts the key copies, `slack` the empty bucket slots, `metadata` the
+/// `HSet` header, the occupied bucket slots and the nodes, and `overhead` what the
+/// allocator reserved beyond each request (measured per node and per key with
+/// `malloc_usable_size` on glibc). This walks every node: O(capacity + count).
+/// Every live set is also counted in the process registry (see `ms_registry_get(MS_HSET)`).
+///
+/// @param hs Pointer to the Hash Set.
+/// @param owned_size Optional callback returning the heap bytes owned by one key (e.g., fields allocated by `copier`); summed into `owned`. May be `NULL`.
+/// @return The breakdown, zeroed if `hs` is `NULL`.
+MemUsage hs_memory_usage(const HSet* hs, size_t (*owned_size)(const void* k));
+
 /******************************************************************************
  *                                                                            *
  *                      Insertion, Deletion & Searching                       *
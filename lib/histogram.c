@@ -0,0 +1,206 @@
+#include "histogram.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bits.h"
+
+/******************************************************************************
+ *                                                                            *
+ *                              Inner Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+// bucket index of `value`
+inline static size_t __hdr_index(const HdrHist* h, uint64_t value);
+// largest value that falls into bucket `index`
+inline static uint64_t __hdr_highest(const HdrHist* h, size_t index);
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+HdrHist* hdr_new(unsigned precision_bits) {
+    if (precision_bits < 2 || precision_bits > 16) return NULL;
+
+    HdrHist* h = (HdrHist*)malloc(sizeof(HdrHist));
+    if (!h) return NULL;
+
+    // 2^p exact buckets, then 2^(p-1) buckets for each of the remaining 64 - p octaves.
+    const size_t half = (size_t)1 << (precision_bits - 1);
+
+    h->precision_bits = precision_bits;
+    h->counts_length = 2 * half + (64 - precision_bits) * half;
+    h->counts = (uint64_t*)calloc(h->counts_length, sizeof(uint64_t));
+
+    if (!h->counts) {
+        free(h);
+        return NULL;
+    }
+
+    h->total_count = 0;
+    h->min = UINT64_MAX;
+    h->max = 0;
+    h->sum = 0.0;
+
+    return h;
+}
+
+void hdr_free(HdrHist* h) {
+    if (!h) return;
+
+    free(h->counts);
+    free(h);
+}
+
+void hdr_reset(HdrHist* h) {
+    if (!h) return;
+
+    memset(h->counts, 0, h->counts_length * sizeof(uint64_t));
+
+    h->total_count = 0;
+    h->min = UINT64_MAX;
+    h->max = 0;
+    h->sum = 0.0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Recording                                  *
+ *                                                                            *
+ ******************************************************************************/
+
+void hdr_record(HdrHist* h, uint64_t value) {
+    hdr_record_n(h, value, 1);
+}
+
+void hdr_record_n(HdrHist* h, uint64_t value, uint64_t n) {
+    if (!h || n == 0) return;
+
+    h->counts[__hdr_index(h, value)] += n;
+
+    h->total_count += n;
+    h->sum += (double)value * (double)n;
+
+    if (value < h->min) h->min = value;
+    if (value > h->max) h->max = value;
+}
+
+bool hdr_merge(HdrHist* dest, const HdrHist* src) {
+    if (!dest || !src || dest->precision_bits != src->precision_bits) return false;
+
+    for (size_t i = 0; i < src->counts_length; i++) {
+        dest->counts[i] += src->counts[i];
+    }
+
+    dest->total_count += src->total_count;
+    dest->sum += src->sum;
+
+    if (src->min < dest->min) dest->min = src->min;
+    if (src->max > dest->max) dest->max = src->max;
+
+    return true;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                  Queries                                   *
+ *                                                                            *
+ ******************************************************************************/
+
+uint64_t hdr_percentile(const HdrHist* h, double percentile) {
+    if (!h || h->total_count == 0) return 0;
+
+    if (percentile <= 0.0) return h->min;
+    if (percentile >= 100.0) return h->max;
+
+    // Rank of the requested value (1-based), rounded up so p50 of {a, b} is a.
+    double exact = percentile / 100.0 * (double)h->total_count;
+    uint64_t rank = (uint64_t)exact;
+    if ((double)rank < exact || rank == 0) rank++;
+
+    uint64_t seen = 0;
+
+    for (size_t i = 0; i < h->counts_length; i++) {
+        seen += h->counts[i];
+
+        if (seen >= rank) {
+            uint64_t value = __hdr_highest(h, i);
+
+            if (value > h->max) value = h->max;
+            if (value < h->min) value = h->min;
+
+            return value;
+        }
+    }
+
+    return h->max;
+}
+
+uint64_t hdr_count(const HdrHist* h) {
+    return h ? h->total_count : 0;
+}
+
+uint64_t hdr_min(const HdrHist* h) {
+    return h && h->total_count ? h->min : 0;
+}
+
+uint64_t hdr_max(const HdrHist* h) {
+    return h ? h->max : 0;
+}
+
+double hdr_mean(const HdrHist* h) {
+    return h && h->total_count ? h->sum / (double)h->total_count : 0.0;
+}
+
+void hdr_fprint_summary(FILE* file, const HdrHist* h, const char* unit) {
+    if (!file) file = stdout;
+    if (!unit) unit = "";
+
+    if (!h) {
+        fprintf(file, "NULL\n");
+        return;
+    }
+
+    fprintf(file,
+            "count=%lu min=%lu%s p50=%lu%s p90=%lu%s p99=%lu%s p99.9=%lu%s max=%lu%s mean=%.1f%s\n",
+            hdr_count(h),
+            hdr_min(h), unit,
+            hdr_percentile(h, 50.0), unit,
+            hdr_percentile(h, 90.0), unit,
+            hdr_percentile(h, 99.0), unit,
+            hdr_percentile(h, 99.9), unit,
+            hdr_max(h), unit,
+            hdr_mean(h), unit);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                      Inner Functions Implementation                        *
+ *                                                                            *
+ ******************************************************************************/
+
+inline static size_t __hdr_index(const HdrHist* h, uint64_t value) {
+    const unsigned p = h->precision_bits;
+
+    if (value < ((uint64_t)1 << p)) return (size_t)value;
+
+    // Shift `value` so it lands in [2^(p-1), 2^p); each extra octave adds 2^(p-1) buckets.
+    const unsigned shift = bits_log2(value) - (p - 1);
+
+    return ((size_t)shift << (p - 1)) + (size_t)(value >> shift);
+}
+
+inline static uint64_t __hdr_highest(const HdrHist* h, size_t index) {
+    const unsigned p = h->precision_bits;
+    const size_t full = (size_t)1 << p;
+
+    if (index < full) return (uint64_t)index;
+
+    const unsigned shift = (unsigned)((index - full) >> (p - 1)) + 1;
+    const uint64_t sub = (uint64_t)(index - ((size_t)shift << (p - 1)));
+
+    return (sub << shift) + (((uint64_t)1 << shift) - 1);
+}
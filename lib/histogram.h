@@ -0,0 +1,117 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Nomenclature used (to avoid collisions): <data_type>_<method_name>
+// Warning: This implementation is not thread-safe, and is for educational purposes only.
+
+/**
+ * @brief HDR-style Latency Histogram
+ *
+ * Records non-negative 64-bit values (e.g., nanoseconds) into log-linear
+ * buckets: every power-of-two range is split into the same number of linear
+ * sub-buckets, so the relative error of any reported value is bounded by
+ * `2^-(precision_bits - 1)` over the whole `uint64_t` range, while recording
+ * stays O(1) with no allocation. Histograms with the same precision can be
+ * merged, e.g. to combine per-thread recordings.
+ */
+typedef struct HdrHistogram HdrHist;
+
+struct HdrHistogram {
+    uint64_t* counts;         ///< Count per bucket (`counts_length` entries).
+    size_t counts_length;     ///< Number of buckets.
+    unsigned precision_bits;  ///< Values below `2^precision_bits` are recorded exactly.
+
+    uint64_t total_count;  ///< Number of recorded values.
+    uint64_t min;          ///< Smallest recorded value (`UINT64_MAX` when empty).
+    uint64_t max;          ///< Largest recorded value (`0` when empty).
+    double sum;            ///< Sum of the recorded values (used for the mean).
+};
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Allocates a new, empty histogram.
+/// @details `precision_bits = 7` gives a worst-case relative error below 1.6% with 3776 buckets (about 30 KiB).
+/// @param precision_bits Number of significant bits kept per value, between 2 and 16.
+/// @return Pointer to the newly allocated `HdrHist`, or `NULL` on allocation failure or invalid precision.
+HdrHist* hdr_new(unsigned precision_bits);
+
+/// @brief Frees the histogram.
+/// @param h Pointer to the histogram (may be `NULL`).
+void hdr_free(HdrHist* h);
+
+/// @brief Removes every recorded value, keeping the buckets allocated.
+/// @param h Pointer to the histogram.
+void hdr_reset(HdrHist* h);
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Recording                                  *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Records a single value.
+/// @param h Pointer to the histogram.
+/// @param value The value to record.
+void hdr_record(HdrHist* h, uint64_t value);
+
+/// @brief Records the same value `n` times.
+/// @param h Pointer to the histogram.
+/// @param value The value to record.
+/// @param n Number of occurrences.
+void hdr_record_n(HdrHist* h, uint64_t value, uint64_t n);
+
+/// @brief Adds every value recorded in `src` to `dest`.
+/// @param dest Pointer to the destination histogram.
+/// @param src Pointer to the source histogram (left untouched).
+/// @return `true` on success, `false` if either is `NULL` or their precisions differ.
+bool hdr_merge(HdrHist* dest, const HdrHist* src);
+
+/******************************************************************************
+ *                                                                            *
+ *                                  Queries                                   *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Gets the value at a given percentile.
+/// @details Returns the highest value equivalent to the bucket holding the requested rank (clamped to the recorded maximum), so the result is never below the true percentile and exceeds it by at most the histogram's relative error.
+/// @param h Pointer to the histogram.
+/// @param percentile Percentile in `[0, 100]` (e.g., `99.9`).
+/// @return The value at the percentile, or `0` if the histogram is empty.
+uint64_t hdr_percentile(const HdrHist* h, double percentile);
+
+/// @brief Gets the number of recorded values.
+/// @param h Pointer to the histogram.
+/// @return The number of recorded values.
+uint64_t hdr_count(const HdrHist* h);
+
+/// @brief Gets the smallest recorded value.
+/// @param h Pointer to the histogram.
+/// @return The exact minimum, or `0` if the histogram is empty.
+uint64_t hdr_min(const HdrHist* h);
+
+/// @brief Gets the largest recorded value.
+/// @param h Pointer to the histogram.
+/// @return The exact maximum, or `0` if the histogram is empty.
+uint64_t hdr_max(const HdrHist* h);
+
+/// @brief Gets the mean of the recorded values.
+/// @param h Pointer to the histogram.
+/// @return The exact mean, or `0.0` if the histogram is empty.
+double hdr_mean(const HdrHist* h);
+
+/// @brief Prints a one-line summary: count, min, p50, p90, p99, p99.9, max and mean.
+/// @param file The output file stream (defaults to `stdout` if `NULL`).
+/// @param h Pointer to the histogram.
+/// @param unit Unit suffix appended to every value (e.g., `"ns"`), may be `NULL`.
+void hdr_fprint_summary(FILE* file, const HdrHist* h, const char* unit);
+
+#endif  // HISTOGRAM_H
@@ -0,0 +1,415 @@
+#include "intrusive.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "bits.h"
+#include "memstat.h"
+#include "random.h"
+
+/******************************************************************************
+ *                                                                            *
+ *                              Inner Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+// links `node` between the adjacent hooks `prev` and `next`
+inline static void __il_link(IList* list, IListNode* prev, IListNode* next, IListNode* node);
+// smallest power of two bucket count holding `count` elements under `load_factor`
+inline static size_t __ihs_buckets_for(size_t count, double load_factor);
+inline static IHSNode* __ihs_node(const IHSet* hs, const void* obj);
+inline static void* __ihs_obj(const IHSet* hs, const IHSNode* node);
+inline static size_t __ihs_index(uint64_t hash, size_t capacity);
+// returns the address of the link pointing to the hook equal to `key`, NULL if not found
+inline static IHSNode** __ihs_find_link(const IHSet* hs, const void* key, uint64_t hash);
+static bool __ihs_rehash(IHSet* hs, size_t new_capacity);
+
+/******************************************************************************
+ *                                                                            *
+ *                        Intrusive Doubly-Linked List                        *
+ *                                                                            *
+ ******************************************************************************/
+
+void il_init(IList* list) {
+    if (!list) return;
+
+    list->head.prev = &list->head;
+    list->head.next = &list->head;
+    list->length = 0;
+}
+
+void il_node_init(IListNode* node) {
+    if (!node) return;
+
+    node->prev = NULL;
+    node->next = NULL;
+}
+
+bool il_is_linked(const IListNode* node) {
+    return node && node->next != NULL;
+}
+
+size_t il_length(const IList* list) {
+    return list ? list->length : 0;
+}
+
+bool il_is_empty(const IList* list) {
+    return !list || list->length == 0;
+}
+
+IListNode* il_first(const IList* list) {
+    if (il_is_empty(list)) return NULL;
+
+    return list->head.next;
+}
+
+IListNode* il_last(const IList* list) {
+    if (il_is_empty(list)) return NULL;
+
+    return list->head.prev;
+}
+
+IListNode* il_next(const IList* list, const IListNode* node) {
+    if (!list || !node || node->next == &list->head) return NULL;
+
+    return node->next;
+}
+
+IListNode* il_prev(const IList* list, const IListNode* node) {
+    if (!list || !node || node->prev == &list->head) return NULL;
+
+    return node->prev;
+}
+
+void il_push_back(IList* list, IListNode* node) {
+    if (!list || !node) return;
+
+    __il_link(list, list->head.prev, &list->head, node);
+}
+
+void il_push_front(IList* list, IListNode* node) {
+    if (!list || !node) return;
+
+    __il_link(list, &list->head, list->head.next, node);
+}
+
+void il_insert_before(IList* list, IListNode* pos, IListNode* node) {
+    if (!list || !pos || !node) return;
+
+    __il_link(list, pos->prev, pos, node);
+}
+
+void il_insert_after(IList* list, IListNode* pos, IListNode* node) {
+    if (!list || !pos || !node) return;
+
+    __il_link(list, pos, pos->next, node);
+}
+
+void il_remove(IList* list, IListNode* node) {
+    if (!list || !il_is_linked(node) || node == &list->head) return;
+
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+
+    node->prev = NULL;
+    node->next = NULL;
+
+    list->length--;
+}
+
+IListNode* il_pop_front(IList* list) {
+    IListNode* node = il_first(list);
+    if (node) il_remove(list, node);
+
+    return node;
+}
+
+IListNode* il_pop_back(IList* list) {
+    IListNode* node = il_last(list);
+    if (node) il_remove(list, node);
+
+    return node;
+}
+
+void il_splice_back(IList* dest, IList* src) {
+    if (!dest || il_is_empty(src) || dest == src) return;
+
+    IListNode* first = src->head.next;
+    IListNode* last = src->head.prev;
+
+    first->prev = dest->head.prev;
+    dest->head.prev->next = first;
+
+    last->next = &dest->head;
+    dest->head.prev = last;
+
+    dest->length += src->length;
+
+    il_init(src);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+IHSet* ihs_new(size_t node_offset, int (*cmp)(const void* a, const void* b), uint64_t (*hasher)(const void* obj, uint64_t seed_0, uint64_t seed_1)) {
+    return ihs_new_with_capacity(node_offset, cmp, hasher, 0);
+}
+
+IHSet* ihs_new_with_capacity(
+    size_t node_offset,
+    int (*cmp)(const void* a, const void* b),
+    uint64_t (*hasher)(const void* obj, uint64_t seed_0, uint64_t seed_1),
+    size_t capacity  //
+) {
+    if (!cmp || !hasher) return NULL;
+
+    IHSet* hs = (IHSet*)malloc(sizeof(IHSet));
+    if (!hs) return NULL;
+
+    hs->load_factor = 0.75;
+    hs->capacity = __ihs_buckets_for(capacity, hs->load_factor);
+
+    hs->buckets = (IHSNode**)calloc(hs->capacity, sizeof(IHSNode*));
+    if (!hs->buckets) {
+        free(hs);
+        return NULL;
+    }
+
+    hs->count = 0;
+    hs->node_offset = node_offset;
+
+    hs->seed_0 = __random_u64();
+    hs->seed_1 = __random_u64();
+
+    hs->cmp = cmp;
+    hs->hasher = hasher;
+
+    ms_track(MS_IHSET, 1, (int64_t)(sizeof(IHSet) + hs->capacity * sizeof(IHSNode*)));
+
+    return hs;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                             Clean Up & Freeing                             *
+ *                                                                            *
+ ******************************************************************************/
+
+void ihs_free(IHSet* hs) {
+    if (!hs) return;
+
+    ms_track(MS_IHSET, -1, -(int64_t)(sizeof(IHSet) + hs->capacity * sizeof(IHSNode*)));
+
+    free(hs->buckets);
+    free(hs);
+}
+
+void ihs_clear(IHSet* hs) {
+    if (!hs) return;
+
+    for (size_t i = 0; i < hs->capacity; i++) {
+        IHSNode* curr = hs->buckets[i];
+
+        while (curr) {
+            IHSNode* next = curr->next;
+            curr->next = NULL;
+            curr = next;
+        }
+
+        hs->buckets[i] = NULL;
+    }
+
+    hs->count = 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                        Insertion, Lookup & Removal                         *
+ *                                                                            *
+ ******************************************************************************/
+
+size_t ihs_count(const IHSet* hs) {
+    return hs ? hs->count : 0;
+}
+
+bool ihs_reserve(IHSet* hs, size_t new_capacity) {
+    if (!hs) return false;
+
+    size_t buckets = __ihs_buckets_for(new_capacity, hs->load_factor);
+    if (buckets <= hs->capacity) return true;
+
+    return __ihs_rehash(hs, buckets);
+}
+
+bool ihs_insert(IHSet* hs, void* obj) {
+    if (!hs || !obj) return false;
+
+    uint64_t hash = hs->hasher(obj, hs->seed_0, hs->seed_1);
+    if (__ihs_find_link(hs, obj, hash)) return false;
+
+    if ((double)(hs->count + 1) > (double)hs->capacity * hs->load_factor) {
+        if (!__ihs_rehash(hs, hs->capacity * 2)) return false;
+    }
+
+    IHSNode* node = __ihs_node(hs, obj);
+    size_t index = __ihs_index(hash, hs->capacity);
+
+    node->hash = hash;
+    node->next = hs->buckets[index];
+    hs->buckets[index] = node;
+
+    hs->count++;
+
+    return true;
+}
+
+void* ihs_find(const IHSet* hs, const void* key) {
+    if (!hs || !key) return NULL;
+
+    IHSNode** link = __ihs_find_link(hs, key, hs->hasher(key, hs->seed_0, hs->seed_1));
+
+    return link ? __ihs_obj(hs, *link) : NULL;
+}
+
+void* ihs_remove(IHSet* hs, const void* key) {
+    if (!hs || !key) return NULL;
+
+    IHSNode** link = __ihs_find_link(hs, key, hs->hasher(key, hs->seed_0, hs->seed_1));
+    if (!link) return NULL;
+
+    IHSNode* node = *link;
+    *link = node->next;
+    node->next = NULL;
+
+    hs->count--;
+
+    return __ihs_obj(hs, node);
+}
+
+bool ihs_remove_obj(IHSet* hs, void* obj) {
+    if (!hs || !obj) return false;
+
+    IHSNode* node = __ihs_node(hs, obj);
+    IHSNode** link = &hs->buckets[__ihs_index(node->hash, hs->capacity)];
+
+    // Identity search: no comparator, no hasher
+    while (*link && *link != node) link = &(*link)->next;
+    if (!*link) return false;
+
+    *link = node->next;
+    node->next = NULL;
+
+    hs->count--;
+
+    return true;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Iteration                                  *
+ *                                                                            *
+ ******************************************************************************/
+
+void ihs_iter_init(IHSIterator* it, const IHSet* hs) {
+    if (!it) return;
+
+    it->hs = hs;
+    it->bucket = 0;
+    it->node = hs ? hs->buckets[0] : NULL;
+}
+
+void* ihs_iter_next(IHSIterator* it) {
+    if (!it || !it->hs) return NULL;
+
+    while (!it->node) {
+        if (++it->bucket >= it->hs->capacity) return NULL;
+
+        it->node = it->hs->buckets[it->bucket];
+    }
+
+    IHSNode* node = it->node;
+    it->node = node->next;  // read before returning, so the caller may unlink `node`
+
+    return __ihs_obj(it->hs, node);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                       Inner Functions Implementation                       *
+ *                                                                            *
+ ******************************************************************************/
+
+inline static void __il_link(IList* list, IListNode* prev, IListNode* next, IListNode* node) {
+    node->prev = prev;
+    node->next = next;
+
+    prev->next = node;
+    next->prev = node;
+
+    list->length++;
+}
+
+inline static size_t __ihs_buckets_for(size_t count, double load_factor) {
+    size_t needed = (size_t)((double)count / load_factor) + 1;
+
+    return needed < 4 ? 4 : bits_npo2(needed);
+}
+
+inline static IHSNode* __ihs_node(const IHSet* hs, const void* obj) {
+    return (IHSNode*)((char*)obj + hs->node_offset);
+}
+
+inline static void* __ihs_obj(const IHSet* hs, const IHSNode* node) {
+    return (char*)node - hs->node_offset;
+}
+
+inline static size_t __ihs_index(uint64_t hash, size_t capacity) {
+    return hash & (capacity - 1);
+}
+
+inline static IHSNode** __ihs_find_link(const IHSet* hs, const void* key, uint64_t hash) {
+    IHSNode** link = &hs->buckets[__ihs_index(hash, hs->capacity)];
+
+    while (*link) {
+        IHSNode* curr = *link;
+
+        if (curr->hash == hash && hs->cmp(__ihs_obj(hs, curr), key) == 0) return link;
+
+        link = &curr->next;
+    }
+
+    return NULL;
+}
+
+static bool __ihs_rehash(IHSet* hs, size_t new_capacity) {
+    IHSNode** new_buckets = (IHSNode**)calloc(new_capacity, sizeof(IHSNode*));
+    if (!new_buckets) return false;
+
+    // The cached hashes make this a pure relinking pass
+    for (size_t i = 0; i < hs->capacity; i++) {
+        IHSNode* curr = hs->buckets[i];
+
+        while (curr) {
+            IHSNode* next = curr->next;
+            size_t index = __ihs_index(curr->hash, new_capacity);
+
+            curr->next = new_buckets[index];
+            new_buckets[index] = curr;
+
+            curr = next;
+        }
+    }
+
+    free(hs->buckets);
+
+    ms_track(MS_IHSET, 0, ((int64_t)new_capacity - (int64_t)hs->capacity) * (int64_t)sizeof(IHSNode*));
+
+    hs->buckets = new_buckets;
+    hs->capacity = new_capacity;
+
+    return true;
+}
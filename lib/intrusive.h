@@ -0,0 +1,272 @@
+#ifndef INTRUSIVE_H
+#define INTRUSIVE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Nomenclature used (to avoid collisions): <data_type>_<method_name>
+// Warning: This implementation is not thread-safe, and is for educational purposes only.
+
+/// @brief Gets a pointer to the structure that embeds `ptr` as its `member` field.
+/// @param ptr Pointer to the embedded member (e.g., an `IListNode*`).
+/// @param type Type of the embedding structure.
+/// @param member Name of the member inside `type`.
+#define container_of(ptr, type, member) ((type*)((char*)(ptr) - offsetof(type, member)))
+
+/******************************************************************************
+ *                                                                            *
+ *                        Intrusive Doubly-Linked List                        *
+ *                                                                            *
+ ******************************************************************************/
+
+/**
+ * @brief Intrusive List Hook
+ *
+ * Embedded in the user's structure; the list links these hooks directly, so
+ * inserting or removing an element never allocates nor copies it. Recover the
+ * element with `container_of` (or `il_entry`).
+ */
+typedef struct IntrusiveListNode IListNode;
+
+struct IntrusiveListNode {
+    IListNode* prev;  ///< Previous hook (the list's sentinel for the first element).
+    IListNode* next;  ///< Next hook (the list's sentinel for the last element).
+};
+
+/**
+ * @brief Intrusive Doubly-Linked List
+ *
+ * Circular list around a sentinel hook, so every operation is branch-free of
+ * head/tail special cases. The list owns nothing: freeing the elements is up
+ * to the caller.
+ */
+typedef struct IntrusiveList IList;
+
+struct IntrusiveList {
+    IListNode head;  ///< Sentinel: `head.next` is the first element, `head.prev` the last.
+    size_t length;   ///< Number of linked elements.
+};
+
+/// @brief Gets the structure embedding the list hook `node`.
+#define il_entry(node, type, member) container_of(node, type, member)
+
+/// @brief Iterates over every hook of `list` (`it` is an `IListNode*`). The current hook must not be removed inside the loop; use `il_for_each_safe` for that.
+#define il_for_each(it, list) for (IListNode* it = (list)->head.next; it != &(list)->head; it = it->next)
+
+/// @brief Iterates over every hook of `list`, allowing the current hook `it` to be removed.
+#define il_for_each_safe(it, list) \
+    for (IListNode *it = (list)->head.next, *__il_next = it->next; it != &(list)->head; it = __il_next, __il_next = it->next)
+
+/// @brief Initializes an empty list.
+/// @param list Pointer to the list.
+void il_init(IList* list);
+
+/// @brief Initializes a hook as unlinked.
+/// @details Optional, but makes `il_is_linked` meaningful for hooks that were never inserted.
+/// @param node Pointer to the hook.
+void il_node_init(IListNode* node);
+
+/// @brief Checks whether a hook is currently linked into a list.
+/// @details Hooks are reset to the unlinked state when removed.
+/// @param node Pointer to the hook.
+/// @return `true` if the hook is linked.
+bool il_is_linked(const IListNode* node);
+
+/// @brief Gets the number of linked elements.
+/// @param list Pointer to the list.
+/// @return The list's length.
+size_t il_length(const IList* list);
+
+/// @brief Checks if the list is empty.
+/// @param list Pointer to the list.
+/// @return `true` if `list` is `NULL` or holds no element.
+bool il_is_empty(const IList* list);
+
+/// @brief Gets the first hook.
+/// @param list Pointer to the list.
+/// @return The first hook, or `NULL` if the list is empty.
+IListNode* il_first(const IList* list);
+
+/// @brief Gets the last hook.
+/// @param list Pointer to the list.
+/// @return The last hook, or `NULL` if the list is empty.
+IListNode* il_last(const IList* list);
+
+/// @brief Gets the hook following `node`.
+/// @param list Pointer to the list containing `node`.
+/// @param node Pointer to a linked hook.
+/// @return The next hook, or `NULL` if `node` is the last one.
+IListNode* il_next(const IList* list, const IListNode* node);
+
+/// @brief Gets the hook preceding `node`.
+/// @param list Pointer to the list containing `node`.
+/// @param node Pointer to a linked hook.
+/// @return The previous hook, or `NULL` if `node` is the first one.
+IListNode* il_prev(const IList* list, const IListNode* node);
+
+/// @brief Links `node` at the end of the list. O(1), allocation-free.
+/// @param list Pointer to the list.
+/// @param node Pointer to an unlinked hook.
+void il_push_back(IList* list, IListNode* node);
+
+/// @brief Links `node` at the front of the list. O(1), allocation-free.
+/// @param list Pointer to the list.
+/// @param node Pointer to an unlinked hook.
+void il_push_front(IList* list, IListNode* node);
+
+/// @brief Links `node` right before `pos`. O(1), allocation-free.
+/// @param list Pointer to the list containing `pos`.
+/// @param pos Pointer to a linked hook.
+/// @param node Pointer to an unlinked hook.
+void il_insert_before(IList* list, IListNode* pos, IListNode* node);
+
+/// @brief Links `node` right after `pos`. O(1), allocation-free.
+/// @param list Pointer to the list containing `pos`.
+/// @param pos Pointer to a linked hook.
+/// @param node Pointer to an unlinked hook.
+void il_insert_after(IList* list, IListNode* pos, IListNode* node);
+
+/// @brief Unlinks `node` from the list. O(1).
+/// @param list Pointer to the list containing `node`.
+/// @param node Pointer to a linked hook; it is left unlinked.
+void il_remove(IList* list, IListNode* node);
+
+/// @brief Unlinks and returns the first hook.
+/// @param list Pointer to the list.
+/// @return The unlinked hook, or `NULL` if the list is empty.
+IListNode* il_pop_front(IList* list);
+
+/// @brief Unlinks and returns the last hook.
+/// @param list Pointer to the list.
+/// @return The unlinked hook, or `NULL` if the list is empty.
+IListNode* il_pop_back(IList* list);
+
+/// @brief Moves every element of `src` to the end of `dest`. O(1).
+/// @param dest Pointer to the destination list.
+/// @param src Pointer to the source list (left empty).
+void il_splice_back(IList* dest, IList* src);
+
+/******************************************************************************
+ *                                                                            *
+ *                             Intrusive Hash Set                             *
+ *                                                                            *
+ ******************************************************************************/
+
+/**
+ * @brief Intrusive Hash Set Hook
+ *
+ * Embedded in the user's structure. Caches the element's hash so rehashing
+ * and probing never call the hasher again.
+ */
+typedef struct IntrusiveHashSetNode IHSNode;
+
+struct IntrusiveHashSetNode {
+    IHSNode* next;  ///< Next hook in the same bucket.
+    uint64_t hash;  ///< Cached hash of the embedding element.
+};
+
+/**
+ * @brief Intrusive Hash Set
+ *
+ * Indexes existing objects through an embedded `IHSNode` located at
+ * `node_offset` inside them (`offsetof(type, member)`). Like `HSet` it uses
+ * separate chaining with seeded hashing, but it neither copies keys nor
+ * allocates nodes: insert and remove are allocation-free, and only growing the
+ * bucket array allocates (avoidable with `ihs_new_with_capacity`). The set owns
+ * nothing but its buckets. `cmp` and `hasher` receive pointers to the
+ * embedding objects.
+ */
+typedef struct IntrusiveHashSet IHSet;
+
+struct IntrusiveHashSet {
+    IHSNode** buckets;   ///< Bucket heads (`capacity` entries).
+    size_t count;        ///< Number of linked elements.
+    size_t capacity;     ///< Number of buckets, always a power of two.
+    size_t node_offset;  ///< Offset of the `IHSNode` hook inside each element.
+
+    uint64_t seed_0;  ///< Hash seeds, random per set.
+    uint64_t seed_1;
+
+    double load_factor;  ///< Maximum `count / capacity` before the buckets double.
+
+    int (*cmp)(const void* a, const void* b);                               ///< Returns 0 if two elements are equal.
+    uint64_t (*hasher)(const void* obj, uint64_t seed_0, uint64_t seed_1);  ///< Hashes an element.
+};
+
+/// @brief Iterator over an `IHSet` (plain value, no allocation).
+typedef struct IntrusiveHashSetIterator {
+    const IHSet* hs;  ///< The set being iterated.
+    size_t bucket;    ///< Current bucket.
+    IHSNode* node;    ///< Next hook to return in the current bucket.
+} IHSIterator;
+
+/// @brief Allocates a new, empty intrusive hash set.
+/// @param node_offset `offsetof(type, member)` of the `IHSNode` hook in the indexed type.
+/// @param cmp Pointer to the comparator (returns 0 for equal elements).
+/// @param hasher Pointer to the seeded hash function.
+/// @return Pointer to the newly allocated `IHSet`, or `NULL` on failure.
+IHSet* ihs_new(size_t node_offset, int (*cmp)(const void* a, const void* b), uint64_t (*hasher)(const void* obj, uint64_t seed_0, uint64_t seed_1));
+
+/// @brief Allocates a new intrusive hash set with buckets for at least `capacity` elements, so up to that many inserts never allocate.
+/// @param node_offset `offsetof(type, member)` of the `IHSNode` hook in the indexed type.
+/// @param cmp Pointer to the comparator (returns 0 for equal elements).
+/// @param hasher Pointer to the seeded hash function.
+/// @param capacity Expected number of elements.
+/// @return Pointer to the newly allocated `IHSet`, or `NULL` on failure.
+IHSet* ihs_new_with_capacity(size_t node_offset, int (*cmp)(const void* a, const void* b), uint64_t (*hasher)(const void* obj, uint64_t seed_0, uint64_t seed_1), size_t capacity);
+
+/// @brief Frees the set's buckets and structure. The indexed objects are left untouched (but their hooks dangle).
+/// @param hs Pointer to the set.
+void ihs_free(IHSet* hs);
+
+/// @brief Unlinks every element, keeping the buckets.
+/// @param hs Pointer to the set.
+void ihs_clear(IHSet* hs);
+
+/// @brief Gets the number of linked elements.
+/// @param hs Pointer to the set.
+/// @return The number of elements.
+size_t ihs_count(const IHSet* hs);
+
+/// @brief Links `obj` into the set. Copy-free; allocates only if the buckets must grow.
+/// @param hs Pointer to the set.
+/// @param obj Pointer to the object embedding an unlinked hook.
+/// @return `true` if linked, `false` if an equal object is already present (or on error).
+bool ihs_insert(IHSet* hs, void* obj);
+
+/// @brief Finds the linked object equal to `key`.
+/// @param hs Pointer to the set.
+/// @param key Pointer to an object of the indexed type (only the fields used by `cmp`/`hasher` need to be set).
+/// @return The linked object, or `NULL` if not found.
+void* ihs_find(const IHSet* hs, const void* key);
+
+/// @brief Unlinks and returns the object equal to `key`. Allocation-free.
+/// @param hs Pointer to the set.
+/// @param key Pointer to an object of the indexed type.
+/// @return The unlinked object, or `NULL` if not found.
+void* ihs_remove(IHSet* hs, const void* key);
+
+/// @brief Unlinks `obj` itself (identity, not equality), using its cached hash. Allocation-free.
+/// @param hs Pointer to the set.
+/// @param obj Pointer to a linked object.
+/// @return `true` if `obj` was linked in `hs`.
+bool ihs_remove_obj(IHSet* hs, void* obj);
+
+/// @brief Grows the buckets to hold at least `new_capacity` elements without exceeding the load factor.
+/// @param hs Pointer to the set.
+/// @param new_capacity Expected number of elements.
+/// @return `true` on success (or if already large enough), `false` on allocation failure.
+bool ihs_reserve(IHSet* hs, size_t new_capacity);
+
+/// @brief Initializes an iterator over `hs`.
+/// @param it Pointer to the iterator.
+/// @param hs Pointer to the set (must not be modified during the iteration, except through `ihs_remove_obj` of the returned object).
+void ihs_iter_init(IHSIterator* it, const IHSet* hs);
+
+/// @brief Advances the iterator.
+/// @param it Pointer to the iterator.
+/// @return The next object, or `NULL` at the end.
+void* ihs_iter_next(IHSIterator* it);
+
+#endif  // INTRUSIVE_H
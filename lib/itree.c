@@ -0,0 +1,576 @@
+#include "itree.h"
+
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "radix_sort.h"
+#include "random.h"
+#include "treap_core.h"
+
+/// Offset of the value inside a node: the header rounded up to the strictest fundamental alignment.
+#define __ITREE_DATA_OFFSET ((sizeof(ITNode) + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1))
+
+/// Subtrees of the static index at or below this level are scanned linearly.
+#define __IIDX_SCAN_LEVEL 3
+
+/******************************************************************************
+ *                                                                            *
+ *                              Inner Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+inline static void* __itree_value(const ITNode* node);
+inline static ITNode* __itree_node(const void* value);
+inline static void __itree_update(ITNode* node);
+// orders nodes by `(start, end)`, then by address so that equal intervals stay distinct
+inline static bool __itree_less(const ITNode* a, const ITNode* b);
+// the treap-core hooks: nodes are their own keys
+inline static int __itree_cmp(const ITree* it, const ITNode* node, const ITNode* k);
+inline static const ITNode* __itree_key(const ITNode* node);
+// splits `node` into the nodes ordered before `k` (`*l`) and the others (`*r`)
+static void __itree_split(const ITree* it, ITNode* node, const ITNode* k, ITNode** l, ITNode** r);
+static ITNode* __itree_merge(ITNode* l, ITNode* r);
+static ITNode* __itree_insert(const ITree* it, ITNode* node, ITNode* fresh);
+static ITNode* __itree_erase(ITNode* node, const ITNode* target, bool* found);
+// finds a node with exactly these bounds
+static ITNode* __itree_find(ITNode* node, int64_t start, int64_t end);
+static void __itree_free_subtree(ITree* it, ITNode* node);
+static size_t __itree_owned(const ITNode* node, size_t (*owned_size)(const void* k));
+// reports the overlaps of $[lo, hi)$ in `node`'s subtree; returns `false` once `fn` asked to stop
+static bool __itree_overlap(ITNode* node, int64_t lo, int64_t hi, bool (*fn)(int64_t start, int64_t end, void* value, void* ctx), void* ctx, size_t* reported);
+// fills in the subtree maxima of the implicit tree and returns the root level
+static int __iidx_index(IIEntry* entries, size_t n);
+static int __iidx_entry_cmp(const void* a, const void* b);
+static int __iidx_i64_cmp(const void* a, const void* b);
+// number of sorted ends not greater than `x`
+static size_t __iidx_ends_upto(const IIndex* idx, int64_t x);
+// number of entries starting before `x`
+static size_t __iidx_starts_before(const IIndex* idx, int64_t x);
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+ITree* itree_new(size_t value_size, void (*copier)(void* dest, const void* src), void (*deallocator)(void* k)) {
+    if (value_size > 0 && (!copier || !deallocator)) return NULL;
+
+    ITree* it = (ITree*)malloc(sizeof(ITree));
+    if (!it) return NULL;
+
+    it->pool = pool_new(__ITREE_DATA_OFFSET + value_size, alignof(max_align_t), ITREE_NODES_PER_SLAB);
+    if (!it->pool) {
+        free(it);
+        return NULL;
+    }
+
+    it->root = NULL;
+    it->count = 0;
+    it->value_size = value_size;
+
+    it->rng_state = __random_u64();
+    if (it->rng_state == 0) it->rng_state = 0x9E3779B97F4A7C15ULL;  // xorshift must not start at 0
+
+    it->copier = copier;
+    it->deallocator = deallocator;
+
+    ms_track(MS_ITREE, 1, (int64_t)sizeof(ITree));
+
+    return it;
+}
+
+IIndex* iidx_new(const DArray* da, void (*bounds)(const void* e, int64_t* start, int64_t* end)) {
+    if (!da || !bounds) return NULL;
+
+    const size_t n = da->length;
+    const char* arr = (const char*)da->arr;
+
+    IIndex* idx = (IIndex*)malloc(sizeof(IIndex));
+    if (!idx) return NULL;
+
+    idx->count = n;
+    idx->entries = (IIEntry*)malloc((n ? n : 1) * sizeof(IIEntry));
+    idx->ends = (int64_t*)malloc((n ? n : 1) * sizeof(int64_t));
+
+    if (!idx->entries || !idx->ends) {
+        free(idx->entries);
+        free(idx->ends);
+        free(idx);
+        return NULL;
+    }
+
+    bool starts_sorted = true, ends_sorted = true;
+
+    for (size_t i = 0; i < n; i++) {
+        IIEntry* entry = &idx->entries[i];
+
+        bounds(arr + i * da->element_size, &entry->start, &entry->end);
+        entry->id = i;
+
+        if (entry->end < entry->start) {
+            free(idx->entries);
+            free(idx->ends);
+            free(idx);
+            return NULL;
+        }
+
+        idx->ends[i] = entry->end;
+
+        if (i > 0) {
+            starts_sorted &= entry[-1].start <= entry->start;
+            ends_sorted &= idx->ends[i - 1] <= idx->ends[i];
+        }
+    }
+
+    // Radix sorting needs a scratch copy; fall back to an in-place sort without one
+    if (!starts_sorted && !__radix_sort(idx->entries, n, sizeof(IIEntry), 1, 1ULL << 63)) qsort(idx->entries, n, sizeof(IIEntry), __iidx_entry_cmp);
+    if (!ends_sorted && !__radix_sort(idx->ends, n, sizeof(int64_t), 1, 1ULL << 63)) qsort(idx->ends, n, sizeof(int64_t), __iidx_i64_cmp);
+
+    idx->root_level = __iidx_index(idx->entries, n);
+
+    ms_track(MS_IIDX, 1, (int64_t)(sizeof(IIndex) + n * (sizeof(IIEntry) + sizeof(int64_t))));
+
+    return idx;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                             Clean Up & Freeing                             *
+ *                                                                            *
+ ******************************************************************************/
+
+void itree_free(ITree* it) {
+    if (!it) return;
+
+    itree_clear(it);
+    pool_release(it->pool);
+
+    ms_track(MS_ITREE, -1, -(int64_t)sizeof(ITree));
+
+    free(it);
+}
+
+void itree_clear(ITree* it) {
+    if (!it) return;
+
+    __itree_free_subtree(it, it->root);
+
+    it->root = NULL;
+    it->count = 0;
+}
+
+void iidx_free(IIndex* idx) {
+    if (!idx) return;
+
+    ms_track(MS_IIDX, -1, -(int64_t)(sizeof(IIndex) + idx->count * (sizeof(IIEntry) + sizeof(int64_t))));
+
+    free(idx->entries);
+    free(idx->ends);
+    free(idx);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Basic Getters                                *
+ *                                                                            *
+ ******************************************************************************/
+
+size_t itree_count(const ITree* it) {
+    return it ? it->count : 0;
+}
+
+bool itree_is_empty(const ITree* it) {
+    return !it || it->count == 0;
+}
+
+void itree_bounds(const void* value, int64_t* start, int64_t* end) {
+    if (!value) return;
+
+    const ITNode* node = __itree_node(value);
+
+    if (start) *start = node->start;
+    if (end) *end = node->end;
+}
+
+size_t iidx_count(const IIndex* idx) {
+    return idx ? idx->count : 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                            Insertion & Removal                             *
+ *                                                                            *
+ ******************************************************************************/
+
+void* itree_insert(ITree* it, int64_t start, int64_t end, const void* value) {
+    if (!it || end < start || (it->value_size > 0 && !value)) return NULL;
+
+    ITNode* node = (ITNode*)pool_alloc(it->pool);
+    if (!node) return NULL;
+
+    node->left = NULL;
+    node->right = NULL;
+    node->priority = __treap_next_priority(&it->rng_state);
+    node->start = start;
+    node->end = end;
+    node->max_end = end;
+
+    if (it->value_size > 0) it->copier(__itree_value(node), value);
+
+    it->root = __itree_insert(it, it->root, node);
+    it->count++;
+
+    return __itree_value(node);
+}
+
+bool itree_erase(ITree* it, void* value) {
+    if (!it || !value) return false;
+
+    ITNode* node = __itree_node(value);
+    bool found = false;
+
+    it->root = __itree_erase(it->root, node, &found);
+    if (!found) return false;
+
+    if (it->value_size > 0) it->deallocator(value);
+    pool_free(it->pool, node);
+    it->count--;
+
+    return true;
+}
+
+bool itree_remove(ITree* it, int64_t start, int64_t end) {
+    if (!it) return false;
+
+    ITNode* node = __itree_find(it->root, start, end);
+
+    return node && itree_erase(it, __itree_value(node));
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                              Overlap Queries                               *
+ *                                                                            *
+ ******************************************************************************/
+
+size_t itree_overlap(const ITree* it, int64_t lo, int64_t hi, bool (*fn)(int64_t start, int64_t end, void* value, void* ctx), void* ctx) {
+    if (!it || lo >= hi) return 0;
+
+    size_t reported = 0;
+    __itree_overlap(it->root, lo, hi, fn, ctx, &reported);
+
+    return reported;
+}
+
+size_t itree_count_overlap(const ITree* it, int64_t lo, int64_t hi) {
+    return itree_overlap(it, lo, hi, NULL, NULL);
+}
+
+size_t iidx_overlap(const IIndex* idx, int64_t lo, int64_t hi, bool (*fn)(int64_t start, int64_t end, size_t id, void* ctx), void* ctx) {
+    if (!idx || idx->count == 0 || lo >= hi) return 0;
+
+    const IIEntry* r = idx->entries;
+    const size_t n = idx->count;
+    size_t reported = 0;
+
+    // Explicit stack of (node, level, left child done); the depth is bounded by the root level
+    struct {
+        size_t x;
+        int k;
+        bool left_done;
+    } stack[64];
+    int top = 0;
+
+    stack[top].x = ((size_t)1 << idx->root_level) - 1;
+    stack[top].k = idx->root_level;
+    stack[top++].left_done = false;
+
+    while (top) {
+        const size_t x = stack[--top].x;
+        const int k = stack[top].k;
+        const bool left_done = stack[top].left_done;
+
+        if (k <= __IIDX_SCAN_LEVEL) {
+            // Small subtree: scan its whole span, which is sorted by start
+            size_t i = x >> k << k;
+            size_t i1 = i + ((size_t)1 << (k + 1)) - 1;
+            if (i1 > n) i1 = n;
+
+            for (; i < i1 && r[i].start < hi; i++) {
+                if (lo < r[i].end) {
+                    reported++;
+                    if (fn && !fn(r[i].start, r[i].end, r[i].id, ctx)) return reported;
+                }
+            }
+        } else if (!left_done) {
+            // Revisit this node after its left child, which may lie past the end of the array
+            const size_t y = x - ((size_t)1 << (k - 1));
+
+            stack[top].x = x;
+            stack[top].k = k;
+            stack[top++].left_done = true;
+
+            if (y >= n || r[y].max > lo) {
+                stack[top].x = y;
+                stack[top].k = k - 1;
+                stack[top++].left_done = false;
+            }
+        } else if (x < n && r[x].start < hi) {
+            if (lo < r[x].end) {
+                reported++;
+                if (fn && !fn(r[x].start, r[x].end, r[x].id, ctx)) return reported;
+            }
+
+            stack[top].x = x + ((size_t)1 << (k - 1));
+            stack[top].k = k - 1;
+            stack[top++].left_done = false;
+        }
+    }
+
+    return reported;
+}
+
+size_t iidx_count_overlap(const IIndex* idx, int64_t lo, int64_t hi) {
+    if (!idx || lo >= hi) return 0;
+
+    // Every interval ending at or before `lo` also starts before `hi`, since `start <= end`
+    return __iidx_starts_before(idx, hi) - __iidx_ends_upto(idx, lo);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                             Memory Accounting                              *
+ *                                                                            *
+ ******************************************************************************/
+
+MemUsage itree_memory_usage(const ITree* it, size_t (*owned_size)(const void* k)) {
+    MemUsage mu = {0, 0, 0, 0, 0};
+    if (!it) return mu;
+
+    const size_t padding = it->pool->block_size - __ITREE_DATA_OFFSET - it->value_size;
+
+    mu.payload = it->count * it->value_size;
+    mu.metadata = sizeof(ITree) + it->count * __ITREE_DATA_OFFSET;
+    mu.slack = it->count * padding;
+    mu.overhead = ms_usable_size(it, sizeof(ITree)) - sizeof(ITree);
+
+    if (owned_size && it->value_size > 0) mu.owned = __itree_owned(it->root, owned_size);
+
+    return mu;
+}
+
+MemUsage iidx_memory_usage(const IIndex* idx) {
+    MemUsage mu = {0, 0, 0, 0, 0};
+    if (!idx) return mu;
+
+    const size_t entries = idx->count * sizeof(IIEntry);
+    const size_t ends = idx->count * sizeof(int64_t);
+
+    mu.payload = idx->count * 2 * sizeof(int64_t);
+    mu.metadata = sizeof(IIndex) + entries - mu.payload + ends;
+    mu.overhead = ms_usable_size(idx, sizeof(IIndex)) - sizeof(IIndex);
+    mu.overhead += ms_usable_size(idx->entries, entries) - entries;
+    mu.overhead += ms_usable_size(idx->ends, ends) - ends;
+
+    return mu;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                       Inner Functions Implementation                       *
+ *                                                                            *
+ ******************************************************************************/
+
+inline static void* __itree_value(const ITNode* node) {
+    return (char*)node + __ITREE_DATA_OFFSET;
+}
+
+inline static ITNode* __itree_node(const void* value) {
+    return (ITNode*)((char*)value - __ITREE_DATA_OFFSET);
+}
+
+inline static void __itree_update(ITNode* node) {
+    int64_t m = node->end;
+
+    if (node->left && node->left->max_end > m) m = node->left->max_end;
+    if (node->right && node->right->max_end > m) m = node->right->max_end;
+
+    node->max_end = m;
+}
+
+inline static bool __itree_less(const ITNode* a, const ITNode* b) {
+    if (a->start != b->start) return a->start < b->start;
+    if (a->end != b->end) return a->end < b->end;
+
+    return (uintptr_t)a < (uintptr_t)b;
+}
+
+inline static int __itree_cmp(const ITree* it, const ITNode* node, const ITNode* k) {
+    (void)it;
+
+    return __itree_less(node, k) ? -1 : __itree_less(k, node);
+}
+
+inline static const ITNode* __itree_key(const ITNode* node) {
+    return node;
+}
+
+DEFINE_TREAP_CORE(__itree, ITNode, const ITree*, const ITNode*, __itree_cmp, __itree_key, __itree_update)
+
+static ITNode* __itree_erase(ITNode* node, const ITNode* target, bool* found) {
+    if (!node) return NULL;
+
+    if (node == target) {
+        *found = true;
+        return __itree_merge(node->left, node->right);
+    }
+
+    if (__itree_less(target, node)) {
+        node->left = __itree_erase(node->left, target, found);
+    } else {
+        node->right = __itree_erase(node->right, target, found);
+    }
+
+    __itree_update(node);
+
+    return node;
+}
+
+static ITNode* __itree_find(ITNode* node, int64_t start, int64_t end) {
+    while (node) {
+        if (start == node->start && end == node->end) return node;
+
+        const bool less = start != node->start ? start < node->start : end < node->end;
+        node = less ? node->left : node->right;
+    }
+
+    return NULL;
+}
+
+static void __itree_free_subtree(ITree* it, ITNode* node) {
+    if (!node) return;
+
+    __itree_free_subtree(it, node->left);
+    __itree_free_subtree(it, node->right);
+
+    if (it->value_size > 0) it->deallocator(__itree_value(node));
+    pool_free(it->pool, node);
+}
+
+static size_t __itree_owned(const ITNode* node, size_t (*owned_size)(const void* k)) {
+    size_t owned = 0;
+
+    while (node) {
+        owned += __itree_owned(node->left, owned_size) + owned_size(__itree_value(node));
+        node = node->right;
+    }
+
+    return owned;
+}
+
+static bool __itree_overlap(ITNode* node, int64_t lo, int64_t hi, bool (*fn)(int64_t start, int64_t end, void* value, void* ctx), void* ctx, size_t* reported) {
+    // Nothing below ends after `lo`; nothing to the right starts before `hi` once this node does not
+    while (node && node->max_end > lo) {
+        if (!__itree_overlap(node->left, lo, hi, fn, ctx, reported)) return false;
+
+        if (node->start >= hi) return true;
+
+        if (lo < node->end) {
+            (*reported)++;
+            if (fn && !fn(node->start, node->end, __itree_value(node), ctx)) return false;
+        }
+
+        node = node->right;
+    }
+
+    return true;
+}
+
+static int __iidx_index(IIEntry* entries, size_t n) {
+    if (n == 0) return -1;
+
+    // Leaves (even positions) cover only themselves
+    size_t last_i = 0;
+    int64_t last = 0;
+
+    for (size_t i = 0; i < n; i += 2) {
+        last_i = i;
+        last = entries[i].max = entries[i].end;
+    }
+
+    // `last` tracks the maximum of the rightmost existing subtree, standing in for missing right children
+    int k = 1;
+
+    for (; ((size_t)1 << k) <= n; k++) {
+        const size_t x = (size_t)1 << (k - 1);
+
+        for (size_t i = (x << 1) - 1; i < n; i += x << 2) {
+            int64_t e = entries[i].end;
+
+            const int64_t el = entries[i - x].max;
+            const int64_t er = i + x < n ? entries[i + x].max : last;
+
+            if (el > e) e = el;
+            if (er > e) e = er;
+
+            entries[i].max = e;
+        }
+
+        last_i = (last_i >> k & 1) ? last_i - x : last_i + x;
+        if (last_i < n && entries[last_i].max > last) last = entries[last_i].max;
+    }
+
+    return k - 1;
+}
+
+static int __iidx_entry_cmp(const void* a, const void* b) {
+    const IIEntry* x = (const IIEntry*)a;
+    const IIEntry* y = (const IIEntry*)b;
+
+    if (x->start != y->start) return (x->start > y->start) - (x->start < y->start);
+
+    return (x->id > y->id) - (x->id < y->id);
+}
+
+static int __iidx_i64_cmp(const void* a, const void* b) {
+    const int64_t x = *(const int64_t*)a;
+    const int64_t y = *(const int64_t*)b;
+
+    return (x > y) - (x < y);
+}
+
+static size_t __iidx_ends_upto(const IIndex* idx, int64_t x) {
+    size_t lo = 0, hi = idx->count;
+
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+
+        if (idx->ends[mid] <= x) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+static size_t __iidx_starts_before(const IIndex* idx, int64_t x) {
+    size_t lo = 0, hi = idx->count;
+
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+
+        if (idx->entries[mid].start < x) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
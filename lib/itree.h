@@ -0,0 +1,246 @@
+#ifndef ITREE_H
+#define ITREE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "darray.h"
+#include "memstat.h"
+#include "pool.h"
+
+// Nomenclature used (to avoid collisions): <data_type>_<method_name>
+// Warning: This implementation is not thread-safe, and is for educational purposes only.
+//
+// Intervals are half-open: $[start, end)$ overlaps the query $[lo, hi)$ iff `start < hi && lo < end`.
+// A point query for `p` is the range $[p, p + 1)$.
+
+/// Number of nodes carved from each slab of the node pool.
+#define ITREE_NODES_PER_SLAB 256
+
+/**
+ * @brief Interval Tree Node
+ *
+ * The value is stored inline right after this header.
+ */
+typedef struct IntervalTreeNode ITNode;
+
+struct IntervalTreeNode {
+    ITNode* left;       ///< Left child (smaller `(start, end)`).
+    ITNode* right;      ///< Right child (greater `(start, end)`).
+    uint64_t priority;  ///< Random heap priority: a node's priority is never lower than its children's.
+    int64_t start;      ///< Inclusive start of the interval.
+    int64_t end;        ///< Exclusive end of the interval.
+    int64_t max_end;    ///< Greatest `end` in this subtree.
+};
+
+/**
+ * @brief Interval Tree (Dynamic, generic over the attached value)
+ *
+ * A treap ordered by `(start, end)` where every node also records the greatest
+ * `end` of its subtree, so overlap queries skip the subtrees ending before the
+ * query in expected O(log n + k) for k reported intervals. Duplicate intervals
+ * are allowed: each insertion returns a handle (the stored value) that stays
+ * valid until that interval is erased.
+ */
+typedef struct IntervalTree ITree;
+
+struct IntervalTree {
+    ITNode* root;  ///< Root node (`NULL` if empty).
+
+    size_t count;       ///< Number of intervals.
+    size_t value_size;  ///< Size of the value attached to each interval in bytes (may be 0).
+
+    uint64_t rng_state;  ///< Xorshift state for node priorities, seeded from `/dev/urandom`.
+
+    Pool* pool;  ///< Node allocator.
+
+    void (*copier)(void* dest, const void* src);  ///< Copies a value into its node.
+    void (*deallocator)(void* k);                 ///< Frees the resources of a value being removed.
+};
+
+/**
+ * @brief Entry of a static interval index.
+ */
+typedef struct IntervalIndexEntry IIEntry;
+
+struct IntervalIndexEntry {
+    int64_t start;  ///< Inclusive start of the interval.
+    int64_t end;    ///< Exclusive end of the interval.
+    int64_t max;    ///< Greatest `end` in the implicit subtree rooted here.
+    size_t id;      ///< Position of the interval in the source `DArray`.
+};
+
+/**
+ * @brief Interval Index (Static, cache-friendly)
+ *
+ * An implicit interval tree in the style of cgranges: the intervals are kept
+ * in one array sorted by start, and the array itself is the tree. Leaves are
+ * the even positions, and the node at level k has its k lowest bits set, with
+ * children $\pm 2^{k-1}$ away. Each entry records the greatest end of its
+ * subtree. Queries walk down from the root and scan small subtrees linearly,
+ * reporting overlaps in start order.
+ *
+ * A second array of the ends, sorted on their own, answers counting queries in
+ * O(log n) with two binary searches: the overlaps of $[lo, hi)$ are the
+ * intervals starting before `hi` minus those ending at or before `lo`.
+ */
+typedef struct IntervalIndex IIndex;
+
+struct IntervalIndex {
+    IIEntry* entries;  ///< Intervals sorted by start, laid out as an implicit tree.
+    int64_t* ends;     ///< Every `end`, sorted.
+    size_t count;      ///< Number of intervals.
+    int root_level;    ///< Level of the root node (`-1` if empty).
+};
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Creates a new, empty interval tree.
+/// @param value_size The size of the value attached to each interval in bytes (0 for bare intervals).
+/// @param copier Pointer to the deep copy function (may be `NULL` if `value_size` is 0).
+/// @param deallocator Pointer to the deallocation function (may be `NULL` if `value_size` is 0).
+/// @return A pointer to the newly allocated `ITree`, or `NULL` on failure.
+ITree* itree_new(size_t value_size, void (*copier)(void* dest, const void* src), void (*deallocator)(void* k));
+
+/// @brief Builds a static interval index over the elements of a `DArray`. O(n log n).
+/// @details Already sorted input skips the sort. The elements are not copied: queries report their position in `da`.
+/// @param da Pointer to the dynamic array (not modified).
+/// @param bounds Extracts the `[start, end)` bounds of an element.
+/// @return A pointer to the newly allocated `IIndex`, or `NULL` if an interval has `end < start` or on failure.
+IIndex* iidx_new(const DArray* da, void (*bounds)(const void* e, int64_t* start, int64_t* end));
+
+/******************************************************************************
+ *                                                                            *
+ *                             Clean Up & Freeing                             *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Frees the tree and its values.
+/// @param it Pointer to the interval tree.
+void itree_free(ITree* it);
+
+/// @brief Removes every interval (deallocating the values).
+/// @param it Pointer to the interval tree.
+void itree_clear(ITree* it);
+
+/// @brief Frees the index.
+/// @param idx Pointer to the interval index.
+void iidx_free(IIndex* idx);
+
+/******************************************************************************
+ *                                                                            *
+ *                               Basic Getters                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Gets the number of intervals.
+/// @param it Pointer to the interval tree.
+/// @return The number of intervals.
+size_t itree_count(const ITree* it);
+
+/// @brief Checks if the tree is empty.
+/// @param it Pointer to the interval tree.
+/// @return `true` if `it` is `NULL` or holds no interval.
+bool itree_is_empty(const ITree* it);
+
+/// @brief Gets the bounds of a stored interval.
+/// @param value Handle returned by `itree_insert`.
+/// @param start Receives the inclusive start.
+/// @param end Receives the exclusive end.
+void itree_bounds(const void* value, int64_t* start, int64_t* end);
+
+/// @brief Gets the number of intervals.
+/// @param idx Pointer to the interval index.
+/// @return The number of intervals.
+size_t iidx_count(const IIndex* idx);
+
+/******************************************************************************
+ *                                                                            *
+ *                            Insertion & Removal                             *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Inserts the interval $[start, end)$ with a copy of `value`. Expected O(log n).
+/// @param it Pointer to the interval tree.
+/// @param start Inclusive start.
+/// @param end Exclusive end (not less than `start`).
+/// @param value Pointer to the value (ignored if `value_size` is 0).
+/// @return The stored value, a handle for `itree_erase`, or `NULL` if `end < start` or on failure.
+void* itree_insert(ITree* it, int64_t start, int64_t end, const void* value);
+
+/// @brief Removes (and deallocates) the interval owning `value`. Expected O(log n).
+/// @param it Pointer to the interval tree.
+/// @param value Handle returned by `itree_insert`.
+/// @return `true` if the interval was found and removed.
+bool itree_erase(ITree* it, void* value);
+
+/// @brief Removes (and deallocates) one interval with exactly these bounds. Expected O(log n).
+/// @param it Pointer to the interval tree.
+/// @param start Inclusive start.
+/// @param end Exclusive end.
+/// @return `true` if an interval was removed.
+bool itree_remove(ITree* it, int64_t start, int64_t end);
+
+/******************************************************************************
+ *                                                                            *
+ *                              Overlap Queries                               *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Calls `fn` on every interval overlapping $[lo, hi)$, in `(start, end)` order. Expected O(log n + k).
+/// @param it Pointer to the interval tree.
+/// @param lo Inclusive start of the query.
+/// @param hi Exclusive end of the query.
+/// @param fn Callback receiving the bounds, the value and `ctx`; returning `false` stops the query.
+/// @param ctx Opaque pointer passed to `fn`.
+/// @return The number of intervals passed to `fn`.
+size_t itree_overlap(const ITree* it, int64_t lo, int64_t hi, bool (*fn)(int64_t start, int64_t end, void* value, void* ctx), void* ctx);
+
+/// @brief Counts the intervals overlapping $[lo, hi)$. Expected O(log n + k).
+/// @param it Pointer to the interval tree.
+/// @param lo Inclusive start of the query.
+/// @param hi Exclusive end of the query.
+/// @return The number of overlapping intervals.
+size_t itree_count_overlap(const ITree* it, int64_t lo, int64_t hi);
+
+/// @brief Calls `fn` on every interval overlapping $[lo, hi)$, in start order. O(log n + k).
+/// @param idx Pointer to the interval index.
+/// @param lo Inclusive start of the query.
+/// @param hi Exclusive end of the query.
+/// @param fn Callback receiving the bounds, the position in the source `DArray` and `ctx`; returning `false` stops the query.
+/// @param ctx Opaque pointer passed to `fn`.
+/// @return The number of intervals passed to `fn`.
+size_t iidx_overlap(const IIndex* idx, int64_t lo, int64_t hi, bool (*fn)(int64_t start, int64_t end, size_t id, void* ctx), void* ctx);
+
+/// @brief Counts the intervals overlapping $[lo, hi)$ without visiting them. O(log n).
+/// @param idx Pointer to the interval index.
+/// @param lo Inclusive start of the query.
+/// @param hi Exclusive end of the query.
+/// @return The number of overlapping intervals.
+size_t iidx_count_overlap(const IIndex* idx, int64_t lo, int64_t hi);
+
+/******************************************************************************
+ *                                                                            *
+ *                             Memory Accounting                              *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Breaks down the memory used by the tree's values and nodes.
+/// @details `payload` is the values, `metadata` the structure and node headers (including the bounds), and `overhead` the allocator's rounding of the structure.
+/// @param it Pointer to the interval tree.
+/// @param owned_size Returns the bytes owned by a value (may be `NULL`).
+/// @return The breakdown (zeroed if `it` is `NULL`).
+MemUsage itree_memory_usage(const ITree* it, size_t (*owned_size)(const void* k));
+
+/// @brief Breaks down the memory used by the index.
+/// @details `payload` is the bounds of the intervals, `metadata` the structure, the subtree maxima, the ids and the sorted ends, and `overhead` the allocator's rounding.
+/// @param idx Pointer to the interval index.
+/// @return The breakdown (zeroed if `idx` is `NULL`).
+MemUsage iidx_memory_usage(const IIndex* idx);
+
+#endif  // ITREE_H
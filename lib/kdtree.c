@@ -0,0 +1,528 @@
+#include "kdtree.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "par_for.h"
+
+/// Ranges this small are sorted outright instead of partitioned further.
+#define __KD_SELECT_CUTOFF 16
+
+/// Points sampled to pick a split dimension, and pivot candidates sampled per partition round.
+#define __KD_SPREAD_SAMPLE 64
+#define __KD_PIVOT_SAMPLE 15
+
+/******************************************************************************
+ *                                                                            *
+ *                              Inner Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+/// Shared state of a build.
+typedef struct KDTreeBuild {
+    KDTree* kd;
+    size_t spawn_depth;
+} KDBuild;
+
+/// Arguments of a subtree build running on its own thread.
+typedef struct KDTreeBuildTask {
+    const KDBuild* build;
+    size_t node;
+    size_t lo;
+    size_t hi;
+    size_t level;
+} KDBuildTask;
+
+/// State of a k-nearest-neighbours query.
+typedef struct KDTreeKnn {
+    const KDTree* kd;
+    const float* q;
+    KDNeighbor* heap;  ///< Max-heap on `dist2` of the best candidates so far.
+    size_t k;
+    size_t size;
+    float off[KD_MAX_DIM];  ///< Per-dimension distance from `q` to the current cell.
+} KDKnn;
+
+/// State of a radius query.
+typedef struct KDTreeRadius {
+    const KDTree* kd;
+    const float* q;
+    float r2;
+    bool (*fn)(const KDNeighbor* nb, void* ctx);
+    void* ctx;
+    size_t reported;
+    bool stopped;
+    float off[KD_MAX_DIM];
+} KDRadius;
+
+/// A slice of a batch of queries.
+typedef struct KDTreeBatchTask {
+    const KDTree* kd;
+    const float* queries;
+    size_t first;
+    size_t last;
+    size_t k;
+    KDNeighbor* out;
+} KDBatchTask;
+
+inline static float* __kd_row(const KDTree* kd, size_t i);
+inline static void __kd_swap_rows(KDTree* kd, size_t i, size_t j);
+inline static float __kd_dist2(const float* p, const float* q, size_t dim);
+// picks the dimension with the largest spread over a sample of rows $[lo, hi)$
+static uint32_t __kd_split_dim(const KDTree* kd, size_t lo, size_t hi);
+// moves the row of rank `nth` on dimension `d` into place, smaller rows before it and greater after
+static void __kd_select(KDTree* kd, size_t lo, size_t hi, size_t nth, uint32_t d);
+static void __kd_build(const KDBuild* build, size_t node, size_t lo, size_t hi, size_t level);
+static void* __kd_build_task(void* arg);
+static void __kd_heap_sift_down(KDNeighbor* heap, size_t i, size_t size);
+static void __kd_knn(KDKnn* s, size_t node, size_t lo, size_t hi, size_t level, float rd);
+static void __kd_radius(KDRadius* s, size_t node, size_t lo, size_t hi, size_t level, float rd);
+static void* __kd_batch_task(void* arg);
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+KDTree* kd_new(const DArray* da, size_t dim, size_t threads) {
+    if (!da || dim == 0 || dim > KD_MAX_DIM || da->element_size < dim * sizeof(float)) return NULL;
+
+    const size_t n = da->length;
+
+    KDTree* kd = (KDTree*)malloc(sizeof(KDTree));
+    if (!kd) return NULL;
+
+    kd->count = n;
+    kd->dim = dim;
+
+    // Smallest depth whose leaves hold at most `KD_LEAF_SIZE` points each
+    kd->depth = 0;
+    while (kd->depth < 63 && ((n + ((size_t)1 << kd->depth) - 1) >> kd->depth) > KD_LEAF_SIZE) kd->depth++;
+
+    const size_t internal = ((size_t)1 << kd->depth) - 1;
+
+    kd->points = (float*)malloc((n ? n : 1) * dim * sizeof(float));
+    kd->ids = (size_t*)malloc((n ? n : 1) * sizeof(size_t));
+    kd->nodes = (KDNode*)malloc((internal ? internal : 1) * sizeof(KDNode));
+
+    if (!kd->points || !kd->ids || !kd->nodes) {
+        free(kd->points);
+        free(kd->ids);
+        free(kd->nodes);
+        free(kd);
+        return NULL;
+    }
+
+    const char* src = (const char*)da->arr;
+    for (size_t i = 0; i < n; i++) {
+        memcpy(__kd_row(kd, i), src + i * da->element_size, dim * sizeof(float));
+        kd->ids[i] = i;
+    }
+
+    KDBuild build = {kd, 0};
+    while (threads > 1 && ((size_t)1 << build.spawn_depth) < threads) build.spawn_depth++;
+
+    __kd_build(&build, 0, 0, n, 0);
+
+    ms_track(MS_KDTREE, 1, (int64_t)(sizeof(KDTree) + n * (dim * sizeof(float) + sizeof(size_t)) + internal * sizeof(KDNode)));
+
+    return kd;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                             Clean Up & Freeing                             *
+ *                                                                            *
+ ******************************************************************************/
+
+void kd_free(KDTree* kd) {
+    if (!kd) return;
+
+    const size_t internal = ((size_t)1 << kd->depth) - 1;
+    ms_track(MS_KDTREE, -1, -(int64_t)(sizeof(KDTree) + kd->count * (kd->dim * sizeof(float) + sizeof(size_t)) + internal * sizeof(KDNode)));
+
+    free(kd->points);
+    free(kd->ids);
+    free(kd->nodes);
+    free(kd);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Basic Getters                                *
+ *                                                                            *
+ ******************************************************************************/
+
+size_t kd_count(const KDTree* kd) {
+    return kd ? kd->count : 0;
+}
+
+size_t kd_dim(const KDTree* kd) {
+    return kd ? kd->dim : 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                  Queries                                   *
+ *                                                                            *
+ ******************************************************************************/
+
+size_t kd_knn(const KDTree* kd, const float* q, size_t k, KDNeighbor* out) {
+    if (!kd || !q || !out || k == 0 || kd->count == 0) return 0;
+
+    KDKnn s;
+    s.kd = kd;
+    s.q = q;
+    s.heap = out;
+    s.k = k;
+    s.size = 0;
+    memset(s.off, 0, sizeof(s.off));
+
+    __kd_knn(&s, 0, 0, kd->count, 0, 0.0f);
+
+    // Heap sort the candidates into increasing distance
+    for (size_t end = s.size; end > 1; end--) {
+        KDNeighbor top = out[0];
+        out[0] = out[end - 1];
+        out[end - 1] = top;
+
+        __kd_heap_sift_down(out, 0, end - 1);
+    }
+
+    return s.size;
+}
+
+size_t kd_radius(const KDTree* kd, const float* q, float r, bool (*fn)(const KDNeighbor* nb, void* ctx), void* ctx) {
+    if (!kd || !q || !(r >= 0.0f) || kd->count == 0) return 0;
+
+    KDRadius s;
+    s.kd = kd;
+    s.q = q;
+    s.r2 = r * r;
+    s.fn = fn;
+    s.ctx = ctx;
+    s.reported = 0;
+    s.stopped = false;
+    memset(s.off, 0, sizeof(s.off));
+
+    __kd_radius(&s, 0, 0, kd->count, 0, 0.0f);
+
+    return s.reported;
+}
+
+bool kd_knn_batch(const KDTree* kd, const float* queries, size_t nq, size_t k, KDNeighbor* out, size_t threads) {
+    if (!kd || !queries || !out || k == 0) return false;
+
+    if (threads < 1) threads = 1;
+    if (threads > nq) threads = nq ? nq : 1;
+
+    KDBatchTask* tasks = (KDBatchTask*)malloc(threads * sizeof(KDBatchTask));
+    if (!tasks) return false;
+
+    for (size_t t = 0; t < threads; t++) {
+        tasks[t] = (KDBatchTask){kd, queries, nq * t / threads, nq * (t + 1) / threads, k, out};
+    }
+
+    __par_for(threads, __kd_batch_task, tasks, sizeof(KDBatchTask));
+
+    free(tasks);
+
+    return true;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                             Memory Accounting                              *
+ *                                                                            *
+ ******************************************************************************/
+
+MemUsage kd_memory_usage(const KDTree* kd) {
+    MemUsage mu = {0, 0, 0, 0, 0};
+    if (!kd) return mu;
+
+    const size_t points = kd->count * kd->dim * sizeof(float);
+    const size_t ids = kd->count * sizeof(size_t);
+    const size_t nodes = (((size_t)1 << kd->depth) - 1) * sizeof(KDNode);
+
+    mu.payload = points;
+    mu.metadata = sizeof(KDTree) + ids + nodes;
+    mu.overhead = ms_usable_size(kd, sizeof(KDTree)) - sizeof(KDTree);
+    mu.overhead += ms_usable_size(kd->points, points) - points;
+    mu.overhead += ms_usable_size(kd->ids, ids) - ids;
+    mu.overhead += ms_usable_size(kd->nodes, nodes) - nodes;
+
+    return mu;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                       Inner Functions Implementation                       *
+ *                                                                            *
+ ******************************************************************************/
+
+inline static float* __kd_row(const KDTree* kd, size_t i) {
+    return kd->points + i * kd->dim;
+}
+
+inline static void __kd_swap_rows(KDTree* kd, size_t i, size_t j) {
+    float* a = __kd_row(kd, i);
+    float* b = __kd_row(kd, j);
+
+    for (size_t d = 0; d < kd->dim; d++) {
+        float t = a[d];
+        a[d] = b[d];
+        b[d] = t;
+    }
+
+    size_t t = kd->ids[i];
+    kd->ids[i] = kd->ids[j];
+    kd->ids[j] = t;
+}
+
+inline static float __kd_dist2(const float* p, const float* q, size_t dim) {
+    float d2 = 0.0f;
+
+    for (size_t d = 0; d < dim; d++) {
+        const float diff = p[d] - q[d];
+        d2 += diff * diff;
+    }
+
+    return d2;
+}
+
+static uint32_t __kd_split_dim(const KDTree* kd, size_t lo, size_t hi) {
+    float min[KD_MAX_DIM], max[KD_MAX_DIM];
+
+    const size_t n = hi - lo;
+    const size_t samples = n < __KD_SPREAD_SAMPLE ? n : __KD_SPREAD_SAMPLE;
+
+    for (size_t s = 0; s < samples; s++) {
+        const float* p = __kd_row(kd, lo + s * n / samples);
+
+        for (size_t d = 0; d < kd->dim; d++) {
+            if (s == 0 || p[d] < min[d]) min[d] = p[d];
+            if (s == 0 || p[d] > max[d]) max[d] = p[d];
+        }
+    }
+
+    uint32_t best = 0;
+    for (size_t d = 1; d < kd->dim; d++) {
+        if (max[d] - min[d] > max[best] - min[best]) best = (uint32_t)d;
+    }
+
+    return best;
+}
+
+static void __kd_select(KDTree* kd, size_t lo, size_t hi, size_t nth, uint32_t d) {
+    while (hi - lo > __KD_SELECT_CUTOFF) {
+        // Pivot: median of evenly spaced samples
+        float sample[__KD_PIVOT_SAMPLE];
+        const size_t n = hi - lo;
+
+        for (size_t s = 0; s < __KD_PIVOT_SAMPLE; s++) {
+            float v = __kd_row(kd, lo + s * n / __KD_PIVOT_SAMPLE)[d];
+
+            size_t j = s;
+            for (; j > 0 && sample[j - 1] > v; j--) sample[j] = sample[j - 1];
+            sample[j] = v;
+        }
+
+        const float pivot = sample[__KD_PIVOT_SAMPLE / 2];
+
+        // Three-way partition, so runs of equal coordinates cannot stall the selection
+        size_t lt = lo, i = lo, gt = hi;
+
+        while (i < gt) {
+            const float v = __kd_row(kd, i)[d];
+
+            if (v < pivot) {
+                if (lt != i) __kd_swap_rows(kd, lt, i);
+                lt++;
+                i++;
+            } else if (v > pivot) {
+                __kd_swap_rows(kd, i, --gt);
+            } else {
+                i++;
+            }
+        }
+
+        if (nth < lt) {
+            hi = lt;
+        } else if (nth >= gt) {
+            lo = gt;
+        } else {
+            return;
+        }
+    }
+
+    for (size_t i = lo + 1; i < hi; i++) {
+        for (size_t j = i; j > lo && __kd_row(kd, j - 1)[d] > __kd_row(kd, j)[d]; j--) __kd_swap_rows(kd, j - 1, j);
+    }
+}
+
+static void __kd_build(const KDBuild* build, size_t node, size_t lo, size_t hi, size_t level) {
+    KDTree* kd = build->kd;
+
+    if (level == kd->depth) return;
+
+    const size_t mid = lo + (hi - lo) / 2;
+    const uint32_t d = hi > lo ? __kd_split_dim(kd, lo, hi) : 0;
+
+    if (hi > lo) __kd_select(kd, lo, hi, mid, d);
+
+    kd->nodes[node].dim = d;
+    kd->nodes[node].split = mid < hi ? __kd_row(kd, mid)[d] : 0.0f;
+
+    // The halves are disjoint row ranges and node slots, so they can be built concurrently
+    if (level < build->spawn_depth) {
+        KDBuildTask task = {build, 2 * node + 1, lo, mid, level + 1};
+        pthread_t thread;
+
+        if (pthread_create(&thread, NULL, __kd_build_task, &task) == 0) {
+            __kd_build(build, 2 * node + 2, mid, hi, level + 1);
+            pthread_join(thread, NULL);
+            return;
+        }
+    }
+
+    __kd_build(build, 2 * node + 1, lo, mid, level + 1);
+    __kd_build(build, 2 * node + 2, mid, hi, level + 1);
+}
+
+static void* __kd_build_task(void* arg) {
+    KDBuildTask* task = (KDBuildTask*)arg;
+
+    __kd_build(task->build, task->node, task->lo, task->hi, task->level);
+
+    return NULL;
+}
+
+static void __kd_heap_sift_down(KDNeighbor* heap, size_t i, size_t size) {
+    for (;;) {
+        size_t largest = i;
+        const size_t l = 2 * i + 1, r = 2 * i + 2;
+
+        if (l < size && heap[l].dist2 > heap[largest].dist2) largest = l;
+        if (r < size && heap[r].dist2 > heap[largest].dist2) largest = r;
+
+        if (largest == i) return;
+
+        KDNeighbor t = heap[i];
+        heap[i] = heap[largest];
+        heap[largest] = t;
+
+        i = largest;
+    }
+}
+
+static void __kd_knn(KDKnn* s, size_t node, size_t lo, size_t hi, size_t level, float rd) {
+    const KDTree* kd = s->kd;
+
+    if (level == kd->depth) {
+        for (size_t i = lo; i < hi; i++) {
+            const float d2 = __kd_dist2(__kd_row(kd, i), s->q, kd->dim);
+
+            if (s->size < s->k) {
+                // Sift the new candidate up
+                size_t j = s->size++;
+                while (j > 0 && s->heap[(j - 1) / 2].dist2 < d2) {
+                    s->heap[j] = s->heap[(j - 1) / 2];
+                    j = (j - 1) / 2;
+                }
+                s->heap[j] = (KDNeighbor){kd->ids[i], d2};
+            } else if (d2 < s->heap[0].dist2) {
+                s->heap[0] = (KDNeighbor){kd->ids[i], d2};
+                __kd_heap_sift_down(s->heap, 0, s->size);
+            }
+        }
+
+        return;
+    }
+
+    const KDNode* nd = &kd->nodes[node];
+    const size_t mid = lo + (hi - lo) / 2;
+    const float diff = s->q[nd->dim] - nd->split;
+
+    // Nearer half first, so the far half is usually pruned by the tightened bound
+    if (diff < 0.0f) {
+        __kd_knn(s, 2 * node + 1, lo, mid, level + 1, rd);
+    } else {
+        __kd_knn(s, 2 * node + 2, mid, hi, level + 1, rd);
+    }
+
+    // Lower bound of the distance to the far cell, updated incrementally on the split dimension
+    const float old = s->off[nd->dim];
+    const float far_rd = rd - old * old + diff * diff;
+
+    if (s->size < s->k || far_rd < s->heap[0].dist2) {
+        s->off[nd->dim] = diff;
+
+        if (diff < 0.0f) {
+            __kd_knn(s, 2 * node + 2, mid, hi, level + 1, far_rd);
+        } else {
+            __kd_knn(s, 2 * node + 1, lo, mid, level + 1, far_rd);
+        }
+
+        s->off[nd->dim] = old;
+    }
+}
+
+static void __kd_radius(KDRadius* s, size_t node, size_t lo, size_t hi, size_t level, float rd) {
+    const KDTree* kd = s->kd;
+
+    if (level == kd->depth) {
+        for (size_t i = lo; i < hi; i++) {
+            const float d2 = __kd_dist2(__kd_row(kd, i), s->q, kd->dim);
+            if (d2 > s->r2) continue;
+
+            s->reported++;
+
+            KDNeighbor nb = {kd->ids[i], d2};
+            if (s->fn && !s->fn(&nb, s->ctx)) {
+                s->stopped = true;
+                return;
+            }
+        }
+
+        return;
+    }
+
+    const KDNode* nd = &kd->nodes[node];
+    const size_t mid = lo + (hi - lo) / 2;
+    const float diff = s->q[nd->dim] - nd->split;
+
+    if (diff < 0.0f) {
+        __kd_radius(s, 2 * node + 1, lo, mid, level + 1, rd);
+    } else {
+        __kd_radius(s, 2 * node + 2, mid, hi, level + 1, rd);
+    }
+
+    const float old = s->off[nd->dim];
+    const float far_rd = rd - old * old + diff * diff;
+
+    if (!s->stopped && far_rd <= s->r2) {
+        s->off[nd->dim] = diff;
+
+        if (diff < 0.0f) {
+            __kd_radius(s, 2 * node + 2, mid, hi, level + 1, far_rd);
+        } else {
+            __kd_radius(s, 2 * node + 1, lo, mid, level + 1, far_rd);
+        }
+
+        s->off[nd->dim] = old;
+    }
+}
+
+static void* __kd_batch_task(void* arg) {
+    KDBatchTask* task = (KDBatchTask*)arg;
+
+    for (size_t i = task->first; i < task->last; i++) {
+        kd_knn(task->kd, task->queries + i * task->kd->dim, task->k, task->out + i * task->k);
+    }
+
+    return NULL;
+}
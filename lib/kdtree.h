@@ -0,0 +1,152 @@
+#ifndef KDTREE_H
+#define KDTREE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "darray.h"
+#include "memstat.h"
+
+// Nomenclature used (to avoid collisions): <data_type>_<method_name>
+// Note: A built tree is immutable, so any number of threads may query it concurrently.
+
+/// Maximum number of points in a leaf bucket.
+#define KD_LEAF_SIZE 16
+
+/// Maximum number of dimensions.
+#define KD_MAX_DIM 64
+
+/**
+ * @brief k-d Tree Split (internal node)
+ */
+typedef struct KDTreeNode KDNode;
+
+struct KDTreeNode {
+    float split;   ///< Points on the left have `coord <= split`, points on the right `coord >= split`.
+    uint32_t dim;  ///< Dimension the node splits on.
+};
+
+/**
+ * @brief Neighbour reported by a query.
+ */
+typedef struct KDNeighbor KDNeighbor;
+
+struct KDNeighbor {
+    size_t id;    ///< Position of the point in the source `DArray`.
+    float dist2;  ///< Squared Euclidean distance to the query.
+};
+
+/**
+ * @brief k-d Tree (Static, flattened)
+ *
+ * A balanced k-d tree over `float` points with no per-node pointers: the
+ * internal nodes form an implicit complete binary tree (children of `i` at
+ * `2i + 1` and `2i + 2`), every level splits its point range at the median
+ * position, and all leaves sit at the same depth. Leaf buckets hold up to
+ * `KD_LEAF_SIZE` points, stored contiguously in leaf order so a bucket scan
+ * reads consecutive memory. The point range of a node is recomputed while
+ * descending rather than stored.
+ *
+ * The split dimension is the one with the largest spread over a sample of the
+ * node's points, and the median is found by quickselect with median-of-sample
+ * pivots.
+ */
+typedef struct KDTree KDTree;
+
+struct KDTree {
+    float* points;  ///< `count * dim` coordinates, permuted into leaf order.
+    size_t* ids;    ///< Source position of each permuted point.
+    KDNode* nodes;  ///< `2^depth - 1` internal nodes in implicit layout.
+    size_t count;   ///< Number of points.
+    size_t dim;     ///< Number of dimensions.
+    size_t depth;   ///< Number of split levels (leaves are at this depth).
+};
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Builds a k-d tree over the points of a `DArray`. O(n log n).
+/// @details Each element must start with `dim` finite `float` coordinates (e.g., `float[dim]` or a struct whose first member is one). The coordinates are copied.
+/// @param da Pointer to the dynamic array (not modified).
+/// @param dim Number of dimensions (1 to `KD_MAX_DIM`).
+/// @param threads Maximum number of threads building independent subtrees (1 builds sequentially).
+/// @return A pointer to the newly allocated `KDTree`, or `NULL` on invalid arguments or failure.
+KDTree* kd_new(const DArray* da, size_t dim, size_t threads);
+
+/******************************************************************************
+ *                                                                            *
+ *                             Clean Up & Freeing                             *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Frees the tree.
+/// @param kd Pointer to the k-d tree.
+void kd_free(KDTree* kd);
+
+/******************************************************************************
+ *                                                                            *
+ *                               Basic Getters                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Gets the number of points.
+/// @param kd Pointer to the k-d tree.
+/// @return The number of points.
+size_t kd_count(const KDTree* kd);
+
+/// @brief Gets the number of dimensions.
+/// @param kd Pointer to the k-d tree.
+/// @return The number of dimensions.
+size_t kd_dim(const KDTree* kd);
+
+/******************************************************************************
+ *                                                                            *
+ *                                  Queries                                   *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Finds the `k` points nearest to `q`. Expected O(log n) for small `k` and dimension.
+/// @details Candidates are kept in a bounded max-heap in `out`, so subtrees farther than the current k-th distance are skipped.
+/// @param kd Pointer to the k-d tree.
+/// @param q The query point (`dim` coordinates).
+/// @param k Number of neighbours wanted.
+/// @param out Receives the neighbours by increasing distance (room for `k`).
+/// @return The number of neighbours written, `min(k, count)`.
+size_t kd_knn(const KDTree* kd, const float* q, size_t k, KDNeighbor* out);
+
+/// @brief Calls `fn` on every point within distance `r` of `q` (inclusive), in no particular order.
+/// @param kd Pointer to the k-d tree.
+/// @param q The query point (`dim` coordinates).
+/// @param r The search radius.
+/// @param fn Callback receiving each neighbour and `ctx`; returning `false` stops the query (may be `NULL` to count).
+/// @param ctx Opaque pointer passed to `fn`.
+/// @return The number of points reported.
+size_t kd_radius(const KDTree* kd, const float* q, float r, bool (*fn)(const KDNeighbor* nb, void* ctx), void* ctx);
+
+/// @brief Runs `kd_knn` for a batch of queries, split across up to `threads` threads.
+/// @param kd Pointer to the k-d tree.
+/// @param queries `nq * dim` coordinates.
+/// @param nq Number of queries.
+/// @param k Number of neighbours per query.
+/// @param out Receives `min(k, count)` neighbours per query, query `i` starting at `out + i * k`.
+/// @param threads Maximum number of threads (1 runs on the calling thread, which also takes any slice whose thread could not start).
+/// @return `true` on success, `false` on invalid arguments or allocation failure.
+bool kd_knn_batch(const KDTree* kd, const float* queries, size_t nq, size_t k, KDNeighbor* out, size_t threads);
+
+/******************************************************************************
+ *                                                                            *
+ *                             Memory Accounting                              *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Breaks down the memory used by the tree.
+/// @details `payload` is the coordinates, `metadata` the structure, ids and split nodes, and `overhead` the allocator's rounding.
+/// @param kd Pointer to the k-d tree.
+/// @return The breakdown (zeroed if `kd` is `NULL`).
+MemUsage kd_memory_usage(const KDTree* kd);
+
+#endif  // KDTREE_H
@@ -0,0 +1,736 @@
+#include "matrix.h"
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "par_for.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define __MAT_X86 1
+#include <immintrin.h>
+#endif
+
+/// Micro-kernel tile: `MR` rows by `NR` columns of the result held in registers.
+#define __MAT_MR 6
+#define __MAT_NR 8
+
+/// Cache blocking: a `KC x NR` panel of `b` stays in L1, an `MC x KC` block of `a` in L2 and a `KC x NC` panel of `b`
+/// in L3.
+#define __MAT_KC 256
+#define __MAT_MC 96
+#define __MAT_NC 2048
+
+/// Row alignment in bytes (one cache line), and in elements.
+#define __MAT_ALIGN 64
+#define __MAT_ALIGN_ELEMS (__MAT_ALIGN / sizeof(double))
+
+/// Smallest dimension for which a Strassen level beats the blocked GEMM.
+#define __MAT_STRASSEN_CROSSOVER 768
+
+/******************************************************************************
+ *                                                                            *
+ *                              Inner Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+typedef double __mat_v4d __attribute__((vector_size(32)));
+
+/// `c[0..mr) x [0..nr) += a_panel * b_panel` over `kc` steps (packed panels, `ldc` is the row stride of `c`).
+typedef void (*MatKernelFn)(size_t kc, const double* a, const double* b, double* c, size_t ldc, size_t mr, size_t nr);
+
+/// A band of rows of `c` computed by one thread.
+typedef struct MatGemmTask {
+    double alpha;
+    double beta;
+    const Matrix* a;
+    const Matrix* b;
+    Matrix* c;
+    size_t row_lo;  ///< Rows `[row_lo, row_hi)` of `c`.
+    size_t row_hi;
+    MatKernelFn kernel;
+    bool ok;
+} MatGemmTask;
+
+static _Atomic int __mat_active = MAT_KERNEL_AUTO;
+
+static MatKernel __mat_resolve(void);
+static bool __mat_supported(MatKernel kernel);
+static MatKernelFn __mat_kernel_fn(void);
+static void __mat_kernel_portable(size_t kc, const double* a, const double* b, double* c, size_t ldc, size_t mr,
+                                  size_t nr);
+#ifdef __MAT_X86
+static void __mat_kernel_avx2(size_t kc, const double* a, const double* b, double* c, size_t ldc, size_t mr,
+                              size_t nr);
+#endif
+inline static void __mat_tile_add(double* c, size_t ldc, const double* tile, size_t mr, size_t nr);
+
+inline static size_t __mat_min(size_t a, size_t b);
+// a sub-matrix sharing the storage of `m` (never freed)
+inline static Matrix __mat_view(const Matrix* m, size_t row, size_t col, size_t rows, size_t cols);
+// `dst = x + s * y` (same shapes)
+static void __mat_combine(Matrix* dst, const Matrix* x, const Matrix* y, double s);
+// `dst += s * src` (same shapes)
+static void __mat_accumulate(Matrix* dst, const Matrix* src, double s);
+
+static void __mat_pack_a(double* dst, const Matrix* a, size_t row, size_t col, size_t mc, size_t kc, double alpha);
+static void __mat_pack_b(double* dst, const Matrix* b, size_t row, size_t col, size_t kc, size_t nc);
+static void* __mat_gemm_task(void* arg);
+// unchecked `c = alpha * a * b + beta * c`
+static bool __mat_gemm(double alpha, const Matrix* a, const Matrix* b, double beta, Matrix* c, size_t threads);
+// `c = a * b`
+static bool __mat_strassen(const Matrix* a, const Matrix* b, Matrix* c, size_t threads);
+static Matrix* __mat_chain(const Matrix* const* ms, const size_t* split, size_t count, size_t i, size_t j,
+                           size_t threads);
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+Matrix* mat_new(size_t rows, size_t cols) {
+    if (!rows || !cols) return NULL;
+
+    Matrix* m = malloc(sizeof(Matrix));
+    if (!m) return NULL;
+
+    m->rows = rows;
+    m->cols = cols;
+    m->stride = (cols + __MAT_ALIGN_ELEMS - 1) / __MAT_ALIGN_ELEMS * __MAT_ALIGN_ELEMS;
+    m->data = aligned_alloc(__MAT_ALIGN, rows * m->stride * sizeof(double));
+
+    if (!m->data) {
+        free(m);
+        return NULL;
+    }
+
+    memset(m->data, 0, rows * m->stride * sizeof(double));
+
+    return m;
+}
+
+Matrix* mat_new_from(size_t rows, size_t cols, const double* values) {
+    if (!values) return NULL;
+
+    Matrix* m = mat_new(rows, cols);
+    if (!m) return NULL;
+
+    for (size_t i = 0; i < rows; i++) memcpy(m->data + i * m->stride, values + i * cols, cols * sizeof(double));
+
+    return m;
+}
+
+Matrix* mat_identity(size_t n) {
+    Matrix* m = mat_new(n, n);
+    if (!m) return NULL;
+
+    for (size_t i = 0; i < n; i++) m->data[i * m->stride + i] = 1.0;
+
+    return m;
+}
+
+Matrix* mat_copy(const Matrix* m) {
+    if (!m) return NULL;
+
+    Matrix* copy = mat_new(m->rows, m->cols);
+    if (!copy) return NULL;
+
+    memcpy(copy->data, m->data, m->rows * m->stride * sizeof(double));
+
+    return copy;
+}
+
+void mat_free(Matrix* m) {
+    if (!m) return;
+
+    free(m->data);
+    free(m);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                   Access                                   *
+ *                                                                            *
+ ******************************************************************************/
+
+double mat_get(const Matrix* m, size_t i, size_t j) {
+    if (!m || i >= m->rows || j >= m->cols) return NAN;
+
+    return m->data[i * m->stride + j];
+}
+
+bool mat_set(Matrix* m, size_t i, size_t j, double value) {
+    if (!m || i >= m->rows || j >= m->cols) return false;
+
+    m->data[i * m->stride + j] = value;
+
+    return true;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Arithmetic                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+Matrix* mat_transpose(const Matrix* m) {
+    if (!m) return NULL;
+
+    Matrix* t = mat_new(m->cols, m->rows);
+    if (!t) return NULL;
+
+    // 8x8 blocks keep both the reads and the strided writes within a few cache lines
+    for (size_t i0 = 0; i0 < m->rows; i0 += 8) {
+        for (size_t j0 = 0; j0 < m->cols; j0 += 8) {
+            const size_t i1 = __mat_min(i0 + 8, m->rows), j1 = __mat_min(j0 + 8, m->cols);
+
+            for (size_t i = i0; i < i1; i++) {
+                for (size_t j = j0; j < j1; j++) t->data[j * t->stride + i] = m->data[i * m->stride + j];
+            }
+        }
+    }
+
+    return t;
+}
+
+Matrix* mat_add(const Matrix* a, const Matrix* b) {
+    if (!a || !b || a->rows != b->rows || a->cols != b->cols) return NULL;
+
+    Matrix* r = mat_new(a->rows, a->cols);
+    if (r) __mat_combine(r, a, b, 1.0);
+
+    return r;
+}
+
+Matrix* mat_sub(const Matrix* a, const Matrix* b) {
+    if (!a || !b || a->rows != b->rows || a->cols != b->cols) return NULL;
+
+    Matrix* r = mat_new(a->rows, a->cols);
+    if (r) __mat_combine(r, a, b, -1.0);
+
+    return r;
+}
+
+bool mat_use_kernel(MatKernel kernel) {
+    if (kernel == MAT_KERNEL_AUTO) kernel = __mat_resolve();
+    if (!__mat_supported(kernel)) return false;
+
+    atomic_store_explicit(&__mat_active, (int)kernel, memory_order_relaxed);
+
+    return true;
+}
+
+MatKernel mat_kernel(void) {
+    int kernel = atomic_load_explicit(&__mat_active, memory_order_relaxed);
+
+    if (kernel == MAT_KERNEL_AUTO) {
+        kernel = (int)__mat_resolve();
+        atomic_store_explicit(&__mat_active, kernel, memory_order_relaxed);
+    }
+
+    return (MatKernel)kernel;
+}
+
+bool mat_gemm(double alpha, const Matrix* a, const Matrix* b, double beta, Matrix* c, size_t threads) {
+    if (!a || !b || !c || a->cols != b->rows || c->rows != a->rows || c->cols != b->cols) return false;
+    if (c->data == a->data || c->data == b->data) return false;
+
+    return __mat_gemm(alpha, a, b, beta, c, threads);
+}
+
+Matrix* mat_mul(const Matrix* a, const Matrix* b, size_t threads) {
+    if (!a || !b || a->cols != b->rows) return NULL;
+
+    Matrix* c = mat_new(a->rows, b->cols);
+    if (!c) return NULL;
+
+    if (!__mat_gemm(1.0, a, b, 0.0, c, threads)) {
+        mat_free(c);
+        return NULL;
+    }
+
+    return c;
+}
+
+Matrix* mat_mul_strassen(const Matrix* a, const Matrix* b, size_t threads) {
+    if (!a || !b || a->cols != b->rows) return NULL;
+
+    Matrix* c = mat_new(a->rows, b->cols);
+    if (!c) return NULL;
+
+    if (!__mat_strassen(a, b, c, threads)) {
+        mat_free(c);
+        return NULL;
+    }
+
+    return c;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                           Matrix Chain Ordering                            *
+ *                                                                            *
+ ******************************************************************************/
+
+uint64_t mat_chain_order(const size_t* dims, size_t count, size_t* split) {
+    if (!dims || !count) return UINT64_MAX;
+
+    uint64_t* cost = calloc(count * count, sizeof(uint64_t));
+    size_t* best = split ? split : calloc(count * count, sizeof(size_t));
+
+    if (!cost || !best) {
+        free(cost);
+        if (best != split) free(best);
+        return UINT64_MAX;
+    }
+
+    // cost[i][j] = min over s of cost[i][s] + cost[s+1][j] + dims[i] dims[s+1] dims[j+1], by increasing chain length
+    for (size_t i = 0; i < count; i++) best[i * count + i] = i;
+
+    for (size_t len = 2; len <= count; len++) {
+        for (size_t i = 0; i + len <= count; i++) {
+            const size_t j = i + len - 1;
+            uint64_t min = UINT64_MAX;
+
+            for (size_t s = i; s < j; s++) {
+                const uint64_t c = cost[i * count + s] + cost[(s + 1) * count + j] +
+                                   (uint64_t)dims[i] * dims[s + 1] * dims[j + 1];
+                if (c < min) {
+                    min = c;
+                    best[i * count + j] = s;
+                }
+            }
+
+            cost[i * count + j] = min;
+        }
+    }
+
+    const uint64_t result = cost[count - 1];
+
+    free(cost);
+    if (best != split) free(best);
+
+    return result;
+}
+
+Matrix* mat_chain_mul(const Matrix* const* ms, size_t count, size_t threads) {
+    if (!ms || !count) return NULL;
+
+    size_t* dims = malloc((count + 1) * sizeof(size_t));
+    size_t* split = malloc(count * count * sizeof(size_t));
+
+    bool ok = dims && split;
+    for (size_t i = 0; ok && i < count; i++) {
+        ok = ms[i] && (i + 1 == count || (ms[i + 1] && ms[i]->cols == ms[i + 1]->rows));
+        if (ok) dims[i] = ms[i]->rows;
+    }
+
+    Matrix* result = NULL;
+    if (ok) {
+        dims[count] = ms[count - 1]->cols;
+        mat_chain_order(dims, count, split);
+        result = count == 1 ? mat_copy(ms[0]) : __mat_chain(ms, split, count, 0, count - 1, threads);
+    }
+
+    free(dims);
+    free(split);
+
+    return result;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                       Inner Functions Implementation                       *
+ *                                                                            *
+ ******************************************************************************/
+
+static MatKernel __mat_resolve(void) {
+#ifdef __MAT_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return MAT_KERNEL_AVX2;
+#endif
+
+    return MAT_KERNEL_PORTABLE;
+}
+
+static bool __mat_supported(MatKernel kernel) {
+    switch (kernel) {
+        case MAT_KERNEL_PORTABLE:
+            return true;
+#ifdef __MAT_X86
+        case MAT_KERNEL_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+        default:
+            return false;
+    }
+}
+
+static MatKernelFn __mat_kernel_fn(void) {
+#ifdef __MAT_X86
+    if (mat_kernel() == MAT_KERNEL_AVX2) return __mat_kernel_avx2;
+#endif
+
+    return __mat_kernel_portable;
+}
+
+static void __mat_kernel_portable(size_t kc, const double* a, const double* b, double* c, size_t ldc, size_t mr,
+                                  size_t nr) {
+    __mat_v4d acc[__MAT_MR][2] = {0};
+
+    for (size_t p = 0; p < kc; p++, a += __MAT_MR, b += __MAT_NR) {
+        const __mat_v4d b0 = *(const __mat_v4d*)b, b1 = *(const __mat_v4d*)(b + 4);
+
+        for (size_t i = 0; i < __MAT_MR; i++) {
+            acc[i][0] += a[i] * b0;
+            acc[i][1] += a[i] * b1;
+        }
+    }
+
+    double tile[__MAT_MR * __MAT_NR] __attribute__((aligned(32)));
+    for (size_t i = 0; i < __MAT_MR; i++) {
+        memcpy(tile + i * __MAT_NR, &acc[i][0], sizeof(__mat_v4d));
+        memcpy(tile + i * __MAT_NR + 4, &acc[i][1], sizeof(__mat_v4d));
+    }
+
+    __mat_tile_add(c, ldc, tile, mr, nr);
+}
+
+#ifdef __MAT_X86
+
+/// One step of the AVX2 kernel: row `i` of the `a` panel times the two vectors of the `b` panel.
+#define __MAT_FMA_ROW(i)                                 \
+    do {                                                 \
+        const __m256d ai = _mm256_broadcast_sd(a + (i)); \
+        c##i##0 = _mm256_fmadd_pd(ai, b0, c##i##0);      \
+        c##i##1 = _mm256_fmadd_pd(ai, b1, c##i##1);      \
+    } while (0)
+
+__attribute__((target("avx2,fma"))) static void __mat_kernel_avx2(
+    size_t kc, const double* a, const double* b, double* c, size_t ldc, size_t mr, size_t nr
+) {
+    // 12 accumulators, 2 `b` vectors and a broadcast fill 15 of the 16 registers
+    __m256d c00 = _mm256_setzero_pd(), c01 = c00, c10 = c00, c11 = c00, c20 = c00, c21 = c00;
+    __m256d c30 = c00, c31 = c00, c40 = c00, c41 = c00, c50 = c00, c51 = c00;
+
+    for (size_t p = 0; p < kc; p++, a += __MAT_MR, b += __MAT_NR) {
+        const __m256d b0 = _mm256_load_pd(b), b1 = _mm256_load_pd(b + 4);
+
+        __MAT_FMA_ROW(0);
+        __MAT_FMA_ROW(1);
+        __MAT_FMA_ROW(2);
+        __MAT_FMA_ROW(3);
+        __MAT_FMA_ROW(4);
+        __MAT_FMA_ROW(5);
+    }
+
+    if (mr == __MAT_MR && nr == __MAT_NR) {
+        const __m256d acc[__MAT_MR][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}, {c40, c41}, {c50, c51}};
+
+        for (size_t i = 0; i < __MAT_MR; i++) {
+            double* row = c + i * ldc;
+            _mm256_storeu_pd(row, _mm256_add_pd(_mm256_loadu_pd(row), acc[i][0]));
+            _mm256_storeu_pd(row + 4, _mm256_add_pd(_mm256_loadu_pd(row + 4), acc[i][1]));
+        }
+
+        return;
+    }
+
+    double tile[__MAT_MR * __MAT_NR] __attribute__((aligned(32)));
+    _mm256_store_pd(tile + 0, c00);
+    _mm256_store_pd(tile + 4, c01);
+    _mm256_store_pd(tile + 8, c10);
+    _mm256_store_pd(tile + 12, c11);
+    _mm256_store_pd(tile + 16, c20);
+    _mm256_store_pd(tile + 20, c21);
+    _mm256_store_pd(tile + 24, c30);
+    _mm256_store_pd(tile + 28, c31);
+    _mm256_store_pd(tile + 32, c40);
+    _mm256_store_pd(tile + 36, c41);
+    _mm256_store_pd(tile + 40, c50);
+    _mm256_store_pd(tile + 44, c51);
+
+    __mat_tile_add(c, ldc, tile, mr, nr);
+}
+
+#endif
+
+inline static void __mat_tile_add(double* c, size_t ldc, const double* tile, size_t mr, size_t nr) {
+    for (size_t i = 0; i < mr; i++) {
+        for (size_t j = 0; j < nr; j++) c[i * ldc + j] += tile[i * __MAT_NR + j];
+    }
+}
+
+inline static size_t __mat_min(size_t a, size_t b) {
+    return a < b ? a : b;
+}
+
+inline static Matrix __mat_view(const Matrix* m, size_t row, size_t col, size_t rows, size_t cols) {
+    return (Matrix){rows, cols, m->stride, m->data + row * m->stride + col};
+}
+
+static void __mat_combine(Matrix* dst, const Matrix* x, const Matrix* y, double s) {
+    for (size_t i = 0; i < dst->rows; i++) {
+        double* d = dst->data + i * dst->stride;
+        const double *u = x->data + i * x->stride, *v = y->data + i * y->stride;
+
+        for (size_t j = 0; j < dst->cols; j++) d[j] = u[j] + s * v[j];
+    }
+}
+
+static void __mat_accumulate(Matrix* dst, const Matrix* src, double s) {
+    for (size_t i = 0; i < dst->rows; i++) {
+        double* d = dst->data + i * dst->stride;
+        const double* u = src->data + i * src->stride;
+
+        for (size_t j = 0; j < dst->cols; j++) d[j] += s * u[j];
+    }
+}
+
+static void __mat_pack_a(double* dst, const Matrix* a, size_t row, size_t col, size_t mc, size_t kc, double alpha) {
+    // Micro-panels of `MR` rows stored column by column (`MR` consecutive values per step), zero-padded at the bottom
+    for (size_t ir = 0; ir < mc; ir += __MAT_MR, dst += __MAT_MR * kc) {
+        const size_t mr = __mat_min(__MAT_MR, mc - ir);
+
+        for (size_t i = 0; i < mr; i++) {
+            const double* src = a->data + (row + ir + i) * a->stride + col;
+            for (size_t p = 0; p < kc; p++) dst[p * __MAT_MR + i] = alpha * src[p];
+        }
+        for (size_t i = mr; i < __MAT_MR; i++) {
+            for (size_t p = 0; p < kc; p++) dst[p * __MAT_MR + i] = 0.0;
+        }
+    }
+}
+
+static void __mat_pack_b(double* dst, const Matrix* b, size_t row, size_t col, size_t kc, size_t nc) {
+    // Micro-panels of `NR` columns stored row by row (`NR` consecutive values per step), zero-padded on the right
+    for (size_t jr = 0; jr < nc; jr += __MAT_NR, dst += __MAT_NR * kc) {
+        const size_t nr = __mat_min(__MAT_NR, nc - jr);
+
+        for (size_t p = 0; p < kc; p++) {
+            const double* src = b->data + (row + p) * b->stride + col + jr;
+            double* out = dst + p * __MAT_NR;
+
+            memcpy(out, src, nr * sizeof(double));
+            for (size_t j = nr; j < __MAT_NR; j++) out[j] = 0.0;
+        }
+    }
+}
+
+static void* __mat_gemm_task(void* arg) {
+    MatGemmTask* task = arg;
+    const Matrix *a = task->a, *b = task->b;
+    Matrix* c = task->c;
+    const size_t k = a->cols, n = b->cols;
+
+    // Scale this band of `c` first, so the blocks below only accumulate
+    for (size_t i = task->row_lo; i < task->row_hi; i++) {
+        double* row = c->data + i * c->stride;
+
+        if (task->beta == 0.0) memset(row, 0, n * sizeof(double));
+        else if (task->beta != 1.0) {
+            for (size_t j = 0; j < n; j++) row[j] *= task->beta;
+        }
+    }
+
+    const size_t nc_max = __mat_min(__MAT_NC, (n + __MAT_NR - 1) / __MAT_NR * __MAT_NR);
+    double* pa = aligned_alloc(__MAT_ALIGN, __MAT_MC * __MAT_KC * sizeof(double));
+    double* pb = aligned_alloc(__MAT_ALIGN, __MAT_KC * nc_max * sizeof(double));
+
+    task->ok = pa && pb;
+
+    for (size_t jc = 0; task->ok && jc < n; jc += __MAT_NC) {
+        const size_t nc = __mat_min(__MAT_NC, n - jc);
+
+        for (size_t pc = 0; pc < k; pc += __MAT_KC) {
+            const size_t kc = __mat_min(__MAT_KC, k - pc);
+            __mat_pack_b(pb, b, pc, jc, kc, nc);
+
+            for (size_t ic = task->row_lo; ic < task->row_hi; ic += __MAT_MC) {
+                const size_t mc = __mat_min(__MAT_MC, task->row_hi - ic);
+                __mat_pack_a(pa, a, ic, pc, mc, kc, task->alpha);
+
+                for (size_t jr = 0; jr < nc; jr += __MAT_NR) {
+                    const size_t nr = __mat_min(__MAT_NR, nc - jr);
+
+                    for (size_t ir = 0; ir < mc; ir += __MAT_MR) {
+                        const size_t mr = __mat_min(__MAT_MR, mc - ir);
+                        double* tile = c->data + (ic + ir) * c->stride + jc + jr;
+
+                        task->kernel(kc, pa + ir * kc, pb + jr * kc, tile, c->stride, mr, nr);
+                    }
+                }
+            }
+        }
+    }
+
+    free(pa);
+    free(pb);
+
+    return NULL;
+}
+
+static bool __mat_gemm(double alpha, const Matrix* a, const Matrix* b, double beta, Matrix* c, size_t threads) {
+    const size_t m = c->rows;
+
+    // Bands are whole micro-tiles, and each one amortizes its own packing of `b`
+    const size_t tiles = (m + __MAT_MR - 1) / __MAT_MR;
+    if (threads < 1) threads = 1;
+    if (threads > tiles) threads = tiles;
+
+    MatGemmTask* tasks = (MatGemmTask*)malloc(threads * sizeof(MatGemmTask));
+    if (!tasks) return false;
+
+    const MatKernelFn kernel = __mat_kernel_fn();
+
+    for (size_t t = 0; t < threads; t++) {
+        const size_t lo = __mat_min(m, tiles * t / threads * __MAT_MR);
+        const size_t hi = __mat_min(m, tiles * (t + 1) / threads * __MAT_MR);
+        tasks[t] = (MatGemmTask){alpha, beta, a, b, c, lo, hi, kernel, false};
+    }
+
+    __par_for(threads, __mat_gemm_task, tasks, sizeof(MatGemmTask));
+
+    bool ok = true;
+    for (size_t t = 0; t < threads; t++) ok = ok && tasks[t].ok;
+
+    free(tasks);
+
+    return ok;
+}
+
+static bool __mat_strassen(const Matrix* a, const Matrix* b, Matrix* c, size_t threads) {
+    const size_t m = a->rows, k = a->cols, n = b->cols;
+
+    if (m < __MAT_STRASSEN_CROSSOVER || k < __MAT_STRASSEN_CROSSOVER || n < __MAT_STRASSEN_CROSSOVER) {
+        return __mat_gemm(1.0, a, b, 0.0, c, threads);
+    }
+
+    // Quadrants of the even-sized leading parts; an odd last row, column or inner index is fixed up by GEMM
+    const size_t mh = m / 2, kh = k / 2, nh = n / 2;
+
+    const Matrix a11 = __mat_view(a, 0, 0, mh, kh), a12 = __mat_view(a, 0, kh, mh, kh);
+    const Matrix a21 = __mat_view(a, mh, 0, mh, kh), a22 = __mat_view(a, mh, kh, mh, kh);
+    const Matrix b11 = __mat_view(b, 0, 0, kh, nh), b12 = __mat_view(b, 0, nh, kh, nh);
+    const Matrix b21 = __mat_view(b, kh, 0, kh, nh), b22 = __mat_view(b, kh, nh, kh, nh);
+    Matrix c11 = __mat_view(c, 0, 0, mh, nh), c12 = __mat_view(c, 0, nh, mh, nh);
+    Matrix c21 = __mat_view(c, mh, 0, mh, nh), c22 = __mat_view(c, mh, nh, mh, nh);
+
+    Matrix* ta = mat_new(mh, kh);
+    Matrix* tb = mat_new(kh, nh);
+    Matrix* p = mat_new(mh, nh);
+    bool ok = ta && tb && p;
+
+    // M1 = (A11 + A22)(B11 + B22): C11 = M1, C22 = M1
+    if (ok) {
+        __mat_combine(ta, &a11, &a22, 1.0);
+        __mat_combine(tb, &b11, &b22, 1.0);
+        ok = __mat_strassen(ta, tb, p, threads);
+    }
+    if (ok) {
+        __mat_combine(&c11, p, p, 0.0);
+        __mat_combine(&c22, p, p, 0.0);
+    }
+
+    // M2 = (A21 + A22) B11: C21 = M2, C22 -= M2
+    if (ok) {
+        __mat_combine(ta, &a21, &a22, 1.0);
+        ok = __mat_strassen(ta, &b11, p, threads);
+    }
+    if (ok) {
+        __mat_combine(&c21, p, p, 0.0);
+        __mat_accumulate(&c22, p, -1.0);
+    }
+
+    // M3 = A11 (B12 - B22): C12 = M3, C22 += M3
+    if (ok) {
+        __mat_combine(tb, &b12, &b22, -1.0);
+        ok = __mat_strassen(&a11, tb, p, threads);
+    }
+    if (ok) {
+        __mat_combine(&c12, p, p, 0.0);
+        __mat_accumulate(&c22, p, 1.0);
+    }
+
+    // M4 = A22 (B21 - B11): C11 += M4, C21 += M4
+    if (ok) {
+        __mat_combine(tb, &b21, &b11, -1.0);
+        ok = __mat_strassen(&a22, tb, p, threads);
+    }
+    if (ok) {
+        __mat_accumulate(&c11, p, 1.0);
+        __mat_accumulate(&c21, p, 1.0);
+    }
+
+    // M5 = (A11 + A12) B22: C11 -= M5, C12 += M5
+    if (ok) {
+        __mat_combine(ta, &a11, &a12, 1.0);
+        ok = __mat_strassen(ta, &b22, p, threads);
+    }
+    if (ok) {
+        __mat_accumulate(&c11, p, -1.0);
+        __mat_accumulate(&c12, p, 1.0);
+    }
+
+    // M6 = (A21 - A11)(B11 + B12): C22 += M6
+    if (ok) {
+        __mat_combine(ta, &a21, &a11, -1.0);
+        __mat_combine(tb, &b11, &b12, 1.0);
+        ok = __mat_strassen(ta, tb, p, threads);
+    }
+    if (ok) __mat_accumulate(&c22, p, 1.0);
+
+    // M7 = (A12 - A22)(B21 + B22): C11 += M7
+    if (ok) {
+        __mat_combine(ta, &a12, &a22, -1.0);
+        __mat_combine(tb, &b21, &b22, 1.0);
+        ok = __mat_strassen(ta, tb, p, threads);
+    }
+    if (ok) __mat_accumulate(&c11, p, 1.0);
+
+    mat_free(ta);
+    mat_free(tb);
+    mat_free(p);
+
+    // Peeling: the last inner index adds a rank-1 update, the last column and row are plain products
+    if (ok && k % 2) {
+        const Matrix acol = __mat_view(a, 0, k - 1, 2 * mh, 1), brow = __mat_view(b, k - 1, 0, 1, 2 * nh);
+        Matrix cc = __mat_view(c, 0, 0, 2 * mh, 2 * nh);
+        ok = __mat_gemm(1.0, &acol, &brow, 1.0, &cc, threads);
+    }
+    if (ok && n % 2) {
+        const Matrix ab = __mat_view(a, 0, 0, 2 * mh, k), bcol = __mat_view(b, 0, n - 1, k, 1);
+        Matrix cc = __mat_view(c, 0, n - 1, 2 * mh, 1);
+        ok = __mat_gemm(1.0, &ab, &bcol, 0.0, &cc, threads);
+    }
+    if (ok && m % 2) {
+        const Matrix arow = __mat_view(a, m - 1, 0, 1, k);
+        Matrix cc = __mat_view(c, m - 1, 0, 1, n);
+        ok = __mat_gemm(1.0, &arow, b, 0.0, &cc, threads);
+    }
+
+    return ok;
+}
+
+static Matrix* __mat_chain(const Matrix* const* ms, const size_t* split, size_t count, size_t i, size_t j,
+                           size_t threads) {
+    // Single matrices are used in place, only the intermediate products are allocated
+    const size_t s = split[i * count + j];
+
+    Matrix* left = s == i ? NULL : __mat_chain(ms, split, count, i, s, threads);
+    Matrix* right = s + 1 == j ? NULL : __mat_chain(ms, split, count, s + 1, j, threads);
+
+    Matrix* product = NULL;
+    if ((s == i || left) && (s + 1 == j || right)) product = mat_mul(left ? left : ms[i], right ? right : ms[j], threads);
+
+    mat_free(left);
+    mat_free(right);
+
+    return product;
+}
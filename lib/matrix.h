@@ -0,0 +1,173 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Nomenclature used (to avoid collisions): mat_<method_name>
+//
+// Products run on a cache-blocked GEMM: operands are packed into panels sized for the L1/L2 caches and a register-tiled
+// micro-kernel computes 6x8 tiles of the result (AVX2 + FMA when the CPU has them). Threads split the rows of the
+// result. Strassen's algorithm and the matrix chain planner are layered on top of it.
+
+/**
+ * @brief Dense `double` matrix, row-major.
+ *
+ * Rows start on 64-byte boundaries: `stride >= cols` is a multiple of 8, and element `(i, j)` is
+ * `data[i * stride + j]`. The padding after each row is kept at zero.
+ */
+typedef struct Matrix Matrix;
+
+struct Matrix {
+    size_t rows;    ///< Number of rows (`> 0`).
+    size_t cols;    ///< Number of columns (`> 0`).
+    size_t stride;  ///< Distance between rows, in elements.
+    double* data;   ///< 64-byte aligned storage of `rows * stride` elements.
+};
+
+/**
+ * @brief GEMM micro-kernel implementations, from slowest to fastest.
+ */
+typedef enum MatKernel {
+    MAT_KERNEL_AUTO,      ///< Fastest one the CPU supports (default).
+    MAT_KERNEL_PORTABLE,  ///< 6x8 tile on GCC vector extensions.
+    MAT_KERNEL_AVX2,      ///< 6x8 tile on 12 AVX2 registers with FMA (x86-64).
+} MatKernel;
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Creates a zero matrix.
+/// @param rows Number of rows (`> 0`).
+/// @param cols Number of columns (`> 0`).
+/// @return Pointer to the new matrix, or `NULL` on invalid sizes or allocation failure.
+Matrix* mat_new(size_t rows, size_t cols);
+
+/// @brief Creates a matrix from dense row-major values.
+/// @param rows Number of rows (`> 0`).
+/// @param cols Number of columns (`> 0`).
+/// @param values `rows * cols` values, row after row.
+/// @return Pointer to the new matrix, or `NULL` on invalid arguments or allocation failure.
+Matrix* mat_new_from(size_t rows, size_t cols, const double* values);
+
+/// @brief Creates an identity matrix.
+/// @param n Number of rows and columns (`> 0`).
+/// @return Pointer to the new matrix, or `NULL` on invalid sizes or allocation failure.
+Matrix* mat_identity(size_t n);
+
+/// @brief Copies a matrix.
+/// @param m Pointer to the matrix.
+/// @return Pointer to the copy, or `NULL` on allocation failure.
+Matrix* mat_copy(const Matrix* m);
+
+/// @brief Frees a matrix.
+/// @param m Pointer to the matrix (may be `NULL`).
+void mat_free(Matrix* m);
+
+/******************************************************************************
+ *                                                                            *
+ *                                   Access                                   *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Reads an element.
+/// @param m Pointer to the matrix.
+/// @param i Row index.
+/// @param j Column index.
+/// @return The element, or `NAN` if out of bounds.
+double mat_get(const Matrix* m, size_t i, size_t j);
+
+/// @brief Writes an element.
+/// @param m Pointer to the matrix.
+/// @param i Row index.
+/// @param j Column index.
+/// @param value The new value.
+/// @return `true` on success, `false` if out of bounds.
+bool mat_set(Matrix* m, size_t i, size_t j, double value);
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Arithmetic                                 *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Transposes, in 8x8 blocks.
+/// @param m Pointer to the matrix.
+/// @return The transpose, or `NULL` on allocation failure.
+Matrix* mat_transpose(const Matrix* m);
+
+/// @brief Adds two matrices of the same shape.
+/// @param a Pointer to the first matrix.
+/// @param b Pointer to the second matrix.
+/// @return `a + b`, or `NULL` on a shape mismatch or allocation failure.
+Matrix* mat_add(const Matrix* a, const Matrix* b);
+
+/// @brief Subtracts two matrices of the same shape.
+/// @param a Pointer to the first matrix.
+/// @param b Pointer to the second matrix.
+/// @return `a - b`, or `NULL` on a shape mismatch or allocation failure.
+Matrix* mat_sub(const Matrix* a, const Matrix* b);
+
+/// @brief Selects the GEMM micro-kernel (for testing and benchmarks); `MAT_KERNEL_AUTO` restores the default.
+/// @param kernel The kernel to use.
+/// @return `true` on success, `false` if the CPU or the build does not support it (the selection is unchanged).
+bool mat_use_kernel(MatKernel kernel);
+
+/// @brief Returns the GEMM micro-kernel in use (never `MAT_KERNEL_AUTO`).
+/// @return The kernel.
+MatKernel mat_kernel(void);
+
+/// @brief General matrix multiply-accumulate: `c = alpha * a * b + beta * c`.
+/// @details Blocked BLIS-style: `b` is packed in `KC x NC` panels, `a` in `MC x KC` blocks and the micro-kernel runs
+/// over `6 x 8` tiles of `c`. Threads take contiguous bands of rows of `c` and pack their own blocks.
+/// @param alpha Scale of the product.
+/// @param a Pointer to the `m x k` left factor.
+/// @param b Pointer to the `k x n` right factor.
+/// @param beta Scale of the previous `c` (`0` ignores its contents, including NaNs).
+/// @param c Pointer to the `m x n` result (must not be `a` or `b`).
+/// @param threads Number of threads (`0` or `1` to run on the calling thread only).
+/// @return `true` on success, `false` on a shape mismatch, aliasing or allocation failure.
+bool mat_gemm(double alpha, const Matrix* a, const Matrix* b, double beta, Matrix* c, size_t threads);
+
+/// @brief Multiplies two matrices with the blocked GEMM.
+/// @param a Pointer to the `m x k` left factor.
+/// @param b Pointer to the `k x n` right factor.
+/// @param threads Number of threads (`0` or `1` to run on the calling thread only).
+/// @return The `m x n` product, or `NULL` on a shape mismatch or allocation failure.
+Matrix* mat_mul(const Matrix* a, const Matrix* b, size_t threads);
+
+/// @brief Multiplies two matrices with Strassen's algorithm down to a crossover size, then the blocked GEMM.
+/// @details Seven half-size products per level instead of eight, O(n^2.81). An odd row or column is peeled off and
+/// handled by GEMM. Needs `O(n^2)` scratch memory and is slightly less accurate than the plain product.
+/// @param a Pointer to the `m x k` left factor.
+/// @param b Pointer to the `k x n` right factor.
+/// @param threads Number of threads for the GEMM products (`0` or `1` to run on the calling thread only).
+/// @return The `m x n` product, or `NULL` on a shape mismatch or allocation failure.
+Matrix* mat_mul_strassen(const Matrix* a, const Matrix* b, size_t threads);
+
+/******************************************************************************
+ *                                                                            *
+ *                           Matrix Chain Ordering                            *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Plans the cheapest parenthesization of a chain of products (dynamic programming, O(count^3)).
+/// @param dims `count + 1` dimensions: matrix `i` is `dims[i] x dims[i + 1]`.
+/// @param count Number of matrices (`> 0`).
+/// @param split Receives `count * count` entries, `split[i * count + j]` being the last matrix of the left factor of
+/// the best product of matrices `i..j` (may be `NULL`).
+/// @return The minimal number of scalar multiplications, or `UINT64_MAX` on invalid arguments or allocation failure.
+uint64_t mat_chain_order(const size_t* dims, size_t count, size_t* split);
+
+/// @brief Multiplies a chain of matrices in the order planned by `mat_chain_order`.
+/// @param ms The matrices, each one's columns matching the next one's rows.
+/// @param count Number of matrices (`> 0`).
+/// @param threads Number of threads for each product (`0` or `1` to run on the calling thread only).
+/// @return The product (a copy when `count` is `1`), or `NULL` on a shape mismatch or allocation failure.
+Matrix* mat_chain_mul(const Matrix* const* ms, size_t count, size_t threads);
+
+#endif  // MATRIX_H
@@ -0,0 +1,127 @@
+#include "memstat.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+/******************************************************************************
+ *                                                                            *
+ *                               Registry State                               *
+ *                                                                            *
+ ******************************************************************************/
+
+static _Atomic int64_t __ms_containers[MS_KIND_COUNT];
+static _Atomic int64_t __ms_bytes[MS_KIND_COUNT];
+
+static const char* const __ms_kind_names[MS_KIND_COUNT] = {
+    [MS_DARRAY] = "darray",
+    [MS_HSET] = "hashset",
+    [MS_IHSET] = "intrusive_hashset",
+    [MS_POOL] = "pool",
+    [MS_ULIST] = "unrolled_list",
+    [MS_HMSET] = "multiset",
+    [MS_RBTREE] = "rbtree",
+    [MS_TREAP] = "treap",
+    [MS_ITREE] = "interval_tree",
+    [MS_IIDX] = "interval_index",
+    [MS_KDTREE] = "kdtree",
+};
+
+/******************************************************************************
+ *                                                                            *
+ *                                Memory Usage                                *
+ *                                                                            *
+ ******************************************************************************/
+
+size_t mu_total(const MemUsage* mu) {
+    if (!mu) return 0;
+
+    return mu->payload + mu->slack + mu->metadata + mu->overhead + mu->owned;
+}
+
+void mu_fprint_json(FILE* file, const MemUsage* mu) {
+    if (!file) file = stdout;
+
+    if (!mu) {
+        fprintf(file, "null");
+        return;
+    }
+
+    fprintf(file,
+            "{\"payload\": %zu, \"slack\": %zu, \"metadata\": %zu, \"overhead\": %zu, \"owned\": %zu, \"total\": %zu}",
+            mu->payload,
+            mu->slack,
+            mu->metadata,
+            mu->overhead,
+            mu->owned,
+            mu_total(mu));
+}
+
+size_t ms_usable_size(const void* ptr, size_t requested) {
+#ifdef __GLIBC__
+    if (ptr) {
+        size_t usable = malloc_usable_size((void*)ptr);
+        if (usable >= requested) return usable;
+    }
+#else
+    (void)ptr;
+#endif
+
+    return requested;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                              Process Registry                              *
+ *                                                                            *
+ ******************************************************************************/
+
+void ms_track(MSKind kind, int64_t containers, int64_t bytes) {
+    if ((unsigned)kind >= MS_KIND_COUNT) return;
+
+    if (containers) atomic_fetch_add_explicit(&__ms_containers[kind], containers, memory_order_relaxed);
+    if (bytes) atomic_fetch_add_explicit(&__ms_bytes[kind], bytes, memory_order_relaxed);
+}
+
+MSCounter ms_registry_get(MSKind kind) {
+    MSCounter counter = {0, 0};
+
+    if ((unsigned)kind >= MS_KIND_COUNT) return counter;
+
+    counter.containers = atomic_load_explicit(&__ms_containers[kind], memory_order_relaxed);
+    counter.bytes = atomic_load_explicit(&__ms_bytes[kind], memory_order_relaxed);
+
+    return counter;
+}
+
+MSCounter ms_registry_total(void) {
+    MSCounter total = {0, 0};
+
+    for (int kind = 0; kind < MS_KIND_COUNT; kind++) {
+        MSCounter counter = ms_registry_get((MSKind)kind);
+
+        total.containers += counter.containers;
+        total.bytes += counter.bytes;
+    }
+
+    return total;
+}
+
+void ms_fprint_registry_json(FILE* file) {
+    if (!file) file = stdout;
+
+    fprintf(file, "{");
+
+    for (int kind = 0; kind < MS_KIND_COUNT; kind++) {
+        MSCounter counter = ms_registry_get((MSKind)kind);
+
+        fprintf(file, "\"%s\": {\"containers\": %ld, \"bytes\": %ld}, ", __ms_kind_names[kind], counter.containers, counter.bytes);
+    }
+
+    MSCounter total = ms_registry_total();
+
+    fprintf(file, "\"total\": {\"containers\": %ld, \"bytes\": %ld}}", total.containers, total.bytes);
+}
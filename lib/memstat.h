@@ -0,0 +1,93 @@
+#ifndef MEMSTAT_H
+#define MEMSTAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Nomenclature used (to avoid collisions): <data_type>_<method_name>
+// Note: The registry counters are relaxed atomics, so they may be updated from any thread.
+
+/**
+ * @brief Memory Usage Breakdown of a single container.
+ *
+ * Filled in by the `*_memory_usage` functions of the containers (e.g.,
+ * `da_memory_usage`, `hs_memory_usage`). All values are in bytes.
+ */
+typedef struct MemoryUsage MemUsage;
+
+struct MemoryUsage {
+    size_t payload;   ///< Bytes occupied by the stored elements themselves.
+    size_t slack;     ///< Bytes reserved for elements (or bucket slots) that are currently unused.
+    size_t metadata;  ///< Bytes of bookkeeping: container headers, bucket arrays, node links, etc.
+    size_t overhead;  ///< Bytes the allocator handed out beyond what was requested (0 where this cannot be measured).
+    size_t owned;     ///< Bytes reached through the elements (e.g., `copier`-allocated fields), as reported by the caller's callback.
+};
+
+/// @brief Sums every category of a memory usage breakdown.
+/// @param mu Pointer to the breakdown.
+/// @return The total number of bytes.
+size_t mu_total(const MemUsage* mu);
+
+/// @brief Prints a memory usage breakdown as a single JSON object.
+/// @param file The output file stream (defaults to `stdout` if `NULL`).
+/// @param mu Pointer to the breakdown.
+void mu_fprint_json(FILE* file, const MemUsage* mu);
+
+/// @brief Gets the number of bytes the allocator actually reserved for a block.
+/// @details Uses `malloc_usable_size` on glibc; elsewhere (or for `NULL`) the requested size is returned.
+/// @param ptr Pointer returned by `malloc`/`calloc`/`realloc`/`posix_memalign`, or `NULL`.
+/// @param requested The size that was requested for the block.
+/// @return The usable size of the block, never less than `requested`.
+size_t ms_usable_size(const void* ptr, size_t requested);
+
+/******************************************************************************
+ *                                                                            *
+ *                              Process Registry                              *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Kinds of containers tracked by the process registry.
+typedef enum MemStatKind {
+    MS_DARRAY,  ///< `DArray`
+    MS_HSET,    ///< `HSet` (structure and buckets; nodes and key copies only with `-DHS_TRACK_NODES`)
+    MS_IHSET,   ///< `IHSet` (buckets only, the elements are owned by the caller)
+    MS_POOL,    ///< `Pool` (structure and slabs)
+    MS_ULIST,   ///< `ULList` (structure only, its nodes live in a `Pool`)
+    MS_HMSET,   ///< `HMultiset`
+    MS_RBTREE,  ///< `RBTree` (structure only, its nodes live in a `Pool`)
+    MS_TREAP,   ///< `Treap` (structure only, its nodes live in a `Pool`)
+    MS_ITREE,   ///< `ITree` (structure only, its nodes live in a `Pool`)
+    MS_IIDX,    ///< `IIndex`
+    MS_KDTREE,  ///< `KDTree`
+
+    MS_KIND_COUNT  ///< Number of kinds (not a kind itself).
+} MSKind;
+
+/// @brief Snapshot of the registry counters for one kind of container.
+typedef struct MemStatCounter {
+    int64_t containers;  ///< Number of live containers.
+    int64_t bytes;       ///< Heap bytes requested by the live containers (headers, storage, nodes and key copies).
+} MSCounter;
+
+/// @brief Records an allocation change in the process registry.
+/// @details Called by the containers themselves on creation, resizing, node allocation and freeing. The update is a relaxed atomic addition.
+/// @param kind The kind of container.
+/// @param containers Change in the number of live containers (`+1`, `-1` or `0`).
+/// @param bytes Change in the number of requested heap bytes (may be negative).
+void ms_track(MSKind kind, int64_t containers, int64_t bytes);
+
+/// @brief Reads the registry counters of one kind of container.
+/// @param kind The kind of container.
+/// @return A snapshot of the counters (zeroed for an invalid kind).
+MSCounter ms_registry_get(MSKind kind);
+
+/// @brief Reads the registry counters summed over every kind of container.
+/// @return A snapshot of the summed counters.
+MSCounter ms_registry_total(void);
+
+/// @brief Prints the registry as a JSON object, one entry per kind plus a total.
+/// @param file The output file stream (defaults to `stdout` if `NULL`).
+void ms_fprint_registry_json(FILE* file);
+
+#endif  // MEMSTAT_H
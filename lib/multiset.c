@@ -0,0 +1,490 @@
+#include "multiset.h"
+
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bits.h"
+#include "random.h"
+
+/**
+ * @brief Header of a multiset slot; the key follows at `sizeof(HMSSlot)`.
+ */
+typedef struct HashMultisetSlot {
+    uint64_t hash;  ///< Cached hash of the key, 0 if the slot is empty.
+    size_t count;   ///< Number of occurrences of the key.
+} HMSSlot;
+
+/******************************************************************************
+ *                                                                            *
+ *                              Inner Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+// slot size: header plus key, rounded to the key's (power of two) alignment
+inline static size_t __hms_stride(size_t element_size);
+// smallest power of two slot count holding `count` keys under `load_factor`
+inline static size_t __hms_capacity_for(size_t count, double load_factor);
+inline static HMSSlot* __hms_slot(const HMultiset* hms, size_t i);
+inline static void* __hms_key(const HMSSlot* slot);
+// never 0, which marks empty slots
+inline static uint64_t __hms_hash(const HMultiset* hms, const void* k);
+// index of the slot holding `k`, or of the empty slot ending its probe run
+inline static size_t __hms_probe(const HMultiset* hms, const void* k, uint64_t hash);
+// adds `n` occurrences of `k`, whose hash under `hms`'s seeds is `hash`
+static size_t __hms_add_hashed(HMultiset* hms, const void* k, uint64_t hash, size_t n);
+// empties slot `i`, shifting the rest of its probe run back
+static void __hms_erase_slot(HMultiset* hms, size_t i);
+static bool __hms_rehash(HMultiset* hms, size_t new_capacity);
+inline static int64_t __hms_bytes(const HMultiset* hms);
+// restores the min-heap (by count) property of `heap[0..n)` below `i`
+inline static void __hms_sift_down(HMSEntry* heap, size_t n, size_t i);
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+HMultiset* hms_new(
+    size_t element_size,
+    int (*cmp)(const void* a, const void* b),
+    uint64_t (*hasher)(const void* k, uint64_t seed_0, uint64_t seed_1),
+    void (*copier)(void* dest, const void* src),
+    void (*deallocator)(void* k)  //
+) {
+    return hms_new_with_capacity(element_size, cmp, hasher, copier, deallocator, 0);
+}
+
+HMultiset* hms_new_with_capacity(
+    size_t element_size,
+    int (*cmp)(const void* a, const void* b),
+    uint64_t (*hasher)(const void* k, uint64_t seed_0, uint64_t seed_1),
+    void (*copier)(void* dest, const void* src),
+    void (*deallocator)(void* k),
+    size_t capacity  //
+) {
+    if (element_size == 0 || !cmp || !hasher || !copier || !deallocator) return NULL;
+
+    HMultiset* hms = (HMultiset*)malloc(sizeof(HMultiset));
+    if (!hms) return NULL;
+
+    hms->load_factor = 0.75;
+    hms->element_size = element_size;
+    hms->stride = __hms_stride(element_size);
+    hms->capacity = __hms_capacity_for(capacity, hms->load_factor);
+
+    hms->slots = (char*)calloc(hms->capacity, hms->stride);
+    if (!hms->slots) {
+        free(hms);
+        return NULL;
+    }
+
+    hms->distinct = 0;
+    hms->total = 0;
+
+    hms->seed_0 = __random_u64();
+    hms->seed_1 = __random_u64();
+
+    hms->cmp = cmp;
+    hms->hasher = hasher;
+    hms->copier = copier;
+    hms->deallocator = deallocator;
+
+    ms_track(MS_HMSET, 1, __hms_bytes(hms));
+
+    return hms;
+}
+
+HMultiset* hms_copy(const HMultiset* hms) {
+    HMultiset* copy = hms_copy_metadata(hms);
+    if (!copy) return NULL;
+
+    if (copy->capacity != hms->capacity && !__hms_rehash(copy, hms->capacity)) {
+        hms_free(copy);
+        return NULL;
+    }
+
+    // Same seeds and capacity: every key lands in the very same slot
+    for (size_t i = 0; i < hms->capacity; i++) {
+        const HMSSlot* src = __hms_slot(hms, i);
+        if (!src->hash) continue;
+
+        HMSSlot* dest = __hms_slot(copy, i);
+
+        dest->hash = src->hash;
+        dest->count = src->count;
+        copy->copier(__hms_key(dest), __hms_key(src));
+    }
+
+    copy->distinct = hms->distinct;
+    copy->total = hms->total;
+
+    return copy;
+}
+
+HMultiset* hms_copy_metadata(const HMultiset* hms) {
+    if (!hms) return NULL;
+
+    HMultiset* copy = hms_new(hms->element_size, hms->cmp, hms->hasher, hms->copier, hms->deallocator);
+    if (!copy) return NULL;
+
+    copy->seed_0 = hms->seed_0;
+    copy->seed_1 = hms->seed_1;
+    copy->load_factor = hms->load_factor;
+
+    return copy;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                             Clean Up & Freeing                             *
+ *                                                                            *
+ ******************************************************************************/
+
+void hms_free(HMultiset* hms) {
+    if (!hms) return;
+
+    hms_clear(hms);
+
+    ms_track(MS_HMSET, -1, -__hms_bytes(hms));
+
+    free(hms->slots);
+    free(hms);
+}
+
+void hms_clear(HMultiset* hms) {
+    if (!hms) return;
+
+    for (size_t i = 0; i < hms->capacity; i++) {
+        HMSSlot* slot = __hms_slot(hms, i);
+        if (!slot->hash) continue;
+
+        hms->deallocator(__hms_key(slot));
+        slot->hash = 0;
+        slot->count = 0;
+    }
+
+    hms->distinct = 0;
+    hms->total = 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Basic Getters                                *
+ *                                                                            *
+ ******************************************************************************/
+
+size_t hms_distinct(const HMultiset* hms) {
+    return hms ? hms->distinct : 0;
+}
+
+size_t hms_total(const HMultiset* hms) {
+    return hms ? hms->total : 0;
+}
+
+bool hms_is_empty(const HMultiset* hms) {
+    return !hms || hms->distinct == 0;
+}
+
+size_t hms_count(const HMultiset* hms, const void* k) {
+    if (!hms || !k) return 0;
+
+    const HMSSlot* slot = __hms_slot(hms, __hms_probe(hms, k, __hms_hash(hms, k)));
+
+    return slot->hash ? slot->count : 0;
+}
+
+bool hms_contains(const HMultiset* hms, const void* k) {
+    return hms_count(hms, k) > 0;
+}
+
+const void* hms_next(const HMultiset* hms, size_t* it, size_t* count) {
+    if (!hms || !it) return NULL;
+
+    while (*it < hms->capacity) {
+        const HMSSlot* slot = __hms_slot(hms, (*it)++);
+
+        if (slot->hash) {
+            if (count) *count = slot->count;
+            return __hms_key(slot);
+        }
+    }
+
+    return NULL;
+}
+
+size_t hms_most_common(const HMultiset* hms, size_t k, HMSEntry* out) {
+    if (!hms || !out || k == 0) return 0;
+
+    // `out` doubles as a min-heap of the k largest counts seen so far
+    size_t n = 0;
+
+    for (size_t i = 0; i < hms->capacity; i++) {
+        const HMSSlot* slot = __hms_slot(hms, i);
+        if (!slot->hash) continue;
+
+        HMSEntry entry = {__hms_key(slot), slot->count};
+
+        if (n < k) {
+            size_t j = n++;
+
+            while (j > 0 && out[(j - 1) / 2].count > entry.count) {
+                out[j] = out[(j - 1) / 2];
+                j = (j - 1) / 2;
+            }
+
+            out[j] = entry;
+        } else if (entry.count > out[0].count) {
+            out[0] = entry;
+            __hms_sift_down(out, n, 0);
+        }
+    }
+
+    // Heap sort: moving the minimum to the back leaves the entries by decreasing count
+    for (size_t end = n; end > 1; end--) {
+        HMSEntry min = out[0];
+
+        out[0] = out[end - 1];
+        out[end - 1] = min;
+
+        __hms_sift_down(out, end - 1, 0);
+    }
+
+    return n;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                             Updates & Merging                              *
+ *                                                                            *
+ ******************************************************************************/
+
+size_t hms_add(HMultiset* hms, const void* k, size_t n) {
+    if (!hms || !k) return (size_t)-1;
+
+    return __hms_add_hashed(hms, k, __hms_hash(hms, k), n);
+}
+
+size_t hms_remove(HMultiset* hms, const void* k, size_t n) {
+    if (!hms || !k || n == 0) return 0;
+
+    size_t i = __hms_probe(hms, k, __hms_hash(hms, k));
+    HMSSlot* slot = __hms_slot(hms, i);
+    if (!slot->hash) return 0;
+
+    size_t removed = n < slot->count ? n : slot->count;
+
+    slot->count -= removed;
+    hms->total -= removed;
+
+    if (slot->count == 0) {
+        hms->deallocator(__hms_key(slot));
+        __hms_erase_slot(hms, i);
+    }
+
+    return removed;
+}
+
+bool hms_merge(HMultiset* dest, const HMultiset* src) {
+    if (!dest || !src || dest->element_size != src->element_size) return false;
+    if (dest == src) return false;
+
+    const bool same_hash = dest->hasher == src->hasher && dest->seed_0 == src->seed_0 && dest->seed_1 == src->seed_1;
+
+    for (size_t i = 0; i < src->capacity; i++) {
+        const HMSSlot* slot = __hms_slot(src, i);
+        if (!slot->hash) continue;
+
+        const void* k = __hms_key(slot);
+        uint64_t hash = same_hash ? slot->hash : __hms_hash(dest, k);
+
+        if (__hms_add_hashed(dest, k, hash, slot->count) == (size_t)-1) return false;
+    }
+
+    return true;
+}
+
+bool hms_reserve(HMultiset* hms, size_t capacity) {
+    if (!hms) return false;
+
+    size_t slots = __hms_capacity_for(capacity, hms->load_factor);
+    if (slots <= hms->capacity) return true;
+
+    return __hms_rehash(hms, slots);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                             Memory Accounting                              *
+ *                                                                            *
+ ******************************************************************************/
+
+MemUsage hms_memory_usage(const HMultiset* hms, size_t (*owned_size)(const void* k)) {
+    MemUsage mu = {0, 0, 0, 0, 0};
+    if (!hms) return mu;
+
+    const size_t table_bytes = hms->capacity * hms->stride;
+
+    mu.payload = hms->distinct * hms->element_size;
+    mu.metadata = sizeof(HMultiset) + hms->capacity * sizeof(HMSSlot);
+    mu.slack = table_bytes - mu.payload - hms->capacity * sizeof(HMSSlot);
+    mu.overhead = (ms_usable_size(hms, sizeof(HMultiset)) - sizeof(HMultiset)) + (ms_usable_size(hms->slots, table_bytes) - table_bytes);
+
+    if (owned_size) {
+        for (size_t i = 0; i < hms->capacity; i++) {
+            const HMSSlot* slot = __hms_slot(hms, i);
+            if (slot->hash) mu.owned += owned_size(__hms_key(slot));
+        }
+    }
+
+    return mu;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                       Inner Functions Implementation                       *
+ *                                                                            *
+ ******************************************************************************/
+
+inline static size_t __hms_stride(size_t element_size) {
+    size_t align = element_size & -element_size;  // largest power of two dividing the size
+
+    if (align > alignof(max_align_t)) align = alignof(max_align_t);
+    if (align < alignof(HMSSlot)) align = alignof(HMSSlot);
+
+    return (sizeof(HMSSlot) + element_size + align - 1) & ~(align - 1);
+}
+
+inline static size_t __hms_capacity_for(size_t count, double load_factor) {
+    size_t needed = (size_t)((double)count / load_factor) + 1;
+
+    return needed < 8 ? 8 : bits_npo2(needed);
+}
+
+inline static HMSSlot* __hms_slot(const HMultiset* hms, size_t i) {
+    return (HMSSlot*)(hms->slots + i * hms->stride);
+}
+
+inline static void* __hms_key(const HMSSlot* slot) {
+    return (char*)slot + sizeof(HMSSlot);
+}
+
+inline static uint64_t __hms_hash(const HMultiset* hms, const void* k) {
+    uint64_t hash = hms->hasher(k, hms->seed_0, hms->seed_1);
+
+    return hash ? hash : 1;
+}
+
+inline static size_t __hms_probe(const HMultiset* hms, const void* k, uint64_t hash) {
+    const size_t mask = hms->capacity - 1;
+    size_t i = (size_t)hash & mask;
+
+    for (;;) {
+        const HMSSlot* slot = __hms_slot(hms, i);
+
+        if (!slot->hash || (slot->hash == hash && hms->cmp(__hms_key(slot), k) == 0)) return i;
+
+        i = (i + 1) & mask;
+    }
+}
+
+static size_t __hms_add_hashed(HMultiset* hms, const void* k, uint64_t hash, size_t n) {
+    size_t i = __hms_probe(hms, k, hash);
+    HMSSlot* slot = __hms_slot(hms, i);
+
+    if (slot->hash) {
+        slot->count += n;
+        hms->total += n;
+
+        return slot->count;
+    }
+
+    if (n == 0) return 0;
+
+    if ((double)(hms->distinct + 1) > (double)hms->capacity * hms->load_factor) {
+        if (!__hms_rehash(hms, hms->capacity * 2)) return (size_t)-1;
+
+        slot = __hms_slot(hms, __hms_probe(hms, k, hash));
+    }
+
+    slot->hash = hash;
+    slot->count = n;
+    hms->copier(__hms_key(slot), k);
+
+    hms->distinct++;
+    hms->total += n;
+
+    return n;
+}
+
+static void __hms_erase_slot(HMultiset* hms, size_t i) {
+    const size_t mask = hms->capacity - 1;
+
+    for (size_t j = (i + 1) & mask; __hms_slot(hms, j)->hash; j = (j + 1) & mask) {
+        size_t home = (size_t)__hms_slot(hms, j)->hash & mask;
+
+        // `j` may move into the hole at `i` only if its home is not in (i, j]
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            memcpy(__hms_slot(hms, i), __hms_slot(hms, j), hms->stride);
+            i = j;
+        }
+    }
+
+    __hms_slot(hms, i)->hash = 0;
+    __hms_slot(hms, i)->count = 0;
+
+    hms->distinct--;
+}
+
+static bool __hms_rehash(HMultiset* hms, size_t new_capacity) {
+    char* new_slots = (char*)calloc(new_capacity, hms->stride);
+    if (!new_slots) return false;
+
+    const size_t mask = new_capacity - 1;
+
+    // Cached hashes: keys are relocated bytewise, the hasher is never called
+    for (size_t i = 0; i < hms->capacity; i++) {
+        const HMSSlot* slot = __hms_slot(hms, i);
+        if (!slot->hash) continue;
+
+        size_t j = (size_t)slot->hash & mask;
+        while (((HMSSlot*)(new_slots + j * hms->stride))->hash) j = (j + 1) & mask;
+
+        memcpy(new_slots + j * hms->stride, slot, hms->stride);
+    }
+
+    const int64_t old_bytes = __hms_bytes(hms);
+
+    free(hms->slots);
+
+    hms->slots = new_slots;
+    hms->capacity = new_capacity;
+
+    ms_track(MS_HMSET, 0, __hms_bytes(hms) - old_bytes);
+
+    return true;
+}
+
+inline static int64_t __hms_bytes(const HMultiset* hms) {
+    return (int64_t)(sizeof(HMultiset) + hms->capacity * hms->stride);
+}
+
+inline static void __hms_sift_down(HMSEntry* heap, size_t n, size_t i) {
+    HMSEntry entry = heap[i];
+
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= n) break;
+
+        if (child + 1 < n && heap[child + 1].count < heap[child].count) child++;
+        if (heap[child].count >= entry.count) break;
+
+        heap[i] = heap[child];
+        i = child;
+    }
+
+    heap[i] = entry;
+}
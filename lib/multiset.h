@@ -0,0 +1,208 @@
+#ifndef MULTISET_H
+#define MULTISET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "memstat.h"
+
+// Nomenclature used (to avoid collisions): <data_type>_<method_name>
+// Warning: This implementation is not thread-safe, and is for educational purposes only.
+
+/**
+ * @brief Hash Multiset (Generic implementation)
+ *
+ * Counts occurrences of keys. Each distinct key is stored once, inline in an
+ * open-addressing table (linear probing, backward-shift deletion), in the
+ * same slot as its cached hash and its count: adding, counting or removing
+ * occurrences is a single probe, with no allocation per update.
+ *
+ * Multisets derived from one another (`hms_copy`, `hms_copy_metadata`) share
+ * their seeds, so `hms_merge` between them reuses the cached hashes instead of
+ * calling the hasher.
+ */
+typedef struct HashMultiset HMultiset;
+
+struct HashMultiset {
+    char* slots;  ///< `capacity` slots of `stride` bytes: cached hash (0 = empty), count, then the key.
+
+    size_t distinct;      ///< Number of distinct keys stored.
+    size_t total;         ///< Sum of all counts.
+    size_t capacity;      ///< Number of slots, always a power of two.
+    size_t element_size;  ///< Size of key type in bytes.
+    size_t stride;        ///< Size of a slot in bytes.
+
+    uint64_t seed_0;  ///< First seed for the inner hashing function.
+    uint64_t seed_1;  ///< Second seed for the inner hashing function.
+
+    double load_factor;  ///< Maximum `distinct / capacity` before the table doubles.
+
+    int (*cmp)(const void* a, const void* b);                             ///< Returns 0 if two keys are equal.
+    uint64_t (*hasher)(const void* k, uint64_t seed_0, uint64_t seed_1);  ///< Hashes a key.
+    void (*copier)(void* dest, const void* src);                          ///< Copies a key into its slot on first insertion.
+    void (*deallocator)(void* k);                                         ///< Frees the resources of a key once its count drops to 0.
+};
+
+/// @brief A key and its number of occurrences (see `hms_most_common`).
+typedef struct HashMultisetEntry {
+    const void* key;  ///< Pointer to the stored key (valid until the multiset is next modified).
+    size_t count;     ///< Number of occurrences.
+} HMSEntry;
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Creates a new, empty multiset.
+/// @param element_size The size of the key type in bytes.
+/// @param cmp Pointer to the comparison function.
+/// @param hasher Pointer to the hashing function.
+/// @param copier Pointer to the deep copy function.
+/// @param deallocator Pointer to the deallocation function.
+/// @return A pointer to the newly allocated `HMultiset`, or `NULL` on failure.
+HMultiset* hms_new(
+    size_t element_size,
+    int (*cmp)(const void* a, const void* b),
+    uint64_t (*hasher)(const void* k, uint64_t seed_0, uint64_t seed_1),
+    void (*copier)(void* dest, const void* src),
+    void (*deallocator)(void* k)  //
+);
+
+/// @brief Creates a new, empty multiset with room for `capacity` distinct keys.
+/// @param element_size The size of the key type in bytes.
+/// @param cmp Pointer to the comparison function.
+/// @param hasher Pointer to the hashing function.
+/// @param copier Pointer to the deep copy function.
+/// @param deallocator Pointer to the deallocation function.
+/// @param capacity Expected number of distinct keys.
+/// @return A pointer to the newly allocated `HMultiset`, or `NULL` on failure.
+HMultiset* hms_new_with_capacity(
+    size_t element_size,
+    int (*cmp)(const void* a, const void* b),
+    uint64_t (*hasher)(const void* k, uint64_t seed_0, uint64_t seed_1),
+    void (*copier)(void* dest, const void* src),
+    void (*deallocator)(void* k),
+    size_t capacity  //
+);
+
+/// @brief Creates a deep copy of a multiset (same seeds, same layout, no rehashing).
+/// @param hms Pointer to the source multiset.
+/// @return A pointer to the copy, or `NULL` on failure.
+HMultiset* hms_copy(const HMultiset* hms);
+
+/// @brief Creates an empty multiset with the same configuration and seeds as `hms`.
+/// @param hms Pointer to the source multiset.
+/// @return A pointer to the new multiset, or `NULL` on failure.
+HMultiset* hms_copy_metadata(const HMultiset* hms);
+
+/******************************************************************************
+ *                                                                            *
+ *                             Clean Up & Freeing                             *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Frees the multiset and its keys.
+/// @param hms Pointer to the multiset.
+void hms_free(HMultiset* hms);
+
+/// @brief Removes every key (via `deallocator`), keeping the capacity.
+/// @param hms Pointer to the multiset.
+void hms_clear(HMultiset* hms);
+
+/******************************************************************************
+ *                                                                            *
+ *                               Basic Getters                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Gets the number of distinct keys.
+/// @param hms Pointer to the multiset.
+/// @return The number of distinct keys.
+size_t hms_distinct(const HMultiset* hms);
+
+/// @brief Gets the total number of occurrences (the sum of all counts).
+/// @param hms Pointer to the multiset.
+/// @return The total count.
+size_t hms_total(const HMultiset* hms);
+
+/// @brief Checks if the multiset is empty.
+/// @param hms Pointer to the multiset.
+/// @return `true` if `hms` is `NULL` or holds no key.
+bool hms_is_empty(const HMultiset* hms);
+
+/// @brief Gets the number of occurrences of `k`. Single probe.
+/// @param hms Pointer to the multiset.
+/// @param k Pointer to the key.
+/// @return The count of `k` (0 if absent).
+size_t hms_count(const HMultiset* hms, const void* k);
+
+/// @brief Checks if `k` occurs at least once.
+/// @param hms Pointer to the multiset.
+/// @param k Pointer to the key.
+/// @return `true` if present.
+bool hms_contains(const HMultiset* hms, const void* k);
+
+/// @brief Iterates over the distinct keys: `for (size_t it = 0; (k = hms_next(hms, &it, &count));)`.
+/// @param hms Pointer to the multiset (must not be modified during the iteration).
+/// @param it Iteration cursor, initialized to 0.
+/// @param count Receives the count of the returned key (may be `NULL`).
+/// @return Pointer to the next stored key, or `NULL` at the end.
+const void* hms_next(const HMultiset* hms, size_t* it, size_t* count);
+
+/// @brief Finds the `k` keys with the highest counts, in O(distinct * log k) with a bounded heap.
+/// @param hms Pointer to the multiset.
+/// @param k Maximum number of entries to return.
+/// @param out Array of at least `k` entries, filled by decreasing count (ties in no particular order).
+/// @return The number of entries written, `min(k, distinct)`.
+size_t hms_most_common(const HMultiset* hms, size_t k, HMSEntry* out);
+
+/******************************************************************************
+ *                                                                            *
+ *                             Updates & Merging                              *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Adds `n` occurrences of `k`. Single probe; the key is copied only on its first occurrence.
+/// @param hms Pointer to the multiset.
+/// @param k Pointer to the key.
+/// @param n Number of occurrences to add (adding 0 never inserts the key).
+/// @return The new count of `k`, or `(size_t)-1` on failure.
+size_t hms_add(HMultiset* hms, const void* k, size_t n);
+
+/// @brief Removes up to `n` occurrences of `k`; the key is deallocated once its count reaches 0.
+/// @param hms Pointer to the multiset.
+/// @param k Pointer to the key.
+/// @param n Number of occurrences to remove (`SIZE_MAX` removes them all).
+/// @return The number of occurrences actually removed.
+size_t hms_remove(HMultiset* hms, const void* k, size_t n);
+
+/// @brief Adds every occurrence of `src` to `dest`.
+/// @details When both multisets share seeds and hasher (see `hms_copy_metadata`), the cached hashes of `src` are reused and the hasher is never called.
+/// @param dest Pointer to the destination multiset.
+/// @param src Pointer to the source multiset.
+/// @return `true` on success, `false` if the key types differ, `dest == src`, or on allocation failure.
+bool hms_merge(HMultiset* dest, const HMultiset* src);
+
+/// @brief Grows the table to hold `capacity` distinct keys without exceeding the load factor.
+/// @param hms Pointer to the multiset.
+/// @param capacity Expected number of distinct keys.
+/// @return `true` on success (or if already large enough), `false` on allocation failure.
+bool hms_reserve(HMultiset* hms, size_t capacity);
+
+/******************************************************************************
+ *                                                                            *
+ *                             Memory Accounting                              *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Breaks down the memory used by the multiset.
+/// @details `payload` is the stored keys, `metadata` the structure plus each slot's hash and count, `slack` the empty slots and padding, and `overhead` the allocator's rounding.
+/// @param hms Pointer to the multiset.
+/// @param owned_size Returns the bytes owned by a key (may be `NULL`).
+/// @return The breakdown (zeroed if `hms` is `NULL`).
+MemUsage hms_memory_usage(const HMultiset* hms, size_t (*owned_size)(const void* k));
+
+#endif  // MULTISET_H
@@ -0,0 +1,634 @@
+#include "ntheory.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bits.h"
+#include "par_for.h"
+
+/// Bytes per sieve segment (each byte covers 30 numbers), sized for the L1 data cache.
+#define __NT_SEGMENT_BYTES 32768
+
+/// Period in wheel bytes of the multiples of the pre-sieved primes 7, 11, 13 and 17.
+#define __NT_PRESIEVE_PERIOD (7 * 11 * 13 * 17)
+
+/******************************************************************************
+ *                                                                            *
+ *                              Inner Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+__extension__ typedef __int128 nt_i128;
+
+/// A contiguous run of wheel bytes sieved by one thread.
+typedef struct NTSieveTask {
+    const uint32_t* primes;  ///< Sieving primes from 19 up to `sqrt(hi)`.
+    size_t nprimes;
+    const uint8_t* pattern;  ///< Segment image with the multiples of 7 to 17 crossed off, `period + segment` bytes.
+    uint64_t lo;             ///< Numbers range `[lo, hi)`.
+    uint64_t hi;
+    uint64_t first;          ///< Wheel bytes `[first, last)` of this task.
+    uint64_t last;
+    bool collect;            ///< Whether to list the primes or only count them.
+    uint64_t count;          ///< Primes found.
+    uint64_t* out;           ///< Listed primes (when `collect`).
+    size_t out_capacity;
+    bool ok;
+} NTSieveTask;
+
+/// Residues modulo 30 of the numbers coprime to 30, one per bit of a wheel byte.
+static const uint8_t __nt_wheel[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+
+/// Bit of each residue modulo 30 in a wheel byte (`-1` for residues sharing a factor with 30).
+static const int8_t __nt_wheel_bit[30] = {
+    -1, 0, -1, -1, -1, -1, -1, 1, -1, -1, -1, 2, -1, 3, -1, -1, -1, 4, -1, 5, -1, -1, -1, 6, -1, -1, -1, -1, -1, 7,
+};
+
+// fills `m` for an odd `n > 1` (unchecked)
+inline static void __nt_mont_setup(NTMont* m, uint64_t n);
+inline static uint64_t __nt_isqrt(uint64_t n);
+// odd-only sieve of Eratosthenes for the primes in `[19, limit]`
+static uint32_t* __nt_sieving_primes(uint64_t limit, size_t* count);
+static uint8_t* __nt_presieve_pattern(void);
+// runs the sieve over `[lo, hi)` split into `threads` tasks; the caller frees `tasks[i].out` and `*tasks`
+static bool __nt_sieve(uint64_t lo, uint64_t hi, size_t threads, bool collect, NTSieveTask** tasks, size_t* ntasks);
+static void* __nt_sieve_task(void* arg);
+inline static bool __nt_collect(NTSieveTask* task, uint64_t byte, uint8_t bits);
+inline static bool __nt_miller_rabin(const NTMont* m, uint64_t base, uint64_t d, unsigned s);
+
+/******************************************************************************
+ *                                                                            *
+ *                            Montgomery & Barrett                            *
+ *                                                                            *
+ ******************************************************************************/
+
+bool nt_mont_init(NTMont* m, uint64_t n) {
+    if (!m || n < 3 || !(n & 1)) return false;
+
+    __nt_mont_setup(m, n);
+
+    return true;
+}
+
+uint64_t nt_mont_pow(const NTMont* m, uint64_t a, uint64_t e) {
+    uint64_t result = m->r1;
+
+    for (; e; e >>= 1) {
+        if (e & 1) result = nt_mont_mul(m, result, a);
+        a = nt_mont_mul(m, a, a);
+    }
+
+    return result;
+}
+
+bool nt_barrett_init(NTBarrett* b, uint64_t n) {
+    if (!b || n < 2) return false;
+
+    const nt_u128 mu = ~(nt_u128)0 / n;
+
+    b->n = n;
+    b->mu_hi = (uint64_t)(mu >> 64);
+    b->mu_lo = (uint64_t)mu;
+
+    return true;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                             Modular Arithmetic                             *
+ *                                                                            *
+ ******************************************************************************/
+
+uint64_t nt_gcd(uint64_t a, uint64_t b) {
+    if (!a) return b;
+    if (!b) return a;
+
+    const unsigned shift = bits_ctz(a | b);
+    a >>= bits_ctz(a);
+
+    while (b) {
+        b >>= bits_ctz(b);
+        if (a > b) {
+            const uint64_t t = a;
+            a = b;
+            b = t;
+        }
+        b -= a;
+    }
+
+    return a << shift;
+}
+
+uint64_t nt_mulmod(uint64_t a, uint64_t b, uint64_t n) {
+    if (!n) return 0;
+
+    return (uint64_t)(((nt_u128)a * b) % n);
+}
+
+uint64_t nt_powmod(uint64_t a, uint64_t e, uint64_t n) {
+    if (n < 2) return 0;
+
+    if (n & 1) {
+        NTMont m;
+        __nt_mont_setup(&m, n);
+
+        return nt_mont_from(&m, nt_mont_pow(&m, nt_mont_to(&m, a), e));
+    }
+
+    NTBarrett b;
+    nt_barrett_init(&b, n);
+
+    uint64_t result = 1;
+    a %= n;
+
+    for (; e; e >>= 1) {
+        if (e & 1) result = nt_barrett_mul(&b, result, a);
+        a = nt_barrett_mul(&b, a, a);
+    }
+
+    return result;
+}
+
+uint64_t nt_invmod(uint64_t a, uint64_t n) {
+    if (n < 2) return 0;
+
+    // Coefficients stay within `n` in absolute value, so 128 bits never overflow
+    nt_i128 t0 = 0, t1 = 1;
+    uint64_t r0 = n, r1 = a % n;
+
+    while (r1) {
+        const uint64_t q = r0 / r1;
+
+        const uint64_t r = r0 - q * r1;
+        r0 = r1;
+        r1 = r;
+
+        const nt_i128 t = t0 - (nt_i128)q * t1;
+        t0 = t1;
+        t1 = t;
+    }
+
+    if (r0 != 1) return 0;
+
+    return (uint64_t)(t0 < 0 ? t0 + n : t0);
+}
+
+bool nt_invmod_batch(const uint64_t* a, size_t count, uint64_t n, uint64_t* out) {
+    if ((!a || !out) && count) return false;
+    if (n < 2) return false;
+    if (!count) return true;
+
+    if (!(n & 1)) {
+        // Even modulus: Barrett reduction instead of the Montgomery form
+        NTBarrett b;
+        nt_barrett_init(&b, n);
+
+        out[0] = a[0] % n;
+        for (size_t i = 1; i < count; i++) out[i] = nt_barrett_mul(&b, out[i - 1], a[i] % n);
+
+        uint64_t inv = nt_invmod(out[count - 1], n);
+        if (!inv) return false;
+
+        for (size_t i = count - 1; i > 0; i--) {
+            out[i] = nt_barrett_mul(&b, inv, out[i - 1]);
+            inv = nt_barrett_mul(&b, inv, a[i] % n);
+        }
+        out[0] = inv;
+
+        return true;
+    }
+
+    NTMont m;
+    __nt_mont_setup(&m, n);
+
+    // Prefix products in Montgomery form: out[i] = a[0] * ... * a[i]
+    out[0] = nt_mont_to(&m, a[0]);
+    for (size_t i = 1; i < count; i++) out[i] = nt_mont_mul(&m, out[i - 1], nt_mont_to(&m, a[i]));
+
+    uint64_t inv = nt_invmod(nt_mont_from(&m, out[count - 1]), n);
+    if (!inv) return false;
+
+    inv = nt_mont_to(&m, inv);
+
+    // Walk back: inv holds (a[0] * ... * a[i])^-1, so inv * prefix[i - 1] = a[i]^-1
+    for (size_t i = count - 1; i > 0; i--) {
+        const uint64_t ai = nt_mont_to(&m, a[i]);
+        out[i] = nt_mont_from(&m, nt_mont_mul(&m, inv, out[i - 1]));
+        inv = nt_mont_mul(&m, inv, ai);
+    }
+    out[0] = nt_mont_from(&m, inv);
+
+    return true;
+}
+
+bool nt_crt(const uint64_t* r, const uint64_t* m, size_t count, uint64_t* x, uint64_t* lcm) {
+    if (!r || !m || !x) return false;
+
+    uint64_t acc = 0, mod = 1;
+
+    for (size_t i = 0; i < count; i++) {
+        if (!m[i]) return false;
+
+        const uint64_t mi = m[i], ri = r[i] % mi;
+        const uint64_t g = nt_gcd(mod, mi);
+
+        // acc + mod * k = ri (mod mi), solvable iff g divides the difference
+        const uint64_t diff = (ri + mi - acc % mi) % mi;
+        if (diff % g) return false;
+
+        const uint64_t step = mi / g;
+        if ((nt_u128)mod * step > UINT64_MAX) return false;
+
+        uint64_t k = 0;
+        if (step > 1) k = nt_mulmod(diff / g, nt_invmod((mod / g) % step, step), step);
+
+        acc = (uint64_t)(acc + (nt_u128)mod * k);
+        mod *= step;
+    }
+
+    *x = acc;
+    if (lcm) *lcm = mod;
+
+    return true;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Primality                                  *
+ *                                                                            *
+ ******************************************************************************/
+
+bool nt_is_prime(uint64_t n) {
+    static const uint8_t small[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61};
+
+    if (n < 2) return false;
+
+    for (size_t i = 0; i < sizeof(small); i++) {
+        if (n == small[i]) return true;
+        if (n % small[i] == 0) return false;
+    }
+
+    if (n < 67 * 67) return true;
+
+    // n - 1 = d * 2^s, d odd
+    const unsigned s = bits_ctz(n - 1);
+    const uint64_t d = (n - 1) >> s;
+
+    NTMont m;
+    __nt_mont_setup(&m, n);
+
+    // Jim Sinclair's bases: no strong pseudoprime to all of them below 2^64
+    static const uint64_t bases[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+
+    for (size_t i = 0; i < sizeof(bases) / sizeof(bases[0]); i++) {
+        if (!__nt_miller_rabin(&m, bases[i], d, s)) return false;
+    }
+
+    return true;
+}
+
+uint64_t nt_prime_count(uint64_t lo, uint64_t hi, size_t threads) {
+    NTSieveTask* tasks;
+    size_t ntasks;
+
+    if (!__nt_sieve(lo, hi, threads, false, &tasks, &ntasks)) return (uint64_t)-1;
+
+    uint64_t count = 0;
+    for (size_t t = 0; t < ntasks; t++) count += tasks[t].count;
+
+    free(tasks);
+
+    // 2, 3 and 5 are not on the wheel
+    for (uint64_t p = 2; p <= 5; p += p == 2 ? 1 : 2) count += p >= lo && p < hi;
+
+    return count;
+}
+
+DArray* nt_primes(uint64_t lo, uint64_t hi, size_t threads) {
+    NTSieveTask* tasks;
+    size_t ntasks;
+
+    if (!__nt_sieve(lo, hi, threads, true, &tasks, &ntasks)) return NULL;
+
+    uint64_t total = 3;
+    for (size_t t = 0; t < ntasks; t++) total += tasks[t].count;
+
+    DArray* out = da_new_with_capacity(sizeof(uint64_t), (size_t)total);
+
+    if (out) {
+        uint64_t* arr = (uint64_t*)out->arr;
+
+        for (uint64_t p = 2; p <= 5; p += p == 2 ? 1 : 2) {
+            if (p >= lo && p < hi) arr[out->length++] = p;
+        }
+
+        for (size_t t = 0; t < ntasks; t++) {
+            memcpy(arr + out->length, tasks[t].out, tasks[t].count * sizeof(uint64_t));
+            out->length += tasks[t].count;
+        }
+    }
+
+    for (size_t t = 0; t < ntasks; t++) free(tasks[t].out);
+    free(tasks);
+
+    return out;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                       Inner Functions Implementation                       *
+ *                                                                            *
+ ******************************************************************************/
+
+inline static void __nt_mont_setup(NTMont* m, uint64_t n) {
+    // Newton's iteration doubles the correct low bits each step; `n * n = 1 (mod 8)` gives 3 to start with
+    uint64_t inv = n;
+    for (int i = 0; i < 5; i++) inv *= 2 - n * inv;
+
+    m->n = n;
+    m->inv = inv;
+    m->r1 = (0 - n) % n;
+    m->r2 = (uint64_t)(((nt_u128)m->r1 * m->r1) % n);
+}
+
+inline static uint64_t __nt_isqrt(uint64_t n) {
+    uint64_t r = (uint64_t)sqrtl((long double)n);
+
+    while (r > 0 && (nt_u128)r * r > n) r--;
+    while ((nt_u128)(r + 1) * (r + 1) <= n) r++;
+
+    return r;
+}
+
+static uint32_t* __nt_sieving_primes(uint64_t limit, size_t* count) {
+    *count = 0;
+
+    // composite[i] marks 2i + 1
+    const size_t half = (size_t)(limit / 2 + 1);
+    uint8_t* composite = (uint8_t*)calloc(half, 1);
+    if (!composite) return NULL;
+
+    size_t found = 0;
+    for (size_t i = 1; i < half; i++) {
+        if (composite[i]) continue;
+
+        const uint64_t p = 2 * i + 1;
+        if (p > limit) break;
+
+        found++;
+        for (uint64_t j = p * p / 2; j < half; j += p) composite[j] = 1;
+    }
+
+    uint32_t* primes = (uint32_t*)malloc((found ? found : 1) * sizeof(uint32_t));
+
+    if (primes) {
+        for (size_t i = 1; i < half; i++) {
+            const uint64_t p = 2 * i + 1;
+            if (p > limit) break;
+            if (!composite[i] && p >= 19) primes[(*count)++] = (uint32_t)p;
+        }
+    }
+
+    free(composite);
+
+    return primes;
+}
+
+static uint8_t* __nt_presieve_pattern(void) {
+    const size_t size = __NT_PRESIEVE_PERIOD + __NT_SEGMENT_BYTES;
+
+    uint8_t* pattern = (uint8_t*)malloc(size);
+    if (!pattern) return NULL;
+
+    // 30 * period is a multiple of 7 * 11 * 13 * 17, so a segment starting at byte `base` looks like the pattern at
+    // `base % period`, and the extra segment length saves wrapping around
+    for (size_t b = 0; b < size; b++) {
+        uint8_t bits = 0;
+
+        for (size_t k = 0; k < 8; k++) {
+            const uint64_t v = 30 * (uint64_t)b + __nt_wheel[k];
+            if (v % 7 && v % 11 && v % 13 && v % 17) bits |= (uint8_t)(1u << k);
+        }
+
+        pattern[b] = bits;
+    }
+
+    return pattern;
+}
+
+static bool __nt_sieve(uint64_t lo, uint64_t hi, size_t threads, bool collect, NTSieveTask** tasks, size_t* ntasks) {
+    if (lo < 7) lo = 7;  // below 7 only 2, 3 and 5, handled by the callers
+    if (hi < lo) hi = lo;
+
+    // Wheel bytes covering [lo, hi)
+    const uint64_t first = lo / 30, last = hi / 30 + (hi % 30 != 0);
+    const uint64_t bytes = last - first;
+    const uint64_t segments = (bytes + __NT_SEGMENT_BYTES - 1) / __NT_SEGMENT_BYTES;
+
+    if (threads < 1) threads = 1;
+    if (threads > segments) threads = segments ? (size_t)segments : 1;
+
+    size_t nprimes;
+    uint32_t* primes = __nt_sieving_primes(hi > 1 ? __nt_isqrt(hi - 1) : 0, &nprimes);
+    uint8_t* pattern = __nt_presieve_pattern();
+
+    NTSieveTask* ts = (NTSieveTask*)calloc(threads, sizeof(NTSieveTask));
+
+    if (!primes || !pattern || !ts) {
+        free(primes);
+        free(pattern);
+        free(ts);
+        return false;
+    }
+
+    for (size_t t = 0; t < threads; t++) {
+        // Split on segment boundaries so every task but the last sieves whole segments
+        const uint64_t s0 = segments * t / threads, s1 = segments * (t + 1) / threads;
+
+        ts[t] = (NTSieveTask){primes, nprimes, pattern, lo, hi, 0, 0, collect, 0, NULL, 0, true};
+        ts[t].first = first + s0 * __NT_SEGMENT_BYTES;
+        ts[t].last = first + s1 * __NT_SEGMENT_BYTES < last ? first + s1 * __NT_SEGMENT_BYTES : last;
+    }
+
+    __par_for(threads, __nt_sieve_task, ts, sizeof(NTSieveTask));
+
+    bool ok = true;
+    for (size_t t = 0; t < threads; t++) ok &= ts[t].ok;
+
+    free(primes);
+    free(pattern);
+
+    if (!ok) {
+        for (size_t t = 0; t < threads; t++) free(ts[t].out);
+        free(ts);
+        return false;
+    }
+
+    *tasks = ts;
+    *ntasks = threads;
+
+    return true;
+}
+
+static void* __nt_sieve_task(void* arg) {
+    NTSieveTask* task = (NTSieveTask*)arg;
+    if (task->first >= task->last) return NULL;
+
+    const size_t np = task->nprimes ? task->nprimes : 1;
+
+    uint8_t* seg = (uint8_t*)malloc(__NT_SEGMENT_BYTES);
+    uint64_t* cycle = (uint64_t*)malloc(np * sizeof(uint64_t));
+    uint8_t* wheel = (uint8_t*)malloc(np);
+    uint32_t* offset = (uint32_t*)malloc(np * 8 * sizeof(uint32_t));
+    uint8_t* mask = (uint8_t*)malloc(np * 8);
+
+    if (!seg || !cycle || !wheel || !offset || !mask) {
+        free(seg);
+        free(cycle);
+        free(wheel);
+        free(offset);
+        free(mask);
+        task->ok = false;
+        return NULL;
+    }
+
+    // The multiples p * (30c + w) of a prime, for the 8 residues w coprime to 30, sit at wheel byte
+    // pc + floor(pw / 30) on a bit fixed by pw mod 30: each cycle c crosses off the same 8 (offset, bit) pairs, p bytes
+    // further. Track per prime the next cycle and the residue to resume from.
+    const uint64_t start = task->first * 30;
+
+    for (size_t i = 0; i < task->nprimes; i++) {
+        const uint64_t p = task->primes[i];
+
+        for (size_t k = 0; k < 8; k++) {
+            offset[8 * i + k] = (uint32_t)(p * __nt_wheel[k] / 30);
+            mask[8 * i + k] = (uint8_t)~(1u << __nt_wheel_bit[p * __nt_wheel[k] % 30]);
+        }
+
+        // First multiplier: at least p (smaller ones were crossed off by smaller primes) and p * q >= start
+        uint64_t qmin = start / p + (start % p != 0);
+        if (qmin < p) qmin = p;
+
+        size_t k = 0;
+        while (__nt_wheel[k] < qmin % 30) k++;
+
+        cycle[i] = p * (qmin / 30);
+        wheel[i] = (uint8_t)k;
+    }
+
+    // Bits of the boundary bytes outside [lo, hi)
+    const uint64_t edge_lo = task->lo / 30, edge_hi = (task->hi - 1) / 30;
+    uint8_t keep_lo = 0, keep_hi = 0;
+
+    for (size_t k = 0; k < 8; k++) {
+        if (edge_lo * 30 + __nt_wheel[k] >= task->lo) keep_lo |= (uint8_t)(1u << k);
+        if (edge_hi * 30 + __nt_wheel[k] < task->hi) keep_hi |= (uint8_t)(1u << k);
+    }
+
+    for (uint64_t base = task->first; base < task->last; base += __NT_SEGMENT_BYTES) {
+        const size_t len = (size_t)(task->last - base < __NT_SEGMENT_BYTES ? task->last - base : __NT_SEGMENT_BYTES);
+        const uint64_t end = base + len;
+
+        memcpy(seg, task->pattern + base % __NT_PRESIEVE_PERIOD, len);
+
+        for (size_t i = 0; i < task->nprimes; i++) {
+            const uint64_t p = task->primes[i];
+            if ((nt_u128)p * p >= (nt_u128)end * 30) break;  // crossing starts at p * p
+
+            const uint32_t* off = offset + 8 * i;
+            const uint8_t* m = mask + 8 * i;
+
+            // Position of the cycle relative to the segment; it may start before it (cycles span p bytes)
+            int64_t pos = (int64_t)(cycle[i] - base);
+            size_t k = wheel[i];
+
+            // Finish the current cycle, then whole cycles unrolled, then the start of the last one
+            for (; k < 8 && pos + off[k] < (int64_t)len; k++) seg[pos + off[k]] &= m[k];
+
+            if (k == 8) {
+                pos += (int64_t)p;
+                k = 0;
+
+                for (; pos + off[7] < (int64_t)len; pos += (int64_t)p) {
+                    uint8_t* s = seg + pos;
+                    s[off[0]] &= m[0];
+                    s[off[1]] &= m[1];
+                    s[off[2]] &= m[2];
+                    s[off[3]] &= m[3];
+                    s[off[4]] &= m[4];
+                    s[off[5]] &= m[5];
+                    s[off[6]] &= m[6];
+                    s[off[7]] &= m[7];
+                }
+
+                for (; pos + off[k] < (int64_t)len; k++) seg[pos + off[k]] &= m[k];
+            }
+
+            cycle[i] = base + (uint64_t)pos;
+            wheel[i] = (uint8_t)k;
+        }
+
+        if (base == 0) seg[0] = 0xFE;  // 1 is not prime, 7 to 17 are (the pattern crossed them off)
+        if (edge_lo >= base && edge_lo < end) seg[edge_lo - base] &= keep_lo;
+        if (edge_hi >= base && edge_hi < end) seg[edge_hi - base] &= keep_hi;
+
+        if (!task->collect) {
+            task->count += bits_popcount_buf(seg, len);
+            continue;
+        }
+
+        for (size_t j = 0; j < len; j++) {
+            if (seg[j] && !__nt_collect(task, base + j, seg[j])) {
+                task->ok = false;
+                break;
+            }
+        }
+
+        if (!task->ok) break;
+    }
+
+    free(seg);
+    free(cycle);
+    free(wheel);
+    free(offset);
+    free(mask);
+
+    return NULL;
+}
+
+inline static bool __nt_collect(NTSieveTask* task, uint64_t byte, uint8_t bits) {
+    if (task->count + 8 > task->out_capacity) {
+        const size_t capacity = task->out_capacity ? task->out_capacity * 2 : 1024;
+
+        uint64_t* out = (uint64_t*)realloc(task->out, capacity * sizeof(uint64_t));
+        if (!out) return false;
+
+        task->out = out;
+        task->out_capacity = capacity;
+    }
+
+    for (; bits; bits &= (uint8_t)(bits - 1)) task->out[task->count++] = byte * 30 + __nt_wheel[bits_ctz(bits)];
+
+    return true;
+}
+
+inline static bool __nt_miller_rabin(const NTMont* m, uint64_t base, uint64_t d, unsigned s) {
+    base %= m->n;
+    if (!base) return true;  // a multiple of n says nothing
+
+    const uint64_t one = m->r1, minus_one = m->n - m->r1;
+    uint64_t x = nt_mont_pow(m, nt_mont_to(m, base), d);
+
+    if (x == one || x == minus_one) return true;
+
+    for (unsigned r = 1; r < s; r++) {
+        x = nt_mont_mul(m, x, x);
+        if (x == minus_one) return true;
+        if (x == one) return false;
+    }
+
+    return false;
+}
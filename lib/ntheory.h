@@ -0,0 +1,216 @@
+#ifndef NTHEORY_H
+#define NTHEORY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "darray.h"
+
+// Nomenclature used (to avoid collisions): nt_<method_name>
+//
+// All arithmetic is on unsigned 64-bit values with 128-bit intermediates. The reduction contexts (`NTMont`, `NTBarrett`)
+// are built once per modulus and their multiplications are `static inline`, for hot loops.
+
+__extension__ typedef unsigned __int128 nt_u128;
+
+/******************************************************************************
+ *                                                                            *
+ *                            Montgomery & Barrett                            *
+ *                                                                            *
+ ******************************************************************************/
+
+/**
+ * @brief Montgomery reduction context for an odd modulus, with `R = 2^64`.
+ *
+ * Values are kept in Montgomery form `aR mod n`: convert with `nt_mont_to` / `nt_mont_from`, multiply with
+ * `nt_mont_mul` (no division), add and subtract as usual modulo `n`.
+ */
+typedef struct NTMontgomery NTMont;
+
+struct NTMontgomery {
+    uint64_t n;    ///< The modulus (odd, `> 1`).
+    uint64_t inv;  ///< `n^-1 mod 2^64`.
+    uint64_t r1;   ///< `R mod n`, i.e. 1 in Montgomery form.
+    uint64_t r2;   ///< `R^2 mod n`, used to convert into Montgomery form.
+};
+
+/**
+ * @brief Barrett reduction context for any modulus `> 1`.
+ *
+ * Replaces the 128-by-64-bit division of `a * b mod n` by multiplications with the precomputed `floor(2^128 / n)`;
+ * slower than Montgomery but needs no conversions and also works for even moduli.
+ */
+typedef struct NTBarrett NTBarrett;
+
+struct NTBarrett {
+    uint64_t n;      ///< The modulus.
+    uint64_t mu_hi;  ///< High word of `floor((2^128 - 1) / n)`.
+    uint64_t mu_lo;  ///< Low word of `floor((2^128 - 1) / n)`.
+};
+
+/// @brief Prepares a Montgomery context.
+/// @param m Pointer to the context to fill.
+/// @param n The modulus.
+/// @return `true` on success, `false` if `n` is even or `1`.
+bool nt_mont_init(NTMont* m, uint64_t n);
+
+/// @brief Montgomery reduction: `t * R^-1 mod n`, for `t < n * R`.
+/// @param m Pointer to the context.
+/// @param t The value to reduce.
+/// @return The reduced value, in `[0, n)`.
+static inline uint64_t nt_mont_reduce(const NTMont* m, nt_u128 t) {
+    const uint64_t q = (uint64_t)t * m->inv;
+    const uint64_t hi = (uint64_t)(t >> 64), qn = (uint64_t)(((nt_u128)q * m->n) >> 64);
+
+    // `t - q * n` is a multiple of `R`, its low words cancel
+    return hi >= qn ? hi - qn : hi - qn + m->n;
+}
+
+/// @brief Multiplies two values in Montgomery form.
+/// @param m Pointer to the context.
+/// @param a The first factor (`< n`).
+/// @param b The second factor (`< n`).
+/// @return The product, in Montgomery form.
+static inline uint64_t nt_mont_mul(const NTMont* m, uint64_t a, uint64_t b) {
+    return nt_mont_reduce(m, (nt_u128)a * b);
+}
+
+/// @brief Converts into Montgomery form.
+/// @param m Pointer to the context.
+/// @param a The value (any, it is reduced first).
+/// @return `aR mod n`.
+static inline uint64_t nt_mont_to(const NTMont* m, uint64_t a) {
+    return nt_mont_mul(m, a % m->n, m->r2);
+}
+
+/// @brief Converts out of Montgomery form.
+/// @param m Pointer to the context.
+/// @param a The value in Montgomery form.
+/// @return `a R^-1 mod n`.
+static inline uint64_t nt_mont_from(const NTMont* m, uint64_t a) {
+    return nt_mont_reduce(m, a);
+}
+
+/// @brief Raises a value in Montgomery form to a power.
+/// @param m Pointer to the context.
+/// @param a The base, in Montgomery form.
+/// @param e The exponent.
+/// @return `a^e`, in Montgomery form.
+uint64_t nt_mont_pow(const NTMont* m, uint64_t a, uint64_t e);
+
+/// @brief Prepares a Barrett context.
+/// @param b Pointer to the context to fill.
+/// @param n The modulus.
+/// @return `true` on success, `false` if `n < 2`.
+bool nt_barrett_init(NTBarrett* b, uint64_t n);
+
+/// @brief Reduces a 128-bit value.
+/// @param b Pointer to the context.
+/// @param x The value, `< n^2`.
+/// @return `x mod n`.
+static inline uint64_t nt_barrett_reduce(const NTBarrett* b, nt_u128 x) {
+    const uint64_t xh = (uint64_t)(x >> 64), xl = (uint64_t)x;
+
+    // High 128 bits of the 256-bit `x * mu`, the quotient estimate (at most 2 too small)
+    const nt_u128 p0 = (nt_u128)xl * b->mu_lo, p1 = (nt_u128)xl * b->mu_hi;
+    const nt_u128 p2 = (nt_u128)xh * b->mu_lo, p3 = (nt_u128)xh * b->mu_hi;
+    const nt_u128 mid = (p0 >> 64) + (uint64_t)p1 + (uint64_t)p2;
+    const nt_u128 q = p3 + (p1 >> 64) + (p2 >> 64) + (mid >> 64);
+
+    nt_u128 r = x - q * b->n;
+    while (r >= b->n) r -= b->n;
+
+    return (uint64_t)r;
+}
+
+/// @brief Multiplies modulo the context's modulus.
+/// @param b Pointer to the context.
+/// @param x The first factor (`< n`).
+/// @param y The second factor (`< n`).
+/// @return `x * y mod n`.
+static inline uint64_t nt_barrett_mul(const NTBarrett* b, uint64_t x, uint64_t y) {
+    return nt_barrett_reduce(b, (nt_u128)x * y);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                             Modular Arithmetic                             *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Greatest common divisor (binary GCD).
+/// @param a The first value.
+/// @param b The second value.
+/// @return `gcd(a, b)`, `0` if both are `0`.
+uint64_t nt_gcd(uint64_t a, uint64_t b);
+
+/// @brief Modular multiplication through a 128-bit product.
+/// @param a The first factor.
+/// @param b The second factor.
+/// @param n The modulus (`> 0`).
+/// @return `a * b mod n`, or `0` if `n` is `0`.
+uint64_t nt_mulmod(uint64_t a, uint64_t b, uint64_t n);
+
+/// @brief Modular exponentiation by squaring, in Montgomery form for odd moduli and with Barrett reduction otherwise.
+/// @param a The base.
+/// @param e The exponent.
+/// @param n The modulus.
+/// @return `a^e mod n` (`0` if `n < 2`).
+uint64_t nt_powmod(uint64_t a, uint64_t e, uint64_t n);
+
+/// @brief Modular inverse through the extended Euclidean algorithm.
+/// @param a The value.
+/// @param n The modulus.
+/// @return `a^-1 mod n`, or `0` if it does not exist (`gcd(a, n) != 1` or `n < 2`).
+uint64_t nt_invmod(uint64_t a, uint64_t n);
+
+/// @brief Inverts many values with a single modular inverse (Montgomery's trick). O(count) multiplications.
+/// @param a The values.
+/// @param count Number of values.
+/// @param n The modulus.
+/// @param out Receives the `count` inverses (must not overlap `a`).
+/// @return `true` on success, `false` if any value is not invertible or `n < 2` (`out` is then unspecified).
+bool nt_invmod_batch(const uint64_t* a, size_t count, uint64_t n, uint64_t* out);
+
+/// @brief Chinese remainder theorem: solves `x = r[i] (mod m[i])` for all `i` (moduli need not be coprime).
+/// @param r The residues.
+/// @param m The moduli (`> 0`).
+/// @param count Number of congruences.
+/// @param x Receives the smallest non-negative solution.
+/// @param lcm Receives the combined modulus (may be `NULL`).
+/// @return `true` on success, `false` if the system has no solution or the combined modulus exceeds 64 bits.
+bool nt_crt(const uint64_t* r, const uint64_t* m, size_t count, uint64_t* x, uint64_t* lcm);
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Primality                                  *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Deterministic Miller-Rabin primality test for all 64-bit values.
+/// @details Trial division by the primes below 64, then Miller-Rabin in Montgomery form with the 7 bases known to have
+/// no strong pseudoprime below `2^64`.
+/// @param n The value.
+/// @return `true` if `n` is prime.
+bool nt_is_prime(uint64_t n);
+
+/// @brief Counts the primes in `[lo, hi)` with a segmented sieve. Memory O(sqrt(hi) + threads * segment).
+/// @details The sieve stores only numbers coprime to 30 (8 bits per 30 numbers) and works on L1-sized segments. Each
+/// segment starts as a copy of a pre-sieved pattern for 7 to 17. Every other prime crosses off 8 multiples per
+/// unrolled wheel cycle. Each thread sieves a contiguous run of segments, and segments are counted with
+/// `bits_popcount_buf`.
+/// @param lo The lower bound (inclusive).
+/// @param hi The upper bound (exclusive).
+/// @param threads Number of threads (`0` or `1` to run on the calling thread only).
+/// @return The number of primes, or `(uint64_t)-1` on allocation failure.
+uint64_t nt_prime_count(uint64_t lo, uint64_t hi, size_t threads);
+
+/// @brief Lists the primes in `[lo, hi)` in increasing order, with the same segmented sieve as `nt_prime_count`.
+/// @param lo The lower bound (inclusive).
+/// @param hi The upper bound (exclusive).
+/// @param threads Number of threads (`0` or `1` to run on the calling thread only).
+/// @return A new array of `uint64_t`, or `NULL` on allocation failure.
+DArray* nt_primes(uint64_t lo, uint64_t hi, size_t threads);
+
+#endif  // NTHEORY_H
@@ -0,0 +1,39 @@
+#ifndef PAR_FOR_H
+#define PAR_FOR_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+// Internal header shared by the batch / multi-threaded entry points; not part of the public API.
+
+/**
+ * @brief Runs `fn` once on each of the `n` tasks of `task_size` bytes at `tasks`, one thread per task.
+ *
+ * The calling thread runs the last task, and any task whose thread could not start (all of them if the
+ * thread handles cannot be allocated), so every task runs exactly once. Returns when all of them are done;
+ * results are reported through the tasks themselves.
+ *
+ * @param n Number of tasks.
+ * @param fn Task body, called with a pointer to its task.
+ * @param tasks The tasks, contiguous.
+ * @param task_size Size of a task in bytes.
+ */
+static inline void __par_for(size_t n, void* (*fn)(void*), void* tasks, size_t task_size) {
+    pthread_t* handles = n > 1 ? (pthread_t*)malloc((n - 1) * sizeof(pthread_t)) : NULL;
+    size_t spawned = 0;
+
+    for (size_t t = 0; t < n; t++) {
+        void* task = (char*)tasks + t * task_size;
+
+        // Started threads are packed at the front of `handles`, so only handles `pthread_create` wrote are joined
+        if (handles && t + 1 < n && pthread_create(&handles[spawned], NULL, fn, task) == 0) spawned++;
+        else fn(task);
+    }
+
+    for (size_t t = 0; t < spawned; t++) pthread_join(handles[t], NULL);
+
+    free(handles);
+}
+
+#endif  // PAR_FOR_H
@@ -0,0 +1,167 @@
+#include "pool.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "memstat.h"
+
+/******************************************************************************
+ *                                                                            *
+ *                              Inner Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+inline static size_t __pool_round_up(size_t n, size_t align);
+// bytes reserved at the start of each slab for its link
+inline static size_t __pool_header_bytes(const Pool* pool);
+inline static size_t __pool_slab_bytes(const Pool* pool);
+// allocates a new slab and makes it the bump region
+static bool __pool_grow(Pool* pool);
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+Pool* pool_new(size_t block_size, size_t align, size_t blocks_per_slab) {
+    if (block_size == 0 || blocks_per_slab == 0 || (align & (align - 1)) != 0) return NULL;
+
+    if (align < sizeof(void*)) align = sizeof(void*);
+
+    Pool* pool = (Pool*)malloc(sizeof(Pool));
+    if (!pool) return NULL;
+
+    pool->free_list = NULL;
+    pool->slabs = NULL;
+
+    pool->bump = NULL;
+    pool->bump_end = NULL;
+
+    pool->block_size = __pool_round_up(block_size, align);
+    pool->align = align;
+    pool->blocks_per_slab = blocks_per_slab;
+
+    pool->live = 0;
+    pool->slab_count = 0;
+    pool->refs = 1;
+
+    ms_track(MS_POOL, 1, (int64_t)sizeof(Pool));
+
+    return pool;
+}
+
+Pool* pool_retain(Pool* pool) {
+    if (pool) pool->refs++;
+
+    return pool;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                             Clean Up & Freeing                             *
+ *                                                                            *
+ ******************************************************************************/
+
+void pool_release(Pool* pool) {
+    if (!pool || --pool->refs > 0) return;
+
+    void* slab = pool->slabs;
+
+    while (slab) {
+        void* next = *(void**)slab;
+        free(slab);
+        slab = next;
+    }
+
+    ms_track(MS_POOL, -1, -(int64_t)(sizeof(Pool) + pool_bytes(pool)));
+
+    free(pool);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                         Allocation & Deallocation                          *
+ *                                                                            *
+ ******************************************************************************/
+
+void* pool_alloc(Pool* pool) {
+    if (!pool) return NULL;
+
+    void* block = pool->free_list;
+
+    if (block) {
+        pool->free_list = *(void**)block;
+    } else {
+        if (pool->bump == pool->bump_end && !__pool_grow(pool)) return NULL;
+
+        block = pool->bump;
+        pool->bump += pool->block_size;
+    }
+
+    pool->live++;
+
+    return block;
+}
+
+void pool_free(Pool* pool, void* block) {
+    if (!pool || !block) return;
+
+    *(void**)block = pool->free_list;
+    pool->free_list = block;
+
+    pool->live--;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Basic Getters                                *
+ *                                                                            *
+ ******************************************************************************/
+
+size_t pool_live(const Pool* pool) {
+    return pool ? pool->live : 0;
+}
+
+size_t pool_bytes(const Pool* pool) {
+    return pool ? pool->slab_count * __pool_slab_bytes(pool) : 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                       Inner Functions Implementation                       *
+ *                                                                            *
+ ******************************************************************************/
+
+inline static size_t __pool_round_up(size_t n, size_t align) {
+    return (n + align - 1) & ~(align - 1);
+}
+
+inline static size_t __pool_header_bytes(const Pool* pool) {
+    return __pool_round_up(sizeof(void*), pool->align);
+}
+
+inline static size_t __pool_slab_bytes(const Pool* pool) {
+    return __pool_header_bytes(pool) + pool->block_size * pool->blocks_per_slab;
+}
+
+static bool __pool_grow(Pool* pool) {
+    size_t bytes = __pool_slab_bytes(pool);
+
+    // `bytes` is a multiple of `align`, as `aligned_alloc` requires
+    char* slab = (char*)aligned_alloc(pool->align, bytes);
+    if (!slab) return false;
+
+    *(void**)slab = pool->slabs;
+    pool->slabs = slab;
+    pool->slab_count++;
+
+    // Blocks are carved lazily, so a fresh slab is never touched up front
+    pool->bump = slab + __pool_header_bytes(pool);
+    pool->bump_end = slab + bytes;
+
+    ms_track(MS_POOL, 0, (int64_t)bytes);
+
+    return true;
+}
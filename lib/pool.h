@@ -0,0 +1,76 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Nomenclature used (to avoid collisions): <data_type>_<method_name>
+// Warning: This implementation is not thread-safe, and is for educational purposes only.
+
+/**
+ * @brief Fixed-Size Block Pool
+ *
+ * Hands out equally sized, aligned blocks carved from large slabs, and keeps
+ * freed blocks on an intrusive free list for reuse. Allocation and freeing are
+ * O(1) and never touch `malloc` once the pool is warm; slabs are only returned
+ * to the system when the pool itself is released. Used for the nodes of linked
+ * containers, so neighbouring nodes end up in neighbouring memory.
+ *
+ * A pool may be shared between containers (see `pool_retain`), which lets them
+ * exchange nodes, e.g. to splice lists in O(1).
+ */
+typedef struct BlockPool Pool;
+
+struct BlockPool {
+    void* free_list;  ///< Singly-linked list of freed blocks (the link lives in the block itself).
+    void* slabs;      ///< Singly-linked list of slabs (the link lives in each slab's header).
+
+    char* bump;      ///< Next never-used block of the newest slab.
+    char* bump_end;  ///< End of the newest slab.
+
+    size_t block_size;       ///< Size of a block, a multiple of `align`.
+    size_t align;            ///< Alignment of every block, a power of two.
+    size_t blocks_per_slab;  ///< Number of blocks carved from each slab.
+
+    size_t live;        ///< Number of blocks currently handed out.
+    size_t slab_count;  ///< Number of slabs allocated.
+    size_t refs;        ///< Number of owners (see `pool_retain` and `pool_release`).
+};
+
+/// @brief Allocates a new, empty pool.
+/// @param block_size Minimum size of a block in bytes (rounded up to a multiple of `align`).
+/// @param align Alignment of the blocks, a power of two (raised to at least `sizeof(void*)`); use 64 for cache-line aligned blocks.
+/// @param blocks_per_slab Number of blocks per slab (at least 1).
+/// @return Pointer to the new `Pool` with a single owner, or `NULL` on invalid arguments or allocation failure.
+Pool* pool_new(size_t block_size, size_t align, size_t blocks_per_slab);
+
+/// @brief Adds an owner to the pool.
+/// @param pool Pointer to the pool.
+/// @return `pool`, for convenience.
+Pool* pool_retain(Pool* pool);
+
+/// @brief Removes an owner from the pool, freeing every slab (and so every block) when the last owner releases it.
+/// @param pool Pointer to the pool.
+void pool_release(Pool* pool);
+
+/// @brief Takes a block from the pool. O(1).
+/// @param pool Pointer to the pool.
+/// @return Pointer to an uninitialized block of `pool->block_size` bytes, or `NULL` on allocation failure.
+void* pool_alloc(Pool* pool);
+
+/// @brief Returns a block to the pool. O(1).
+/// @param pool Pointer to the pool the block was taken from.
+/// @param block Pointer to the block (ignored if `NULL`).
+void pool_free(Pool* pool, void* block);
+
+/// @brief Gets the number of blocks currently handed out.
+/// @param pool Pointer to the pool.
+/// @return The number of live blocks.
+size_t pool_live(const Pool* pool);
+
+/// @brief Gets the number of heap bytes held by the pool's slabs.
+/// @param pool Pointer to the pool.
+/// @return The size of all slabs in bytes.
+size_t pool_bytes(const Pool* pool);
+
+#endif  // POOL_H
@@ -0,0 +1,91 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Internal header shared by lib/geometry.c and lib/itree.c; not part of the public API.
+
+/**
+ * @brief Stable LSD radix sort of `n` records of `stride` bytes on their `key_words` leading `uint64_t` words.
+ *
+ * The first word is the most significant. `flip` is XORed into it before its bytes are read, e.g.
+ * `1ULL << 63` orders signed keys with the negatives first. A single pass builds the histograms of every
+ * byte, and a byte shared by every key is skipped since it leaves the order unchanged. The records
+ * ping-pong between `base` and one scratch buffer.
+ *
+ * @param base The records; each must hold its `key_words` key words at its start.
+ * @param n Number of records.
+ * @param stride Size of a record in bytes.
+ * @param key_words Number of key words (1 or 2).
+ * @param flip Mask XORed into the first key word.
+ * @return `false` if the scratch buffer could not be allocated or `key_words` is out of range (nothing moved).
+ */
+static inline bool __radix_sort(void* base, size_t n, size_t stride, size_t key_words, uint64_t flip) {
+    if (key_words < 1 || key_words > 2) return false;
+    if (n < 2) return true;
+
+    unsigned char* src = (unsigned char*)base;
+    unsigned char* dst = (unsigned char*)malloc(n * stride);
+    if (!dst) return false;
+
+    unsigned char* const scratch = dst;
+
+    // Digit `d` is byte `d % 8` of word `key_words - 1 - d / 8`: least significant first
+    const size_t digits = 8 * key_words;
+    size_t hist[16][256];
+    memset(hist, 0, digits * sizeof(hist[0]));
+
+    for (size_t i = 0; i < n; i++) {
+        for (size_t w = 0; w < key_words; w++) {
+            uint64_t key;
+            memcpy(&key, src + i * stride + w * sizeof(uint64_t), sizeof(key));
+            if (w == 0) key ^= flip;
+
+            const size_t d0 = 8 * (key_words - 1 - w);
+            for (size_t b = 0; b < 8; b++) hist[d0 + b][(key >> (8 * b)) & 0xFF]++;
+        }
+    }
+
+    for (size_t d = 0; d < digits; d++) {
+        const size_t w = key_words - 1 - d / 8;
+        const size_t word = w * sizeof(uint64_t);
+        const uint64_t mask = w == 0 ? flip : 0;
+        const size_t shift = 8 * (d % 8);
+
+        uint64_t first;
+        memcpy(&first, src + word, sizeof(first));
+
+        // A byte shared by every key leaves the order unchanged
+        if (hist[d][((first ^ mask) >> shift) & 0xFF] == n) continue;
+
+        size_t offset = 0;
+        for (size_t b = 0; b < 256; b++) {
+            const size_t c = hist[d][b];
+            hist[d][b] = offset;
+            offset += c;
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            uint64_t key;
+            memcpy(&key, src + i * stride + word, sizeof(key));
+
+            memcpy(dst + hist[d][((key ^ mask) >> shift) & 0xFF]++ * stride, src + i * stride, stride);
+        }
+
+        unsigned char* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != (unsigned char*)base) memcpy(base, src, n * stride);
+
+    free(scratch);
+
+    return true;
+}
+
+#endif  // RADIX_SORT_H
@@ -0,0 +1,14 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <stdint.h>
+
+// Internal header shared by the containers that seed hashers or priorities (including the typed_* generators); not
+// part of the public API.
+
+/// @brief Random 64-bit value read from `/dev/urandom` (defined in hashset.c).
+/// @details Exits the process if `/dev/urandom` cannot be read.
+/// @return The random value.
+uint64_t __random_u64(void);
+
+#endif  // RANDOM_H
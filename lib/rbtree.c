@@ -0,0 +1,669 @@
+#include "rbtree.h"
+
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Offset of the element inside a node: the header rounded up to the strictest fundamental alignment.
+#define __RB_DATA_OFFSET ((sizeof(RBNode) + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1))
+
+/******************************************************************************
+ *                                                                            *
+ *                              Inner Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+static RBTree* __rb_new(size_t element_size, int (*cmp)(const void* a, const void* b), void (*copier)(void* dest, const void* src), void (*deallocator)(void* k), bool order_stats);
+inline static void* __rb_elem(const RBNode* node);
+inline static RBNode* __rb_node(const void* e);
+inline static bool __rb_is_red(const RBNode* node);
+inline static size_t __rb_size(const RBNode* node);
+inline static RBNode* __rb_min(RBNode* node);
+inline static RBNode* __rb_max(RBNode* node);
+inline static RBNode* __rb_new_node(RBTree* rb, const void* e);
+// deallocates the element of `node` and returns the node to the pool
+inline static void __rb_free_node(RBTree* rb, RBNode* node);
+// replaces the subtree rooted at `u` by the one rooted at `v` (which may be NULL)
+inline static void __rb_transplant(RBTree* rb, RBNode* u, RBNode* v);
+static void __rb_rotate_left(RBTree* rb, RBNode* x);
+static void __rb_rotate_right(RBTree* rb, RBNode* x);
+static void __rb_insert_fixup(RBTree* rb, RBNode* z);
+// `x` (possibly NULL) carries an extra black, `parent` is its parent
+static void __rb_erase_fixup(RBTree* rb, RBNode* x, RBNode* parent);
+// adds `delta` to the subtree sizes from `node` up to the root
+inline static void __rb_adjust_sizes(RBNode* node, int delta);
+// builds a perfectly balanced subtree from `arr[lo..hi)`; nodes at depth `red_depth` are red
+static RBNode* __rb_build(RBTree* rb, const char* arr, size_t lo, size_t hi, size_t depth, size_t red_depth, bool* ok);
+// returns every node of the subtree to the pool, iteratively
+static void __rb_free_subtree(RBTree* rb, RBNode* node);
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+RBTree* rb_new(size_t element_size, int (*cmp)(const void* a, const void* b), void (*copier)(void* dest, const void* src), void (*deallocator)(void* k)) {
+    return __rb_new(element_size, cmp, copier, deallocator, false);
+}
+
+RBTree* rb_new_with_order_stats(size_t element_size, int (*cmp)(const void* a, const void* b), void (*copier)(void* dest, const void* src), void (*deallocator)(void* k)) {
+    return __rb_new(element_size, cmp, copier, deallocator, true);
+}
+
+RBTree* rb_new_from_sorted(const DArray* da, int (*cmp)(const void* a, const void* b), void (*deallocator)(void* k), bool order_stats) {
+    if (!da) return NULL;
+
+    const char* arr = (const char*)da->arr;
+    const size_t es = da->element_size;
+
+    for (size_t i = 1; i < da->length; i++) {
+        if (cmp && cmp(arr + (i - 1) * es, arr + i * es) >= 0) return NULL;
+    }
+
+    RBTree* rb = __rb_new(es, cmp, da->copier, deallocator, order_stats);
+    if (!rb || da->length == 0) return rb;
+
+    // Levels 0..h-1 for h = floor(log2(n)) + 1; only an incomplete last level is colored red
+    size_t levels = 0;
+    for (size_t n = da->length; n; n >>= 1) levels++;
+
+    const bool complete = (da->length & (da->length + 1)) == 0;
+
+    bool ok = true;
+    rb->root = __rb_build(rb, arr, 0, da->length, 0, complete ? SIZE_MAX : levels - 1, &ok);
+
+    if (!ok) {
+        rb_free(rb);
+        return NULL;
+    }
+
+    rb->count = da->length;
+
+    return rb;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                             Clean Up & Freeing                             *
+ *                                                                            *
+ ******************************************************************************/
+
+void rb_free(RBTree* rb) {
+    if (!rb) return;
+
+    rb_clear(rb);
+    pool_release(rb->pool);
+
+    ms_track(MS_RBTREE, -1, -(int64_t)sizeof(RBTree));
+
+    free(rb);
+}
+
+void rb_clear(RBTree* rb) {
+    if (!rb) return;
+
+    __rb_free_subtree(rb, rb->root);
+
+    rb->root = NULL;
+    rb->count = 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Basic Getters                                *
+ *                                                                            *
+ ******************************************************************************/
+
+size_t rb_count(const RBTree* rb) {
+    return rb ? rb->count : 0;
+}
+
+bool rb_is_empty(const RBTree* rb) {
+    return !rb || rb->count == 0;
+}
+
+void* rb_find(const RBTree* rb, const void* k) {
+    if (!rb || !k) return NULL;
+
+    RBNode* node = rb->root;
+
+    while (node) {
+        int c = rb->cmp(k, __rb_elem(node));
+
+        if (c == 0) return __rb_elem(node);
+
+        node = c < 0 ? node->left : node->right;
+    }
+
+    return NULL;
+}
+
+bool rb_contains(const RBTree* rb, const void* k) {
+    return rb_find(rb, k) != NULL;
+}
+
+void* rb_lower_bound(const RBTree* rb, const void* k) {
+    if (!rb || !k) return NULL;
+
+    RBNode* node = rb->root;
+    RBNode* best = NULL;
+
+    while (node) {
+        if (rb->cmp(__rb_elem(node), k) >= 0) {
+            best = node;
+            node = node->left;
+        } else {
+            node = node->right;
+        }
+    }
+
+    return best ? __rb_elem(best) : NULL;
+}
+
+void* rb_upper_bound(const RBTree* rb, const void* k) {
+    if (!rb || !k) return NULL;
+
+    RBNode* node = rb->root;
+    RBNode* best = NULL;
+
+    while (node) {
+        if (rb->cmp(__rb_elem(node), k) > 0) {
+            best = node;
+            node = node->left;
+        } else {
+            node = node->right;
+        }
+    }
+
+    return best ? __rb_elem(best) : NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Iteration                                  *
+ *                                                                            *
+ ******************************************************************************/
+
+void* rb_first(const RBTree* rb) {
+    if (rb_is_empty(rb)) return NULL;
+
+    return __rb_elem(__rb_min(rb->root));
+}
+
+void* rb_last(const RBTree* rb) {
+    if (rb_is_empty(rb)) return NULL;
+
+    return __rb_elem(__rb_max(rb->root));
+}
+
+void* rb_next(const RBTree* rb, const void* e) {
+    if (!rb || !e) return NULL;
+
+    RBNode* node = __rb_node(e);
+
+    if (node->right) return __rb_elem(__rb_min(node->right));
+
+    while (node->parent && node == node->parent->right) node = node->parent;
+
+    return node->parent ? __rb_elem(node->parent) : NULL;
+}
+
+void* rb_prev(const RBTree* rb, const void* e) {
+    if (!rb || !e) return NULL;
+
+    RBNode* node = __rb_node(e);
+
+    if (node->left) return __rb_elem(__rb_max(node->left));
+
+    while (node->parent && node == node->parent->left) node = node->parent;
+
+    return node->parent ? __rb_elem(node->parent) : NULL;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                            Insertion & Removal                             *
+ *                                                                            *
+ ******************************************************************************/
+
+bool rb_insert(RBTree* rb, const void* e) {
+    if (!rb || !e) return false;
+
+    RBNode* parent = NULL;
+    RBNode** link = &rb->root;
+
+    while (*link) {
+        parent = *link;
+
+        int c = rb->cmp(e, __rb_elem(parent));
+        if (c == 0) return false;
+
+        link = c < 0 ? &parent->left : &parent->right;
+    }
+
+    RBNode* node = __rb_new_node(rb, e);
+    if (!node) return false;
+
+    node->parent = parent;
+    *link = node;
+
+    if (rb->order_stats) __rb_adjust_sizes(parent, 1);
+
+    __rb_insert_fixup(rb, node);
+    rb->count++;
+
+    return true;
+}
+
+bool rb_remove(RBTree* rb, const void* k) {
+    void* e = rb_find(rb, k);
+    if (!e) return false;
+
+    rb_erase(rb, e);
+
+    return true;
+}
+
+void rb_erase(RBTree* rb, void* e) {
+    if (!rb || !e) return;
+
+    RBNode* z = __rb_node(e);
+    RBNode* x;
+    RBNode* x_parent;
+    bool removed_red = z->red;
+
+    if (!z->left) {
+        x = z->right;
+        x_parent = z->parent;
+        __rb_transplant(rb, z, z->right);
+    } else if (!z->right) {
+        x = z->left;
+        x_parent = z->parent;
+        __rb_transplant(rb, z, z->left);
+    } else {
+        // Two children: the successor `y` takes `z`'s place (and color)
+        RBNode* y = __rb_min(z->right);
+        removed_red = y->red;
+        x = y->right;
+
+        if (y->parent == z) {
+            x_parent = y;
+        } else {
+            x_parent = y->parent;
+            __rb_transplant(rb, y, y->right);
+
+            y->right = z->right;
+            y->right->parent = y;
+        }
+
+        __rb_transplant(rb, z, y);
+
+        y->left = z->left;
+        y->left->parent = y;
+        y->red = z->red;
+        y->size = z->size;
+    }
+
+    if (rb->order_stats) __rb_adjust_sizes(x_parent, -1);
+
+    if (!removed_red) __rb_erase_fixup(rb, x, x_parent);
+
+    __rb_free_node(rb, z);
+    rb->count--;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                              Order Statistics                              *
+ *                                                                            *
+ ******************************************************************************/
+
+size_t rb_rank(const RBTree* rb, const void* k) {
+    if (!rb || !k || !rb->order_stats) return (size_t)-1;
+
+    size_t rank = 0;
+    RBNode* node = rb->root;
+
+    while (node) {
+        if (rb->cmp(__rb_elem(node), k) < 0) {
+            rank += __rb_size(node->left) + 1;
+            node = node->right;
+        } else {
+            node = node->left;
+        }
+    }
+
+    return rank;
+}
+
+void* rb_select(const RBTree* rb, size_t idx) {
+    if (!rb || !rb->order_stats || idx >= rb->count) return NULL;
+
+    RBNode* node = rb->root;
+
+    for (;;) {
+        size_t left = __rb_size(node->left);
+
+        if (idx == left) return __rb_elem(node);
+
+        if (idx < left) {
+            node = node->left;
+        } else {
+            idx -= left + 1;
+            node = node->right;
+        }
+    }
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                             Memory Accounting                              *
+ *                                                                            *
+ ******************************************************************************/
+
+MemUsage rb_memory_usage(const RBTree* rb, size_t (*owned_size)(const void* k)) {
+    MemUsage mu = {0, 0, 0, 0, 0};
+    if (!rb) return mu;
+
+    mu.payload = rb->count * rb->element_size;
+    mu.metadata = sizeof(RBTree) + rb->count * __RB_DATA_OFFSET;
+    mu.slack = pool_bytes(rb->pool) - mu.payload - rb->count * __RB_DATA_OFFSET;
+    mu.overhead = ms_usable_size(rb, sizeof(RBTree)) - sizeof(RBTree);
+
+    if (owned_size) {
+        for (void* e = rb_first(rb); e; e = rb_next(rb, e)) mu.owned += owned_size(e);
+    }
+
+    return mu;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                       Inner Functions Implementation                       *
+ *                                                                            *
+ ******************************************************************************/
+
+static RBTree* __rb_new(size_t element_size, int (*cmp)(const void* a, const void* b), void (*copier)(void* dest, const void* src), void (*deallocator)(void* k), bool order_stats) {
+    if (element_size == 0 || !cmp || !copier || !deallocator) return NULL;
+
+    RBTree* rb = (RBTree*)malloc(sizeof(RBTree));
+    if (!rb) return NULL;
+
+    rb->pool = pool_new(__RB_DATA_OFFSET + element_size, alignof(max_align_t), RB_NODES_PER_SLAB);
+    if (!rb->pool) {
+        free(rb);
+        return NULL;
+    }
+
+    rb->root = NULL;
+    rb->count = 0;
+    rb->element_size = element_size;
+    rb->order_stats = order_stats;
+
+    rb->cmp = cmp;
+    rb->copier = copier;
+    rb->deallocator = deallocator;
+
+    ms_track(MS_RBTREE, 1, (int64_t)sizeof(RBTree));
+
+    return rb;
+}
+
+inline static void* __rb_elem(const RBNode* node) {
+    return (char*)node + __RB_DATA_OFFSET;
+}
+
+inline static RBNode* __rb_node(const void* e) {
+    return (RBNode*)((char*)e - __RB_DATA_OFFSET);
+}
+
+inline static bool __rb_is_red(const RBNode* node) {
+    return node && node->red;
+}
+
+inline static size_t __rb_size(const RBNode* node) {
+    return node ? node->size : 0;
+}
+
+inline static RBNode* __rb_min(RBNode* node) {
+    while (node->left) node = node->left;
+
+    return node;
+}
+
+inline static RBNode* __rb_max(RBNode* node) {
+    while (node->right) node = node->right;
+
+    return node;
+}
+
+inline static RBNode* __rb_new_node(RBTree* rb, const void* e) {
+    RBNode* node = (RBNode*)pool_alloc(rb->pool);
+    if (!node) return NULL;
+
+    node->parent = NULL;
+    node->left = NULL;
+    node->right = NULL;
+    node->size = 1;
+    node->red = true;
+
+    rb->copier(__rb_elem(node), e);
+
+    return node;
+}
+
+inline static void __rb_free_node(RBTree* rb, RBNode* node) {
+    rb->deallocator(__rb_elem(node));
+    pool_free(rb->pool, node);
+}
+
+inline static void __rb_transplant(RBTree* rb, RBNode* u, RBNode* v) {
+    if (!u->parent) {
+        rb->root = v;
+    } else if (u == u->parent->left) {
+        u->parent->left = v;
+    } else {
+        u->parent->right = v;
+    }
+
+    if (v) v->parent = u->parent;
+}
+
+static void __rb_rotate_left(RBTree* rb, RBNode* x) {
+    RBNode* y = x->right;
+
+    x->right = y->left;
+    if (y->left) y->left->parent = x;
+
+    __rb_transplant(rb, x, y);
+
+    y->left = x;
+    x->parent = y;
+
+    y->size = x->size;
+    x->size = __rb_size(x->left) + __rb_size(x->right) + 1;
+}
+
+static void __rb_rotate_right(RBTree* rb, RBNode* x) {
+    RBNode* y = x->left;
+
+    x->left = y->right;
+    if (y->right) y->right->parent = x;
+
+    __rb_transplant(rb, x, y);
+
+    y->right = x;
+    x->parent = y;
+
+    y->size = x->size;
+    x->size = __rb_size(x->left) + __rb_size(x->right) + 1;
+}
+
+static void __rb_insert_fixup(RBTree* rb, RBNode* z) {
+    while (__rb_is_red(z->parent)) {
+        RBNode* parent = z->parent;
+        RBNode* grandparent = parent->parent;  // exists: a red node is never the root
+
+        if (parent == grandparent->left) {
+            RBNode* uncle = grandparent->right;
+
+            if (__rb_is_red(uncle)) {
+                parent->red = false;
+                uncle->red = false;
+                grandparent->red = true;
+                z = grandparent;
+                continue;
+            }
+
+            if (z == parent->right) {
+                z = parent;
+                __rb_rotate_left(rb, z);
+                parent = z->parent;
+            }
+
+            parent->red = false;
+            grandparent->red = true;
+            __rb_rotate_right(rb, grandparent);
+        } else {
+            RBNode* uncle = grandparent->left;
+
+            if (__rb_is_red(uncle)) {
+                parent->red = false;
+                uncle->red = false;
+                grandparent->red = true;
+                z = grandparent;
+                continue;
+            }
+
+            if (z == parent->left) {
+                z = parent;
+                __rb_rotate_right(rb, z);
+                parent = z->parent;
+            }
+
+            parent->red = false;
+            grandparent->red = true;
+            __rb_rotate_left(rb, grandparent);
+        }
+    }
+
+    rb->root->red = false;
+}
+
+static void __rb_erase_fixup(RBTree* rb, RBNode* x, RBNode* parent) {
+    while (x != rb->root && !__rb_is_red(x)) {
+        // The sibling exists: the path through `x` is one black short
+        if (x == parent->left) {
+            RBNode* sibling = parent->right;
+
+            if (sibling->red) {
+                sibling->red = false;
+                parent->red = true;
+                __rb_rotate_left(rb, parent);
+                sibling = parent->right;
+            }
+
+            if (!__rb_is_red(sibling->left) && !__rb_is_red(sibling->right)) {
+                sibling->red = true;
+                x = parent;
+                parent = x->parent;
+                continue;
+            }
+
+            if (!__rb_is_red(sibling->right)) {
+                sibling->left->red = false;
+                sibling->red = true;
+                __rb_rotate_right(rb, sibling);
+                sibling = parent->right;
+            }
+
+            sibling->red = parent->red;
+            parent->red = false;
+            sibling->right->red = false;
+            __rb_rotate_left(rb, parent);
+        } else {
+            RBNode* sibling = parent->left;
+
+            if (sibling->red) {
+                sibling->red = false;
+                parent->red = true;
+                __rb_rotate_right(rb, parent);
+                sibling = parent->left;
+            }
+
+            if (!__rb_is_red(sibling->left) && !__rb_is_red(sibling->right)) {
+                sibling->red = true;
+                x = parent;
+                parent = x->parent;
+                continue;
+            }
+
+            if (!__rb_is_red(sibling->left)) {
+                sibling->right->red = false;
+                sibling->red = true;
+                __rb_rotate_left(rb, sibling);
+                sibling = parent->left;
+            }
+
+            sibling->red = parent->red;
+            parent->red = false;
+            sibling->left->red = false;
+            __rb_rotate_right(rb, parent);
+        }
+
+        x = rb->root;
+    }
+
+    if (x) x->red = false;
+}
+
+inline static void __rb_adjust_sizes(RBNode* node, int delta) {
+    for (; node; node = node->parent) node->size = (size_t)((int64_t)node->size + delta);
+}
+
+static RBNode* __rb_build(RBTree* rb, const char* arr, size_t lo, size_t hi, size_t depth, size_t red_depth, bool* ok) {
+    if (lo >= hi || !*ok) return NULL;
+
+    size_t mid = lo + (hi - lo) / 2;
+
+    RBNode* node = __rb_new_node(rb, arr + mid * rb->element_size);
+    if (!node) {
+        *ok = false;
+        return NULL;
+    }
+
+    node->red = depth == red_depth && depth > 0;
+    node->size = hi - lo;
+
+    node->left = __rb_build(rb, arr, lo, mid, depth + 1, red_depth, ok);
+    node->right = __rb_build(rb, arr, mid + 1, hi, depth + 1, red_depth, ok);
+
+    if (node->left) node->left->parent = node;
+    if (node->right) node->right->parent = node;
+
+    return node;
+}
+
+static void __rb_free_subtree(RBTree* rb, RBNode* node) {
+    // Post-order walk through the parent pointers: no stack, no recursion
+    while (node) {
+        if (node->left) {
+            node = node->left;
+        } else if (node->right) {
+            node = node->right;
+        } else {
+            RBNode* parent = node->parent;
+
+            if (parent) {
+                if (parent->left == node) parent->left = NULL;
+                else parent->right = NULL;
+            }
+
+            __rb_free_node(rb, node);
+            node = parent;
+        }
+    }
+}
@@ -0,0 +1,229 @@
+#ifndef RBTREE_H
+#define RBTREE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "darray.h"
+#include "memstat.h"
+#include "pool.h"
+
+// Nomenclature used (to avoid collisions): <data_type>_<method_name>
+// Warning: This implementation is not thread-safe, and is for educational purposes only.
+
+/// Number of nodes carved from each slab of the node pool.
+#define RB_NODES_PER_SLAB 256
+
+/**
+ * @brief Red-Black Tree Node
+ *
+ * The element is stored inline right after this header, so a node is a
+ * single pool block.
+ */
+typedef struct RedBlackTreeNode RBNode;
+
+struct RedBlackTreeNode {
+    RBNode* parent;  ///< Parent node (`NULL` for the root).
+    RBNode* left;    ///< Left child (`NULL` if none).
+    RBNode* right;   ///< Right child (`NULL` if none).
+    size_t size;     ///< Number of nodes in this subtree (only maintained with order statistics).
+    bool red;        ///< Node color.
+};
+
+/**
+ * @brief Red-Black Tree (Generic implementation)
+ *
+ * An ordered set of elements of `element_size` bytes, ordered by `cmp`. Used
+ * as an ordered map by storing key/value structs and comparing the key part.
+ * Elements live in pooled nodes and never move, so a pointer to an element
+ * stays valid (and works as an iterator) until that element is removed.
+ * Parent pointers make `rb_next`/`rb_prev` O(1) amortized.
+ *
+ * With order statistics enabled (`rb_new_with_order_stats`) every node also
+ * tracks its subtree size, for O(log n) `rb_rank` and `rb_select`.
+ */
+typedef struct RedBlackTree RBTree;
+
+struct RedBlackTree {
+    RBNode* root;  ///< Root node (`NULL` if empty).
+
+    size_t count;         ///< Number of elements.
+    size_t element_size;  ///< Size of an element in bytes.
+    bool order_stats;     ///< Whether subtree sizes are maintained.
+
+    Pool* pool;  ///< Node allocator.
+
+    int (*cmp)(const void* a, const void* b);     ///< Orders the elements (negative, 0 or positive).
+    void (*copier)(void* dest, const void* src);  ///< Copies an element into its node.
+    void (*deallocator)(void* k);                 ///< Frees the resources of an element being removed.
+};
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Creates a new, empty red-black tree.
+/// @param element_size The size of an element in bytes.
+/// @param cmp Pointer to the comparison function.
+/// @param copier Pointer to the deep copy function.
+/// @param deallocator Pointer to the deallocation function.
+/// @return A pointer to the newly allocated `RBTree`, or `NULL` on failure.
+RBTree* rb_new(size_t element_size, int (*cmp)(const void* a, const void* b), void (*copier)(void* dest, const void* src), void (*deallocator)(void* k));
+
+/// @brief Creates a new, empty red-black tree maintaining subtree sizes (see `rb_rank` and `rb_select`).
+/// @param element_size The size of an element in bytes.
+/// @param cmp Pointer to the comparison function.
+/// @param copier Pointer to the deep copy function.
+/// @param deallocator Pointer to the deallocation function.
+/// @return A pointer to the newly allocated `RBTree`, or `NULL` on failure.
+RBTree* rb_new_with_order_stats(size_t element_size, int (*cmp)(const void* a, const void* b), void (*copier)(void* dest, const void* src), void (*deallocator)(void* k));
+
+/// @brief Builds a tree from a strictly increasing dynamic array in O(n), without any comparison-driven insertion.
+/// @details The elements are copied with `da->copier`. The resulting tree is perfectly balanced, with only its deepest level colored red.
+/// @param da Pointer to the sorted source array.
+/// @param cmp Pointer to the comparison function (used to validate the order, and for later operations).
+/// @param deallocator Pointer to the deallocation function.
+/// @param order_stats Whether to maintain subtree sizes.
+/// @return A pointer to the new `RBTree`, or `NULL` if `da` is not strictly increasing or on failure.
+RBTree* rb_new_from_sorted(const DArray* da, int (*cmp)(const void* a, const void* b), void (*deallocator)(void* k), bool order_stats);
+
+/******************************************************************************
+ *                                                                            *
+ *                             Clean Up & Freeing                             *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Frees the tree, its elements and its nodes.
+/// @param rb Pointer to the tree.
+void rb_free(RBTree* rb);
+
+/// @brief Removes every element (via `deallocator`).
+/// @param rb Pointer to the tree.
+void rb_clear(RBTree* rb);
+
+/******************************************************************************
+ *                                                                            *
+ *                               Basic Getters                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Gets the number of elements.
+/// @param rb Pointer to the tree.
+/// @return The number of elements.
+size_t rb_count(const RBTree* rb);
+
+/// @brief Checks if the tree is empty.
+/// @param rb Pointer to the tree.
+/// @return `true` if `rb` is `NULL` or holds no element.
+bool rb_is_empty(const RBTree* rb);
+
+/// @brief Finds the element equal to `k`. O(log n).
+/// @param rb Pointer to the tree.
+/// @param k Pointer to the key (an element whose compared fields are set).
+/// @return Pointer to the stored element (its non-key fields may be modified in place), or `NULL`.
+void* rb_find(const RBTree* rb, const void* k);
+
+/// @brief Checks if an element equal to `k` is stored.
+/// @param rb Pointer to the tree.
+/// @param k Pointer to the key.
+/// @return `true` if found.
+bool rb_contains(const RBTree* rb, const void* k);
+
+/// @brief Finds the first element not less than `k`. O(log n).
+/// @param rb Pointer to the tree.
+/// @param k Pointer to the key.
+/// @return Pointer to the element, or `NULL` if every element is less than `k`.
+void* rb_lower_bound(const RBTree* rb, const void* k);
+
+/// @brief Finds the first element greater than `k`. O(log n).
+/// @param rb Pointer to the tree.
+/// @param k Pointer to the key.
+/// @return Pointer to the element, or `NULL` if no element is greater than `k`.
+void* rb_upper_bound(const RBTree* rb, const void* k);
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Iteration                                  *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Gets the smallest element.
+/// @param rb Pointer to the tree.
+/// @return Pointer to the element, or `NULL` if empty.
+void* rb_first(const RBTree* rb);
+
+/// @brief Gets the largest element.
+/// @param rb Pointer to the tree.
+/// @return Pointer to the element, or `NULL` if empty.
+void* rb_last(const RBTree* rb);
+
+/// @brief Gets the in-order successor of a stored element. O(1) amortized.
+/// @param rb Pointer to the tree.
+/// @param e Pointer to a stored element (as returned by the tree).
+/// @return Pointer to the next element, or `NULL` if `e` is the last one.
+void* rb_next(const RBTree* rb, const void* e);
+
+/// @brief Gets the in-order predecessor of a stored element. O(1) amortized.
+/// @param rb Pointer to the tree.
+/// @param e Pointer to a stored element (as returned by the tree).
+/// @return Pointer to the previous element, or `NULL` if `e` is the first one.
+void* rb_prev(const RBTree* rb, const void* e);
+
+/******************************************************************************
+ *                                                                            *
+ *                            Insertion & Removal                             *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Inserts a copy of `e`. O(log n); no other element moves.
+/// @param rb Pointer to the tree.
+/// @param e Pointer to the element.
+/// @return `true` if inserted, `false` if an equal element exists or on failure.
+bool rb_insert(RBTree* rb, const void* e);
+
+/// @brief Removes (and deallocates) the element equal to `k`. O(log n).
+/// @param rb Pointer to the tree.
+/// @param k Pointer to the key.
+/// @return `true` if an element was removed.
+bool rb_remove(RBTree* rb, const void* k);
+
+/// @brief Removes (and deallocates) a stored element through its pointer, without searching.
+/// @param rb Pointer to the tree.
+/// @param e Pointer to a stored element; it is invalid afterwards.
+void rb_erase(RBTree* rb, void* e);
+
+/******************************************************************************
+ *                                                                            *
+ *                              Order Statistics                              *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Counts the elements less than `k`. O(log n); requires order statistics.
+/// @param rb Pointer to the tree.
+/// @param k Pointer to the key.
+/// @return The rank of `k`, or `(size_t)-1` if order statistics are disabled.
+size_t rb_rank(const RBTree* rb, const void* k);
+
+/// @brief Gets the element at in-order position `idx`. O(log n); requires order statistics.
+/// @param rb Pointer to the tree.
+/// @param idx Zero-based position.
+/// @return Pointer to the element, or `NULL` if out of bounds or order statistics are disabled.
+void* rb_select(const RBTree* rb, size_t idx);
+
+/******************************************************************************
+ *                                                                            *
+ *                             Memory Accounting                              *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Breaks down the memory used by the tree.
+/// @details `payload` is the elements, `metadata` the structure and node headers, `slack` the node padding and free pool blocks, and `overhead` the allocator's rounding of the structure.
+/// @param rb Pointer to the tree.
+/// @param owned_size Returns the bytes owned by an element (may be `NULL`).
+/// @return The breakdown (zeroed if `rb` is `NULL`).
+MemUsage rb_memory_usage(const RBTree* rb, size_t (*owned_size)(const void* k));
+
+#endif  // RBTREE_H
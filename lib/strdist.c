@@ -0,0 +1,372 @@
+#include "strdist.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "bits.h"
+#include "par_for.h"
+
+/// Most significant bit of a full block.
+#define __SD_HIGH_BIT ((uint64_t)1 << 63)
+
+/******************************************************************************
+ *                                                                            *
+ *                              Inner Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+/// Buffers reused across pairs; the pattern tables are kept all-zero between calls.
+typedef struct SDScratch {
+    uint64_t small[256];  ///< Pattern bits per byte value, for patterns of at most 64 bytes.
+    uint64_t* peq;        ///< Pattern bits of longer patterns, `256 * cap` words (entry `c * words + w`).
+    uint64_t* pv;         ///< Vertical +1 deltas, one word per block.
+    uint64_t* mv;         ///< Vertical -1 deltas, one word per block.
+    size_t* score;        ///< DP value at the bottom row of each block.
+    size_t cap;           ///< Number of blocks the buffers above can hold.
+} SDScratch;
+
+/// A slice of pairs computed by one thread.
+typedef struct SDBatchTask {
+    const SDPair* pairs;
+    size_t lo;  ///< Pairs `[lo, hi)`.
+    size_t hi;
+    size_t max;
+    size_t* out;
+    bool ok;
+} SDBatchTask;
+
+static bool __sd_reserve(SDScratch* s, size_t words);
+static void __sd_release(SDScratch* s);
+// pattern table of `p` (`words == 1` uses the inline table)
+static uint64_t* __sd_peq_build(SDScratch* s, const uint8_t* p, size_t m, size_t words);
+static void __sd_peq_clear(uint64_t* peq, const uint8_t* p, size_t m, size_t words);
+
+// one block of one DP column: updates the vertical deltas, returns the horizontal delta out of the row at `hbit`
+inline static int __sd_step(uint64_t* pv, uint64_t* mv, uint64_t eq, int hin, uint64_t hbit);
+
+static size_t __sd_levenshtein(const uint8_t* a, size_t m, const uint8_t* b, size_t n, size_t max, SDScratch* s);
+static size_t __sd_myers_word(const uint8_t* a, size_t m, const uint8_t* b, size_t n, size_t max, SDScratch* s);
+static size_t __sd_myers_band(const uint8_t* a, size_t m, const uint8_t* b, size_t n, size_t max, SDScratch* s);
+static size_t __sd_lcs(const uint8_t* a, size_t m, const uint8_t* b, size_t n, SDScratch* s);
+static void* __sd_batch_task(void* arg);
+
+/******************************************************************************
+ *                                                                            *
+ *                               Edit Distance                                *
+ *                                                                            *
+ ******************************************************************************/
+
+size_t sd_levenshtein(const char* a, size_t a_len, const char* b, size_t b_len) {
+    return sd_levenshtein_bounded(a, a_len, b, b_len, SIZE_MAX);
+}
+
+size_t sd_levenshtein_bounded(const char* a, size_t a_len, const char* b, size_t b_len, size_t max) {
+    if ((!a && a_len) || (!b && b_len)) return SIZE_MAX;
+
+    SDScratch s = {0};
+    const size_t d = __sd_levenshtein((const uint8_t*)a, a_len, (const uint8_t*)b, b_len, max, &s);
+    __sd_release(&s);
+
+    return d;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                         Longest Common Subsequence                         *
+ *                                                                            *
+ ******************************************************************************/
+
+size_t sd_lcs(const char* a, size_t a_len, const char* b, size_t b_len) {
+    if ((!a && a_len) || (!b && b_len)) return SIZE_MAX;
+
+    SDScratch s = {0};
+    const size_t l = __sd_lcs((const uint8_t*)a, a_len, (const uint8_t*)b, b_len, &s);
+    __sd_release(&s);
+
+    return l;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                   Batch                                    *
+ *                                                                            *
+ ******************************************************************************/
+
+bool sd_levenshtein_batch(const SDPair* pairs, size_t count, size_t max, size_t* out, size_t threads) {
+    if (!pairs || !out) return false;
+
+    if (threads < 1) threads = 1;
+    if (threads > count) threads = count ? count : 1;
+
+    SDBatchTask* tasks = (SDBatchTask*)malloc(threads * sizeof(SDBatchTask));
+    if (!tasks) return false;
+
+    for (size_t t = 0; t < threads; t++) {
+        tasks[t] = (SDBatchTask){pairs, count * t / threads, count * (t + 1) / threads, max, out, true};
+    }
+
+    __par_for(threads, __sd_batch_task, tasks, sizeof(SDBatchTask));
+
+    bool ok = true;
+    for (size_t t = 0; t < threads; t++) ok = ok && tasks[t].ok;
+
+    free(tasks);
+
+    return ok;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                       Inner Functions Implementation                       *
+ *                                                                            *
+ ******************************************************************************/
+
+static bool __sd_reserve(SDScratch* s, size_t words) {
+    if (words <= s->cap) return true;
+
+    __sd_release(s);
+
+    s->peq = (uint64_t*)calloc(256 * words, sizeof(uint64_t));
+    s->pv = (uint64_t*)malloc(words * sizeof(uint64_t));
+    s->mv = (uint64_t*)malloc(words * sizeof(uint64_t));
+    s->score = (size_t*)malloc(words * sizeof(size_t));
+
+    if (!s->peq || !s->pv || !s->mv || !s->score) {
+        __sd_release(s);
+        return false;
+    }
+
+    s->cap = words;
+
+    return true;
+}
+
+static void __sd_release(SDScratch* s) {
+    free(s->peq);
+    free(s->pv);
+    free(s->mv);
+    free(s->score);
+
+    s->peq = NULL;
+    s->pv = s->mv = NULL;
+    s->score = NULL;
+    s->cap = 0;
+}
+
+static uint64_t* __sd_peq_build(SDScratch* s, const uint8_t* p, size_t m, size_t words) {
+    uint64_t* peq = words == 1 ? s->small : s->peq;
+
+    for (size_t i = 0; i < m; i++) peq[p[i] * words + i / 64] |= (uint64_t)1 << (i % 64);
+
+    return peq;
+}
+
+static void __sd_peq_clear(uint64_t* peq, const uint8_t* p, size_t m, size_t words) {
+    for (size_t i = 0; i < m; i++) peq[p[i] * words + i / 64] = 0;
+}
+
+inline static int __sd_step(uint64_t* pv, uint64_t* mv, uint64_t eq, int hin, uint64_t hbit) {
+    // Hyyrö's formulation of Myers' column update, with the delta entering at the top of the block as input
+    const uint64_t p = *pv, n = *mv;
+    const uint64_t neg = hin < 0, pos = hin > 0;
+
+    const uint64_t xv = eq | n;
+    eq |= neg;
+    const uint64_t xh = (((eq & p) + p) ^ p) | eq;
+
+    uint64_t ph = n | ~(xh | p);
+    uint64_t mh = p & xh;
+    const int hout = (ph & hbit) ? 1 : (mh & hbit) ? -1 : 0;
+
+    ph = (ph << 1) | pos;
+    mh = (mh << 1) | neg;
+
+    *pv = mh | ~(xv | ph);
+    *mv = ph & xv;
+
+    return hout;
+}
+
+static size_t __sd_levenshtein(const uint8_t* a, size_t m, const uint8_t* b, size_t n, size_t max, SDScratch* s) {
+    // The shorter string is the bit-vector (rows), the longer one is scanned (columns)
+    if (m > n) {
+        const uint8_t* t = a;
+        a = b;
+        b = t;
+
+        const size_t l = m;
+        m = n;
+        n = l;
+    }
+
+    if (n - m > max) return max + 1;
+
+    // A common prefix or suffix never changes the distance
+    while (m && *a == *b) a++, b++, m--, n--;
+    while (m && a[m - 1] == b[n - 1]) m--, n--;
+
+    if (!m) return n <= max ? n : max + 1;
+
+    // The distance is at most `n`, which also keeps `max + 1` from overflowing
+    if (max > n) max = n;
+
+    return m <= 64 ? __sd_myers_word(a, m, b, n, max, s) : __sd_myers_band(a, m, b, n, max, s);
+}
+
+static size_t __sd_myers_word(const uint8_t* a, size_t m, const uint8_t* b, size_t n, size_t max, SDScratch* s) {
+    uint64_t* peq = __sd_peq_build(s, a, m, 1);
+    uint64_t pv = ~(uint64_t)0, mv = 0;
+    const uint64_t hbit = (uint64_t)1 << (m - 1);
+    size_t score = m;
+
+    for (size_t j = 0; j < n; j++) {
+        const int h = __sd_step(&pv, &mv, peq[b[j]], 1, hbit);
+        score = (size_t)((ptrdiff_t)score + h);
+
+        // The last row drops by at most 1 per remaining column
+        if (score > max + (n - j - 1)) {
+            score = max + 1;
+            break;
+        }
+    }
+
+    __sd_peq_clear(peq, a, m, 1);
+
+    return score <= max ? score : max + 1;
+}
+
+static size_t __sd_myers_band(const uint8_t* a, size_t m, const uint8_t* b, size_t n, size_t max, SDScratch* s) {
+    const size_t words = (m + 63) / 64;
+    if (!__sd_reserve(s, words)) return SIZE_MAX;
+
+    uint64_t* peq = __sd_peq_build(s, a, m, words);
+    uint64_t *pv = s->pv, *mv = s->mv;
+    size_t* score = s->score;
+    const uint64_t last_bit = (uint64_t)1 << ((m - 1) % 64);
+
+    // A path of cost <= max only visits cells (i, j) with i - j <= below and j - i <= above (each cell costs at least
+    // |i - j| to reach and |(m - i) - (n - j)| to leave). Cells outside are never computed: the block below the band
+    // enters as a column of +1 steps and the block above it is replaced by a +1 horizontal delta, both upper bounds of
+    // the true values, so every cell of the band on such a path stays exact.
+    const size_t d = n - m, below = (max - d) / 2, above = (max + d) / 2;
+
+    size_t first = 0, last = ((m < 1 + below ? m : 1 + below) - 1) / 64;
+    for (size_t w = 0; w <= last; w++) {
+        pv[w] = ~(uint64_t)0;
+        mv[w] = 0;
+        score[w] = w + 1 < words ? 64 * (w + 1) : m;
+    }
+
+    size_t result = max + 1;
+    bool exceeded = false;
+
+    for (size_t j = 1; j <= n && !exceeded; j++) {
+        // Rows `[lo, hi]` of column `j` (1-based) are in the band
+        const size_t hi = m < j + below ? m : j + below, lo = j > above ? j - above : 1;
+
+        while (last < (hi - 1) / 64) {
+            last++;
+            pv[last] = ~(uint64_t)0;
+            mv[last] = 0;
+            score[last] = score[last - 1] + (last + 1 < words ? 64 : m - 64 * last);
+        }
+        first = (lo - 1) / 64;
+
+        const uint64_t* eq = peq + b[j - 1] * words;
+        size_t bound = SIZE_MAX;
+        int h = 1;
+
+        for (size_t w = first; w <= last; w++) {
+            h = __sd_step(&pv[w], &mv[w], eq[w], h, w + 1 < words ? __SD_HIGH_BIT : last_bit);
+            score[w] = (size_t)((ptrdiff_t)score[w] + h);
+
+            // Vertical neighbours differ by at most 1, so no cell of the block is below this
+            const size_t rows = w + 1 < words ? 64 : m - 64 * w;
+            const size_t low = score[w] + 1 > rows ? score[w] + 1 - rows : 0;
+            if (low < bound) bound = low;
+        }
+
+        // Every path crosses this column, and its cells there only grow along it
+        exceeded = bound > max;
+    }
+
+    if (!exceeded) result = score[words - 1];
+
+    __sd_peq_clear(peq, a, m, words);
+
+    return result <= max ? result : max + 1;
+}
+
+static size_t __sd_lcs(const uint8_t* a, size_t m, const uint8_t* b, size_t n, SDScratch* s) {
+    if (m > n) {
+        const uint8_t* t = a;
+        a = b;
+        b = t;
+
+        const size_t l = m;
+        m = n;
+        n = l;
+    }
+
+    // A common prefix or suffix is part of some longest common subsequence
+    size_t common = 0;
+    while (m && *a == *b) a++, b++, m--, n--, common++;
+    while (m && a[m - 1] == b[n - 1]) m--, n--, common++;
+
+    if (!m) return common;
+
+    const size_t words = (m + 63) / 64;
+    if (words > 1 && !__sd_reserve(s, words)) return SIZE_MAX;
+
+    uint64_t* peq = __sd_peq_build(s, a, m, words);
+    uint64_t single = ~(uint64_t)0;
+    uint64_t* v = words == 1 ? &single : s->pv;
+
+    for (size_t w = 0; w < words; w++) v[w] = ~(uint64_t)0;
+
+    // A zero bit of `v` marks a row where the LCS grows: v = (v + (v & eq)) | (v & ~eq), carried across words
+    for (size_t j = 0; j < n; j++) {
+        const uint64_t* eq = peq + b[j] * words;
+        uint64_t carry = 0;
+
+        for (size_t w = 0; w < words; w++) {
+            const uint64_t x = v[w], u = x & eq[w];
+            uint64_t sum;
+            const uint64_t c1 = __builtin_add_overflow(x, u, &sum);
+            const uint64_t c2 = __builtin_add_overflow(sum, carry, &sum);
+
+            v[w] = sum | (x & ~eq[w]);
+            carry = c1 | c2;
+        }
+    }
+
+    size_t length = 0;
+    for (size_t w = 0; w < words; w++) {
+        const uint64_t mask = w + 1 < words || m % 64 == 0 ? ~(uint64_t)0 : ((uint64_t)1 << (m % 64)) - 1;
+        length += bits_popcount(~v[w] & mask);
+    }
+
+    __sd_peq_clear(peq, a, m, words);
+
+    return common + length;
+}
+
+static void* __sd_batch_task(void* arg) {
+    SDBatchTask* task = arg;
+    SDScratch s = {0};
+
+    for (size_t i = task->lo; i < task->hi; i++) {
+        const SDPair* p = &task->pairs[i];
+
+        const uint8_t *a = (const uint8_t*)p->a, *b = (const uint8_t*)p->b;
+
+        if ((!a && p->a_len) || (!b && p->b_len)) task->out[i] = SIZE_MAX;
+        else task->out[i] = __sd_levenshtein(a, p->a_len, b, p->b_len, task->max, &s);
+
+        task->ok = task->ok && task->out[i] != SIZE_MAX;
+    }
+
+    __sd_release(&s);
+
+    return NULL;
+}
@@ -0,0 +1,84 @@
+#ifndef STRDIST_H
+#define STRDIST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Nomenclature used (to avoid collisions): sd_<method_name>
+//
+// Distances between byte strings, computed on bit-vectors: the shorter string is encoded as one bit per character in
+// 64-bit words and each character of the longer one updates a whole DP column in O(m / 64) word operations, i.e.
+// O(n * m / 64) instead of the O(n * m) table. Strings are given as pointer and length and may contain zero bytes.
+
+/**
+ * @brief One pair of strings for the batch API.
+ */
+typedef struct SDPair {
+    const char* a;  ///< First string (may be `NULL` when `a_len` is 0).
+    size_t a_len;   ///< Length of `a`, in bytes.
+    const char* b;  ///< Second string (may be `NULL` when `b_len` is 0).
+    size_t b_len;   ///< Length of `b`, in bytes.
+} SDPair;
+
+/******************************************************************************
+ *                                                                            *
+ *                               Edit Distance                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Levenshtein distance (insertions, deletions and substitutions of one byte each cost 1).
+/// @details Myers' bit-parallel algorithm in Hyyrö's multi-word form, restricted to the diagonal band that can still
+/// hold the optimal path. A common prefix and suffix are stripped first.
+/// @param a First string.
+/// @param a_len Length of `a`.
+/// @param b Second string.
+/// @param b_len Length of `b`.
+/// @return The distance, or `SIZE_MAX` on a `NULL` string of non-zero length or allocation failure.
+size_t sd_levenshtein(const char* a, size_t a_len, const char* b, size_t b_len);
+
+/// @brief Levenshtein distance capped at a threshold, for "is it within `max` edits" tests.
+/// @details Only the blocks of 64 rows crossing the band of diagonals `[-max, max]` (narrowed by the length difference)
+/// are computed, so the cost is O(max * n / 64), and the scan stops as soon as every cell of the current column
+/// exceeds `max`. Pairs whose lengths differ by more than `max` return immediately.
+/// @param a First string.
+/// @param a_len Length of `a`.
+/// @param b Second string.
+/// @param b_len Length of `b`.
+/// @param max Largest distance of interest.
+/// @return The distance if it is at most `max`, `max + 1` otherwise, or `SIZE_MAX` on a `NULL` string of non-zero
+/// length or allocation failure.
+size_t sd_levenshtein_bounded(const char* a, size_t a_len, const char* b, size_t b_len, size_t max);
+
+/******************************************************************************
+ *                                                                            *
+ *                         Longest Common Subsequence                         *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Length of the longest common subsequence (bit-parallel, Allison-Dix / Hyyrö).
+/// @param a First string.
+/// @param a_len Length of `a`.
+/// @param b Second string.
+/// @param b_len Length of `b`.
+/// @return The length, or `SIZE_MAX` on a `NULL` string of non-zero length or allocation failure.
+size_t sd_lcs(const char* a, size_t a_len, const char* b, size_t b_len);
+
+/******************************************************************************
+ *                                                                            *
+ *                                   Batch                                    *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Runs `sd_levenshtein_bounded` over many pairs, split across up to `threads` threads.
+/// @details Each thread reuses its own scratch buffers, so short pairs cost no allocation.
+/// @param pairs The pairs.
+/// @param count Number of pairs.
+/// @param max Largest distance of interest (`SIZE_MAX` for exact distances).
+/// @param out Receives `count` results, as `sd_levenshtein_bounded` returns them.
+/// @param threads Maximum number of threads (1 runs on the calling thread, which also takes any slice whose thread
+/// could not start).
+/// @return `true` if every pair was computed, `false` on `NULL` arguments or if some pair failed (its result is then
+/// `SIZE_MAX`).
+bool sd_levenshtein_batch(const SDPair* pairs, size_t count, size_t max, size_t* out, size_t threads);
+
+#endif  // STRDIST_H
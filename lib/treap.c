@@ -0,0 +1,534 @@
+#include "treap.h"
+
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "random.h"
+#include "treap_core.h"
+
+/// Offset of the element inside a node: the header rounded up to the strictest fundamental alignment.
+#define __TP_DATA_OFFSET ((sizeof(TPNode) + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1))
+
+/******************************************************************************
+ *                                                                            *
+ *                              Inner Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+// allocates an empty treap sharing `pool` (whose reference is taken over)
+static Treap* __tp_new_with_pool(size_t element_size, int (*cmp)(const void* a, const void* b), void (*copier)(void* dest, const void* src), void (*deallocator)(void* k), Pool* pool, uint64_t rng_state);
+// allocates an empty treap configured like `tp`, sharing its pool
+static Treap* __tp_new_like(Treap* tp);
+inline static void* __tp_elem(const TPNode* node);
+inline static size_t __tp_size(const TPNode* node);
+inline static void __tp_update(TPNode* node);
+// orders `node`'s element against the element `k` (the treap-core comparison hook)
+inline static int __tp_cmp(const Treap* tp, const TPNode* node, const void* k);
+// splits `node` into the elements less than `k` (`*l`) and the others (`*r`)
+static void __tp_split(const Treap* tp, TPNode* node, const void* k, TPNode** l, TPNode** r);
+// concatenates `l` and `r`, every element of `l` being less than every element of `r`
+static TPNode* __tp_merge(TPNode* l, TPNode* r);
+static TPNode* __tp_insert(const Treap* tp, TPNode* node, TPNode* fresh);
+// unlinks the node equal to `k` into `*removed`
+static TPNode* __tp_remove(const Treap* tp, TPNode* node, const void* k, TPNode** removed);
+// unions `a` and `b`, keeping `a`'s element on equality; the discarded nodes are chained on `*dups` through their `left` link
+static TPNode* __tp_union(const Treap* tp, TPNode* a, TPNode* b, TPNode** dups, size_t depth, size_t spawn_depth);
+static void* __tp_union_task(void* arg);
+// makes `src`'s nodes belong to `dest`'s pool, moving them if needed; returns false on allocation failure
+static bool __tp_adopt(Treap* dest, Treap* src);
+static TPNode* __tp_clone_into(Pool* pool, const TPNode* node, size_t block_size, bool* ok);
+// returns every node of the subtree to `pool`, deallocating the elements if `deallocator` is set
+static void __tp_free_subtree(Pool* pool, TPNode* node, void (*deallocator)(void* k));
+static void __tp_for_each(TPNode* node, void (*fn)(void* e, void* ctx), void* ctx);
+
+/// Arguments and result of a union half running on its own thread.
+typedef struct TreapUnionTask {
+    const Treap* tp;
+    TPNode* a;
+    TPNode* b;
+    TPNode* dups;
+    TPNode* result;
+    size_t depth;
+    size_t spawn_depth;
+} TPUnionTask;
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+Treap* tp_new(size_t element_size, int (*cmp)(const void* a, const void* b), void (*copier)(void* dest, const void* src), void (*deallocator)(void* k)) {
+    if (element_size == 0 || !cmp || !copier || !deallocator) return NULL;
+
+    Pool* pool = pool_new(__TP_DATA_OFFSET + element_size, alignof(max_align_t), TP_NODES_PER_SLAB);
+    if (!pool) return NULL;
+
+    Treap* tp = __tp_new_with_pool(element_size, cmp, copier, deallocator, pool, __random_u64());
+    if (!tp) pool_release(pool);
+
+    return tp;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                             Clean Up & Freeing                             *
+ *                                                                            *
+ ******************************************************************************/
+
+void tp_free(Treap* tp) {
+    if (!tp) return;
+
+    tp_clear(tp);
+    pool_release(tp->pool);
+
+    ms_track(MS_TREAP, -1, -(int64_t)sizeof(Treap));
+
+    free(tp);
+}
+
+void tp_clear(Treap* tp) {
+    if (!tp) return;
+
+    __tp_free_subtree(tp->pool, tp->root, tp->deallocator);
+
+    tp->root = NULL;
+    tp->count = 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Basic Getters                                *
+ *                                                                            *
+ ******************************************************************************/
+
+size_t tp_count(const Treap* tp) {
+    return tp ? tp->count : 0;
+}
+
+bool tp_is_empty(const Treap* tp) {
+    return !tp || tp->count == 0;
+}
+
+void* tp_find(const Treap* tp, const void* k) {
+    if (!tp || !k) return NULL;
+
+    TPNode* node = tp->root;
+
+    while (node) {
+        int c = tp->cmp(k, __tp_elem(node));
+
+        if (c == 0) return __tp_elem(node);
+
+        node = c < 0 ? node->left : node->right;
+    }
+
+    return NULL;
+}
+
+bool tp_contains(const Treap* tp, const void* k) {
+    return tp_find(tp, k) != NULL;
+}
+
+size_t tp_rank(const Treap* tp, const void* k) {
+    if (!tp || !k) return 0;
+
+    size_t rank = 0;
+    TPNode* node = tp->root;
+
+    while (node) {
+        if (tp->cmp(__tp_elem(node), k) < 0) {
+            rank += __tp_size(node->left) + 1;
+            node = node->right;
+        } else {
+            node = node->left;
+        }
+    }
+
+    return rank;
+}
+
+void* tp_at(const Treap* tp, size_t idx) {
+    if (!tp || idx >= tp->count) return NULL;
+
+    TPNode* node = tp->root;
+
+    for (;;) {
+        size_t left = __tp_size(node->left);
+
+        if (idx == left) return __tp_elem(node);
+
+        if (idx < left) {
+            node = node->left;
+        } else {
+            idx -= left + 1;
+            node = node->right;
+        }
+    }
+}
+
+void tp_for_each(const Treap* tp, void (*fn)(void* e, void* ctx), void* ctx) {
+    if (!tp || !fn) return;
+
+    __tp_for_each(tp->root, fn, ctx);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                            Insertion & Removal                             *
+ *                                                                            *
+ ******************************************************************************/
+
+bool tp_insert(Treap* tp, const void* e) {
+    if (!tp || !e || tp_contains(tp, e)) return false;
+
+    TPNode* node = (TPNode*)pool_alloc(tp->pool);
+    if (!node) return false;
+
+    node->left = NULL;
+    node->right = NULL;
+    node->priority = __treap_next_priority(&tp->rng_state);
+    node->size = 1;
+
+    tp->copier(__tp_elem(node), e);
+
+    tp->root = __tp_insert(tp, tp->root, node);
+    tp->count++;
+
+    return true;
+}
+
+bool tp_remove(Treap* tp, const void* k) {
+    if (!tp || !k) return false;
+
+    TPNode* removed = NULL;
+    tp->root = __tp_remove(tp, tp->root, k, &removed);
+
+    if (!removed) return false;
+
+    tp->deallocator(__tp_elem(removed));
+    pool_free(tp->pool, removed);
+    tp->count--;
+
+    return true;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                            Split, Merge & Union                            *
+ *                                                                            *
+ ******************************************************************************/
+
+Treap* tp_split(Treap* tp, const void* k) {
+    if (!tp || !k) return NULL;
+
+    Treap* right = __tp_new_like(tp);
+    if (!right) return NULL;
+
+    __tp_split(tp, tp->root, k, &tp->root, &right->root);
+
+    tp->count = __tp_size(tp->root);
+    right->count = __tp_size(right->root);
+
+    return right;
+}
+
+Treap* tp_extract_range(Treap* tp, const void* lo, const void* hi) {
+    if (!tp || !lo || !hi) return NULL;
+
+    Treap* range = __tp_new_like(tp);
+    if (!range) return NULL;
+
+    if (tp->cmp(lo, hi) < 0) {
+        TPNode *below, *rest, *above;
+
+        __tp_split(tp, tp->root, lo, &below, &rest);
+        __tp_split(tp, rest, hi, &range->root, &above);
+
+        tp->root = __tp_merge(below, above);
+    }
+
+    tp->count = __tp_size(tp->root);
+    range->count = __tp_size(range->root);
+
+    return range;
+}
+
+bool tp_merge(Treap* dest, Treap* src) {
+    if (!dest || !src || dest == src || dest->element_size != src->element_size) return false;
+    if (!src->root) return true;
+
+    if (dest->root && dest->cmp(tp_at(dest, dest->count - 1), tp_at(src, 0)) >= 0) return false;
+
+    if (!__tp_adopt(dest, src)) return false;
+
+    dest->root = __tp_merge(dest->root, src->root);
+    dest->count = __tp_size(dest->root);
+
+    src->root = NULL;
+    src->count = 0;
+
+    return true;
+}
+
+bool tp_union(Treap* dest, Treap* src) {
+    return tp_union_parallel(dest, src, 1);
+}
+
+bool tp_union_parallel(Treap* dest, Treap* src, size_t threads) {
+    if (!dest || !src || dest == src || dest->element_size != src->element_size) return false;
+    if (!src->root) return true;
+
+    if (!__tp_adopt(dest, src)) return false;
+
+    // Each spawning level doubles the number of running halves
+    size_t spawn_depth = 0;
+    while (threads > 1 && ((size_t)1 << spawn_depth) < threads) spawn_depth++;
+
+    TPNode* dups = NULL;
+    dest->root = __tp_union(dest, dest->root, src->root, &dups, 0, spawn_depth);
+    dest->count = __tp_size(dest->root);
+
+    src->root = NULL;
+    src->count = 0;
+
+    // The pool is not thread-safe: duplicates are only released once every thread is done
+    while (dups) {
+        TPNode* next = dups->left;
+
+        dest->deallocator(__tp_elem(dups));
+        pool_free(dest->pool, dups);
+
+        dups = next;
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                             Memory Accounting                              *
+ *                                                                            *
+ ******************************************************************************/
+
+MemUsage tp_memory_usage(const Treap* tp, size_t (*owned_size)(const void* k)) {
+    MemUsage mu = {0, 0, 0, 0, 0};
+    if (!tp) return mu;
+
+    const size_t padding = tp->pool->block_size - __TP_DATA_OFFSET - tp->element_size;
+
+    mu.payload = tp->count * tp->element_size;
+    mu.metadata = sizeof(Treap) + tp->count * __TP_DATA_OFFSET;
+    mu.slack = tp->count * padding;
+    mu.overhead = ms_usable_size(tp, sizeof(Treap)) - sizeof(Treap);
+
+    if (owned_size) {
+        for (size_t i = 0; i < tp->count; i++) mu.owned += owned_size(tp_at(tp, i));
+    }
+
+    return mu;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                       Inner Functions Implementation                       *
+ *                                                                            *
+ ******************************************************************************/
+
+static Treap* __tp_new_with_pool(size_t element_size, int (*cmp)(const void* a, const void* b), void (*copier)(void* dest, const void* src), void (*deallocator)(void* k), Pool* pool, uint64_t rng_state) {
+    Treap* tp = (Treap*)malloc(sizeof(Treap));
+    if (!tp) return NULL;
+
+    tp->root = NULL;
+    tp->count = 0;
+    tp->element_size = element_size;
+
+    tp->rng_state = rng_state ? rng_state : 0x9E3779B97F4A7C15ULL;  // xorshift must not start at 0
+
+    tp->pool = pool;
+
+    tp->cmp = cmp;
+    tp->copier = copier;
+    tp->deallocator = deallocator;
+
+    ms_track(MS_TREAP, 1, (int64_t)sizeof(Treap));
+
+    return tp;
+}
+
+static Treap* __tp_new_like(Treap* tp) {
+    Treap* like = __tp_new_with_pool(tp->element_size, tp->cmp, tp->copier, tp->deallocator, pool_retain(tp->pool), __treap_next_priority(&tp->rng_state));
+    if (!like) pool_release(tp->pool);
+
+    return like;
+}
+
+inline static void* __tp_elem(const TPNode* node) {
+    return (char*)node + __TP_DATA_OFFSET;
+}
+
+inline static size_t __tp_size(const TPNode* node) {
+    return node ? node->size : 0;
+}
+
+inline static void __tp_update(TPNode* node) {
+    node->size = __tp_size(node->left) + __tp_size(node->right) + 1;
+}
+
+inline static int __tp_cmp(const Treap* tp, const TPNode* node, const void* k) {
+    return tp->cmp(__tp_elem(node), k);
+}
+
+DEFINE_TREAP_CORE(__tp, TPNode, const Treap*, const void*, __tp_cmp, __tp_elem, __tp_update)
+
+static TPNode* __tp_remove(const Treap* tp, TPNode* node, const void* k, TPNode** removed) {
+    if (!node) return NULL;
+
+    int c = tp->cmp(k, __tp_elem(node));
+
+    if (c == 0) {
+        *removed = node;
+        return __tp_merge(node->left, node->right);
+    }
+
+    if (c < 0) {
+        node->left = __tp_remove(tp, node->left, k, removed);
+    } else {
+        node->right = __tp_remove(tp, node->right, k, removed);
+    }
+
+    __tp_update(node);
+
+    return node;
+}
+
+static TPNode* __tp_union(const Treap* tp, TPNode* a, TPNode* b, TPNode** dups, size_t depth, size_t spawn_depth) {
+    if (!a) return b;
+    if (!b) return a;
+
+    // The higher priority root stays on top, the other side is split around it
+    const bool b_on_top = b->priority > a->priority;
+
+    TPNode* root = b_on_top ? b : a;
+    TPNode *lo, *hi, *equal = NULL;
+
+    __tp_split(tp, b_on_top ? a : b, __tp_elem(root), &lo, &hi);
+    hi = __tp_remove(tp, hi, __tp_elem(root), &equal);
+
+    if (equal && b_on_top) {
+        // `a`'s element wins: its node takes over the position (and priority) of `b`'s
+        equal->left = root->left;
+        equal->right = root->right;
+        equal->priority = root->priority;
+
+        TPNode* tmp = root;
+        root = equal;
+        equal = tmp;
+    }
+
+    if (equal) {
+        equal->left = *dups;
+        *dups = equal;
+    }
+
+    // Children of `root` and halves of the split side, each pair ordered (from `a`, from `b`)
+    TPNode* left_a = b_on_top ? lo : root->left;
+    TPNode* left_b = b_on_top ? root->left : lo;
+    TPNode* right_a = b_on_top ? hi : root->right;
+    TPNode* right_b = b_on_top ? root->right : hi;
+
+    if (depth < spawn_depth) {
+        TPUnionTask task = {tp, left_a, left_b, NULL, NULL, depth + 1, spawn_depth};
+        pthread_t thread;
+
+        if (pthread_create(&thread, NULL, __tp_union_task, &task) == 0) {
+            root->right = __tp_union(tp, right_a, right_b, dups, depth + 1, spawn_depth);
+            pthread_join(thread, NULL);
+
+            root->left = task.result;
+
+            // Append the other half's duplicates
+            while (task.dups) {
+                TPNode* next = task.dups->left;
+                task.dups->left = *dups;
+                *dups = task.dups;
+                task.dups = next;
+            }
+
+            __tp_update(root);
+            return root;
+        }
+    }
+
+    root->left = __tp_union(tp, left_a, left_b, dups, depth + 1, spawn_depth);
+    root->right = __tp_union(tp, right_a, right_b, dups, depth + 1, spawn_depth);
+    __tp_update(root);
+
+    return root;
+}
+
+static void* __tp_union_task(void* arg) {
+    TPUnionTask* task = (TPUnionTask*)arg;
+
+    task->result = __tp_union(task->tp, task->a, task->b, &task->dups, task->depth, task->spawn_depth);
+
+    return NULL;
+}
+
+static bool __tp_adopt(Treap* dest, Treap* src) {
+    if (dest->pool == src->pool || !src->root) return true;
+
+    // Copy every block (header and element bytes) into `dest`'s pool first, so a failure leaves `src` intact
+    bool ok = true;
+    TPNode* clone = __tp_clone_into(dest->pool, src->root, src->element_size + __TP_DATA_OFFSET, &ok);
+
+    if (!ok) {
+        __tp_free_subtree(dest->pool, clone, NULL);
+        return false;
+    }
+
+    // The elements were moved, not copied: release the old nodes without deallocating them
+    __tp_free_subtree(src->pool, src->root, NULL);
+    src->root = clone;
+
+    return true;
+}
+
+static TPNode* __tp_clone_into(Pool* pool, const TPNode* node, size_t block_size, bool* ok) {
+    if (!node || !*ok) return NULL;
+
+    TPNode* clone = (TPNode*)pool_alloc(pool);
+    if (!clone) {
+        *ok = false;
+        return NULL;
+    }
+
+    memcpy(clone, node, block_size);
+
+    clone->left = __tp_clone_into(pool, node->left, block_size, ok);
+    clone->right = __tp_clone_into(pool, node->right, block_size, ok);
+
+    return clone;
+}
+
+static void __tp_free_subtree(Pool* pool, TPNode* node, void (*deallocator)(void* k)) {
+    if (!node) return;
+
+    __tp_free_subtree(pool, node->left, deallocator);
+    __tp_free_subtree(pool, node->right, deallocator);
+
+    if (deallocator) deallocator(__tp_elem(node));
+    pool_free(pool, node);
+}
+
+static void __tp_for_each(TPNode* node, void (*fn)(void* e, void* ctx), void* ctx) {
+    while (node) {
+        __tp_for_each(node->left, fn, ctx);
+        fn(__tp_elem(node), ctx);
+        node = node->right;
+    }
+}
@@ -0,0 +1,205 @@
+#ifndef TREAP_H
+#define TREAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "memstat.h"
+#include "pool.h"
+
+// Nomenclature used (to avoid collisions): <data_type>_<method_name>
+// Warning: This implementation is not thread-safe, and is for educational purposes only.
+
+/// Number of nodes carved from each slab of the node pool.
+#define TP_NODES_PER_SLAB 256
+
+/**
+ * @brief Treap Node
+ *
+ * The element is stored inline right after this header.
+ */
+typedef struct TreapNode TPNode;
+
+struct TreapNode {
+    TPNode* left;       ///< Left child (smaller elements).
+    TPNode* right;      ///< Right child (greater elements).
+    uint64_t priority;  ///< Random heap priority: a node's priority is never lower than its children's.
+    size_t size;        ///< Number of nodes in this subtree.
+};
+
+/**
+ * @brief Treap (Generic implementation)
+ *
+ * A randomized balanced search tree over elements of `element_size` bytes,
+ * ordered by `cmp`. Besides the usual operations it supports splitting at a
+ * key, concatenating, and cutting out a key range, all in expected O(log n):
+ * nodes are relinked, never copied. Subtree sizes give O(log n) `tp_rank` and
+ * `tp_at`.
+ *
+ * Treaps produced by `tp_split`/`tp_extract_range` share their node pool with
+ * the source treap, which lets them be merged back without copying.
+ */
+typedef struct Treap Treap;
+
+struct Treap {
+    TPNode* root;  ///< Root node (`NULL` if empty).
+
+    size_t count;         ///< Number of elements.
+    size_t element_size;  ///< Size of an element in bytes.
+
+    uint64_t rng_state;  ///< Xorshift state for node priorities, seeded from `/dev/urandom`.
+
+    Pool* pool;  ///< Node allocator, possibly shared with other treaps.
+
+    int (*cmp)(const void* a, const void* b);     ///< Orders the elements (negative, 0 or positive).
+    void (*copier)(void* dest, const void* src);  ///< Copies an element into its node.
+    void (*deallocator)(void* k);                 ///< Frees the resources of an element being removed.
+};
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Creates a new, empty treap.
+/// @param element_size The size of an element in bytes.
+/// @param cmp Pointer to the comparison function.
+/// @param copier Pointer to the deep copy function.
+/// @param deallocator Pointer to the deallocation function.
+/// @return A pointer to the newly allocated `Treap`, or `NULL` on failure.
+Treap* tp_new(size_t element_size, int (*cmp)(const void* a, const void* b), void (*copier)(void* dest, const void* src), void (*deallocator)(void* k));
+
+/******************************************************************************
+ *                                                                            *
+ *                             Clean Up & Freeing                             *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Frees the treap and its elements. The node pool is freed once no treap shares it anymore.
+/// @param tp Pointer to the treap.
+void tp_free(Treap* tp);
+
+/// @brief Removes every element (via `deallocator`).
+/// @param tp Pointer to the treap.
+void tp_clear(Treap* tp);
+
+/******************************************************************************
+ *                                                                            *
+ *                               Basic Getters                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Gets the number of elements.
+/// @param tp Pointer to the treap.
+/// @return The number of elements.
+size_t tp_count(const Treap* tp);
+
+/// @brief Checks if the treap is empty.
+/// @param tp Pointer to the treap.
+/// @return `true` if `tp` is `NULL` or holds no element.
+bool tp_is_empty(const Treap* tp);
+
+/// @brief Finds the element equal to `k`. Expected O(log n).
+/// @param tp Pointer to the treap.
+/// @param k Pointer to the key.
+/// @return Pointer to the stored element, or `NULL`.
+void* tp_find(const Treap* tp, const void* k);
+
+/// @brief Checks if an element equal to `k` is stored.
+/// @param tp Pointer to the treap.
+/// @param k Pointer to the key.
+/// @return `true` if found.
+bool tp_contains(const Treap* tp, const void* k);
+
+/// @brief Counts the elements less than `k`. Expected O(log n).
+/// @param tp Pointer to the treap.
+/// @param k Pointer to the key.
+/// @return The rank of `k`.
+size_t tp_rank(const Treap* tp, const void* k);
+
+/// @brief Gets the element at in-order position `idx`. Expected O(log n).
+/// @param tp Pointer to the treap.
+/// @param idx Zero-based position.
+/// @return Pointer to the element, or `NULL` if out of bounds.
+void* tp_at(const Treap* tp, size_t idx);
+
+/// @brief Calls `fn` on every element in increasing order.
+/// @param tp Pointer to the treap.
+/// @param fn Callback receiving each element and `ctx`.
+/// @param ctx Opaque pointer passed to `fn`.
+void tp_for_each(const Treap* tp, void (*fn)(void* e, void* ctx), void* ctx);
+
+/******************************************************************************
+ *                                                                            *
+ *                            Insertion & Removal                             *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Inserts a copy of `e`. Expected O(log n).
+/// @param tp Pointer to the treap.
+/// @param e Pointer to the element.
+/// @return `true` if inserted, `false` if an equal element exists or on failure.
+bool tp_insert(Treap* tp, const void* e);
+
+/// @brief Removes (and deallocates) the element equal to `k`. Expected O(log n).
+/// @param tp Pointer to the treap.
+/// @param k Pointer to the key.
+/// @return `true` if an element was removed.
+bool tp_remove(Treap* tp, const void* k);
+
+/******************************************************************************
+ *                                                                            *
+ *                            Split, Merge & Union                            *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Moves every element not less than `k` into a new treap. Expected O(log n).
+/// @param tp Pointer to the treap (keeps the elements less than `k`).
+/// @param k Pointer to the split key.
+/// @return The new treap (sharing `tp`'s pool), or `NULL` on failure.
+Treap* tp_split(Treap* tp, const void* k);
+
+/// @brief Moves the elements in $[lo, hi)$ into a new treap. Expected O(log n).
+/// @param tp Pointer to the treap.
+/// @param lo Pointer to the inclusive lower bound.
+/// @param hi Pointer to the exclusive upper bound.
+/// @return The new treap (sharing `tp`'s pool), or `NULL` on failure.
+Treap* tp_extract_range(Treap* tp, const void* lo, const void* hi);
+
+/// @brief Appends `src` to `dest`, where every element of `src` is greater than every element of `dest`. Expected O(log n).
+/// @details When the treaps do not share a pool, the nodes of `src` are first moved into `dest`'s pool in O(|src|).
+/// @param dest Pointer to the treap holding the smaller elements.
+/// @param src Pointer to the treap holding the greater elements (left empty).
+/// @return `true` on success, `false` if the ranges overlap, the element sizes differ, or on failure.
+bool tp_merge(Treap* dest, Treap* src);
+
+/// @brief Moves every element of `src` into `dest`, deallocating the elements of `src` already present in `dest`.
+/// @details Split-merge recursion in expected O(m log(n/m + 1)) for sizes m <= n. When the treaps do not share a pool, the nodes of `src` are first moved into `dest`'s pool in O(|src|).
+/// @param dest Pointer to the destination treap.
+/// @param src Pointer to the source treap (left empty).
+/// @return `true` on success, `false` if the element sizes differ or on failure.
+bool tp_union(Treap* dest, Treap* src);
+
+/// @brief Same as `tp_union`, running the independent halves of the top recursion levels on up to `threads` threads.
+/// @param dest Pointer to the destination treap.
+/// @param src Pointer to the source treap (left empty).
+/// @param threads Maximum number of threads (1 is the sequential `tp_union`).
+/// @return `true` on success, `false` if the element sizes differ or on failure.
+bool tp_union_parallel(Treap* dest, Treap* src, size_t threads);
+
+/******************************************************************************
+ *                                                                            *
+ *                             Memory Accounting                              *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Breaks down the memory used by the treap's elements and nodes.
+/// @details `payload` is the elements, `metadata` the structure and node headers, and `overhead` the allocator's rounding of the structure. Pool slack is not attributed, as the pool may be shared.
+/// @param tp Pointer to the treap.
+/// @param owned_size Returns the bytes owned by an element (may be `NULL`).
+/// @return The breakdown (zeroed if `tp` is `NULL`).
+MemUsage tp_memory_usage(const Treap* tp, size_t (*owned_size)(const void* k));
+
+#endif  // TREAP_H
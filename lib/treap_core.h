@@ -0,0 +1,91 @@
+#ifndef TREAP_CORE_H
+#define TREAP_CORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Internal header shared by lib/treap.c and lib/itree.c; not part of the public API.
+
+/**
+ * @brief Next node priority from a xorshift64* state (which must not be 0).
+ */
+static inline uint64_t __treap_next_priority(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * @brief Treap Core Generator (split / merge / insert)
+ *
+ * `DEFINE_TREAP_CORE(prefix, Node, Ctx, Key, cmp, key_of, update)` emits
+ * `prefix_split`, `prefix_merge` and `prefix_insert` for a node type with
+ * `left`, `right` and `priority` members. The hooks are called directly, so
+ * they are best `static inline` functions:
+ * - `int cmp(Ctx ctx, const Node* node, Key k)`: `<0`, `0` or `>0` as `node`
+ *   orders before, with or after `k`;
+ * - `Key key_of(const Node* node)`: the key a node is ordered by;
+ * - `void update(Node* node)`: recomputes the node's augmentation (size,
+ *   subtree maximum, ...) from its children, which are already up to date.
+ */
+#define DEFINE_TREAP_CORE(prefix, Node, Ctx, Key, cmp, key_of, update)                             \
+    /* splits `node` into the nodes ordered before `k` (`*l`) and the others (`*r`) */              \
+    static void prefix##_split(Ctx ctx, Node* node, Key k, Node** l, Node** r) {                    \
+        if (!node) {                                                                                \
+            *l = *r = NULL;                                                                         \
+            return;                                                                                 \
+        }                                                                                           \
+                                                                                                    \
+        if (cmp(ctx, node, k) < 0) {                                                                \
+            prefix##_split(ctx, node->right, k, &node->right, r);                                   \
+            *l = node;                                                                              \
+        } else {                                                                                    \
+            prefix##_split(ctx, node->left, k, l, &node->left);                                     \
+            *r = node;                                                                              \
+        }                                                                                           \
+                                                                                                    \
+        update(node);                                                                               \
+    }                                                                                               \
+                                                                                                    \
+    /* concatenates `l` and `r`, every node of `l` being ordered before every node of `r` */        \
+    static Node* prefix##_merge(Node* l, Node* r) {                                                 \
+        if (!l) return r;                                                                           \
+        if (!r) return l;                                                                           \
+                                                                                                    \
+        if (l->priority > r->priority) {                                                            \
+            l->right = prefix##_merge(l->right, r);                                                 \
+            update(l);                                                                              \
+            return l;                                                                               \
+        }                                                                                           \
+                                                                                                    \
+        r->left = prefix##_merge(l, r->left);                                                       \
+        update(r);                                                                                  \
+                                                                                                    \
+        return r;                                                                                   \
+    }                                                                                               \
+                                                                                                    \
+    /* links `fresh` (no children, priority already drawn) into the subtree of `node` */            \
+    static Node* prefix##_insert(Ctx ctx, Node* node, Node* fresh) {                                \
+        if (!node) return fresh;                                                                    \
+                                                                                                    \
+        /* `fresh` becomes the root of this subtree once it outranks it */                          \
+        if (fresh->priority > node->priority) {                                                     \
+            prefix##_split(ctx, node, key_of(fresh), &fresh->left, &fresh->right);                  \
+            update(fresh);                                                                          \
+            return fresh;                                                                           \
+        }                                                                                           \
+                                                                                                    \
+        if (cmp(ctx, node, key_of(fresh)) > 0) {                                                    \
+            node->left = prefix##_insert(ctx, node->left, fresh);                                   \
+        } else {                                                                                    \
+            node->right = prefix##_insert(ctx, node->right, fresh);                                 \
+        }                                                                                           \
+                                                                                                    \
+        update(node);                                                                               \
+                                                                                                    \
+        return node;                                                                                \
+    }
+
+#endif  // TREAP_CORE_H
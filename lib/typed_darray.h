@@ -0,0 +1,513 @@
+#ifndef TYPED_DARRAY_H
+#define TYPED_DARRAY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memstat.h"
+
+// Nomenclature used (to avoid collisions): <name>_<method_name>, where `name` is chosen by the user.
+// Warning: This implementation is not thread-safe, and is for educational purposes only.
+
+/**
+ * @brief Typed Dynamic Array Generator (header-only)
+ *
+ * `DEFINE_DARRAY(name, T)` emits a struct `name` and a family of
+ * `static inline` functions `name_*` mirroring lib/darray.h, specialized for
+ * the element type `T`. There is no `void*`, `element_size` or function
+ * pointer on the hot path, so element copies are plain assignments and the
+ * compiler can inline and vectorize freely.
+ *
+ * `DEFINE_DARRAY_CMP(name, T, cmp_fn)` (after `DEFINE_DARRAY`) adds the
+ * operations that need an ordering: find, contains, remove, binary search,
+ * sort and equality. `cmp_fn(T a, T b)` returns `<0`, `0` or `>0`; it may be
+ * a function or a function-like macro and is always called directly.
+ *
+ * @note Elements are copied by value (`=`): unlike `DArray` there is no
+ * `copier` / `deallocator`, so element-owned memory stays the caller's
+ * responsibility. Keep using `DArray` for heterogeneous or owning elements.
+ *
+ * @code
+ * DEFINE_DARRAY(IntArr, int)
+ * DEFINE_DARRAY_CMP(IntArr, int, int_cmp)
+ *
+ * IntArr* a = IntArr_new();
+ * IntArr_push(a, 42);
+ * IntArr_sort(a);
+ * IntArr_free(a);
+ * @endcode
+ */
+#define DEFINE_DARRAY(name, T)                                                                      \
+    typedef struct name {                                                                           \
+        T* arr;          /* Pointer to the heap-allocated elements. */                              \
+        size_t length;   /* Number of stored elements. */                                           \
+        size_t capacity; /* Number of elements `arr` can hold. */                                   \
+    } name;                                                                                         \
+                                                                                                    \
+    /* Inner Functions */                                                                           \
+                                                                                                    \
+    /* reallocates the storage to exactly `capacity` elements */                                    \
+    static inline bool __##name##_realloc(name* da, size_t capacity) {                              \
+        T* arr = (T*)realloc(da->arr, (capacity ? capacity : 1) * sizeof(T));                       \
+        if (!arr) return false;                                                                     \
+                                                                                                    \
+        ms_track(MS_DARRAY, 0, ((int64_t)capacity - (int64_t)da->capacity) * (int64_t)sizeof(T));   \
+                                                                                                    \
+        da->arr = arr;                                                                              \
+        da->capacity = capacity;                                                                    \
+                                                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    /* doubles the capacity when the array is full */                                               \
+    static inline bool __##name##_upsize(name* da) {                                                \
+        if (da->length < da->capacity) return true;                                                 \
+                                                                                                    \
+        return __##name##_realloc(da, da->capacity ? da->capacity * 2 : 4);                         \
+    }                                                                                               \
+                                                                                                    \
+    /* shrinks to fit once less than a fifth of the capacity is used (same policy as `DArray`) */   \
+    static inline void __##name##_downsize(name* da) {                                              \
+        if (da->length * 5 < da->capacity) __##name##_realloc(da, da->length);                      \
+    }                                                                                               \
+                                                                                                    \
+    /* Intialization */                                                                             \
+                                                                                                    \
+    static inline name* name##_new_with_capacity(size_t capacity) {                                 \
+        name* da = (name*)malloc(sizeof(name));                                                     \
+        if (!da) return NULL;                                                                       \
+                                                                                                    \
+        da->arr = (T*)malloc((capacity ? capacity : 1) * sizeof(T));                                \
+        if (!da->arr) {                                                                             \
+            free(da);                                                                               \
+            return NULL;                                                                            \
+        }                                                                                           \
+                                                                                                    \
+        da->length = 0;                                                                             \
+        da->capacity = capacity;                                                                    \
+                                                                                                    \
+        ms_track(MS_DARRAY, 1, (int64_t)(sizeof(name) + capacity * sizeof(T)));                     \
+                                                                                                    \
+        return da;                                                                                  \
+    }                                                                                               \
+                                                                                                    \
+    static inline name* name##_new(void) {                                                          \
+        return name##_new_with_capacity(4);                                                         \
+    }                                                                                               \
+                                                                                                    \
+    static inline name* name##_new_from_array(const T* arr, size_t length) {                        \
+        name* da = name##_new_with_capacity(length);                                                \
+        if (!da) return NULL;                                                                       \
+                                                                                                    \
+        if (length) memcpy(da->arr, arr, length * sizeof(T));                                       \
+        da->length = length;                                                                        \
+                                                                                                    \
+        return da;                                                                                  \
+    }                                                                                               \
+                                                                                                    \
+    static inline name* name##_copy(const name* da) {                                               \
+        if (!da) return NULL;                                                                       \
+                                                                                                    \
+        return name##_new_from_array(da->arr, da->length);                                          \
+    }                                                                                               \
+                                                                                                    \
+    /* Clean Up & Freeing */                                                                        \
+                                                                                                    \
+    static inline void name##_free(name* da) {                                                      \
+        if (!da) return;                                                                            \
+                                                                                                    \
+        ms_track(MS_DARRAY, -1, -(int64_t)(sizeof(name) + da->capacity * sizeof(T)));               \
+                                                                                                    \
+        free(da->arr);                                                                              \
+        free(da);                                                                                   \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_clear(name* da) {                                                     \
+        if (!da) return false;                                                                      \
+                                                                                                    \
+        da->length = 0;                                                                             \
+                                                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    /* Basic Getters */                                                                             \
+                                                                                                    \
+    static inline size_t name##_length(const name* da) {                                            \
+        return da ? da->length : 0;                                                                 \
+    }                                                                                               \
+                                                                                                    \
+    static inline size_t name##_capacity(const name* da) {                                          \
+        return da ? da->capacity : 0;                                                               \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_is_empty(const name* da) {                                            \
+        return !da || da->length == 0;                                                              \
+    }                                                                                               \
+                                                                                                    \
+    /* unchecked: `idx` must be below `capacity` */                                                 \
+    static inline T* name##_index(name* da, size_t idx) {                                           \
+        return da->arr + idx;                                                                       \
+    }                                                                                               \
+                                                                                                    \
+    static inline T* name##_raw(name* da) {                                                         \
+        return da ? da->arr : NULL;                                                                 \
+    }                                                                                               \
+                                                                                                    \
+    /* Advanced Getters */                                                                          \
+                                                                                                    \
+    static inline T* name##_get(name* da, size_t idx) {                                             \
+        if (!da || idx >= da->length) return NULL;                                                  \
+                                                                                                    \
+        return da->arr + idx;                                                                       \
+    }                                                                                               \
+                                                                                                    \
+    static inline T* name##_get_first(name* da) {                                                   \
+        return name##_get(da, 0);                                                                   \
+    }                                                                                               \
+                                                                                                    \
+    static inline T* name##_get_last(name* da) {                                                    \
+        return da && da->length ? da->arr + da->length - 1 : NULL;                                  \
+    }                                                                                               \
+                                                                                                    \
+    /* Setters */                                                                                   \
+                                                                                                    \
+    static inline bool name##_set(name* da, size_t idx, T e) {                                      \
+        if (!da || idx >= da->length) return false;                                                 \
+                                                                                                    \
+        da->arr[idx] = e;                                                                           \
+                                                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_swap(name* da, size_t i, size_t j) {                                  \
+        if (!da || i >= da->length || j >= da->length) return false;                                \
+                                                                                                    \
+        T tmp = da->arr[i];                                                                         \
+        da->arr[i] = da->arr[j];                                                                    \
+        da->arr[j] = tmp;                                                                           \
+                                                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    /* Insertion & Deletion */                                                                      \
+                                                                                                    \
+    static inline bool name##_push(name* da, T e) {                                                 \
+        if (!da || !__##name##_upsize(da)) return false;                                            \
+                                                                                                    \
+        da->arr[da->length++] = e;                                                                  \
+                                                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_insert_at(name* da, size_t idx, T e) {                                \
+        if (!da || idx > da->length || !__##name##_upsize(da)) return false;                        \
+                                                                                                    \
+        memmove(da->arr + idx + 1, da->arr + idx, (da->length - idx) * sizeof(T));                  \
+        da->arr[idx] = e;                                                                           \
+        da->length++;                                                                               \
+                                                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_push_front(name* da, T e) {                                           \
+        return name##_insert_at(da, 0, e);                                                          \
+    }                                                                                               \
+                                                                                                    \
+    /* `out` may be NULL */                                                                         \
+    static inline bool name##_pop(name* da, T* out) {                                               \
+        if (!da || da->length == 0) return false;                                                   \
+                                                                                                    \
+        da->length--;                                                                               \
+        if (out) *out = da->arr[da->length];                                                        \
+                                                                                                    \
+        __##name##_downsize(da);                                                                    \
+                                                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    /* `out` may be NULL */                                                                         \
+    static inline bool name##_remove_at_into(name* da, size_t idx, T* out) {                        \
+        if (!da || idx >= da->length) return false;                                                 \
+                                                                                                    \
+        if (out) *out = da->arr[idx];                                                               \
+                                                                                                    \
+        memmove(da->arr + idx, da->arr + idx + 1, (da->length - idx - 1) * sizeof(T));              \
+        da->length--;                                                                               \
+                                                                                                    \
+        __##name##_downsize(da);                                                                    \
+                                                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_remove_at(name* da, size_t idx) {                                     \
+        return name##_remove_at_into(da, idx, NULL);                                                \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_pop_front(name* da, T* out) {                                         \
+        return name##_remove_at_into(da, 0, out);                                                   \
+    }                                                                                               \
+                                                                                                    \
+    /* Resizing */                                                                                  \
+                                                                                                    \
+    static inline bool name##_truncate(name* da, size_t new_length) {                               \
+        if (!da) return false;                                                                      \
+                                                                                                    \
+        if (new_length < da->length) da->length = new_length;                                       \
+                                                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_resize(name* da, size_t capacity) {                                   \
+        if (!da) return false;                                                                      \
+        if (da->capacity == capacity) return true;                                                  \
+                                                                                                    \
+        if (!__##name##_realloc(da, capacity)) return false;                                        \
+        if (da->length > capacity) da->length = capacity;                                           \
+                                                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_reserve(name* da, size_t capacity) {                                  \
+        if (!da) return false;                                                                      \
+                                                                                                    \
+        return da->capacity >= capacity || name##_resize(da, capacity);                             \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_shrink(name* da) {                                                    \
+        if (!da) return false;                                                                      \
+                                                                                                    \
+        return name##_resize(da, da->length);                                                       \
+    }                                                                                               \
+                                                                                                    \
+    /* Concatanation */                                                                             \
+                                                                                                    \
+    static inline bool name##_extend(name* da, const T* arr, size_t length) {                       \
+        if (!da || !name##_reserve(da, da->length + length)) return false;                          \
+                                                                                                    \
+        if (length) memcpy(da->arr + da->length, arr, length * sizeof(T));                          \
+        da->length += length;                                                                       \
+                                                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    static inline name* name##_concat(const name* a, const name* b) {                               \
+        if (!a || !b) return NULL;                                                                  \
+                                                                                                    \
+        name* da = name##_new_with_capacity(a->length + b->length);                                 \
+        if (!da) return NULL;                                                                       \
+                                                                                                    \
+        name##_extend(da, a->arr, a->length);                                                       \
+        name##_extend(da, b->arr, b->length);                                                       \
+                                                                                                    \
+        return da;                                                                                  \
+    }                                                                                               \
+                                                                                                    \
+    /* Order Manipulation */                                                                        \
+                                                                                                    \
+    static inline void name##_reverse(name* da) {                                                   \
+        if (!da || da->length < 2) return;                                                          \
+                                                                                                    \
+        for (size_t i = 0, j = da->length - 1; i < j; i++, j--) {                                   \
+            T tmp = da->arr[i];                                                                     \
+            da->arr[i] = da->arr[j];                                                                \
+            da->arr[j] = tmp;                                                                       \
+        }                                                                                           \
+    }                                                                                               \
+                                                                                                    \
+    /* Functional Methods */                                                                        \
+                                                                                                    \
+    static inline name* name##_filter(const name* da, bool (*filter_fn)(const T* e)) {              \
+        if (!da || !filter_fn) return NULL;                                                         \
+                                                                                                    \
+        name* out = name##_new_with_capacity(da->length);                                           \
+        if (!out) return NULL;                                                                      \
+                                                                                                    \
+        for (size_t i = 0; i < da->length; i++) {                                                   \
+            if (filter_fn(&da->arr[i])) out->arr[out->length++] = da->arr[i];                       \
+        }                                                                                           \
+                                                                                                    \
+        return out;                                                                                 \
+    }                                                                                               \
+                                                                                                    \
+    /* Memory Accounting */                                                                         \
+                                                                                                    \
+    static inline MemUsage name##_memory_usage(const name* da) {                                    \
+        MemUsage mu = {0, 0, 0, 0, 0};                                                              \
+        if (!da) return mu;                                                                         \
+                                                                                                    \
+        const size_t storage = (da->capacity ? da->capacity : 1) * sizeof(T);                       \
+                                                                                                    \
+        mu.payload = da->length * sizeof(T);                                                        \
+        mu.slack = storage - mu.payload;                                                            \
+        mu.metadata = sizeof(name);                                                                 \
+        mu.overhead = (ms_usable_size(da, sizeof(name)) - sizeof(name)) +                           \
+                      (ms_usable_size(da->arr, storage) - storage);                                 \
+                                                                                                    \
+        return mu;                                                                                  \
+    }
+
+/// @brief Adds the ordering-dependent operations to a typed array defined with `DEFINE_DARRAY(name, T)`.
+/// @details Emits `name_find`, `name_contains`, `name_remove`, `name_binary_search`, `name_contains_bsearch`, `name_are_eq` and `name_sort` (an introsort that calls `cmp_fn` directly, so small comparators are inlined). Indices are `(size_t)-1` when not found, as in lib/darray.h.
+#define DEFINE_DARRAY_CMP(name, T, cmp_fn)                                                          \
+    /* Inner Functions */                                                                           \
+                                                                                                    \
+    static inline void __##name##_insertion_sort(T* arr, size_t n) {                                \
+        for (size_t i = 1; i < n; i++) {                                                            \
+            T key = arr[i];                                                                         \
+            size_t j = i;                                                                           \
+                                                                                                    \
+            while (j > 0 && cmp_fn(key, arr[j - 1]) < 0) {                                          \
+                arr[j] = arr[j - 1];                                                                \
+                j--;                                                                                \
+            }                                                                                       \
+                                                                                                    \
+            arr[j] = key;                                                                           \
+        }                                                                                           \
+    }                                                                                               \
+                                                                                                    \
+    static inline void __##name##_sift_down(T* arr, size_t root, size_t n) {                        \
+        T value = arr[root];                                                                        \
+                                                                                                    \
+        for (size_t child; (child = 2 * root + 1) < n; root = child) {                              \
+            if (child + 1 < n && cmp_fn(arr[child], arr[child + 1]) < 0) child++;                   \
+            if (cmp_fn(value, arr[child]) >= 0) break;                                              \
+                                                                                                    \
+            arr[root] = arr[child];                                                                 \
+        }                                                                                           \
+                                                                                                    \
+        arr[root] = value;                                                                          \
+    }                                                                                               \
+                                                                                                    \
+    static inline void __##name##_heap_sort(T* arr, size_t n) {                                     \
+        for (size_t i = n / 2; i-- > 0;) __##name##_sift_down(arr, i, n);                           \
+                                                                                                    \
+        for (size_t end = n; end-- > 1;) {                                                          \
+            T tmp = arr[0];                                                                         \
+            arr[0] = arr[end];                                                                      \
+            arr[end] = tmp;                                                                         \
+                                                                                                    \
+            __##name##_sift_down(arr, 0, end);                                                      \
+        }                                                                                           \
+    }                                                                                               \
+                                                                                                    \
+    /* quicksort with median-of-three pivots; heap sort once `depth` runs out */                    \
+    static inline void __##name##_intro_sort(T* arr, size_t n, unsigned depth) {                    \
+        while (n > 16) {                                                                            \
+            if (depth-- == 0) {                                                                     \
+                __##name##_heap_sort(arr, n);                                                       \
+                return;                                                                             \
+            }                                                                                       \
+                                                                                                    \
+            T* a = arr;                                                                             \
+            T* b = arr + n / 2;                                                                     \
+            T* c = arr + n - 1;                                                                     \
+                                                                                                    \
+            if (cmp_fn(*b, *a) < 0) { T t = *a; *a = *b; *b = t; }                                  \
+            if (cmp_fn(*c, *b) < 0) { T t = *b; *b = *c; *c = t; }                                  \
+            if (cmp_fn(*b, *a) < 0) { T t = *a; *a = *b; *b = t; }                                  \
+                                                                                                    \
+            T pivot = *b;                                                                           \
+            size_t i = 0, j = n - 1;                                                                \
+                                                                                                    \
+            for (;;) {                                                                              \
+                while (cmp_fn(arr[i], pivot) < 0) i++;                                              \
+                while (cmp_fn(pivot, arr[j]) < 0) j--;                                              \
+                if (i >= j) break;                                                                  \
+                                                                                                    \
+                T t = arr[i];                                                                       \
+                arr[i] = arr[j];                                                                    \
+                arr[j] = t;                                                                         \
+                i++;                                                                                \
+                j--;                                                                                \
+            }                                                                                       \
+                                                                                                    \
+            /* recurse into the smaller side, loop on the larger one */                             \
+            if (j + 1 < n - j - 1) {                                                                \
+                __##name##_intro_sort(arr, j + 1, depth);                                           \
+                arr += j + 1;                                                                       \
+                n -= j + 1;                                                                         \
+            } else {                                                                                \
+                __##name##_intro_sort(arr + j + 1, n - j - 1, depth);                               \
+                n = j + 1;                                                                          \
+            }                                                                                       \
+        }                                                                                           \
+                                                                                                    \
+        __##name##_insertion_sort(arr, n);                                                          \
+    }                                                                                               \
+                                                                                                    \
+    /* Searching */                                                                                 \
+                                                                                                    \
+    static inline size_t name##_find(const name* da, T target) {                                    \
+        if (!da) return (size_t)-1;                                                                 \
+                                                                                                    \
+        for (size_t i = 0; i < da->length; i++) {                                                   \
+            if (cmp_fn(da->arr[i], target) == 0) return i;                                          \
+        }                                                                                           \
+                                                                                                    \
+        return (size_t)-1;                                                                          \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_contains(const name* da, T target) {                                  \
+        return name##_find(da, target) != (size_t)-1;                                               \
+    }                                                                                               \
+                                                                                                    \
+    /* index of the first element equal to `target` in a sorted array, or (size_t)-1 */             \
+    static inline size_t name##_binary_search(const name* da, T target) {                           \
+        if (!da) return (size_t)-1;                                                                 \
+                                                                                                    \
+        size_t lo = 0, hi = da->length;                                                             \
+                                                                                                    \
+        while (lo < hi) {                                                                           \
+            size_t mid = lo + (hi - lo) / 2;                                                        \
+                                                                                                    \
+            if (cmp_fn(da->arr[mid], target) < 0) {                                                 \
+                lo = mid + 1;                                                                       \
+            } else {                                                                                \
+                hi = mid;                                                                           \
+            }                                                                                       \
+        }                                                                                           \
+                                                                                                    \
+        return lo < da->length && cmp_fn(da->arr[lo], target) == 0 ? lo : (size_t)-1;               \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_contains_bsearch(const name* da, T target) {                          \
+        return name##_binary_search(da, target) != (size_t)-1;                                      \
+    }                                                                                               \
+                                                                                                    \
+    /* Compare */                                                                                   \
+                                                                                                    \
+    static inline bool name##_are_eq(const name* a, const name* b) {                                \
+        if (!a || !b || a->length != b->length) return false;                                       \
+                                                                                                    \
+        for (size_t i = 0; i < a->length; i++) {                                                    \
+            if (cmp_fn(a->arr[i], b->arr[i]) != 0) return false;                                    \
+        }                                                                                           \
+                                                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    /* Insertion & Deletion */                                                                      \
+                                                                                                    \
+    static inline size_t name##_remove(name* da, T target) {                                        \
+        size_t idx = name##_find(da, target);                                                       \
+                                                                                                    \
+        if (idx != (size_t)-1) name##_remove_at(da, idx);                                           \
+                                                                                                    \
+        return idx;                                                                                 \
+    }                                                                                               \
+                                                                                                    \
+    /* Sorting */                                                                                   \
+                                                                                                    \
+    static inline void name##_sort(name* da) {                                                      \
+        if (!da || da->length < 2) return;                                                          \
+                                                                                                    \
+        unsigned depth = 0;                                                                         \
+        for (size_t n = da->length; n > 1; n >>= 1) depth += 2;                                     \
+                                                                                                    \
+        __##name##_intro_sort(da->arr, da->length, depth);                                          \
+    }
+
+#endif  // TYPED_DARRAY_H
@@ -0,0 +1,476 @@
+#ifndef TYPED_HASHSET_H
+#define TYPED_HASHSET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memstat.h"
+#include "random.h"
+
+// Nomenclature used (to avoid collisions): <name>_<method_name>, where `name` is chosen by the user.
+// Warning: This implementation is not thread-safe, and is for educational purposes only.
+
+/**
+ * @brief Typed Hash Set Generator (header-only)
+ *
+ * `DEFINE_HSET(name, K, hash_fn, eq_fn)` emits a struct `name` and a family
+ * of `static inline` functions `name_*` mirroring lib/hashset.h, specialized
+ * for the key type `K`:
+ *
+ * - `uint64_t hash_fn(K k, uint64_t seed_0, uint64_t seed_1)` hashes a key
+ *   (same seeding contract as `HSet`'s `hasher`);
+ * - `bool eq_fn(K a, K b)` tests two keys for equality.
+ *
+ * Both may be functions or function-like macros and are called directly, so
+ * they inline. Unlike `HSet` (separate chaining, one node and one key
+ * allocation per element), keys are stored inline in a single open-addressing
+ * table with linear probing and backward-shift deletion; the full hash of
+ * every slot is kept next to it so probes and rehashing never call `hash_fn`
+ * twice for the same key.
+ *
+ * @note Keys are copied by value (`=`): there is no `copier` / `deallocator`.
+ * Keep using `HSet` for heterogeneous or owning keys.
+ *
+ * @code
+ * DEFINE_HSET(IntSet, int, int_hash, int_eq)
+ *
+ * IntSet* s = IntSet_new();
+ * IntSet_insert(s, 42);
+ * for (size_t it = 0; (k = IntSet_next(s, &it));) ...
+ * IntSet_free(s);
+ * @endcode
+ */
+#define DEFINE_HSET(name, K, hash_fn, eq_fn)                                                        \
+    typedef struct name {                                                                           \
+        K* keys;          /* Slot keys (valid where `hashes[i] != 0`). */                           \
+        uint64_t* hashes; /* Slot hashes, `0` marks an empty slot. */                               \
+        size_t count;     /* Number of stored keys. */                                              \
+        size_t capacity;  /* Number of slots, always a power of two. */                             \
+                                                                                                    \
+        uint64_t seed_0; /* Hash seeds, random per set. */                                          \
+        uint64_t seed_1;                                                                            \
+    } name;                                                                                         \
+                                                                                                    \
+    /* Inner Functions */                                                                           \
+                                                                                                    \
+    /* hash of `k`, never 0 (0 marks empty slots) */                                                \
+    static inline uint64_t __##name##_hash(const name* hs, K k) {                                   \
+        uint64_t h = hash_fn(k, hs->seed_0, hs->seed_1);                                            \
+        return h ? h : 1;                                                                           \
+    }                                                                                               \
+                                                                                                    \
+    /* heap bytes requested by a set of `capacity` slots (for the memstat registry) */              \
+    static inline int64_t __##name##_bytes(size_t capacity) {                                       \
+        return (int64_t)(sizeof(name) + capacity * (sizeof(K) + sizeof(uint64_t)));                 \
+    }                                                                                               \
+                                                                                                    \
+    /* slot holding `k`, or the empty slot where it would go */                                     \
+    static inline size_t __##name##_probe(const name* hs, K k, uint64_t h) {                        \
+        const size_t mask = hs->capacity - 1;                                                       \
+        size_t i = (size_t)h & mask;                                                                \
+                                                                                                    \
+        while (hs->hashes[i] && !(hs->hashes[i] == h && eq_fn(hs->keys[i], k))) i = (i + 1) & mask; \
+                                                                                                    \
+        return i;                                                                                   \
+    }                                                                                               \
+                                                                                                    \
+    /* allocates an empty table of `capacity` slots (a power of two) */                             \
+    static inline bool __##name##_alloc_table(name* hs, size_t capacity) {                          \
+        hs->keys = (K*)malloc(capacity * sizeof(K));                                                \
+        hs->hashes = (uint64_t*)calloc(capacity, sizeof(uint64_t));                                 \
+                                                                                                    \
+        if (!hs->keys || !hs->hashes) {                                                             \
+            free(hs->keys);                                                                         \
+            free(hs->hashes);                                                                       \
+            return false;                                                                           \
+        }                                                                                           \
+                                                                                                    \
+        hs->capacity = capacity;                                                                    \
+                                                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    /* moves every key into a new table of `capacity` slots, reusing the stored hashes */           \
+    static inline bool __##name##_rehash(name* hs, size_t capacity) {                               \
+        K* old_keys = hs->keys;                                                                     \
+        uint64_t* old_hashes = hs->hashes;                                                          \
+        const size_t old_capacity = hs->capacity;                                                   \
+                                                                                                    \
+        if (!__##name##_alloc_table(hs, capacity)) {                                                \
+            hs->keys = old_keys;                                                                    \
+            hs->hashes = old_hashes;                                                                \
+            return false;                                                                           \
+        }                                                                                           \
+                                                                                                    \
+        const size_t mask = capacity - 1;                                                           \
+                                                                                                    \
+        for (size_t j = 0; j < old_capacity; j++) {                                                 \
+            if (!old_hashes[j]) continue;                                                           \
+                                                                                                    \
+            size_t i = (size_t)old_hashes[j] & mask;                                                \
+            while (hs->hashes[i]) i = (i + 1) & mask;                                               \
+                                                                                                    \
+            hs->keys[i] = old_keys[j];                                                              \
+            hs->hashes[i] = old_hashes[j];                                                          \
+        }                                                                                           \
+                                                                                                    \
+        ms_track(MS_HSET, 0, __##name##_bytes(capacity) - __##name##_bytes(old_capacity));          \
+                                                                                                    \
+        free(old_keys);                                                                             \
+        free(old_hashes);                                                                           \
+                                                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    /* smallest power of two holding `count` keys under the 0.75 load factor */                     \
+    static inline size_t __##name##_capacity_for(size_t count) {                                    \
+        size_t capacity = 4;                                                                        \
+        while (capacity - capacity / 4 < count) capacity *= 2;                                      \
+        return capacity;                                                                            \
+    }                                                                                               \
+                                                                                                    \
+    /* Intialization */                                                                             \
+                                                                                                    \
+    static inline name* name##_new_with_capacity(size_t capacity) {                                 \
+        name* hs = (name*)malloc(sizeof(name));                                                     \
+        if (!hs) return NULL;                                                                       \
+                                                                                                    \
+        if (!__##name##_alloc_table(hs, __##name##_capacity_for(capacity))) {                       \
+            free(hs);                                                                               \
+            return NULL;                                                                            \
+        }                                                                                           \
+                                                                                                    \
+        hs->count = 0;                                                                              \
+        hs->seed_0 = __random_u64();                                                                \
+        hs->seed_1 = __random_u64();                                                                \
+                                                                                                    \
+        ms_track(MS_HSET, 1, __##name##_bytes(hs->capacity));                                       \
+                                                                                                    \
+        return hs;                                                                                  \
+    }                                                                                               \
+                                                                                                    \
+    static inline name* name##_new(void) {                                                          \
+        return name##_new_with_capacity(4);                                                         \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_insert(name* hs, K k);                                                \
+    static inline bool name##_contains(const name* hs, K k);                                        \
+    static inline void name##_free(name* hs);                                                       \
+                                                                                                    \
+    static inline name* name##_new_from_array(const K* arr, size_t length) {                        \
+        name* hs = name##_new_with_capacity(length);                                                \
+        if (!hs) return NULL;                                                                       \
+                                                                                                    \
+        for (size_t i = 0; i < length; i++) {                                                       \
+            /* `insert` also fails on duplicates, which are fine here */                            \
+            if (!name##_insert(hs, arr[i]) && !name##_contains(hs, arr[i])) {                       \
+                name##_free(hs);                                                                    \
+                return NULL;                                                                        \
+            }                                                                                       \
+        }                                                                                           \
+                                                                                                    \
+        return hs;                                                                                  \
+    }                                                                                               \
+                                                                                                    \
+    /* Clean Up & Freeing */                                                                        \
+                                                                                                    \
+    static inline void name##_free(name* hs) {                                                      \
+        if (!hs) return;                                                                            \
+                                                                                                    \
+        ms_track(MS_HSET, -1, -__##name##_bytes(hs->capacity));                                     \
+                                                                                                    \
+        free(hs->keys);                                                                             \
+        free(hs->hashes);                                                                           \
+        free(hs);                                                                                   \
+    }                                                                                               \
+                                                                                                    \
+    static inline void name##_clear(name* hs) {                                                     \
+        if (!hs) return;                                                                            \
+                                                                                                    \
+        memset(hs->hashes, 0, hs->capacity * sizeof(uint64_t));                                     \
+        hs->count = 0;                                                                              \
+    }                                                                                               \
+                                                                                                    \
+    /* Basic Getters */                                                                             \
+                                                                                                    \
+    static inline size_t name##_count(const name* hs) {                                             \
+        return hs ? hs->count : 0;                                                                  \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_is_empty(const name* hs) {                                            \
+        return !hs || hs->count == 0;                                                               \
+    }                                                                                               \
+                                                                                                    \
+    /* Copiers */                                                                                   \
+                                                                                                    \
+    static inline name* name##_copy(const name* hs) {                                               \
+        if (!hs) return NULL;                                                                       \
+                                                                                                    \
+        name* copy = (name*)malloc(sizeof(name));                                                   \
+        if (!copy) return NULL;                                                                     \
+                                                                                                    \
+        if (!__##name##_alloc_table(copy, hs->capacity)) {                                          \
+            free(copy);                                                                             \
+            return NULL;                                                                            \
+        }                                                                                           \
+                                                                                                    \
+        /* Same seeds and capacity: the table can be copied verbatim. */                            \
+        memcpy(copy->keys, hs->keys, hs->capacity * sizeof(K));                                     \
+        memcpy(copy->hashes, hs->hashes, hs->capacity * sizeof(uint64_t));                          \
+                                                                                                    \
+        copy->count = hs->count;                                                                    \
+        copy->seed_0 = hs->seed_0;                                                                  \
+        copy->seed_1 = hs->seed_1;                                                                  \
+                                                                                                    \
+        ms_track(MS_HSET, 1, __##name##_bytes(copy->capacity));                                     \
+                                                                                                    \
+        return copy;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    /* Resize */                                                                                    \
+                                                                                                    \
+    static inline bool name##_resize(name* hs, size_t new_capacity) {                               \
+        if (!hs) return false;                                                                      \
+                                                                                                    \
+        size_t capacity = __##name##_capacity_for(new_capacity);                                    \
+        if (capacity <= hs->capacity) return true;                                                  \
+                                                                                                    \
+        return __##name##_rehash(hs, capacity);                                                     \
+    }                                                                                               \
+                                                                                                    \
+    /* Insertion, Deletion & Searching */                                                           \
+                                                                                                    \
+    static inline bool name##_insert(name* hs, K k) {                                               \
+        if (!hs) return false;                                                                      \
+                                                                                                    \
+        const uint64_t h = __##name##_hash(hs, k);                                                  \
+        size_t i = __##name##_probe(hs, k, h);                                                      \
+                                                                                                    \
+        /* A duplicate never grows the table, so `false` after a hit is not an allocation failure */\
+        if (hs->hashes[i]) return false;                                                            \
+                                                                                                    \
+        if (hs->count + 1 > hs->capacity - hs->capacity / 4) {                                      \
+            if (!__##name##_rehash(hs, hs->capacity * 2)) return false;                             \
+            i = __##name##_probe(hs, k, h);                                                         \
+        }                                                                                           \
+                                                                                                    \
+        hs->keys[i] = k;                                                                            \
+        hs->hashes[i] = h;                                                                          \
+        hs->count++;                                                                                \
+                                                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_contains(const name* hs, K k) {                                       \
+        if (!hs) return false;                                                                      \
+                                                                                                    \
+        return hs->hashes[__##name##_probe(hs, k, __##name##_hash(hs, k))] != 0;                    \
+    }                                                                                               \
+                                                                                                    \
+    /* pointer to the stored key equal to `k`, or NULL (valid until the next insert/remove) */      \
+    static inline K* name##_get(name* hs, K k) {                                                    \
+        if (!hs) return NULL;                                                                       \
+                                                                                                    \
+        size_t i = __##name##_probe(hs, k, __##name##_hash(hs, k));                                 \
+                                                                                                    \
+        return hs->hashes[i] ? &hs->keys[i] : NULL;                                                 \
+    }                                                                                               \
+                                                                                                    \
+    /* removes slot `i` and shifts the rest of its probe run back (no tombstones) */                \
+    static inline void __##name##_erase_slot(name* hs, size_t i) {                                  \
+        const size_t mask = hs->capacity - 1;                                                       \
+                                                                                                    \
+        for (size_t j = (i + 1) & mask; hs->hashes[j]; j = (j + 1) & mask) {                        \
+            size_t home = (size_t)hs->hashes[j] & mask;                                             \
+                                                                                                    \
+            /* `j` may move into the hole at `i` only if its home is not in (i, j] */               \
+            if (((j - home) & mask) >= ((j - i) & mask)) {                                          \
+                hs->keys[i] = hs->keys[j];                                                          \
+                hs->hashes[i] = hs->hashes[j];                                                      \
+                i = j;                                                                              \
+            }                                                                                       \
+        }                                                                                           \
+                                                                                                    \
+        hs->hashes[i] = 0;                                                                          \
+        hs->count--;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_remove(name* hs, K k) {                                               \
+        if (!hs) return false;                                                                      \
+                                                                                                    \
+        size_t i = __##name##_probe(hs, k, __##name##_hash(hs, k));                                 \
+        if (!hs->hashes[i]) return false;                                                           \
+                                                                                                    \
+        __##name##_erase_slot(hs, i);                                                               \
+                                                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    static inline void name##_retain(name* hs, bool (*predicate)(const K* k)) {                     \
+        if (!hs || !predicate) return;                                                              \
+                                                                                                    \
+        /* Walk backwards from just below an empty slot: a backward shift only pulls in keys */     \
+        /* from later in the same probe run, which this order has already visited. */               \
+        const size_t mask = hs->capacity - 1;                                                       \
+        size_t empty = 0;                                                                           \
+        while (hs->hashes[empty]) empty++;                                                          \
+                                                                                                    \
+        for (size_t n = 1; n < hs->capacity; n++) {                                                 \
+            size_t i = (empty - n) & mask;                                                          \
+            while (hs->hashes[i] && !predicate(&hs->keys[i])) __##name##_erase_slot(hs, i);         \
+        }                                                                                           \
+    }                                                                                               \
+                                                                                                    \
+    /* Iterator: `for (size_t it = 0; (k = name_next(hs, &it));)` */                                \
+                                                                                                    \
+    static inline K* name##_next(name* hs, size_t* it) {                                            \
+        if (!hs || !it) return NULL;                                                                \
+                                                                                                    \
+        while (*it < hs->capacity) {                                                                \
+            size_t i = (*it)++;                                                                     \
+            if (hs->hashes[i]) return &hs->keys[i];                                                 \
+        }                                                                                           \
+                                                                                                    \
+        return NULL;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    /* Advanced Getters */                                                                          \
+                                                                                                    \
+    /* heap-allocated array of the `count` keys (caller frees), or NULL */                          \
+    static inline K* name##_extract(const name* hs) {                                               \
+        if (!hs) return NULL;                                                                       \
+                                                                                                    \
+        K* arr = (K*)malloc((hs->count ? hs->count : 1) * sizeof(K));                               \
+        if (!arr) return NULL;                                                                      \
+                                                                                                    \
+        for (size_t i = 0, n = 0; i < hs->capacity; i++) {                                          \
+            if (hs->hashes[i]) arr[n++] = hs->keys[i];                                              \
+        }                                                                                           \
+                                                                                                    \
+        return arr;                                                                                 \
+    }                                                                                               \
+                                                                                                    \
+    /* Comparators */                                                                               \
+                                                                                                    \
+    static inline bool name##_is_subset(const name* a, const name* b) {                             \
+        if (!a || !b || a->count > b->count) return false;                                          \
+                                                                                                    \
+        for (size_t i = 0; i < a->capacity; i++) {                                                  \
+            if (a->hashes[i] && !name##_contains(b, a->keys[i])) return false;                      \
+        }                                                                                           \
+                                                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_is_supset(const name* a, const name* b) {                             \
+        return name##_is_subset(b, a);                                                              \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_are_eq(const name* a, const name* b) {                                \
+        return a && b && a->count == b->count && name##_is_subset(a, b);                            \
+    }                                                                                               \
+                                                                                                    \
+    static inline bool name##_are_disjoint(const name* a, const name* b) {                          \
+        if (!a || !b) return false;                                                                 \
+        if (a->count > b->count) return name##_are_disjoint(b, a);                                  \
+                                                                                                    \
+        for (size_t i = 0; i < a->capacity; i++) {                                                  \
+            if (a->hashes[i] && name##_contains(b, a->keys[i])) return false;                       \
+        }                                                                                           \
+                                                                                                    \
+        return true;                                                                                \
+    }                                                                                               \
+                                                                                                    \
+    /* Algebric Operations */                                                                       \
+                                                                                                    \
+    /* keys of `a` whose presence in `b` equals `keep_if_in_b` */                                   \
+    static inline name* __##name##_select(const name* a, const name* b, bool keep_if_in_b) {        \
+        name* out = name##_new_with_capacity(a->count);                                             \
+        if (!out) return NULL;                                                                      \
+                                                                                                    \
+        for (size_t i = 0; i < a->capacity; i++) {                                                  \
+            if (a->hashes[i] && name##_contains(b, a->keys[i]) == keep_if_in_b) {                   \
+                name##_insert(out, a->keys[i]);                                                     \
+            }                                                                                       \
+        }                                                                                           \
+                                                                                                    \
+        return out;                                                                                 \
+    }                                                                                               \
+                                                                                                    \
+    static inline name* name##_union(const name* a, const name* b) {                                \
+        if (!a || !b) return NULL;                                                                  \
+                                                                                                    \
+        name* out = name##_copy(a->count >= b->count ? a : b);                                      \
+        const name* other = a->count >= b->count ? b : a;                                           \
+        if (!out) return NULL;                                                                      \
+                                                                                                    \
+        for (size_t i = 0; i < other->capacity; i++) {                                              \
+            if (other->hashes[i]) name##_insert(out, other->keys[i]);                               \
+        }                                                                                           \
+                                                                                                    \
+        return out;                                                                                 \
+    }                                                                                               \
+                                                                                                    \
+    static inline name* name##_intersection(const name* a, const name* b) {                         \
+        if (!a || !b) return NULL;                                                                  \
+                                                                                                    \
+        if (a->count > b->count) return __##name##_select(b, a, true);                              \
+                                                                                                    \
+        return __##name##_select(a, b, true);                                                       \
+    }                                                                                               \
+                                                                                                    \
+    static inline name* name##_difference(const name* a, const name* b) {                           \
+        if (!a || !b) return NULL;                                                                  \
+                                                                                                    \
+        return __##name##_select(a, b, false);                                                      \
+    }                                                                                               \
+                                                                                                    \
+    static inline name* name##_sym_difference(const name* a, const name* b) {                       \
+        if (!a || !b) return NULL;                                                                  \
+                                                                                                    \
+        name* out = __##name##_select(a, b, false);                                                 \
+        if (!out) return NULL;                                                                      \
+                                                                                                    \
+        for (size_t i = 0; i < b->capacity; i++) {                                                  \
+            if (b->hashes[i] && !name##_contains(a, b->keys[i])) name##_insert(out, b->keys[i]);    \
+        }                                                                                           \
+                                                                                                    \
+        return out;                                                                                 \
+    }                                                                                               \
+                                                                                                    \
+    static inline name* name##_filter(const name* hs, bool (*predicate)(const K* k)) {              \
+        if (!hs || !predicate) return NULL;                                                         \
+                                                                                                    \
+        name* out = name##_new_with_capacity(hs->count);                                            \
+        if (!out) return NULL;                                                                      \
+                                                                                                    \
+        for (size_t i = 0; i < hs->capacity; i++) {                                                 \
+            if (hs->hashes[i] && predicate(&hs->keys[i])) name##_insert(out, hs->keys[i]);          \
+        }                                                                                           \
+                                                                                                    \
+        return out;                                                                                 \
+    }                                                                                               \
+                                                                                                    \
+    /* Memory Accounting */                                                                         \
+                                                                                                    \
+    static inline MemUsage name##_memory_usage(const name* hs) {                                    \
+        MemUsage mu = {0, 0, 0, 0, 0};                                                              \
+        if (!hs) return mu;                                                                         \
+                                                                                                    \
+        const size_t key_bytes = hs->capacity * sizeof(K);                                          \
+        const size_t hash_bytes = hs->capacity * sizeof(uint64_t);                                  \
+                                                                                                    \
+        mu.payload = hs->count * sizeof(K);                                                         \
+        mu.slack = key_bytes - mu.payload;                                                          \
+        mu.metadata = sizeof(name) + hash_bytes;                                                    \
+        mu.overhead = (ms_usable_size(hs, sizeof(name)) - sizeof(name)) +                           \
+                      (ms_usable_size(hs->keys, key_bytes) - key_bytes) +                           \
+                      (ms_usable_size(hs->hashes, hash_bytes) - hash_bytes);                        \
+                                                                                                    \
+        return mu;                                                                                  \
+    }
+
+#endif  // TYPED_HASHSET_H
@@ -0,0 +1,554 @@
+#include "ulist.h"
+
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Offset of the elements inside a node: the header rounded up to the strictest fundamental alignment.
+#define __UL_DATA_OFFSET ((sizeof(ULNode) + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1))
+
+/// Nodes are multiples of (and aligned to) a cache line.
+#define __UL_CACHE_LINE 64
+
+/******************************************************************************
+ *                                                                            *
+ *                              Inner Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+inline static size_t __ul_node_bytes(const ULList* ul);
+inline static char* __ul_elem(const ULList* ul, const ULNode* node, size_t i);
+inline static ULNode* __ul_new_node(ULList* ul);
+inline static void __ul_free_node(ULList* ul, ULNode* node);
+// links `node` right after `pos` (at the head if `pos` is NULL)
+inline static void __ul_link_after(ULList* ul, ULNode* pos, ULNode* node);
+inline static void __ul_unlink(ULList* ul, ULNode* node);
+// finds the node holding index `idx < length`, and the offset of `idx` within it
+inline static ULNode* __ul_locate(const ULList* ul, size_t idx, size_t* offset);
+// opens a gap at `offset` in a non-full node and copies `e` into it
+inline static void __ul_insert_in_node(ULList* ul, ULNode* node, size_t offset, const void* e);
+// moves the element at `offset` out of `node` (into `out`, or deallocates it), and closes the gap
+inline static void __ul_take_from_node(ULList* ul, ULNode* node, size_t offset, void* out);
+// moves the upper half of a full node into a new node linked after it, returns the new node
+static ULNode* __ul_split(ULList* ul, ULNode* node);
+// restores the fill factor of an interior `node` with its successor; returns true if the successor was merged (and freed)
+static bool __ul_rebalance(ULList* ul, ULNode* node);
+// returns every node to the pool, without deallocating the elements
+static void __ul_release_nodes(ULList* ul);
+static ULList* __ul_new_with_pool(size_t element_size, size_t node_capacity, Pool* pool);
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+ULList* ul_new(size_t element_size) {
+    return ul_new_with_node_size(element_size, UL_DEFAULT_NODE_BYTES);
+}
+
+ULList* ul_new_with_node_size(size_t element_size, size_t node_bytes) {
+    if (element_size == 0) return NULL;
+
+    if (node_bytes < __UL_DATA_OFFSET + 2 * element_size) node_bytes = __UL_DATA_OFFSET + 2 * element_size;
+    node_bytes = (node_bytes + __UL_CACHE_LINE - 1) & ~(size_t)(__UL_CACHE_LINE - 1);
+
+    Pool* pool = pool_new(node_bytes, __UL_CACHE_LINE, UL_NODES_PER_SLAB);
+    if (!pool) return NULL;
+
+    ULList* ul = __ul_new_with_pool(element_size, (node_bytes - __UL_DATA_OFFSET) / element_size, pool);
+    if (!ul) pool_release(pool);
+
+    return ul;
+}
+
+ULList* ul_new_sharing_pool(const ULList* other) {
+    if (!other) return NULL;
+
+    ULList* ul = __ul_new_with_pool(other->element_size, other->node_capacity, pool_retain(other->pool));
+    if (!ul) pool_release(other->pool);
+
+    if (ul) ul->deallocator = other->deallocator;
+
+    return ul;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                             Clean Up & Freeing                             *
+ *                                                                            *
+ ******************************************************************************/
+
+void ul_free(ULList* ul) {
+    if (!ul) return;
+
+    ul_clear(ul);
+    pool_release(ul->pool);
+
+    ms_track(MS_ULIST, -1, -(int64_t)sizeof(ULList));
+
+    free(ul);
+}
+
+void ul_clear(ULList* ul) {
+    if (!ul) return;
+
+    if (ul->deallocator) {
+        for (ULNode* node = ul->head; node; node = node->next) {
+            for (size_t i = 0; i < node->count; i++) ul->deallocator(__ul_elem(ul, node, i));
+        }
+    }
+
+    __ul_release_nodes(ul);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Basic Getters                                *
+ *                                                                            *
+ ******************************************************************************/
+
+size_t ul_length(const ULList* ul) {
+    return ul ? ul->length : 0;
+}
+
+bool ul_is_empty(const ULList* ul) {
+    return !ul || ul->length == 0;
+}
+
+void* ul_get(const ULList* ul, size_t idx) {
+    if (!ul || idx >= ul->length) return NULL;
+
+    size_t offset;
+    ULNode* node = __ul_locate(ul, idx, &offset);
+
+    return __ul_elem(ul, node, offset);
+}
+
+void* ul_get_first(const ULList* ul) {
+    if (ul_is_empty(ul)) return NULL;
+
+    return __ul_elem(ul, ul->head, 0);
+}
+
+void* ul_get_last(const ULList* ul) {
+    if (ul_is_empty(ul)) return NULL;
+
+    return __ul_elem(ul, ul->tail, ul->tail->count - 1);
+}
+
+bool ul_set(ULList* ul, size_t idx, const void* e) {
+    void* dest = ul_get(ul, idx);
+    if (!dest || !e) return false;
+
+    if (ul->deallocator) ul->deallocator(dest);
+    memcpy(dest, e, ul->element_size);
+
+    return true;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                            Insertion & Removal                             *
+ *                                                                            *
+ ******************************************************************************/
+
+bool ul_push_back(ULList* ul, const void* e) {
+    if (!ul || !e) return false;
+
+    ULNode* node = ul->tail;
+
+    // A full tail gets a fresh successor rather than a split, so appends leave full nodes behind
+    if (!node || node->count == ul->node_capacity) {
+        node = __ul_new_node(ul);
+        if (!node) return false;
+
+        __ul_link_after(ul, ul->tail, node);
+    }
+
+    __ul_insert_in_node(ul, node, node->count, e);
+
+    return true;
+}
+
+bool ul_push_front(ULList* ul, const void* e) {
+    if (!ul || !e) return false;
+
+    ULNode* node = ul->head;
+
+    if (!node || node->count == ul->node_capacity) {
+        node = __ul_new_node(ul);
+        if (!node) return false;
+
+        __ul_link_after(ul, NULL, node);
+    }
+
+    __ul_insert_in_node(ul, node, 0, e);
+
+    return true;
+}
+
+bool ul_insert_at(ULList* ul, size_t idx, const void* e) {
+    if (!ul || !e || idx > ul->length) return false;
+
+    if (idx == ul->length) return ul_push_back(ul, e);
+    if (idx == 0) return ul_push_front(ul, e);
+
+    size_t offset;
+    ULNode* node = __ul_locate(ul, idx, &offset);
+
+    if (node->count == ul->node_capacity) {
+        ULNode* right = __ul_split(ul, node);
+        if (!right) return false;
+
+        if (offset > node->count) {
+            offset -= node->count;
+            node = right;
+        }
+    }
+
+    __ul_insert_in_node(ul, node, offset, e);
+
+    return true;
+}
+
+bool ul_pop_back(ULList* ul, void* out) {
+    if (ul_is_empty(ul)) return false;
+
+    __ul_take_from_node(ul, ul->tail, ul->tail->count - 1, out);
+
+    return true;
+}
+
+bool ul_pop_front(ULList* ul, void* out) {
+    if (ul_is_empty(ul)) return false;
+
+    __ul_take_from_node(ul, ul->head, 0, out);
+
+    return true;
+}
+
+bool ul_remove_at(ULList* ul, size_t idx, void* out) {
+    if (!ul || idx >= ul->length) return false;
+
+    size_t offset;
+    ULNode* node = __ul_locate(ul, idx, &offset);
+
+    bool emptied = node->count == 1;
+    __ul_take_from_node(ul, node, offset, out);
+
+    if (!emptied) __ul_rebalance(ul, node);
+
+    return true;
+}
+
+bool ul_splice_back(ULList* dest, ULList* src) {
+    if (!dest || !src || dest->element_size != src->element_size) return false;
+    if (dest == src || src->length == 0) return true;
+
+    if (dest->pool != src->pool) {
+        // Different allocators: the nodes cannot change hands, so copy the elements over
+        ULIterator it;
+        ul_iter_init(&it, src);
+
+        size_t pushed = 0;
+        for (void* e; (e = ul_iter_next(&it)); pushed++) {
+            if (!ul_push_back(dest, e)) {
+                // Roll back without deallocating: `src` still owns the elements
+                void (*deallocator)(void* k) = dest->deallocator;
+                dest->deallocator = NULL;
+
+                while (pushed--) ul_pop_back(dest, NULL);
+
+                dest->deallocator = deallocator;
+                return false;
+            }
+        }
+
+        __ul_release_nodes(src);
+
+        return true;
+    }
+
+    ULNode* seam_left = dest->tail;
+    ULNode* seam_right = src->head;
+
+    if (seam_left) {
+        seam_left->next = seam_right;
+        seam_right->prev = seam_left;
+    } else {
+        dest->head = seam_right;
+    }
+
+    dest->tail = src->tail;
+    dest->length += src->length;
+    dest->node_count += src->node_count;
+
+    src->head = src->tail = NULL;
+    src->length = src->node_count = 0;
+
+    // Only the two nodes meeting at the seam may now be under-filled interior nodes
+    if (!seam_left || !__ul_rebalance(dest, seam_left)) __ul_rebalance(dest, seam_right);
+
+    return true;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Iteration                                  *
+ *                                                                            *
+ ******************************************************************************/
+
+void ul_iter_init(ULIterator* it, const ULList* ul) {
+    if (!it) return;
+
+    it->node = ul ? ul->head : NULL;
+    it->offset = 0;
+    it->element_size = ul ? ul->element_size : 0;
+}
+
+void* ul_iter_next(ULIterator* it) {
+    if (!it) return NULL;
+
+    while (it->node && it->offset >= it->node->count) {
+        it->node = it->node->next;
+        it->offset = 0;
+    }
+
+    if (!it->node) return NULL;
+
+    return (char*)it->node + __UL_DATA_OFFSET + it->element_size * it->offset++;
+}
+
+void* ul_iter_next_block(ULIterator* it, size_t* count) {
+    if (!it || !count) return NULL;
+
+    while (it->node && it->offset >= it->node->count) {
+        it->node = it->node->next;
+        it->offset = 0;
+    }
+
+    if (!it->node) {
+        *count = 0;
+        return NULL;
+    }
+
+    void* block = (char*)it->node + __UL_DATA_OFFSET + it->element_size * it->offset;
+
+    *count = it->node->count - it->offset;
+    it->offset = it->node->count;
+
+    return block;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                             Memory Accounting                              *
+ *                                                                            *
+ ******************************************************************************/
+
+MemUsage ul_memory_usage(const ULList* ul, size_t (*owned_size)(const void* k)) {
+    MemUsage mu = {0, 0, 0, 0, 0};
+    if (!ul) return mu;
+
+    const size_t slots = ul->node_count * ul->node_capacity * ul->element_size;
+
+    mu.payload = ul->length * ul->element_size;
+    mu.slack = slots - mu.payload;
+    mu.metadata = sizeof(ULList) + ul->node_count * __ul_node_bytes(ul) - slots;
+    mu.overhead = ms_usable_size(ul, sizeof(ULList)) - sizeof(ULList);
+
+    if (owned_size) {
+        for (ULNode* node = ul->head; node; node = node->next) {
+            for (size_t i = 0; i < node->count; i++) mu.owned += owned_size(__ul_elem(ul, node, i));
+        }
+    }
+
+    return mu;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                       Inner Functions Implementation                       *
+ *                                                                            *
+ ******************************************************************************/
+
+inline static size_t __ul_node_bytes(const ULList* ul) {
+    return ul->pool->block_size;
+}
+
+inline static char* __ul_elem(const ULList* ul, const ULNode* node, size_t i) {
+    return (char*)node + __UL_DATA_OFFSET + ul->element_size * i;
+}
+
+inline static ULNode* __ul_new_node(ULList* ul) {
+    ULNode* node = (ULNode*)pool_alloc(ul->pool);
+    if (!node) return NULL;
+
+    node->prev = NULL;
+    node->next = NULL;
+    node->count = 0;
+
+    return node;
+}
+
+inline static void __ul_free_node(ULList* ul, ULNode* node) {
+    pool_free(ul->pool, node);
+}
+
+inline static void __ul_link_after(ULList* ul, ULNode* pos, ULNode* node) {
+    ULNode* next = pos ? pos->next : ul->head;
+
+    node->prev = pos;
+    node->next = next;
+
+    if (pos) pos->next = node;
+    else ul->head = node;
+
+    if (next) next->prev = node;
+    else ul->tail = node;
+
+    ul->node_count++;
+}
+
+inline static void __ul_unlink(ULList* ul, ULNode* node) {
+    if (node->prev) node->prev->next = node->next;
+    else ul->head = node->next;
+
+    if (node->next) node->next->prev = node->prev;
+    else ul->tail = node->prev;
+
+    ul->node_count--;
+}
+
+inline static ULNode* __ul_locate(const ULList* ul, size_t idx, size_t* offset) {
+    ULNode* node;
+
+    if (idx < ul->length / 2) {
+        node = ul->head;
+
+        while (idx >= node->count) {
+            idx -= node->count;
+            node = node->next;
+        }
+    } else {
+        size_t from_end = ul->length - 1 - idx;
+        node = ul->tail;
+
+        while (from_end >= node->count) {
+            from_end -= node->count;
+            node = node->prev;
+        }
+
+        idx = node->count - 1 - from_end;
+    }
+
+    *offset = idx;
+
+    return node;
+}
+
+inline static void __ul_insert_in_node(ULList* ul, ULNode* node, size_t offset, const void* e) {
+    char* slot = __ul_elem(ul, node, offset);
+
+    memmove(slot + ul->element_size, slot, (node->count - offset) * ul->element_size);
+    memcpy(slot, e, ul->element_size);
+
+    node->count++;
+    ul->length++;
+}
+
+inline static void __ul_take_from_node(ULList* ul, ULNode* node, size_t offset, void* out) {
+    char* slot = __ul_elem(ul, node, offset);
+
+    if (out) memcpy(out, slot, ul->element_size);
+    else if (ul->deallocator) ul->deallocator(slot);
+
+    memmove(slot, slot + ul->element_size, (node->count - offset - 1) * ul->element_size);
+
+    node->count--;
+    ul->length--;
+
+    if (node->count == 0) {
+        __ul_unlink(ul, node);
+        __ul_free_node(ul, node);
+    }
+}
+
+static ULNode* __ul_split(ULList* ul, ULNode* node) {
+    ULNode* right = __ul_new_node(ul);
+    if (!right) return NULL;
+
+    size_t keep = node->count / 2;
+
+    right->count = node->count - keep;
+    memcpy(__ul_elem(ul, right, 0), __ul_elem(ul, node, keep), right->count * ul->element_size);
+    node->count = keep;
+
+    __ul_link_after(ul, node, right);
+
+    return right;
+}
+
+static bool __ul_rebalance(ULList* ul, ULNode* node) {
+    // The head and the tail are exempt from the fill factor
+    if (!node->prev || !node->next || node->count >= ul->node_capacity / 2) return false;
+
+    ULNode* next = node->next;
+    const size_t es = ul->element_size;
+
+    if (node->count + next->count <= ul->node_capacity) {
+        memcpy(__ul_elem(ul, node, node->count), __ul_elem(ul, next, 0), next->count * es);
+        node->count += next->count;
+
+        __ul_unlink(ul, next);
+        __ul_free_node(ul, next);
+
+        return true;
+    }
+
+    // Borrow from the successor so both end up (at least) half full
+    size_t moved = (next->count - node->count) / 2;
+
+    memcpy(__ul_elem(ul, node, node->count), __ul_elem(ul, next, 0), moved * es);
+    memmove(__ul_elem(ul, next, 0), __ul_elem(ul, next, moved), (next->count - moved) * es);
+
+    node->count += moved;
+    next->count -= moved;
+
+    return false;
+}
+
+static void __ul_release_nodes(ULList* ul) {
+    ULNode* node = ul->head;
+
+    while (node) {
+        ULNode* next = node->next;
+        __ul_free_node(ul, node);
+        node = next;
+    }
+
+    ul->head = ul->tail = NULL;
+    ul->length = ul->node_count = 0;
+}
+
+static ULList* __ul_new_with_pool(size_t element_size, size_t node_capacity, Pool* pool) {
+    ULList* ul = (ULList*)malloc(sizeof(ULList));
+    if (!ul) return NULL;
+
+    ul->head = ul->tail = NULL;
+
+    ul->length = 0;
+    ul->node_count = 0;
+    ul->element_size = element_size;
+    ul->node_capacity = node_capacity;
+
+    ul->pool = pool;
+    ul->deallocator = NULL;
+
+    ms_track(MS_ULIST, 1, (int64_t)sizeof(ULList));
+
+    return ul;
+}
@@ -0,0 +1,238 @@
+#ifndef ULIST_H
+#define ULIST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "memstat.h"
+#include "pool.h"
+
+// Nomenclature used (to avoid collisions): <data_type>_<method_name>
+// Warning: This implementation is not thread-safe, and is for educational purposes only.
+
+/// Default size of a node in bytes (header included): four cache lines.
+#define UL_DEFAULT_NODE_BYTES 256
+
+/// Number of nodes carved from each slab of the node pool.
+#define UL_NODES_PER_SLAB 64
+
+/**
+ * @brief Unrolled Linked List Node
+ *
+ * A cache-line aligned block holding up to `node_capacity` contiguous elements
+ * right after this header.
+ */
+typedef struct UnrolledListNode ULNode;
+
+struct UnrolledListNode {
+    ULNode* prev;  ///< Previous node (`NULL` for the head).
+    ULNode* next;  ///< Next node (`NULL` for the tail).
+    size_t count;  ///< Number of elements stored in this node.
+};
+
+/**
+ * @brief Unrolled Linked List (Generic implementation)
+ *
+ * A doubly-linked list of fixed-size, cache-line-multiple nodes, each storing a
+ * small array of elements. Iteration streams through contiguous blocks, an
+ * insertion in the middle shifts at most one node's elements, and lists sharing
+ * a node pool can be spliced in O(1).
+ *
+ * Fill-factor policy: every node except the head and the tail holds at least
+ * half of `node_capacity` elements. A full node splits in two halves; a node
+ * falling under half after a removal borrows from, or merges with, a neighbour.
+ *
+ * Elements are moved bytewise (`memcpy`/`memmove`), so they must be trivially
+ * relocatable. `deallocator` (may be `NULL`) is called on the elements dropped
+ * by `ul_clear`, `ul_free` and `ul_remove_at` without an output.
+ */
+typedef struct UnrolledList ULList;
+
+struct UnrolledList {
+    ULNode* head;  ///< First node (`NULL` if empty).
+    ULNode* tail;  ///< Last node (`NULL` if empty).
+
+    size_t length;         ///< Number of elements.
+    size_t node_count;     ///< Number of nodes.
+    size_t element_size;   ///< The size in bytes of a single element.
+    size_t node_capacity;  ///< Maximum number of elements per node (at least 2).
+
+    Pool* pool;  ///< Node allocator, possibly shared with other lists (see `ul_new_sharing_pool`).
+
+    void (*deallocator)(void* k);  ///< Cleans up the resources owned by an element (may be `NULL`).
+};
+
+/// @brief Iterator over an `ULList` (plain value, no allocation).
+typedef struct UnrolledListIterator {
+    ULNode* node;         ///< Current node.
+    size_t offset;        ///< Index of the next element within `node`.
+    size_t element_size;  ///< The size in bytes of a single element.
+} ULIterator;
+
+/******************************************************************************
+ *                                                                            *
+ *                               Intialization                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Allocates a new, empty unrolled list with `UL_DEFAULT_NODE_BYTES` nodes.
+/// @param element_size Size of the elements to be stored. Must be greater than 0.
+/// @return Pointer to the new `ULList`, or `NULL` on failure.
+ULList* ul_new(size_t element_size);
+
+/// @brief Allocates a new, empty unrolled list with a given node size.
+/// @details `node_bytes` is rounded up to a multiple of the cache line (64 bytes), and raised so that a node holds at least two elements.
+/// @param element_size Size of the elements to be stored. Must be greater than 0.
+/// @param node_bytes Size of a node in bytes, header included.
+/// @return Pointer to the new `ULList`, or `NULL` on failure.
+ULList* ul_new_with_node_size(size_t element_size, size_t node_bytes);
+
+/// @brief Allocates a new, empty unrolled list with the same layout as `other`, sharing its node pool.
+/// @details Lists sharing a pool can be spliced into each other in O(1).
+/// @param other Pointer to the list whose pool is shared.
+/// @return Pointer to the new `ULList`, or `NULL` on failure.
+ULList* ul_new_sharing_pool(const ULList* other);
+
+/******************************************************************************
+ *                                                                            *
+ *                             Clean Up & Freeing                             *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Frees the list, its elements (via `deallocator`) and its nodes. The pool is freed once no list shares it anymore.
+/// @param ul Pointer to the list.
+void ul_free(ULList* ul);
+
+/// @brief Removes every element (via `deallocator`) and returns the nodes to the pool.
+/// @param ul Pointer to the list.
+void ul_clear(ULList* ul);
+
+/******************************************************************************
+ *                                                                            *
+ *                               Basic Getters                                *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Gets the number of elements.
+/// @param ul Pointer to the list.
+/// @return The list's length (0 if `ul` is `NULL`).
+size_t ul_length(const ULList* ul);
+
+/// @brief Checks if the list is empty.
+/// @param ul Pointer to the list.
+/// @return `true` if `ul` is `NULL` or holds no element.
+bool ul_is_empty(const ULList* ul);
+
+/// @brief Safely retrieves a pointer to the element at index `idx`.
+/// @details O(n / node_capacity): walks the nodes from the nearer end.
+/// @param ul Pointer to the list.
+/// @param idx The index of the element.
+/// @return Pointer to the element, or `NULL` if out of bounds.
+void* ul_get(const ULList* ul, size_t idx);
+
+/// @brief Retrieves a pointer to the first element.
+/// @param ul Pointer to the list.
+/// @return Pointer to the element, or `NULL` if empty.
+void* ul_get_first(const ULList* ul);
+
+/// @brief Retrieves a pointer to the last element.
+/// @param ul Pointer to the list.
+/// @return Pointer to the element, or `NULL` if empty.
+void* ul_get_last(const ULList* ul);
+
+/// @brief Overwrites the element at index `idx` (the old element is deallocated).
+/// @param ul Pointer to the list.
+/// @param idx The index of the element.
+/// @param e Pointer to the new element.
+/// @return `true` on success, `false` if out of bounds.
+bool ul_set(ULList* ul, size_t idx, const void* e);
+
+/******************************************************************************
+ *                                                                            *
+ *                            Insertion & Removal                             *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Appends an element. Amortized O(1).
+/// @param ul Pointer to the list.
+/// @param e Pointer to the element.
+/// @return `true` on success, `false` on failure.
+bool ul_push_back(ULList* ul, const void* e);
+
+/// @brief Prepends an element. Amortized O(1).
+/// @param ul Pointer to the list.
+/// @param e Pointer to the element.
+/// @return `true` on success, `false` on failure.
+bool ul_push_front(ULList* ul, const void* e);
+
+/// @brief Inserts an element at index `idx`, shifting at most one node's elements.
+/// @param ul Pointer to the list.
+/// @param idx The insertion index, in $[0, \text{length}]$.
+/// @param e Pointer to the element.
+/// @return `true` on success, `false` if out of bounds or on failure.
+bool ul_insert_at(ULList* ul, size_t idx, const void* e);
+
+/// @brief Removes the last element, moving it into `out`.
+/// @param ul Pointer to the list.
+/// @param out Destination for the element (may be `NULL`, in which case it is deallocated).
+/// @return `true` on success, `false` if empty.
+bool ul_pop_back(ULList* ul, void* out);
+
+/// @brief Removes the first element, moving it into `out`.
+/// @param ul Pointer to the list.
+/// @param out Destination for the element (may be `NULL`, in which case it is deallocated).
+/// @return `true` on success, `false` if empty.
+bool ul_pop_front(ULList* ul, void* out);
+
+/// @brief Removes the element at index `idx`, moving it into `out`.
+/// @param ul Pointer to the list.
+/// @param idx The index of the element.
+/// @param out Destination for the element (may be `NULL`, in which case it is deallocated).
+/// @return `true` on success, `false` if out of bounds.
+bool ul_remove_at(ULList* ul, size_t idx, void* out);
+
+/// @brief Moves every element of `src` to the end of `dest`, leaving `src` empty.
+/// @details O(1) when both lists share a pool (see `ul_new_sharing_pool`): the nodes are relinked and only the two nodes at the seam may be rebalanced. Otherwise the elements are copied.
+/// @param dest Pointer to the destination list.
+/// @param src Pointer to the source list.
+/// @return `true` on success, `false` if the element sizes differ or on failure.
+bool ul_splice_back(ULList* dest, ULList* src);
+
+/******************************************************************************
+ *                                                                            *
+ *                                 Iteration                                  *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Initializes an iterator at the first element.
+/// @param it Pointer to the iterator.
+/// @param ul Pointer to the list (must not be modified during the iteration).
+void ul_iter_init(ULIterator* it, const ULList* ul);
+
+/// @brief Advances the iterator by one element.
+/// @param it Pointer to the iterator.
+/// @return Pointer to the next element, or `NULL` at the end.
+void* ul_iter_next(ULIterator* it);
+
+/// @brief Advances the iterator to the end of the current node, returning the remaining contiguous elements.
+/// @details Lets hot loops run over plain arrays: `for (T* p; (p = ul_iter_next_block(&it, &n));) for (i < n) ... p[i]`.
+/// @param it Pointer to the iterator.
+/// @param count Receives the number of elements in the block.
+/// @return Pointer to the first element of the block, or `NULL` at the end.
+void* ul_iter_next_block(ULIterator* it, size_t* count);
+
+/******************************************************************************
+ *                                                                            *
+ *                             Memory Accounting                              *
+ *                                                                            *
+ ******************************************************************************/
+
+/// @brief Breaks down the memory used by the list.
+/// @details `payload` is the stored elements, `slack` the unused node slots, `metadata` the list structure and the node headers, and `overhead` the allocator's rounding of the structure. Unused pool blocks are not attributed to the list.
+/// @param ul Pointer to the list.
+/// @param owned_size Returns the bytes owned by an element (may be `NULL`).
+/// @return The breakdown (zeroed if `ul` is `NULL`).
+MemUsage ul_memory_usage(const ULList* ul, size_t (*owned_size)(const void* k));
+
+#endif  // ULIST_H
@@ -0,0 +1,414 @@
+#include "../lib/bigint.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+__extension__ typedef __int128 i128;
+__extension__ typedef unsigned __int128 u128;
+
+uint64_t xorshift(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state;
+}
+
+/// A random value of exactly `limbs` limbs, with runs of all-ones and zero limbs to stress the carry chains.
+BigInt* random_bi(size_t limbs, bool negative, uint64_t* state) {
+    BigInt* a = bi_new();
+    assert(a);
+
+    for (size_t i = 0; i < limbs; i++) {
+        const uint64_t kind = xorshift(state) % 8;
+        uint64_t limb = kind == 0 ? UINT64_MAX : kind == 1 ? 0 : xorshift(state);
+        if (i == limbs - 1 && !limb) limb = 1;
+        assert(da_push(a->limbs, &limb));
+    }
+    a->negative = limbs && negative;
+
+    return a;
+}
+
+/// Schoolbook product of the magnitudes.
+BigInt* naive_mul(const BigInt* a, const BigInt* b) {
+    const size_t an = a->limbs->length, bn = b->limbs->length;
+    const uint64_t *x = a->limbs->arr, *y = b->limbs->arr;
+    uint64_t* r = calloc(an + bn + 1, sizeof(uint64_t));
+    assert(r);
+
+    for (size_t i = 0; i < an; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < bn; j++) {
+            const u128 p = (u128)x[i] * y[j] + r[i + j] + carry;
+            r[i + j] = (uint64_t)p;
+            carry = (uint64_t)(p >> 64);
+        }
+        r[i + bn] = carry;
+    }
+
+    BigInt* result = bi_new();
+    size_t n = an + bn;
+    while (n && !r[n - 1]) n--;
+    for (size_t i = 0; i < n; i++) assert(da_push(result->limbs, &r[i]));
+    result->negative = n && a->negative != b->negative;
+
+    free(r);
+
+    return result;
+}
+
+BigInt* from_i128(i128 v) {
+    const u128 m = v < 0 ? (u128)0 - (u128)v : (u128)v;
+    BigInt* lo = bi_from_u64((uint64_t)m);
+    BigInt* hi = bi_from_u64((uint64_t)(m >> 64));
+    BigInt* shifted = bi_shl(hi, 64);
+    BigInt* r = bi_add(shifted, lo);
+    if (v < 0) r->negative = true;
+
+    bi_free(lo);
+    bi_free(hi);
+    bi_free(shifted);
+
+    return r;
+}
+
+void assert_string(const BigInt* a, const char* expected) {
+    char* s = bi_to_string(a);
+    assert(s && strcmp(s, expected) == 0);
+    free(s);
+}
+
+/// `q * b + r == a` with `|r| < |b|` and the truncated-division signs.
+void check_divmod(const BigInt* a, const BigInt* b) {
+    BigInt *q = NULL, *r = NULL;
+    assert(bi_divmod(a, b, &q, &r));
+
+    BigInt* qb = bi_mul(q, b);
+    BigInt* back = bi_add(qb, r);
+    assert(bi_cmp(back, a) == 0);
+    assert(bi_cmp_abs(r, b) < 0);
+    assert(bi_is_zero(r) || bi_sign(r) == bi_sign(a));
+    assert(bi_is_zero(q) || bi_sign(q) == bi_sign(a) * bi_sign(b));
+
+    bi_free(q);
+    bi_free(r);
+    bi_free(qb);
+    bi_free(back);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Test Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+void test_basics() {
+    printf("--- Test Basics ---\n");
+
+    BigInt* zero = bi_new();
+    BigInt* max = bi_from_u64(UINT64_MAX);
+    BigInt* min = bi_from_i64(INT64_MIN);
+    uint64_t v = 0;
+
+    assert(bi_is_zero(zero) && bi_sign(zero) == 0 && bi_bits(zero) == 0);
+    assert_string(zero, "0");
+    assert_string(max, "18446744073709551615");
+    assert_string(min, "-9223372036854775808");
+    assert(bi_sign(min) == -1 && bi_bits(min) == 64 && bi_bits(max) == 64);
+    assert(bi_to_u64(max, &v) && v == UINT64_MAX);
+    assert(!bi_to_u64(min, &v) && bi_to_u64(zero, &v) && v == 0);
+    assert(bi_cmp(min, zero) < 0 && bi_cmp(max, min) > 0 && bi_cmp_abs(max, min) > 0 && bi_cmp(zero, zero) == 0);
+
+    const char* bad[] = {"", "-", "+", "12a", " 1", "1-", "--1", "0x10"};
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) assert(!bi_from_string(bad[i]));
+    assert(!bi_from_string(NULL));
+
+    BigInt* parsed = bi_from_string("-000123456789012345678901234567890");
+    assert_string(parsed, "-123456789012345678901234567890");
+    bi_free(parsed);
+
+    parsed = bi_from_string("-0000");
+    assert(bi_is_zero(parsed) && !parsed->negative);
+    assert_string(parsed, "0");
+    bi_free(parsed);
+
+    parsed = bi_from_string("+18446744073709551616");
+    BigInt* one = bi_from_u64(1);
+    BigInt* two64 = bi_shl(one, 64);
+    assert(bi_cmp(parsed, two64) == 0 && bi_bits(two64) == 65);
+
+    BigInt* neg = bi_neg(two64);
+    BigInt* back = bi_shr(neg, 63);
+    assert_string(back, "-2");
+    assert(!bi_divmod(one, zero, NULL, NULL) && !bi_div(one, zero) && !bi_mod(one, zero));
+
+    bi_free(parsed);
+    bi_free(one);
+    bi_free(two64);
+    bi_free(neg);
+    bi_free(back);
+    bi_free(zero);
+    bi_free(max);
+    bi_free(min);
+
+    printf("... done.\n\n");
+}
+
+void test_small_arithmetic() {
+    printf("--- Test Small Arithmetic ---\n");
+
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+    for (int iter = 0; iter < 20000; iter++) {
+        // Values below 2^62 in magnitude, so sums and products fit in 128 bits
+        const int64_t x = (int64_t)(xorshift(&state) >> (2 + xorshift(&state) % 60)) * (xorshift(&state) & 1 ? -1 : 1);
+        const int64_t y = (int64_t)(xorshift(&state) >> (2 + xorshift(&state) % 60)) * (xorshift(&state) & 1 ? -1 : 1);
+
+        BigInt *a = bi_from_i64(x), *b = bi_from_i64(y);
+        BigInt *sum = bi_add(a, b), *diff = bi_sub(a, b), *prod = bi_mul(a, b);
+        BigInt *esum = from_i128((i128)x + y), *ediff = from_i128((i128)x - y), *eprod = from_i128((i128)x * y);
+
+        assert(bi_cmp(sum, esum) == 0 && bi_cmp(diff, ediff) == 0 && bi_cmp(prod, eprod) == 0);
+        assert(bi_cmp(a, b) == (x < y ? -1 : x > y));
+
+        if (y) {
+            BigInt *q = NULL, *r = NULL;
+            assert(bi_divmod(a, b, &q, &r));
+
+            BigInt *eq = bi_from_i64(x / y), *er = bi_from_i64(x % y);
+            assert(bi_cmp(q, eq) == 0 && bi_cmp(r, er) == 0);
+
+            bi_free(q);
+            bi_free(r);
+            bi_free(eq);
+            bi_free(er);
+        }
+
+        const unsigned s = (unsigned)(xorshift(&state) % 64);
+        BigInt* sh = bi_shl(a, s);
+        BigInt* esh = from_i128((i128)x * ((i128)1 << s));
+        BigInt* shr = bi_shr(a, s);
+        BigInt* eshr = bi_from_i64(x < 0 ? -(int64_t)((uint64_t)-x >> s) : (int64_t)((uint64_t)x >> s));
+        assert(bi_cmp(sh, esh) == 0 && bi_cmp(shr, eshr) == 0);
+
+        BigInt* all[] = {a, b, sum, diff, prod, esum, ediff, eprod, sh, esh, shr, eshr};
+        for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); i++) bi_free(all[i]);
+    }
+
+    printf("... done.\n\n");
+}
+
+void test_multiplication() {
+    printf("--- Test Multiplication ---\n");
+
+    uint64_t state = 0xDEADBEEFCAFEF00DULL;
+
+    // Sizes around the Karatsuba (24) and Toom-3 (240) thresholds, odd splits and unbalanced operands
+    const size_t sizes[][2] = {{1, 1},     {5, 3},     {23, 23},   {24, 24},   {25, 25},   {47, 20},  {64, 64},
+                               {95, 95},   {239, 239}, {240, 240}, {241, 241}, {200, 199}, {250, 40}, {480, 480},
+                               {481, 479}, {700, 350}, {1000, 33}, {1234, 1234}};
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        for (int signs = 0; signs < 2; signs++) {
+            BigInt* a = random_bi(sizes[i][0], signs, &state);
+            BigInt* b = random_bi(sizes[i][1], false, &state);
+
+            BigInt *ab = bi_mul(a, b), *ba = bi_mul(b, a), *expected = naive_mul(a, b);
+            assert(bi_cmp(ab, expected) == 0 && bi_cmp(ba, expected) == 0);
+
+            bi_free(a);
+            bi_free(b);
+            bi_free(ab);
+            bi_free(ba);
+            bi_free(expected);
+        }
+    }
+
+    // All-ones operands maximize every carry: (B^n - 1)^2 = B^2n - 2 B^n + 1
+    for (size_t n = 100; n <= 1000; n += 450) {
+        BigInt* ones = bi_new();
+        const uint64_t max = UINT64_MAX;
+        for (size_t i = 0; i < n; i++) assert(da_push(ones->limbs, &max));
+
+        BigInt* sq = bi_mul(ones, ones);
+        BigInt* expected = naive_mul(ones, ones);
+        assert(bi_cmp(sq, expected) == 0);
+
+        bi_free(ones);
+        bi_free(sq);
+        bi_free(expected);
+    }
+
+    printf("... done.\n\n");
+}
+
+void test_division() {
+    printf("--- Test Division ---\n");
+
+    uint64_t state = 0x0F1E2D3C4B5A6978ULL;
+
+    // Divisors on both sides of the Newton threshold (64), single-step and chunked dividends
+    const size_t sizes[][2] = {{1, 1},    {3, 1},    {10, 2},    {10, 9},     {100, 50},  {63, 63},
+                               {200, 63}, {200, 64}, {128, 64},  {129, 64},   {300, 100}, {1000, 120},
+                               {500, 250}, {64, 65}, {2000, 700}, {3000, 1000}};
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        for (int signs = 0; signs < 4; signs++) {
+            BigInt* a = random_bi(sizes[i][0], signs & 1, &state);
+            BigInt* b = random_bi(sizes[i][1], signs & 2, &state);
+
+            check_divmod(a, b);
+
+            // A positive multiple plus one: the quotient and remainder are known
+            BigInt* c = random_bi(sizes[i][0], false, &state);
+            BigInt* cb = bi_mul(c, b);
+            BigInt* one = bi_from_u64(1);
+            BigInt* cb1 = bi_add(cb, one);
+            BigInt *q = NULL, *r = NULL;
+
+            assert(bi_divmod(cb1, b, &q, &r));
+            if (bi_cmp(b, one) > 0) {
+                assert(bi_cmp_abs(q, c) == 0 && bi_cmp(r, one) == 0);
+            }
+
+            bi_free(a);
+            bi_free(b);
+            bi_free(c);
+            bi_free(cb);
+            bi_free(one);
+            bi_free(cb1);
+            bi_free(q);
+            bi_free(r);
+        }
+    }
+
+    // Divisor with a top limb of 1 (largest normalization shift) and a divisor equal to the dividend
+    BigInt* one = bi_from_u64(1);
+    BigInt* b = bi_shl(one, 64 * 150);
+    BigInt* b1 = bi_add(b, one);
+    BigInt* a = random_bi(500, false, &state);
+    check_divmod(a, b1);
+    check_divmod(b1, b1);
+
+    BigInt* q = bi_div(a, a);
+    assert(bi_cmp(q, one) == 0);
+
+    bi_free(one);
+    bi_free(b);
+    bi_free(b1);
+    bi_free(a);
+    bi_free(q);
+
+    printf("... done.\n\n");
+}
+
+void test_strings() {
+    printf("--- Test Strings ---\n");
+
+    uint64_t state = 0x5555AAAA3333CCCCULL;
+
+    // Powers of ten and their predecessors, across the divide-and-conquer split sizes
+    BigInt* ten = bi_from_u64(10);
+    BigInt* one = bi_from_u64(1);
+    BigInt* p = bi_from_u64(1);
+    char* expected = malloc(3002);
+    assert(expected);
+
+    for (size_t k = 0; k <= 3000; k++) {
+        if (k % 97 == 0 || k == 3000 || (k % 19) == 0) {
+            expected[0] = '1';
+            memset(expected + 1, '0', k);
+            expected[k + 1] = '\0';
+            assert_string(p, expected);
+
+            BigInt* parsed = bi_from_string(expected);
+            assert(bi_cmp(parsed, p) == 0);
+            bi_free(parsed);
+
+            BigInt* pm1 = bi_sub(p, one);
+            if (k) {
+                memset(expected, '9', k);
+                expected[k] = '\0';
+                assert_string(pm1, expected);
+            }
+            bi_free(pm1);
+        }
+
+        BigInt* next = bi_mul(p, ten);
+        bi_free(p);
+        p = next;
+    }
+    free(expected);
+
+    // Random digit strings against Horner's rule with small multiplications
+    for (size_t len = 1; len <= 2500; len = len * 3 + 7) {
+        char* digits = malloc(len + 2);
+        assert(digits);
+
+        digits[0] = '-';
+        for (size_t i = 1; i <= len; i++) digits[i] = (char)('0' + xorshift(&state) % 10);
+        if (digits[1] == '0') digits[1] = '7';
+        digits[len + 1] = '\0';
+
+        BigInt* horner = bi_new();
+        for (size_t i = 1; i <= len; i++) {
+            BigInt* d = bi_from_u64((uint64_t)(digits[i] - '0'));
+            BigInt* t = bi_mul(horner, ten);
+            bi_free(horner);
+            horner = bi_add(t, d);
+            bi_free(t);
+            bi_free(d);
+        }
+        horner->negative = true;
+
+        BigInt* parsed = bi_from_string(digits);
+        assert(bi_cmp(parsed, horner) == 0);
+        assert_string(parsed, digits);
+
+        bi_free(horner);
+        bi_free(parsed);
+        free(digits);
+    }
+
+    // Round trips of large random values
+    for (size_t limbs = 30; limbs <= 6000; limbs *= 3) {
+        BigInt* a = random_bi(limbs, limbs % 2, &state);
+        char* s = bi_to_string(a);
+        BigInt* back = bi_from_string(s);
+        assert(bi_cmp(a, back) == 0);
+
+        free(s);
+        bi_free(a);
+        bi_free(back);
+    }
+
+    bi_free(ten);
+    bi_free(one);
+    bi_free(p);
+
+    printf("... done.\n\n");
+}
+
+int main() {
+    printf("Starting Big Integer Test Suite...\n\n");
+
+    test_basics();
+    test_small_arithmetic();
+    test_multiplication();
+    test_division();
+    test_strings();
+
+    printf("All tests passed!\n");
+
+    return 0;
+}
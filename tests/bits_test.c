@@ -0,0 +1,195 @@
+#include "../lib/bits.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+uint64_t xorshift(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state;
+}
+
+unsigned naive_popcount(uint64_t x) {
+    unsigned count = 0;
+    for (; x; x >>= 1) count += (unsigned)(x & 1);
+    return count;
+}
+
+uint64_t naive_pdep(uint64_t x, uint64_t mask) {
+    uint64_t result = 0;
+    unsigned k = 0;
+
+    for (unsigned i = 0; i < 64; i++) {
+        if (!((mask >> i) & 1)) continue;
+        if ((x >> k) & 1) result |= (uint64_t)1 << i;
+        k++;
+    }
+
+    return result;
+}
+
+uint64_t naive_pext(uint64_t x, uint64_t mask) {
+    uint64_t result = 0;
+    unsigned k = 0;
+
+    for (unsigned i = 0; i < 64; i++) {
+        if (!((mask >> i) & 1)) continue;
+        if ((x >> i) & 1) result |= (uint64_t)1 << k;
+        k++;
+    }
+
+    return result;
+}
+
+uint64_t naive_count(const uint8_t* a, const uint8_t* b, size_t bytes, int op) {
+    uint64_t count = 0;
+
+    for (size_t i = 0; i < bytes; i++) {
+        const uint8_t v = op == 0 ? a[i] : op == 1 ? (uint8_t)(a[i] & b[i]) : (uint8_t)(a[i] ^ b[i]);
+        count += naive_popcount(v);
+    }
+
+    return count;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Test Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+void test_word() {
+    printf("--- Test Single Word ---\n");
+
+    assert(bits_clz(0) == 64 && bits_ctz(0) == 64);
+    assert(bits_clz(1) == 63 && bits_ctz(1) == 0);
+    assert(bits_clz(UINT64_MAX) == 0 && bits_ctz((uint64_t)1 << 63) == 63);
+
+    assert(!bits_is_pow2(0) && bits_is_pow2(1) && bits_is_pow2(1024) && !bits_is_pow2(1023));
+    assert(bits_is_pow2((uint64_t)1 << 63) && !bits_is_pow2(UINT64_MAX));
+
+    assert(bits_log2(0) == 0 && bits_log2(1) == 0 && bits_log2(2) == 1 && bits_log2(3) == 1);
+    assert(bits_log2(UINT64_MAX) == 63);
+    assert(bits_log2_ceil(0) == 0 && bits_log2_ceil(1) == 0 && bits_log2_ceil(3) == 2 && bits_log2_ceil(4) == 2);
+    assert(bits_log2_ceil(UINT64_MAX) == 64);
+
+    assert(bits_npo2(0) == 1 && bits_npo2(1) == 1 && bits_npo2(2) == 2 && bits_npo2(3) == 4);
+    assert(bits_npo2(5) == 8 && bits_npo2(1000) == 1024 && bits_npo2(1024) == 1024);
+
+    // Beyond the 32-bit range that the old `1 << ...` hashset helper overflowed on
+    assert(bits_npo2(((uint64_t)1 << 31) + 1) == (uint64_t)1 << 32);
+    assert(bits_npo2(((uint64_t)1 << 40) - 7) == (uint64_t)1 << 40);
+    assert(bits_npo2((uint64_t)1 << 63) == (uint64_t)1 << 63);
+    assert(bits_npo2(((uint64_t)1 << 63) + 1) == 0 && bits_npo2(UINT64_MAX) == 0);
+
+    for (unsigned s = 2; s < 63; s++) {
+        const uint64_t p = (uint64_t)1 << s;
+        assert(bits_npo2(p - 1) == p && bits_npo2(p) == p && bits_npo2(p + 1) == p << 1);
+        assert(bits_log2(p) == s && bits_log2(p - 1) == s - 1 && bits_log2_ceil(p + 1) == s + 1);
+    }
+
+    printf("npo2 / log2 / clz / ctz passed.\n");
+
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (int t = 0; t < 100000; t++) {
+        const uint64_t x = xorshift(&state);
+        uint64_t mask = xorshift(&state);
+        if (t % 3 == 0) mask &= xorshift(&state);  // sparser masks too
+
+        assert(bits_popcount(x) == naive_popcount(x));
+        assert(bits_pdep(x, mask) == naive_pdep(x, mask));
+        assert(bits_pext(x, mask) == naive_pext(x, mask));
+
+        // pext undoes pdep on the low popcount(mask) bits
+        const unsigned width = bits_popcount(mask);
+        const uint64_t low = width == 64 ? UINT64_MAX : ((uint64_t)1 << width) - 1;
+        assert(bits_pext(bits_pdep(x, mask), mask) == (x & low));
+
+        const unsigned k = (unsigned)(xorshift(&state) % 66);
+        const unsigned pos = bits_select(mask, k);
+        if (k < bits_popcount(mask)) {
+            assert(pos < 64 && ((mask >> pos) & 1));
+            assert(bits_popcount(mask & (((uint64_t)1 << pos) - 1)) == k);
+        } else {
+            assert(pos == 64);
+        }
+    }
+
+    printf("pdep / pext / select passed.\n");
+    printf("Test Single Word done.\n\n");
+}
+
+void test_bulk() {
+    printf("--- Test Bulk Popcount ---\n");
+
+    const size_t max = 5000;
+    uint8_t* a = malloc(max + 64);
+    uint8_t* b = malloc(max + 64);
+
+    uint64_t state = 0xDEADBEEFCAFEF00DULL;
+    for (size_t i = 0; i < max + 64; i++) {
+        a[i] = (uint8_t)xorshift(&state);
+        b[i] = (uint8_t)xorshift(&state);
+    }
+
+    const BitsKernel kernels[] = {BITS_KERNEL_PORTABLE, BITS_KERNEL_POPCNT, BITS_KERNEL_AVX2};
+    const char* names[] = {"portable", "popcnt", "avx2"};
+    const BitsKernel best = bits_kernel();
+
+    assert(best != BITS_KERNEL_AUTO);
+
+    for (size_t k = 0; k < 3; k++) {
+        if (!bits_use_kernel(kernels[k])) {
+            printf("kernel %s not supported, skipped.\n", names[k]);
+            continue;
+        }
+        assert(bits_kernel() == kernels[k]);
+
+        for (size_t n = 0; n <= max; n += (n < 1100 ? 1 : 97)) {
+            const size_t off_a = n % 7, off_b = n % 13;  // misaligned starts
+
+            assert(bits_popcount_buf(a + off_a, n) == naive_count(a + off_a, NULL, n, 0));
+            assert(bits_popcount_and(a + off_a, b + off_b, n) == naive_count(a + off_a, b + off_b, n, 1));
+            assert(bits_popcount_xor(a + off_a, b + off_b, n) == naive_count(a + off_a, b + off_b, n, 2));
+        }
+
+        printf("kernel %s passed.\n", names[k]);
+    }
+
+    // Saturated and empty inputs
+    uint8_t* ones = malloc(4096);
+    for (size_t i = 0; i < 4096; i++) ones[i] = 0xFF;
+    assert(bits_popcount_buf(ones, 4096) == 4096 * 8);
+    assert(bits_popcount_xor(ones, ones, 4096) == 0);
+    assert(bits_popcount_buf(NULL, 10) == 0);
+    free(ones);
+
+    assert(bits_use_kernel(BITS_KERNEL_AUTO));
+    assert(bits_kernel() == best);
+
+    free(a);
+    free(b);
+
+    printf("Test Bulk Popcount done.\n\n");
+}
+
+int main() {
+    printf("Starting Bits Test Suite...\n\n");
+
+    test_word();
+    test_bulk();
+
+    printf("All tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,248 @@
+#define _DEFAULT_SOURCE
+
+#include "../lib/darray_io.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+int int_cmp(const void* a, const void* b) {
+    return *(const int*)a - *(const int*)b;
+}
+
+int u64_cmp(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+
+    return (x > y) - (x < y);
+}
+
+// Writes `n` pseudo-random values (with plenty of duplicates) to `path`.
+void write_random_file(const char* path, size_t n) {
+    FILE* f = fopen(path, "wb");
+    assert(f != NULL);
+
+    uint64_t x = 88172645463325252ULL;
+    for (size_t i = 0; i < n; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+
+        uint64_t v = x % 50000;
+        fwrite(&v, sizeof(v), 1, f);
+    }
+
+    fclose(f);
+}
+
+// Checks that `path` holds `n` values in non-decreasing order whose sum matches `expected_sum`.
+void check_sorted_file(const char* path, size_t n, uint64_t expected_sum) {
+    FILE* f = fopen(path, "rb");
+    assert(f != NULL);
+
+    uint64_t prev = 0, v, sum = 0;
+    size_t count = 0;
+
+    while (fread(&v, sizeof(v), 1, f) == 1) {
+        assert(v >= prev);
+        prev = v;
+        sum += v;
+        count++;
+    }
+
+    fclose(f);
+
+    assert(count == n);
+    assert(sum == expected_sum);
+}
+
+void int_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(int));
+}
+
+typedef struct {
+    unsigned char b[3];
+} Triple;
+
+void triple_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(Triple));
+}
+
+uint64_t file_sum(const char* path) {
+    FILE* f = fopen(path, "rb");
+    assert(f != NULL);
+
+    uint64_t v, sum = 0;
+    while (fread(&v, sizeof(v), 1, f) == 1) sum += v;
+
+    fclose(f);
+
+    return sum;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Test Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+void test_external_sort() {
+    printf("--- Test External Sort ---\n");
+
+    char in[] = "/tmp/da_io_test_in_XXXXXX";
+    char out[] = "/tmp/da_io_test_out_XXXXXX";
+    close(mkstemp(in));
+    close(mkstemp(out));
+
+    const size_t n = 200000;
+    write_random_file(in, n);
+    uint64_t sum = file_sum(in);
+
+    // Fits in a single run
+    assert(da_external_sort(in, out, sizeof(uint64_t), u64_cmp, 64 * 1024 * 1024));
+    check_sorted_file(out, n, sum);
+    printf("da_external_sort (single run) passed.\n");
+
+    // Many runs, single merge pass
+    assert(da_external_sort(in, out, sizeof(uint64_t), u64_cmp, 256 * 1024));
+    check_sorted_file(out, n, sum);
+    printf("da_external_sort (single merge pass) passed.\n");
+
+    // Tiny budget: forces intermediate merge passes
+    assert(da_external_sort(in, out, sizeof(uint64_t), u64_cmp, 2048));
+    check_sorted_file(out, n, sum);
+    printf("da_external_sort (multiple merge passes) passed.\n");
+
+    // Budget too small to hold anything useful
+    assert(!da_external_sort(in, out, sizeof(uint64_t), u64_cmp, 8));
+
+    // Empty input
+    write_random_file(in, 0);
+    assert(da_external_sort(in, out, sizeof(uint64_t), u64_cmp, 4096));
+    check_sorted_file(out, 0, 0);
+    printf("da_external_sort (empty) passed.\n");
+
+    unlink(in);
+    unlink(out);
+
+    printf("Test External Sort done.\n\n");
+}
+
+void test_save_load() {
+    printf("--- Test Save & Load ---\n");
+
+    char path[] = "/tmp/da_io_test_save_XXXXXX";
+    close(mkstemp(path));
+
+    DArray* da = da_new(sizeof(int));
+    da->copier = int_copier;
+    for (int i = 0; i < 100000; i++) {
+        int v = i * 7 - 3;
+        da_push(da, &v);
+    }
+
+    int modes[] = {0, DA_IO_DIRECT};
+
+    for (size_t m = 0; m < 2; m++) {
+        assert(da_save(da, path, modes[m]));
+
+        DArray* loaded = da_load(path, modes[m], int_copier);
+        assert(loaded != NULL);
+        assert(da_are_eq(da, loaded, int_cmp));
+        assert(loaded->copier == int_copier);
+
+        // Loaded arrays behave like any other array.
+        int v = 42;
+        assert(da_push(loaded, &v));
+        da_free(loaded);
+    }
+    printf("da_save/da_load passed.\n");
+
+    // Streaming reader, chunk size that does not divide the length
+    DAReader* dar = da_reader_open(path, 0);
+    assert(dar != NULL);
+    assert(dar_element_size(dar) == sizeof(int));
+    assert(dar_length(dar) == 100000);
+
+    DArray* chunk = da_new_with_capacity(sizeof(int), 999);
+    size_t seen = 0;
+
+    while (dar_next_chunk(dar, chunk)) {
+        for (size_t i = 0; i < chunk->length; i++) {
+            assert(*(int*)da_get(chunk, i) == (int)(seen + i) * 7 - 3);
+        }
+        seen += chunk->length;
+    }
+
+    assert(seen == 100000);
+    assert(dar_close(dar));
+    da_free(chunk);
+    printf("da_reader (buffered) passed.\n");
+
+    // Odd element size through O_DIRECT (or its fallback)
+    DArray* triples = da_new(sizeof(Triple));
+    triples->copier = triple_copier;
+    for (int i = 0; i < 5001; i++) {
+        Triple t = {{(unsigned char)i, (unsigned char)(i >> 8), (unsigned char)(i * 3)}};
+        da_push(triples, &t);
+    }
+
+    assert(da_save(triples, path, DA_IO_DIRECT));
+
+    dar = da_reader_open(path, DA_IO_DIRECT);
+    chunk = da_new_with_capacity(sizeof(Triple), 64);
+    seen = 0;
+
+    while (dar_next_chunk(dar, chunk)) {
+        assert(memcmp(da_raw(chunk), da_index(triples, seen), chunk->length * sizeof(Triple)) == 0);
+        seen += chunk->length;
+    }
+
+    assert(seen == 5001);
+    assert(dar_close(dar));
+    da_free(chunk);
+    da_free(triples);
+    printf("da_reader (direct) passed.\n");
+
+    // Corruption is detected by the checksum
+    assert(da_save(da, path, 0));
+
+    FILE* f = fopen(path, "r+b");
+    fseek(f, 4096 + 1234, SEEK_SET);
+    fputc(0x5A, f);
+    fclose(f);
+
+    assert(da_load(path, 0, int_copier) == NULL);
+
+    dar = da_reader_open(path, 0);
+    chunk = da_new_with_capacity(sizeof(int), 4096);
+    while (dar_next_chunk(dar, chunk));
+    assert(!dar_close(dar));
+    da_free(chunk);
+    printf("checksum verification passed.\n");
+
+    da_free(da);
+    unlink(path);
+
+    printf("Test Save & Load done.\n\n");
+}
+
+int main() {
+    printf("Starting DArray I/O Test Suite...\n\n");
+
+    test_external_sort();
+    test_save_load();
+
+    printf("All tests passed!\n");
+
+    return 0;
+}
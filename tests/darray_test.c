@@ -85,6 +85,11 @@ int person_cmp_by_id(const void* a, const void* b) {
     return 0;  // IDs match, elements are considered equal for searching
 }
 
+uint64_t person_id_hasher(const void* k, uint64_t s0, uint64_t s1) {
+    (void)s1;
+    return ((uint64_t)((const Person*)k)->id ^ s0) * UINT64_C(0x9E3779B97F4A7C15);
+}
+
 // --- Custom Operations for Integer Type (No heap management needed) ---
 
 void int_copier(void* dest, const void* src) {
@@ -101,6 +106,11 @@ int int_cmp(const void* a, const void* b) {
     return (*ia - *ib);
 }
 
+uint64_t int_hasher(const void* k, uint64_t s0, uint64_t s1) {
+    (void)s1;
+    return ((uint64_t)*(const int*)k ^ s0) * UINT64_C(0x9E3779B97F4A7C15);
+}
+
 /******************************************************************************
  *                                                                            *
  *                               Test Functions                               *
@@ -458,6 +468,112 @@ void test_resizing() {
     da_free(da);
     printf("Test Resizing done.\n\n");
 }
+
+void test_small_buffer() {
+    printf("--- Test Small Buffer ---\n");
+
+    MSCounter before = ms_registry_get(MS_DARRAY);
+
+    // Single allocation, spills to the heap on growth and moves back on shrink
+    DArray* da = da_new_with_inline(sizeof(int), 8);
+    da->copier = int_copier;
+    assert(da_capacity(da) == 8);
+    assert(da->arr == da->_inline_buf);
+
+    for (int i = 0; i < 8; i++) assert(da_push(da, &i));
+    assert(da->arr == da->_inline_buf);
+
+    for (int i = 8; i < 100; i++) assert(da_push(da, &i));
+    assert(da->arr != da->_inline_buf);
+    assert(da_capacity(da) >= 100);
+    for (int i = 0; i < 100; i++) assert(*(int*)da_get(da, (size_t)i) == i);
+
+    assert(da_truncate(da, 5));
+    assert(da_shrink(da));
+    assert(da->arr == da->_inline_buf);
+    assert(da_capacity(da) == 8);
+    for (int i = 0; i < 5; i++) assert(*(int*)da_get(da, (size_t)i) == i);
+    printf("da_new_with_inline passed.\n");
+
+    MemUsage mu = da_memory_usage(da, NULL);
+    assert(mu.payload == 5 * sizeof(int) && mu.slack == 3 * sizeof(int));
+
+    // da_get_raw hands out a heap copy of inline storage
+    int* raw = (int*)da_get_raw(da);
+    assert(raw[4] == 4);
+    free(raw);
+
+    // Caller-owned structure and buffer
+    struct {
+        DArray items;
+        int buf[4];
+    } owner;
+
+    assert(da_init_inline(&owner.items, sizeof(int), owner.buf, sizeof(owner.buf)));
+    owner.items.copier = int_copier;
+    assert(da_capacity(&owner.items) == 4);
+
+    for (int i = 0; i < 4; i++) da_push(&owner.items, &i);
+    assert(owner.items.arr == owner.buf && owner.buf[3] == 3);
+
+    for (int i = 4; i < 20; i++) da_push(&owner.items, &i);
+    assert(owner.items.arr != owner.buf);
+    assert(*(int*)da_get_last(&owner.items) == 19);
+
+    // Push/pop across the inline boundary keeps the heap storage instead of bouncing between the two
+    while (da_length(&owner.items) > 5) free(da_pop(&owner.items));
+    int settle = 5;
+    assert(da_push(&owner.items, &settle));  // regrows the storage shrunk to fit on the way down
+    free(da_pop(&owner.items));
+    const void* spilled = owner.items.arr;
+    assert(spilled != owner.buf);
+    for (int round = 0; round < 10; round++) {
+        int v = round;
+        assert(da_push(&owner.items, &v));
+        free(da_pop(&owner.items));
+        free(da_pop(&owner.items));
+        assert(da_length(&owner.items) == 4 && owner.items.arr == spilled);
+        assert(da_push(&owner.items, &v));
+        assert(owner.items.arr == spilled);
+    }
+
+    // Shrinking through pops lands back in the buffer
+    while (da_length(&owner.items) > 2) free(da_pop(&owner.items));
+    assert(owner.items.arr == owner.buf);
+
+    da_deinit(&owner.items);
+    assert(da_length(&owner.items) == 0 && owner.items.arr == owner.buf);
+    assert(ms_registry_get(MS_DARRAY).containers == before.containers);
+
+    // Reused as is, it counts as live again, and the next da_deinit retires it exactly once
+    for (int i = 0; i < 10; i++) da_push(&owner.items, &i);
+    assert(ms_registry_get(MS_DARRAY).containers == before.containers + 1);
+    da_deinit(&owner.items);
+    da_deinit(&owner.items);
+    assert(ms_registry_get(MS_DARRAY).containers == before.containers);
+    assert(ms_registry_get(MS_DARRAY).bytes == before.bytes);
+
+    // Reusable after da_deinit; da_free on an embedded array only deinitializes it
+    assert(da_init_inline(&owner.items, sizeof(int), owner.buf, sizeof(owner.buf)));
+    owner.items.copier = int_copier;
+    for (int i = 0; i < 10; i++) da_push(&owner.items, &i);
+    da_free(&owner.items);
+    printf("da_init_inline passed.\n");
+
+    // Without a buffer it behaves like a plain heap array
+    DArray bare;
+    assert(da_init_inline(&bare, sizeof(int), NULL, 0));
+    bare.copier = int_copier;
+    for (int i = 0; i < 3; i++) da_push(&bare, &i);
+    assert(*(int*)da_get(&bare, 2) == 2);
+    da_deinit(&bare);
+
+    MSCounter after = ms_registry_get(MS_DARRAY);
+    assert(after.containers == before.containers && after.bytes == before.bytes);
+    printf("registry balance passed.\n");
+
+    printf("Test Small Buffer done.\n\n");
+}
 // ---
 
 void test_searching() {
@@ -528,6 +644,23 @@ void test_order_manipulation() {
     assert(*(int*)da_get(da, 3) == 40);
     printf("da_rotate_right passed.\n");
 
+    da_free(da);
+
+    // Larger arrays exercise the vectorized reverse and the block-swap rotation
+    da = da_new(sizeof(int));
+    da->copier = int_copier;
+    for (int i = 0; i < 1000; i++) da_push(da, &i);
+
+    da_reverse(da);
+    for (int i = 0; i < 1000; i++) assert(*(int*)da_get(da, (size_t)i) == 999 - i);
+    da_reverse(da);
+
+    da_rotate_left(da, 300);  // neither block fits the stack buffer
+    for (int i = 0; i < 1000; i++) assert(*(int*)da_get(da, (size_t)i) == (i + 300) % 1000);
+    da_rotate_right(da, 300);
+    for (int i = 0; i < 1000; i++) assert(*(int*)da_get(da, (size_t)i) == i);
+    printf("da_reverse/da_rotate (large) passed.\n");
+
     da_free(da);
     printf("Test Order Manipulation done.\n\n");
 }
@@ -576,12 +709,118 @@ void test_concatenation() {
     da_free(merged);
     printf("da_merge_sorted (interleaving) passed.\n");
 
+    // Test da_merge_k
+    int r0[] = {1, 4, 7, 10}, r1[] = {2, 5, 8}, r2[] = {3, 6, 9, 11, 12};
+    DArray* runs[] = {
+        da_new_from_array(sizeof(int), 4, r0, int_copier),
+        NULL,  // skipped
+        da_new_from_array(sizeof(int), 3, r1, int_copier),
+        da_new_from_array(sizeof(int), 5, r2, int_copier),
+    };
+    merged = da_merge_k((const DArray* const*)runs, 4, int_cmp);
+    assert(da_length(merged) == 12);
+    for (int i = 0; i < 12; i++) assert(*(int*)da_get(merged, (size_t)i) == i + 1);
+    da_free(merged);
+    printf("da_merge_k passed.\n");
+
+    // Test streaming merge over iterators
+    DAIterator* its[] = {da_iterator(runs[0]), da_iterator(runs[2]), da_iterator(runs[3])};
+    DAMergeSource sources[] = {dai_merge_source(its[0]), dai_merge_source(its[1]), dai_merge_source(its[2])};
+    DAMergeIterator* dami = da_merge_iterator(sources, 3, int_cmp);
+    int expected = 1;
+    while (dami_next(dami)) {
+        assert(*(const int*)dami_get(dami) == expected++);
+    }
+    assert(expected == 13);
+    assert(dami_get(dami) == NULL);
+    dami_free(dami);
+    for (size_t i = 0; i < 3; i++) dai_free(its[i]);
+    for (size_t i = 0; i < 4; i++) da_free(runs[i]);
+    printf("da_merge_iterator passed.\n");
+
     da_free(a);
     da_free(b);
     printf("Test Concatenation done.\n\n");
 }
 // ---
 
+void test_dedup_grouping() {
+    printf("--- Test Deduplication & Grouping ---\n");
+
+    // Test da_unique_sorted
+    int s[] = {1, 1, 2, 3, 3, 3, 4};
+    DArray* da = da_new_from_array(sizeof(int), 7, s, int_copier);
+    assert(da_unique_sorted(da, int_cmp) == 4);
+    for (int i = 0; i < 4; i++) assert(*(int*)da_get(da, (size_t)i) == i + 1);
+    da_free(da);
+    printf("da_unique_sorted passed.\n");
+
+    // Test da_dedup (keeps first occurrences, in order)
+    int v[] = {5, 3, 5, 1, 3, 3, 7, 1};
+    da = da_new_from_array(sizeof(int), 8, v, int_copier);
+    assert(da_dedup(da, int_cmp, int_hasher) == 4);
+    assert(*(int*)da_get(da, 0) == 5);
+    assert(*(int*)da_get(da, 1) == 3);
+    assert(*(int*)da_get(da, 2) == 1);
+    assert(*(int*)da_get(da, 3) == 7);
+    da_free(da);
+
+    // Larger input, forces probing chains in the scratch table.
+    da = da_new(sizeof(int));
+    da->copier = int_copier;
+    for (int i = 0; i < 1000; i++) {
+        int x = i % 97;
+        da_push(da, &x);
+    }
+    assert(da_dedup(da, int_cmp, int_hasher) == 97);
+    for (int i = 0; i < 97; i++) assert(*(int*)da_get(da, (size_t)i) == i);
+    da_free(da);
+    printf("da_dedup passed.\n");
+
+    // Test da_group_by (Person grouped by id)
+    Person people[] = {
+        create_person(2, "a"), create_person(1, "b"), create_person(2, "c"),
+        create_person(3, "d"), create_person(1, "e"),  //
+    };
+    DArray* src = da_new_from_array(sizeof(Person), 5, people, person_copier);
+    src->deallocator = person_deallocator;
+
+    DArray* offsets = NULL;
+    DArray* grouped = da_group_by(src, person_cmp_by_id, person_id_hasher, &offsets);
+    assert(grouped != NULL && offsets != NULL);
+    assert(da_length(grouped) == 5);
+    assert(da_length(offsets) == 4);  // 3 groups
+
+    size_t* off = (size_t*)da_raw(offsets);
+    assert(off[0] == 0 && off[1] == 2 && off[2] == 4 && off[3] == 5);
+    assert(strcmp(((Person*)da_get(grouped, 0))->name, "a") == 0);
+    assert(strcmp(((Person*)da_get(grouped, 1))->name, "c") == 0);
+    assert(strcmp(((Person*)da_get(grouped, 2))->name, "b") == 0);
+    assert(strcmp(((Person*)da_get(grouped, 3))->name, "e") == 0);
+    assert(((Person*)da_get(grouped, 4))->id == 3);
+    da_free(grouped);
+    da_free(offsets);
+    printf("da_group_by passed.\n");
+
+    // Test da_count_by_key
+    DArray* counts = NULL;
+    DArray* keys = da_count_by_key(src, person_cmp_by_id, person_id_hasher, &counts);
+    assert(keys != NULL && counts != NULL);
+    assert(da_length(keys) == 3 && da_length(counts) == 3);
+    assert(((Person*)da_get(keys, 0))->id == 2 && *(size_t*)da_get(counts, 0) == 2);
+    assert(((Person*)da_get(keys, 1))->id == 1 && *(size_t*)da_get(counts, 1) == 2);
+    assert(((Person*)da_get(keys, 2))->id == 3 && *(size_t*)da_get(counts, 2) == 1);
+    da_free(keys);
+    da_free(counts);
+    printf("da_count_by_key passed.\n");
+
+    da_free(src);
+    for (size_t i = 0; i < 5; i++) destroy_person(people[i]);
+
+    printf("Test Deduplication & Grouping done.\n\n");
+}
+// ---
+
 // Transformation function for map: int -> struct
 typedef struct {
     int value;
@@ -696,9 +935,11 @@ int main() {
     test_setters();
     test_insertion_deletion();
     test_resizing();
+    test_small_buffer();
     test_searching();
     test_order_manipulation();
     test_concatenation();
+    test_dedup_grouping();
     test_functional_methods();
     test_default_fns();
 
@@ -0,0 +1,423 @@
+#define _DEFAULT_SOURCE
+
+#include "../lib/geometry.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+void point_f_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(Point2f));
+}
+
+void point_d_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(Point2d));
+}
+
+uint64_t xorshift(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state;
+}
+
+double random_unit(uint64_t* state) {
+    return (double)(xorshift(state) >> 11) / 9007199254740992.0;
+}
+
+DArray* random_points_d(size_t n, double scale, uint64_t* state) {
+    DArray* da = da_new(sizeof(Point2d));
+    da->copier = point_d_copier;
+
+    for (size_t i = 0; i < n; i++) {
+        Point2d p = {(random_unit(state) - 0.5) * scale, (random_unit(state) - 0.5) * scale};
+        da_push(da, &p);
+    }
+
+    return da;
+}
+
+DArray* random_points_f(size_t n, float scale, uint64_t* state) {
+    DArray* da = da_new(sizeof(Point2f));
+    da->copier = point_f_copier;
+
+    for (size_t i = 0; i < n; i++) {
+        Point2f p = {((float)random_unit(state) - 0.5f) * scale, ((float)random_unit(state) - 0.5f) * scale};
+        da_push(da, &p);
+    }
+
+    return da;
+}
+
+Point2d load(DArray* da, size_t i) {
+    if (da->element_size == sizeof(Point2f)) {
+        Point2f* p = (Point2f*)da_get(da, i);
+        return (Point2d){p->x, p->y};
+    }
+
+    return *(Point2d*)da_get(da, i);
+}
+
+int point_cmp(const void* a, const void* b) {
+    const Point2d* p = (const Point2d*)a;
+    const Point2d* q = (const Point2d*)b;
+
+    if (p->x != q->x) return (p->x > q->x) - (p->x < q->x);
+    return (p->y > q->y) - (p->y < q->y);
+}
+
+__extension__ typedef __int128 i128;
+
+// Exact orientation of integer-grid points, |coords| < 2^52
+int orient_i128(int64_t ax, int64_t ay, int64_t bx, int64_t by, int64_t cx, int64_t cy) {
+    i128 det = (i128)(ax - cx) * (by - cy) - (i128)(ay - cy) * (bx - cx);
+    return (det > 0) - (det < 0);
+}
+
+// Checks that `hull` is strictly convex, counter-clockwise, and contains every point of `pts`.
+void check_hull(DArray* pts, DArray* hull) {
+    const size_t h = hull->length;
+
+    if (h >= 3) {
+        for (size_t i = 0; i < h; i++) {
+            Point2d a = load(hull, i), b = load(hull, (i + 1) % h), c = load(hull, (i + 2) % h);
+            assert(geo_orient2d(&a, &b, &c) > 0);
+        }
+
+        for (size_t k = 0; k < pts->length; k++) {
+            Point2d p = load(pts, k);
+
+            for (size_t i = 0; i < h; i++) {
+                Point2d a = load(hull, i), b = load(hull, (i + 1) % h);
+                assert(geo_orient2d(&a, &b, &p) >= 0);
+            }
+        }
+    }
+
+    // Starts at the smallest (x, y)
+    for (size_t k = 0; k < pts->length; k++) {
+        Point2d p = load(pts, k), first = load(hull, 0);
+        assert(point_cmp(&first, &p) <= 0);
+    }
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Test Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+void test_sort() {
+    printf("--- Test Radix Sort ---\n");
+
+    uint64_t state = 0x1111222233334444ULL;
+
+    DArray* d = random_points_d(20000, 1e6, &state);
+    DArray* f = random_points_f(20000, 1e3f, &state);
+
+    // Duplicated x values exercise the secondary key
+    for (size_t i = 0; i < 20000; i += 3) {
+        ((Point2d*)da_get(d, i))->x = 42.0;
+        ((Point2f*)da_get(f, i))->x = -7.5f;
+    }
+
+    Point2d* ref = malloc(20000 * sizeof(Point2d));
+    for (size_t i = 0; i < 20000; i++) ref[i] = load(d, i);
+    qsort(ref, 20000, sizeof(Point2d), point_cmp);
+
+    assert(geo_sort(d));
+    for (size_t i = 0; i < 20000; i++) {
+        Point2d p = load(d, i);
+        assert(p.x == ref[i].x && p.y == ref[i].y);
+    }
+
+    for (size_t i = 0; i < 20000; i++) ref[i] = load(f, i);
+    qsort(ref, 20000, sizeof(Point2d), point_cmp);
+
+    assert(geo_sort(f));
+    for (size_t i = 0; i < 20000; i++) {
+        Point2d p = load(f, i);
+        assert(p.x == ref[i].x && p.y == ref[i].y);
+    }
+
+    free(ref);
+    da_free(d);
+    da_free(f);
+
+    DArray* bad = da_new(sizeof(int));
+    assert(!geo_sort(bad));
+    da_free(bad);
+
+    printf("Test Radix Sort done.\n\n");
+}
+
+void test_orient() {
+    printf("--- Test Robust Orientation ---\n");
+
+    // Classic failure case of the naive determinant
+    Point2d a = {0.5, 0.5}, b = {12.0, 12.0}, c = {24.0, 24.0};
+    assert(geo_orient2d(&a, &b, &c) == 0);
+
+    c.y = nextafter(24.0, 25.0);
+    assert(geo_orient2d(&a, &b, &c) == 1);
+    c.y = nextafter(24.0, 23.0);
+    assert(geo_orient2d(&a, &b, &c) == -1);
+
+    for (int i = 0; i < 256; i++) {
+        Point2d p = {0.5 + (double)i * 0x1p-52, 0.5};
+        Point2d q = {12.0, 12.0}, r = {24.0, 24.0};
+        // p moves right of the diagonal: clockwise
+        assert(geo_orient2d(&p, &q, &r) == (i == 0 ? 0 : -1));
+    }
+
+    // Near-collinear triples on a fine grid, checked against 128-bit integers
+    uint64_t state = 0x9999AAAABBBBCCCCULL;
+    size_t exact_paths = 0;
+
+    for (int t = 0; t < 100000; t++) {
+        const int64_t lim = (int64_t)1 << 50;
+        int64_t ax = (int64_t)(xorshift(&state) % (uint64_t)lim) - lim / 2;
+        int64_t ay = (int64_t)(xorshift(&state) % (uint64_t)lim) - lim / 2;
+        int64_t bx = (int64_t)(xorshift(&state) % (uint64_t)lim) - lim / 2;
+        int64_t by = (int64_t)(xorshift(&state) % (uint64_t)lim) - lim / 2;
+
+        // c on the line through a and b (up to rounding), nudged by a few units
+        const int64_t s = (int64_t)(xorshift(&state) % 1024);
+        int64_t cx = ax + (bx - ax) / 1024 * s + (int64_t)(xorshift(&state) % 5) - 2;
+        int64_t cy = ay + (by - ay) / 1024 * s + (int64_t)(xorshift(&state) % 5) - 2;
+
+        const double scale = 0x1p-30;
+        Point2d pa = {(double)ax * scale, (double)ay * scale};
+        Point2d pb = {(double)bx * scale, (double)by * scale};
+        Point2d pc = {(double)cx * scale, (double)cy * scale};
+
+        const int expected = orient_i128(ax, ay, bx, by, cx, cy);
+        assert(geo_orient2d(&pa, &pb, &pc) == expected);
+
+        const double naive = (pa.x - pc.x) * (pb.y - pc.y) - (pa.y - pc.y) * (pb.x - pc.x);
+        if (((naive > 0) - (naive < 0)) != expected) exact_paths++;
+    }
+
+    // The naive determinant really is wrong on this data, so the exact fallback was exercised
+    assert(exact_paths > 0);
+    printf("geo_orient2d fixed %zu naive sign errors.\n", exact_paths);
+
+    Point2f fa = {0.0f, 0.0f}, fb = {1.0f, 1.0f}, fc = {2.0f, nextafterf(2.0f, 3.0f)};
+    assert(geo_orient2d_f(&fa, &fb, &fc) == 1);
+
+    printf("Test Robust Orientation done.\n\n");
+}
+
+void test_kernels() {
+    printf("--- Test Batch Kernels ---\n");
+
+    uint64_t state = 0x4242424242424242ULL;
+
+    for (size_t n = 0; n < 40; n++) {
+        DArray* d = random_points_d(n, 100.0, &state);
+        DArray* f = random_points_f(n, 100.0f, &state);
+
+        Point2d qa = {1.0, 2.0}, qb = {-3.0, 5.0};
+        Point2f fa = {1.0f, 2.0f}, fb = {-3.0f, 5.0f};
+
+        double out_d[40], dist_d[40];
+        float out_f[40], dist_f[40];
+
+        geo_orient_batch_d(&qa, &qb, (const Point2d*)d->arr, n, out_d);
+        geo_dist2_batch_d(&qa, (const Point2d*)d->arr, n, dist_d);
+        geo_orient_batch_f(&fa, &fb, (const Point2f*)f->arr, n, out_f);
+        geo_dist2_batch_f(&fa, (const Point2f*)f->arr, n, dist_f);
+
+        for (size_t i = 0; i < n; i++) {
+            Point2d p = load(d, i);
+            assert(out_d[i] == (qb.x - qa.x) * (p.y - qa.y) - (qb.y - qa.y) * (p.x - qa.x));
+            assert(dist_d[i] == (p.x - qa.x) * (p.x - qa.x) + (p.y - qa.y) * (p.y - qa.y));
+
+            Point2f* pf = (Point2f*)da_get(f, i);
+            const float ox = pf->x - fa.x, oy = pf->y - fa.y;
+            assert(out_f[i] == (fb.x - fa.x) * oy - (fb.y - fa.y) * ox);
+            assert(dist_f[i] == ox * ox + oy * oy);
+        }
+
+        da_free(d);
+        da_free(f);
+    }
+
+    printf("Test Batch Kernels done.\n\n");
+}
+
+void test_convex_hull() {
+    printf("--- Test Convex Hull ---\n");
+
+    uint64_t state = 0x7777888899990000ULL;
+
+    size_t sizes[] = {0, 1, 2, 3, 7, 8, 100, 5000};
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        DArray* d = random_points_d(sizes[s], 1000.0, &state);
+        DArray* hd = geo_convex_hull(d);
+        assert(hd != NULL && hd->element_size == sizeof(Point2d));
+        assert(hd->length == (sizes[s] < 3 ? sizes[s] : hd->length));
+        check_hull(d, hd);
+
+        DArray* f = random_points_f(sizes[s], 1000.0f, &state);
+        DArray* hf = geo_convex_hull(f);
+        assert(hf != NULL && hf->element_size == sizeof(Point2f));
+        check_hull(f, hf);
+
+        // The result is a regular array
+        Point2d extra = {0.0, 0.0};
+        assert(da_push(hd, &extra));
+
+        da_free(d);
+        da_free(hd);
+        da_free(f);
+        da_free(hf);
+    }
+
+    printf("geo_convex_hull (random) passed.\n");
+
+    // Grid with heavy collinearity and duplicates: only the 4 corners remain
+    DArray* grid = da_new(sizeof(Point2d));
+    grid->copier = point_d_copier;
+    for (int rep = 0; rep < 3; rep++) {
+        for (int i = 0; i < 30; i++) {
+            for (int j = 0; j < 30; j++) {
+                Point2d p = {(double)i, (double)j};
+                da_push(grid, &p);
+            }
+        }
+    }
+
+    DArray* hull = geo_convex_hull(grid);
+    assert(hull->length == 4);
+    Point2d c0 = load(hull, 0), c1 = load(hull, 1), c2 = load(hull, 2), c3 = load(hull, 3);
+    assert(c0.x == 0 && c0.y == 0 && c1.x == 29 && c1.y == 0);
+    assert(c2.x == 29 && c2.y == 29 && c3.x == 0 && c3.y == 29);
+    da_free(hull);
+    da_free(grid);
+
+    // All points on one line, and all points equal
+    DArray* line = da_new(sizeof(Point2d));
+    line->copier = point_d_copier;
+    for (int i = 0; i < 50; i++) {
+        Point2d p = {(double)(i * 7 % 50), (double)(i * 7 % 50 * 3)};
+        da_push(line, &p);
+    }
+
+    hull = geo_convex_hull(line);
+    assert(hull->length == 2);
+    da_free(hull);
+
+    da_clear(line);
+    for (int i = 0; i < 20; i++) {
+        Point2d p = {3.0, -3.0};
+        da_push(line, &p);
+    }
+
+    hull = geo_convex_hull(line);
+    assert(hull->length == 1);
+    da_free(hull);
+    da_free(line);
+
+    // Points on a circle are all hull vertices
+    DArray* circle = da_new(sizeof(Point2d));
+    circle->copier = point_d_copier;
+    for (int i = 0; i < 1000; i++) {
+        Point2d p = {cos(i * 2 * M_PI / 1000) * 1e3, sin(i * 2 * M_PI / 1000) * 1e3};
+        da_push(circle, &p);
+    }
+
+    hull = geo_convex_hull(circle);
+    check_hull(circle, hull);
+    assert(hull->length > 990);
+    da_free(hull);
+    da_free(circle);
+
+    printf("Test Convex Hull done.\n\n");
+}
+
+void test_closest_pair() {
+    printf("--- Test Closest Pair ---\n");
+
+    uint64_t state = 0x1234ABCD5678EF90ULL;
+
+    size_t sizes[] = {2, 3, 4, 5, 17, 100, 3000};
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (int type = 0; type < 2; type++) {
+            DArray* pts = type ? random_points_f(sizes[s], 1000.0f, &state) : random_points_d(sizes[s], 1000.0, &state);
+
+            double best = INFINITY;
+            for (size_t i = 0; i < pts->length; i++) {
+                for (size_t j = i + 1; j < pts->length; j++) {
+                    Point2d p = load(pts, i), q = load(pts, j);
+                    double d2 = (p.x - q.x) * (p.x - q.x) + (p.y - q.y) * (p.y - q.y);
+                    if (d2 < best) best = d2;
+                }
+            }
+
+            size_t i, j;
+            double d2;
+            assert(geo_closest_pair(pts, &i, &j, &d2));
+            assert(i < j && j < pts->length);
+            assert(d2 == best);
+
+            Point2d p = load(pts, i), q = load(pts, j);
+            assert((p.x - q.x) * (p.x - q.x) + (p.y - q.y) * (p.y - q.y) == best);
+
+            da_free(pts);
+        }
+    }
+
+    printf("geo_closest_pair (random) passed.\n");
+
+    // A duplicate is found at distance 0
+    DArray* pts = random_points_d(1000, 10.0, &state);
+    Point2d dup = load(pts, 123);
+    da_set(pts, 877, &dup);
+
+    size_t i, j;
+    double d2;
+    assert(geo_closest_pair(pts, &i, &j, &d2));
+    assert(i == 123 && j == 877 && d2 == 0.0);
+
+    // Vertical line: every point shares x
+    da_clear(pts);
+    for (int k = 0; k < 500; k++) {
+        Point2d p = {1.0, (double)((k * 37) % 500) * 2.0 + (k == 250 ? 0.5 : 0.0)};
+        da_push(pts, &p);
+    }
+    assert(geo_closest_pair(pts, &i, &j, &d2));
+    assert(d2 == 2.25);  // 500.5 sits between 498 and 502
+
+    DArray* one = random_points_d(1, 1.0, &state);
+    assert(!geo_closest_pair(one, &i, &j, &d2));
+
+    da_free(one);
+    da_free(pts);
+
+    printf("Test Closest Pair done.\n\n");
+}
+
+int main() {
+    printf("Starting Geometry Test Suite...\n\n");
+
+    test_sort();
+    test_orient();
+    test_kernels();
+    test_convex_hull();
+    test_closest_pair();
+
+    printf("All tests passed!\n");
+
+    return 0;
+}
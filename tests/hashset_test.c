@@ -123,12 +123,65 @@ void test_iterator() {
     hs_free(hs);
 }
 
+void test_stats() {
+    HSet *hs = hs_new(sizeof(int), int_cmp, int_hasher, int_copier, int_deallocator);
+
+    for (int i = 0; i < 1000; i++) hs_insert(hs, &i);
+    for (int i = 0; i < 2000; i++) hs_contains(hs, &i);
+
+    HSStats stats = hs_stats(hs);
+
+#ifdef HS_STATS
+    assert(stats.enabled);
+    assert(stats.hits >= 1000);
+    assert(stats.misses >= 2000);  // 1000 inserts + 1000 absent lookups
+    assert(stats.resizes > 0);
+    assert(stats.max_chain >= 1);
+    assert(stats.node_bytes == 1000 * sizeof(HSNode));
+    assert(stats.key_bytes == 1000 * sizeof(int));
+    assert(stats.bucket_bytes == hs->capacity * sizeof(HSNode *));
+    assert(stats.hash_calls >= 3000);
+
+    uint64_t lookups = 0;
+    for (size_t i = 0; i < HS_STATS_PROBE_BUCKETS; i++) lookups += stats.probe_histogram[i];
+    assert(lookups == stats.hits + stats.misses);
+
+    hs_clear(hs);
+    assert(hs_count(hs) == 0);
+    assert(hs_stats(hs).node_bytes == 0);
+#else
+    assert(!stats.enabled);
+    assert(stats.hits == 0 && stats.resizes == 0);
+
+    hs_clear(hs);
+    assert(hs_count(hs) == 0);
+#endif
+
+    int x = 5;
+    assert(!hs_contains(hs, &x));
+    assert(hs_insert(hs, &x));
+
+    FILE *f = tmpfile();
+    hs_fprint_stats_json(f, hs);
+    rewind(f);
+
+    char buf[1024] = {0};
+    size_t read = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+
+    assert(read > 0 && buf[0] == '{' && buf[read - 1] == '}');
+    assert(strstr(buf, "\"count\": 1") != NULL);
+
+    hs_free(hs);
+}
+
 int main() {
     test_basic_insert();
     test_remove();
     test_copy_and_eq();
     test_set_operations();
     test_iterator();
+    test_stats();
 
     printf("All tests passed!\n");
     return 0;
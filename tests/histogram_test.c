@@ -0,0 +1,122 @@
+#include "histogram.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                               Test Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+// `reported` must be within the relative error of a `precision_bits` histogram above `exact`.
+void assert_close(uint64_t reported, uint64_t exact, unsigned precision_bits) {
+    assert(reported >= exact);
+    assert((double)(reported - exact) <= (double)exact / (double)(1u << (precision_bits - 1)));
+}
+
+void test_basic() {
+    printf("--- Test Basic Recording ---\n");
+
+    assert(hdr_new(1) == NULL);
+    assert(hdr_new(17) == NULL);
+
+    HdrHist* h = hdr_new(7);
+    assert(h != NULL);
+    assert(hdr_count(h) == 0);
+    assert(hdr_percentile(h, 50.0) == 0);
+    assert(hdr_mean(h) == 0.0);
+
+    // Small values are exact.
+    for (uint64_t v = 1; v <= 100; v++) hdr_record(h, v);
+
+    assert(hdr_count(h) == 100);
+    assert(hdr_min(h) == 1);
+    assert(hdr_max(h) == 100);
+    assert(hdr_percentile(h, 50.0) == 50);
+    assert(hdr_percentile(h, 99.0) == 99);
+    assert(hdr_percentile(h, 100.0) == 100);
+    assert(hdr_percentile(h, 0.0) == 1);
+    assert(hdr_mean(h) == 50.5);
+    printf("exact range passed.\n");
+
+    // Large values stay within the relative error, across the whole range.
+    hdr_reset(h);
+    assert(hdr_count(h) == 0);
+
+    for (uint64_t v = 1000; v <= 1000000; v += 1000) hdr_record(h, v);
+
+    assert_close(hdr_percentile(h, 50.0), 500000, 7);
+    assert_close(hdr_percentile(h, 99.0), 990000, 7);
+    assert_close(hdr_percentile(h, 99.9), 999000, 7);
+    assert(hdr_max(h) == 1000000);
+
+    hdr_record(h, UINT64_MAX);
+    assert(hdr_max(h) == UINT64_MAX);
+    assert(hdr_percentile(h, 100.0) == UINT64_MAX);
+    printf("log-linear range passed.\n");
+
+    hdr_record_n(h, 5, 10);
+    assert(hdr_count(h) == 1000 + 1 + 10);
+    assert(hdr_min(h) == 5);
+
+    hdr_free(h);
+
+    printf("Test Basic Recording done.\n\n");
+}
+
+void test_merge() {
+    printf("--- Test Merge ---\n");
+
+    HdrHist* a = hdr_new(5);
+    HdrHist* b = hdr_new(5);
+    HdrHist* all = hdr_new(5);
+    HdrHist* other = hdr_new(6);
+
+    for (uint64_t v = 0; v < 50000; v++) {
+        uint64_t x = v * v % 100003;
+
+        hdr_record((v & 1) ? a : b, x);
+        hdr_record(all, x);
+    }
+
+    assert(!hdr_merge(a, other));
+    assert(hdr_merge(a, b));
+
+    assert(hdr_count(a) == hdr_count(all));
+    assert(hdr_min(a) == hdr_min(all));
+    assert(hdr_max(a) == hdr_max(all));
+    assert(memcmp(a->counts, all->counts, a->counts_length * sizeof(uint64_t)) == 0);
+
+    double ps[] = {10.0, 50.0, 90.0, 99.0, 99.9};
+    for (size_t i = 0; i < 5; i++) assert(hdr_percentile(a, ps[i]) == hdr_percentile(all, ps[i]));
+
+    FILE* f = tmpfile();
+    hdr_fprint_summary(f, a, "ns");
+    rewind(f);
+
+    char buf[256] = {0};
+    assert(fgets(buf, sizeof(buf), f) != NULL);
+    assert(strstr(buf, "count=50000") != NULL && strstr(buf, "p99.9=") != NULL);
+    fclose(f);
+
+    hdr_free(a);
+    hdr_free(b);
+    hdr_free(all);
+    hdr_free(other);
+    printf("hdr_merge passed.\n");
+
+    printf("Test Merge done.\n\n");
+}
+
+int main() {
+    printf("Starting Histogram Test Suite...\n\n");
+
+    test_basic();
+    test_merge();
+
+    printf("All tests passed!\n");
+
+    return 0;
+}
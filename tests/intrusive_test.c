@@ -0,0 +1,236 @@
+#include "../lib/intrusive.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../lib/memstat.h"
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+// A user record linked into a list and a hash set at the same time.
+typedef struct {
+    int id;
+    char name[16];
+    IListNode lru;
+    IHSNode by_id;
+} Record;
+
+int record_cmp(const void* a, const void* b) {
+    return ((const Record*)a)->id - ((const Record*)b)->id;
+}
+
+uint64_t record_hash(const void* obj, uint64_t seed_0, uint64_t seed_1) {
+    uint64_t x = (uint64_t)((const Record*)obj)->id ^ seed_0;
+
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+
+    return x ^ seed_1;
+}
+
+// A deliberately terrible hasher, to exercise long chains.
+uint64_t constant_hash(const void* obj, uint64_t seed_0, uint64_t seed_1) {
+    (void)obj;
+    (void)seed_0;
+    (void)seed_1;
+
+    return 7;
+}
+
+// Collects the ids of `list` in order.
+size_t list_ids(const IList* list, int* out) {
+    size_t n = 0;
+
+    il_for_each(it, list) {
+        out[n++] = il_entry(it, Record, lru)->id;
+    }
+
+    return n;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Test Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+void test_list() {
+    printf("--- Test Intrusive List ---\n");
+
+    Record recs[6];
+    for (int i = 0; i < 6; i++) {
+        recs[i].id = i;
+        il_node_init(&recs[i].lru);
+    }
+
+    IList list;
+    il_init(&list);
+    assert(il_is_empty(&list));
+    assert(il_first(&list) == NULL && il_pop_front(&list) == NULL);
+
+    il_push_back(&list, &recs[1].lru);
+    il_push_back(&list, &recs[2].lru);
+    il_push_front(&list, &recs[0].lru);
+    il_insert_after(&list, &recs[2].lru, &recs[4].lru);
+    il_insert_before(&list, &recs[4].lru, &recs[3].lru);
+
+    int ids[8];
+    assert(list_ids(&list, ids) == 5 && il_length(&list) == 5);
+    for (int i = 0; i < 5; i++) assert(ids[i] == i);
+
+    assert(container_of(il_first(&list), Record, lru) == &recs[0]);
+    assert(il_entry(il_last(&list), Record, lru) == &recs[4]);
+    assert(il_next(&list, &recs[0].lru) == &recs[1].lru);
+    assert(il_next(&list, &recs[4].lru) == NULL);
+    assert(il_prev(&list, &recs[0].lru) == NULL);
+    printf("il_push/il_insert passed.\n");
+
+    // Move-to-front, as an LRU would
+    il_remove(&list, &recs[3].lru);
+    assert(!il_is_linked(&recs[3].lru) && il_is_linked(&recs[2].lru));
+    il_push_front(&list, &recs[3].lru);
+
+    assert(list_ids(&list, ids) == 5);
+    assert(ids[0] == 3 && ids[1] == 0 && ids[4] == 4);
+
+    assert(il_pop_back(&list) == &recs[4].lru);
+    assert(il_pop_front(&list) == &recs[3].lru);
+    assert(il_length(&list) == 3);
+
+    // Removing while iterating
+    il_for_each_safe(it, &list) {
+        if (il_entry(it, Record, lru)->id == 1) il_remove(&list, it);
+    }
+    assert(list_ids(&list, ids) == 2 && ids[0] == 0 && ids[1] == 2);
+    printf("il_remove/il_pop passed.\n");
+
+    IList other;
+    il_init(&other);
+    il_push_back(&other, &recs[5].lru);
+    il_push_back(&other, &recs[1].lru);
+
+    il_splice_back(&list, &other);
+    assert(il_is_empty(&other));
+    assert(list_ids(&list, ids) == 4 && il_length(&list) == 4);
+    assert(ids[0] == 0 && ids[1] == 2 && ids[2] == 5 && ids[3] == 1);
+
+    // Backward traversal still consistent after the splice
+    IListNode* node = il_last(&list);
+    for (int i = 3; i >= 0; i--) {
+        assert(il_entry(node, Record, lru)->id == ids[i]);
+        node = il_prev(&list, node);
+    }
+    assert(node == NULL);
+    printf("il_splice_back passed.\n");
+
+    printf("Test Intrusive List done.\n\n");
+}
+
+void test_hashset() {
+    printf("--- Test Intrusive Hash Set ---\n");
+
+    MSCounter before = ms_registry_get(MS_IHSET);
+
+    const int n = 5000;
+    Record* recs = (Record*)malloc((size_t)n * sizeof(Record));
+
+    IHSet* hs = ihs_new(offsetof(Record, by_id), record_cmp, record_hash);
+    assert(hs != NULL);
+    assert(ms_registry_get(MS_IHSET).containers == before.containers + 1);
+
+    for (int i = 0; i < n; i++) {
+        recs[i].id = i * 3;
+        snprintf(recs[i].name, sizeof(recs[i].name), "rec%d", i);
+        assert(ihs_insert(hs, &recs[i]));
+    }
+    assert(ihs_count(hs) == (size_t)n);
+
+    // Duplicates are rejected, the set keeps pointing to the original
+    Record dup = {.id = 30};
+    assert(!ihs_insert(hs, &dup));
+
+    for (int i = 0; i < n; i++) {
+        Record key = {.id = i * 3};
+        assert(ihs_find(hs, &key) == &recs[i]);
+
+        key.id = i * 3 + 1;
+        assert(ihs_find(hs, &key) == NULL);
+    }
+    printf("ihs_insert/ihs_find passed.\n");
+
+    // Remove by key, then by identity
+    Record key = {.id = 30};
+    Record* removed = (Record*)ihs_remove(hs, &key);
+    assert(removed == &recs[10] && strcmp(removed->name, "rec10") == 0);
+    assert(ihs_remove(hs, &key) == NULL);
+
+    assert(ihs_remove_obj(hs, &recs[11]));
+    assert(!ihs_remove_obj(hs, &recs[11]));
+    assert(ihs_count(hs) == (size_t)n - 2);
+
+    // The removed objects can be relinked without any copy
+    assert(ihs_insert(hs, &recs[10]));
+    assert(ihs_insert(hs, &recs[11]));
+    printf("ihs_remove/ihs_remove_obj passed.\n");
+
+    // Iteration sees every object exactly once, and tolerates unlinking the current one
+    IHSIterator it;
+    ihs_iter_init(&it, hs);
+
+    size_t seen = 0;
+    long long sum = 0;
+    for (Record* r; (r = (Record*)ihs_iter_next(&it));) {
+        seen++;
+        sum += r->id;
+        if (r->id % 2 == 0) assert(ihs_remove_obj(hs, r));
+    }
+    assert(seen == (size_t)n);
+    assert(sum == 3LL * (long long)n * (n - 1) / 2);
+    assert(ihs_count(hs) == (size_t)n / 2);
+    printf("ihs_iter passed.\n");
+
+    ihs_clear(hs);
+    assert(ihs_count(hs) == 0);
+    ihs_free(hs);
+
+    assert(ms_registry_get(MS_IHSET).containers == before.containers);
+    assert(ms_registry_get(MS_IHSET).bytes == before.bytes);
+
+    // Presized: no bucket allocation while inserting, even with a single long chain
+    hs = ihs_new_with_capacity(offsetof(Record, by_id), record_cmp, constant_hash, (size_t)n);
+    size_t capacity = hs->capacity;
+
+    for (int i = 0; i < 200; i++) assert(ihs_insert(hs, &recs[i]));
+    for (int i = 0; i < 200; i += 2) assert(ihs_remove(hs, &recs[i]) == &recs[i]);
+    for (int i = 1; i < 200; i += 2) assert(ihs_find(hs, &recs[i]) == &recs[i]);
+
+    assert(hs->capacity == capacity);
+    assert(ihs_count(hs) == 100);
+    assert(ihs_reserve(hs, 4 * (size_t)n) && hs->capacity > capacity);
+    for (int i = 1; i < 200; i += 2) assert(ihs_find(hs, &recs[i]) == &recs[i]);
+
+    ihs_free(hs);
+    free(recs);
+    printf("ihs_new_with_capacity/ihs_reserve passed.\n");
+
+    printf("Test Intrusive Hash Set done.\n\n");
+}
+
+int main() {
+    printf("Starting Intrusive Containers Test Suite...\n\n");
+
+    test_list();
+    test_hashset();
+
+    printf("All tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,311 @@
+#include "../lib/itree.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+// A genomic-style feature: half-open coordinates plus a label.
+typedef struct {
+    int64_t start;
+    int64_t end;
+    int label;
+} Feature;
+
+void feature_bounds(const void* e, int64_t* start, int64_t* end) {
+    *start = ((const Feature*)e)->start;
+    *end = ((const Feature*)e)->end;
+}
+
+void feature_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(Feature));
+}
+
+int live_labels = 0;
+
+void label_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(int));
+    live_labels++;
+}
+
+void label_deallocator(void* k) {
+    (void)k;
+    live_labels--;
+}
+
+uint64_t xorshift(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state;
+}
+
+bool overlaps(const Feature* f, int64_t lo, int64_t hi) {
+    return f->start < hi && lo < f->end;
+}
+
+// Checks the heap order and the subtree maxima; returns the subtree maximum end.
+int64_t check_subtree(const ITNode* node) {
+    if (!node) return INT64_MIN;
+
+    int64_t m = node->end;
+
+    if (node->left) {
+        assert(node->left->priority <= node->priority);
+        int64_t l = check_subtree(node->left);
+        if (l > m) m = l;
+    }
+
+    if (node->right) {
+        assert(node->right->priority <= node->priority);
+        int64_t r = check_subtree(node->right);
+        if (r > m) m = r;
+    }
+
+    assert(node->max_end == m);
+
+    return m;
+}
+
+typedef struct {
+    int64_t prev_start;
+    uint64_t label_sum;
+    size_t limit;
+} QueryState;
+
+bool tree_visit(int64_t start, int64_t end, void* value, void* ctx) {
+    QueryState* qs = (QueryState*)ctx;
+    (void)end;
+
+    assert(start >= qs->prev_start);
+    qs->prev_start = start;
+    qs->label_sum += (uint64_t)*(int*)value;
+
+    return --qs->limit > 0;
+}
+
+bool index_visit(int64_t start, int64_t end, size_t id, void* ctx) {
+    QueryState* qs = (QueryState*)ctx;
+    (void)end;
+
+    assert(start >= qs->prev_start);
+    qs->prev_start = start;
+    qs->label_sum += id;
+
+    return --qs->limit > 0;
+}
+
+DArray* random_features(size_t n, int64_t span, int64_t max_len, uint64_t* state) {
+    DArray* da = da_new(sizeof(Feature));
+    da->copier = feature_copier;
+
+    for (size_t i = 0; i < n; i++) {
+        Feature f;
+        f.start = (int64_t)(xorshift(state) % (uint64_t)span) - span / 2;
+        f.end = f.start + (int64_t)(xorshift(state) % (uint64_t)max_len);
+        f.label = (int)i;
+        da_push(da, &f);
+    }
+
+    return da;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Test Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+void test_tree_basic() {
+    printf("--- Test Interval Tree Basics ---\n");
+
+    ITree* it = itree_new(sizeof(int), label_copier, label_deallocator);
+    assert(itree_is_empty(it));
+
+    int v = 1;
+    void* a = itree_insert(it, 10, 20, &v);
+    v = 2;
+    void* b = itree_insert(it, 10, 20, &v);  // duplicate bounds, distinct interval
+    v = 3;
+    void* c = itree_insert(it, 15, 15, &v);  // empty interval
+    v = 4;
+    assert(itree_insert(it, 30, 25, &v) == NULL);
+
+    assert(a && b && c && a != b);
+    assert(itree_count(it) == 3);
+    assert(live_labels == 3);
+
+    int64_t s, e;
+    itree_bounds(b, &s, &e);
+    assert(s == 10 && e == 20 && *(int*)b == 2);
+
+    assert(itree_count_overlap(it, 0, 10) == 0);
+    assert(itree_count_overlap(it, 19, 21) == 2);
+    assert(itree_count_overlap(it, 14, 16) == 3);
+    assert(itree_count_overlap(it, 15, 16) == 2);  // [15, 15) only overlaps ranges strictly around it
+    assert(itree_count_overlap(it, 20, 30) == 0);
+    assert(itree_count_overlap(it, 12, 12) == 0);
+
+    assert(itree_erase(it, a));
+    assert(itree_count_overlap(it, 0, 100) == 2);
+    assert(itree_remove(it, 10, 20));
+    assert(!itree_remove(it, 10, 20));
+    assert(itree_count(it) == 1 && live_labels == 1);
+
+    itree_free(it);
+    assert(live_labels == 0);
+
+    // Bare intervals
+    ITree* bare = itree_new(0, NULL, NULL);
+    assert(itree_insert(bare, -5, 5, NULL) != NULL);
+    assert(itree_count_overlap(bare, 4, 6) == 1);
+    itree_free(bare);
+
+    printf("Test Interval Tree Basics done.\n\n");
+}
+
+void test_tree_random() {
+    printf("--- Test Interval Tree vs Linear Scan ---\n");
+
+    uint64_t state = 0x1234567887654321ULL;
+    DArray* ref = random_features(5000, 100000, 2000, &state);
+
+    ITree* it = itree_new(sizeof(int), label_copier, label_deallocator);
+    void** handles = malloc(ref->length * sizeof(void*));
+
+    for (size_t i = 0; i < ref->length; i++) {
+        Feature* f = (Feature*)da_get(ref, i);
+        handles[i] = itree_insert(it, f->start, f->end, &f->label);
+    }
+
+    check_subtree(it->root);
+
+    // Erase every third interval
+    for (size_t i = 0; i < ref->length; i += 3) {
+        assert(itree_erase(it, handles[i]));
+        ((Feature*)da_get(ref, i))->label = -1;
+    }
+
+    check_subtree(it->root);
+    assert(live_labels == (int)itree_count(it));
+
+    for (int q = 0; q < 500; q++) {
+        int64_t lo = (int64_t)(xorshift(&state) % 110000) - 55000;
+        int64_t hi = lo + (int64_t)(xorshift(&state) % 3000) + 1;
+
+        size_t expected = 0;
+        uint64_t expected_sum = 0;
+
+        for (size_t i = 0; i < ref->length; i++) {
+            Feature* f = (Feature*)da_get(ref, i);
+            if (f->label >= 0 && overlaps(f, lo, hi)) {
+                expected++;
+                expected_sum += (uint64_t)f->label;
+            }
+        }
+
+        QueryState qs = {INT64_MIN, 0, SIZE_MAX};
+        assert(itree_overlap(it, lo, hi, tree_visit, &qs) == expected);
+        assert(qs.label_sum == expected_sum);
+        assert(itree_count_overlap(it, lo, hi) == expected);
+
+        // Early stop
+        if (expected > 2) {
+            QueryState stop = {INT64_MIN, 0, 2};
+            assert(itree_overlap(it, lo, hi, tree_visit, &stop) == 2);
+        }
+    }
+
+    free(handles);
+    itree_free(it);
+    da_free(ref);
+    assert(live_labels == 0);
+
+    printf("Test Interval Tree vs Linear Scan done.\n\n");
+}
+
+void test_index() {
+    printf("--- Test Interval Index vs Linear Scan ---\n");
+
+    uint64_t state = 0xABCDEF0123456789ULL;
+
+    // Sizes around powers of two exercise the missing right subtrees
+    size_t sizes[] = {0, 1, 2, 3, 7, 8, 9, 31, 33, 1000, 4097};
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        DArray* ref = random_features(sizes[s], 50000, 3000, &state);
+
+        IIndex* idx = iidx_new(ref, feature_bounds);
+        assert(idx != NULL);
+        assert(iidx_count(idx) == sizes[s]);
+
+        for (size_t i = 1; i < idx->count; i++) assert(idx->entries[i - 1].start <= idx->entries[i].start);
+
+        for (int q = 0; q < 300; q++) {
+            int64_t lo = (int64_t)(xorshift(&state) % 60000) - 30000;
+            int64_t hi = lo + (int64_t)(xorshift(&state) % 2000) + 1;
+
+            size_t expected = 0;
+            uint64_t expected_sum = 0;
+
+            for (size_t i = 0; i < ref->length; i++) {
+                if (overlaps((Feature*)da_get(ref, i), lo, hi)) {
+                    expected++;
+                    expected_sum += i;
+                }
+            }
+
+            QueryState qs = {INT64_MIN, 0, SIZE_MAX};
+            assert(iidx_overlap(idx, lo, hi, index_visit, &qs) == expected);
+            assert(qs.label_sum == expected_sum);
+            assert(iidx_count_overlap(idx, lo, hi) == expected);
+        }
+
+        assert(iidx_count_overlap(idx, 5, 5) == 0);
+
+        iidx_free(idx);
+        da_free(ref);
+    }
+
+    printf("iidx queries passed.\n");
+
+    // Already sorted input, and rejection of reversed intervals
+    DArray* sorted = da_new(sizeof(Feature));
+    sorted->copier = feature_copier;
+    for (int i = 0; i < 100; i++) {
+        Feature f = {i * 10, i * 10 + 25, i};
+        da_push(sorted, &f);
+    }
+
+    IIndex* idx = iidx_new(sorted, feature_bounds);
+    assert(iidx_count_overlap(idx, 50, 51) == 3);
+    for (size_t i = 0; i < 100; i++) assert(idx->entries[i].id == i);
+    iidx_free(idx);
+
+    Feature bad = {10, 5, 0};
+    da_push(sorted, &bad);
+    assert(iidx_new(sorted, feature_bounds) == NULL);
+    da_free(sorted);
+
+    printf("Test Interval Index vs Linear Scan done.\n\n");
+}
+
+int main() {
+    printf("Starting Interval Tree Test Suite...\n\n");
+
+    test_tree_basic();
+    test_tree_random();
+    test_index();
+
+    printf("All tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,274 @@
+#include "../lib/kdtree.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+// A point carrying a payload after its coordinates.
+typedef struct {
+    float xyz[3];
+    int tag;
+} Tagged;
+
+size_t point_bytes = 0;
+
+void point_copier(void* dest, const void* src) {
+    memcpy(dest, src, point_bytes);
+}
+
+uint64_t xorshift(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state;
+}
+
+float random_coord(uint64_t* state) {
+    return (float)(xorshift(state) % 1000000) / 1000.0f;
+}
+
+DArray* random_points(size_t n, size_t dim, uint64_t* state) {
+    point_bytes = dim * sizeof(float);
+
+    DArray* da = da_new(point_bytes);
+    da->copier = point_copier;
+
+    float p[KD_MAX_DIM];
+    for (size_t i = 0; i < n; i++) {
+        for (size_t d = 0; d < dim; d++) p[d] = random_coord(state);
+        da_push(da, p);
+    }
+
+    return da;
+}
+
+float dist2(const float* a, const float* b, size_t dim) {
+    float s = 0.0f;
+    for (size_t d = 0; d < dim; d++) s += (a[d] - b[d]) * (a[d] - b[d]);
+    return s;
+}
+
+// The k smallest brute-force distances, sorted.
+void brute_knn(DArray* da, size_t dim, const float* q, size_t k, float* out) {
+    size_t found = 0;
+
+    for (size_t i = 0; i < da->length; i++) {
+        float d2 = dist2((const float*)da_get(da, i), q, dim);
+
+        if (found < k) {
+            found++;
+        } else if (d2 >= out[k - 1]) {
+            continue;
+        }
+
+        size_t j = found - 1;
+        for (; j > 0 && out[j - 1] > d2; j--) out[j] = out[j - 1];
+        out[j] = d2;
+    }
+}
+
+typedef struct {
+    size_t count;
+    size_t id_sum;
+    size_t limit;
+} RadiusState;
+
+bool radius_visit(const KDNeighbor* nb, void* ctx) {
+    RadiusState* rs = (RadiusState*)ctx;
+
+    rs->count++;
+    rs->id_sum += nb->id;
+
+    return rs->count < rs->limit;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Test Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+void test_knn() {
+    printf("--- Test kNN vs Brute Force ---\n");
+
+    uint64_t state = 0x0123456789ABCDEFULL;
+    size_t dims[] = {1, 2, 3, 8, 16};
+    size_t sizes[] = {0, 1, 5, 17, 1000, 20000};
+
+    for (size_t di = 0; di < sizeof(dims) / sizeof(dims[0]); di++) {
+        for (size_t si = 0; si < sizeof(sizes) / sizeof(sizes[0]); si++) {
+            const size_t dim = dims[di], n = sizes[si];
+            DArray* da = random_points(n, dim, &state);
+
+            KDTree* kd = kd_new(da, dim, 4);
+            assert(kd != NULL);
+            assert(kd_count(kd) == n && kd_dim(kd) == dim);
+
+            KDNeighbor out[10];
+            float expected[10];
+            float q[KD_MAX_DIM];
+
+            for (int t = 0; t < 50; t++) {
+                for (size_t d = 0; d < dim; d++) q[d] = random_coord(&state);
+
+                const size_t k = (size_t)t % 10 + 1;
+                const size_t found = kd_knn(kd, q, k, out);
+
+                assert(found == (k < n ? k : n));
+                brute_knn(da, dim, q, k, expected);
+
+                for (size_t i = 0; i < found; i++) {
+                    assert(out[i].dist2 == expected[i]);
+                    assert(dist2((const float*)da_get(da, out[i].id), q, dim) == out[i].dist2);
+                }
+            }
+
+            kd_free(kd);
+            da_free(da);
+        }
+    }
+
+    printf("kd_knn passed.\n");
+
+    // Many duplicates: every point on a 4x4 grid, repeated
+    point_bytes = 2 * sizeof(float);
+    DArray* grid = da_new(point_bytes);
+    grid->copier = point_copier;
+
+    for (int rep = 0; rep < 50; rep++) {
+        for (int i = 0; i < 16; i++) {
+            float p[2] = {(float)(i % 4), (float)(i / 4)};
+            da_push(grid, p);
+        }
+    }
+
+    KDTree* kd = kd_new(grid, 2, 1);
+    float q[2] = {1.1f, 2.0f};
+    KDNeighbor out[60];
+
+    assert(kd_knn(kd, q, 60, out) == 60);
+    for (size_t i = 0; i < 50; i++) {
+        const float* p = (const float*)da_get(grid, out[i].id);
+        assert(p[0] == 1.0f && p[1] == 2.0f);
+    }
+
+    kd_free(kd);
+    da_free(grid);
+
+    printf("kd_knn (duplicates) passed.\n");
+
+    // Coordinates embedded at the start of a larger element
+    DArray* tagged = da_new(sizeof(Tagged));
+    point_bytes = sizeof(Tagged);
+    tagged->copier = point_copier;
+
+    for (int i = 0; i < 100; i++) {
+        Tagged t = {{(float)i, 0.0f, 0.0f}, i * 10};
+        da_push(tagged, &t);
+    }
+
+    kd = kd_new(tagged, 3, 1);
+    float tq[3] = {41.6f, 0.0f, 0.0f};
+    assert(kd_knn(kd, tq, 1, out) == 1);
+    assert(((Tagged*)da_get(tagged, out[0].id))->tag == 420);
+
+    assert(kd_new(tagged, 5, 1) == NULL);
+    assert(kd_new(tagged, 0, 1) == NULL);
+
+    kd_free(kd);
+    da_free(tagged);
+
+    printf("Test kNN vs Brute Force done.\n\n");
+}
+
+void test_radius() {
+    printf("--- Test Radius Search ---\n");
+
+    uint64_t state = 0xFEEDFACECAFEBEEFULL;
+    const size_t dim = 3;
+    DArray* da = random_points(20000, dim, &state);
+    KDTree* kd = kd_new(da, dim, 2);
+
+    float q[3];
+    for (int t = 0; t < 100; t++) {
+        for (size_t d = 0; d < dim; d++) q[d] = random_coord(&state);
+        const float r = (float)(t % 10) * 10.0f + 1.0f;
+
+        size_t expected = 0, expected_sum = 0;
+        for (size_t i = 0; i < da->length; i++) {
+            if (dist2((const float*)da_get(da, i), q, dim) <= r * r) {
+                expected++;
+                expected_sum += i;
+            }
+        }
+
+        RadiusState rs = {0, 0, SIZE_MAX};
+        assert(kd_radius(kd, q, r, radius_visit, &rs) == expected);
+        assert(rs.count == expected && rs.id_sum == expected_sum);
+        assert(kd_radius(kd, q, r, NULL, NULL) == expected);
+
+        if (expected > 3) {
+            RadiusState stop = {0, 0, 3};
+            assert(kd_radius(kd, q, r, radius_visit, &stop) == 3);
+        }
+    }
+
+    kd_free(kd);
+    da_free(da);
+
+    printf("Test Radius Search done.\n\n");
+}
+
+void test_batch() {
+    printf("--- Test Batch Queries ---\n");
+
+    uint64_t state = 0x5555AAAA5555AAAAULL;
+    const size_t dim = 4, k = 5, nq = 333;
+    DArray* da = random_points(10000, dim, &state);
+    KDTree* kd = kd_new(da, dim, 8);
+
+    float* queries = malloc(nq * dim * sizeof(float));
+    for (size_t i = 0; i < nq * dim; i++) queries[i] = random_coord(&state);
+
+    KDNeighbor* batch = malloc(nq * k * sizeof(KDNeighbor));
+    KDNeighbor single[5];
+
+    size_t threads[] = {1, 3, 8, 1000};
+    for (size_t t = 0; t < 4; t++) {
+        memset(batch, 0, nq * k * sizeof(KDNeighbor));
+        assert(kd_knn_batch(kd, queries, nq, k, batch, threads[t]));
+
+        for (size_t i = 0; i < nq; i++) {
+            kd_knn(kd, queries + i * dim, k, single);
+            for (size_t j = 0; j < k; j++) assert(batch[i * k + j].dist2 == single[j].dist2);
+        }
+    }
+
+    free(queries);
+    free(batch);
+    kd_free(kd);
+    da_free(da);
+
+    printf("Test Batch Queries done.\n\n");
+}
+
+int main() {
+    printf("Starting k-d Tree Test Suite...\n\n");
+
+    test_knn();
+    test_radius();
+    test_batch();
+
+    printf("All tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,295 @@
+#include "../lib/matrix.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+uint64_t xorshift(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state;
+}
+
+// a matrix of values in [-1, 1)
+Matrix* random_matrix(size_t rows, size_t cols, uint64_t* state) {
+    Matrix* m = mat_new(rows, cols);
+
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < cols; j++) mat_set(m, i, j, (double)(xorshift(state) >> 11) * 0x1p-52 - 1.0);
+    }
+
+    return m;
+}
+
+// `alpha * a * b + beta * c` with the triple loop (`c` may be `NULL` when `beta` is 0)
+Matrix* naive_gemm(double alpha, const Matrix* a, const Matrix* b, double beta, const Matrix* c) {
+    Matrix* r = mat_new(a->rows, b->cols);
+
+    for (size_t i = 0; i < a->rows; i++) {
+        for (size_t j = 0; j < b->cols; j++) {
+            double sum = 0.0;
+            for (size_t p = 0; p < a->cols; p++) sum += mat_get(a, i, p) * mat_get(b, p, j);
+
+            mat_set(r, i, j, alpha * sum + (beta == 0.0 ? 0.0 : beta * mat_get(c, i, j)));
+        }
+    }
+
+    return r;
+}
+
+bool near(const Matrix* a, const Matrix* b, double tolerance) {
+    if (a->rows != b->rows || a->cols != b->cols) return false;
+
+    for (size_t i = 0; i < a->rows; i++) {
+        for (size_t j = 0; j < a->cols; j++) {
+            if (!(fabs(mat_get(a, i, j) - mat_get(b, i, j)) <= tolerance)) return false;
+        }
+    }
+
+    return true;
+}
+
+// the padding after each row must stay zero
+bool padding_clear(const Matrix* m) {
+    for (size_t i = 0; i < m->rows; i++) {
+        for (size_t j = m->cols; j < m->stride; j++) {
+            if (m->data[i * m->stride + j] != 0.0) return false;
+        }
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Test Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+void test_basics() {
+    printf("--- Test Basics ---\n");
+
+    assert(mat_new(0, 3) == NULL);
+    assert(mat_new(3, 0) == NULL);
+    assert(mat_new_from(2, 2, NULL) == NULL);
+
+    const double values[] = {1, 2, 3, 4, 5, 6};
+    Matrix* m = mat_new_from(2, 3, values);
+    assert(m->rows == 2 && m->cols == 3);
+    assert(m->stride % 8 == 0 && m->stride >= 3);
+    assert((uintptr_t)m->data % 64 == 0);
+    assert(mat_get(m, 1, 2) == 6.0);
+    assert(isnan(mat_get(m, 2, 0)) && isnan(mat_get(m, 0, 3)));
+    assert(mat_set(m, 0, 1, -2.0) && mat_get(m, 0, 1) == -2.0);
+    assert(!mat_set(m, 0, 3, 1.0));
+    assert(padding_clear(m));
+
+    Matrix* t = mat_transpose(m);
+    assert(t->rows == 3 && t->cols == 2);
+    assert(mat_get(t, 1, 0) == -2.0 && mat_get(t, 2, 1) == 6.0);
+
+    Matrix* id = mat_identity(3);
+    Matrix* p = mat_mul(m, id, 1);
+    assert(near(p, m, 0.0));
+    assert(mat_mul(m, m, 1) == NULL);
+
+    Matrix* s = mat_add(m, p);
+    Matrix* d = mat_sub(s, m);
+    assert(mat_get(s, 1, 1) == 10.0);
+    assert(near(d, m, 0.0));
+    assert(mat_add(m, t) == NULL);
+
+    // Blocked transpose over several 8x8 blocks and ragged edges
+    uint64_t state = 0x1234;
+    Matrix* big = random_matrix(19, 37, &state);
+    Matrix* bt = mat_transpose(big);
+    Matrix* btt = mat_transpose(bt);
+    assert(near(btt, big, 0.0));
+    assert(padding_clear(bt));
+
+    mat_free(m);
+    mat_free(t);
+    mat_free(id);
+    mat_free(p);
+    mat_free(s);
+    mat_free(d);
+    mat_free(big);
+    mat_free(bt);
+    mat_free(btt);
+    mat_free(NULL);
+
+    printf("Test Basics done.\n\n");
+}
+
+void test_gemm() {
+    printf("--- Test GEMM ---\n");
+
+    // Edges of the 6x8 tiles and of the KC / MC blocks
+    const size_t shapes[][3] = {{1, 1, 1},   {5, 7, 9},    {6, 8, 8},     {13, 300, 17},
+                                {100, 3, 41}, {97, 257, 65}, {200, 20, 130}};
+    const MatKernel kernels[] = {MAT_KERNEL_PORTABLE, MAT_KERNEL_AVX2};
+    const char* names[] = {"portable", "avx2"};
+    const MatKernel best = mat_kernel();
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+    assert(best != MAT_KERNEL_AUTO);
+
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        if (!mat_use_kernel(kernels[k])) {
+            printf("kernel %s not supported, skipped.\n", names[k]);
+            continue;
+        }
+        assert(mat_kernel() == kernels[k]);
+
+        for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+            Matrix* a = random_matrix(shapes[s][0], shapes[s][1], &state);
+            Matrix* b = random_matrix(shapes[s][1], shapes[s][2], &state);
+            Matrix* c = random_matrix(shapes[s][0], shapes[s][2], &state);
+            const double tolerance = 1e-12 * (double)shapes[s][1];
+
+            // Plain product, on one and several threads
+            Matrix* expected = naive_gemm(1.0, a, b, 0.0, NULL);
+            for (size_t threads = 1; threads <= 3; threads += 2) {
+                Matrix* p = mat_mul(a, b, threads);
+                assert(near(p, expected, tolerance));
+                assert(padding_clear(p));
+                mat_free(p);
+            }
+            mat_free(expected);
+
+            // Scaled accumulation into `c`
+            expected = naive_gemm(-0.5, a, b, 2.0, c);
+            assert(mat_gemm(-0.5, a, b, 2.0, c, 2));
+            assert(near(c, expected, tolerance));
+            mat_free(expected);
+
+            // `beta == 0` overwrites NaNs
+            mat_set(c, 0, 0, NAN);
+            expected = naive_gemm(3.0, a, b, 0.0, NULL);
+            assert(mat_gemm(3.0, a, b, 0.0, c, 1));
+            assert(near(c, expected, 3.0 * tolerance));
+            mat_free(expected);
+
+            mat_free(a);
+            mat_free(b);
+            mat_free(c);
+        }
+
+        printf("kernel %s passed.\n", names[k]);
+    }
+
+    assert(mat_use_kernel(MAT_KERNEL_AUTO));
+    assert(mat_kernel() == best);
+
+    // Shape mismatches and aliasing
+    Matrix* sq = mat_identity(4);
+    Matrix* r = mat_new(4, 3);
+    assert(!mat_gemm(1.0, sq, sq, 0.0, sq, 1));
+    assert(!mat_gemm(1.0, sq, sq, 0.0, r, 1));
+    assert(!mat_gemm(1.0, sq, r, 0.0, NULL, 1));
+    mat_free(sq);
+    mat_free(r);
+
+    printf("Test GEMM done.\n\n");
+}
+
+void test_strassen() {
+    printf("--- Test Strassen ---\n");
+
+    uint64_t state = 0xC0FFEE;
+
+    // Small products fall through to GEMM
+    Matrix* a = random_matrix(30, 20, &state);
+    Matrix* b = random_matrix(20, 10, &state);
+    Matrix* p = mat_mul_strassen(a, b, 1);
+    Matrix* expected = naive_gemm(1.0, a, b, 0.0, NULL);
+    assert(near(p, expected, 1e-12));
+    assert(mat_mul_strassen(b, b, 1) == NULL);
+
+    mat_free(a);
+    mat_free(b);
+    mat_free(p);
+    mat_free(expected);
+
+    // One level above the crossover, with every dimension odd to exercise the peeling
+    a = random_matrix(769, 771, &state);
+    b = random_matrix(771, 773, &state);
+    p = mat_mul_strassen(a, b, 2);
+    expected = mat_mul(a, b, 2);
+    assert(near(p, expected, 1e-9));
+    assert(padding_clear(p));
+
+    mat_free(a);
+    mat_free(b);
+    mat_free(p);
+    mat_free(expected);
+
+    printf("Test Strassen done.\n\n");
+}
+
+void test_chain() {
+    printf("--- Test Matrix Chain ---\n");
+
+    // The textbook example: ((A1 (A2 A3)) ((A4 A5) A6))
+    const size_t dims[] = {30, 35, 15, 5, 10, 20, 25};
+    size_t split[36];
+    assert(mat_chain_order(dims, 6, split) == 15125);
+    assert(split[0 * 6 + 5] == 2);
+    assert(split[0 * 6 + 2] == 0);
+    assert(split[3 * 6 + 5] == 4);
+    assert(mat_chain_order(dims, 1, NULL) == 0);
+    assert(mat_chain_order(NULL, 3, NULL) == UINT64_MAX);
+    assert(mat_chain_order(dims, 0, NULL) == UINT64_MAX);
+
+    uint64_t state = 0xABCDEF;
+    Matrix* ms[6];
+    for (size_t i = 0; i < 6; i++) ms[i] = random_matrix(dims[i], dims[i + 1], &state);
+
+    Matrix* expected = mat_copy(ms[0]);
+    for (size_t i = 1; i < 6; i++) {
+        Matrix* next = naive_gemm(1.0, expected, ms[i], 0.0, NULL);
+        mat_free(expected);
+        expected = next;
+    }
+
+    Matrix* product = mat_chain_mul((const Matrix* const*)ms, 6, 2);
+    assert(near(product, expected, 1e-9));
+
+    Matrix* single = mat_chain_mul((const Matrix* const*)ms, 1, 1);
+    assert(single != ms[0] && near(single, ms[0], 0.0));
+
+    // Mismatched neighbours
+    const Matrix* bad[] = {ms[0], ms[2]};
+    assert(mat_chain_mul(bad, 2, 1) == NULL);
+    assert(mat_chain_mul(NULL, 2, 1) == NULL);
+
+    for (size_t i = 0; i < 6; i++) mat_free(ms[i]);
+    mat_free(expected);
+    mat_free(product);
+    mat_free(single);
+
+    printf("Test Matrix Chain done.\n\n");
+}
+
+int main() {
+    printf("Starting Matrix Test Suite...\n\n");
+
+    test_basics();
+    test_gemm();
+    test_strassen();
+    test_chain();
+
+    printf("All tests passed!\n");
+
+    return 0;
+}
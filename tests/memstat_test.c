@@ -0,0 +1,165 @@
+#include "darray.h"
+#include "hashset.h"
+#include "memstat.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+int int_cmp(const void* a, const void* b) {
+    return *(const int*)a - *(const int*)b;
+}
+
+uint64_t int_hasher(const void* k, uint64_t s0, uint64_t s1) {
+    (void)s0;
+    (void)s1;
+    return (uint64_t)*(const int*)k * UINT64_C(0x9E3779B97F4A7C15);
+}
+
+void int_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(int));
+}
+
+void int_deallocator(void* k) {
+    free(k);
+}
+
+typedef struct {
+    char* name;
+} Named;
+
+void named_copier(void* dest, const void* src) {
+    const Named* s = (const Named*)src;
+    Named* d = (Named*)dest;
+
+    d->name = malloc(strlen(s->name) + 1);
+    strcpy(d->name, s->name);
+}
+
+void named_deallocator(void* k) {
+    free(((Named*)k)->name);
+}
+
+size_t named_owned_size(const void* k) {
+    return strlen(((const Named*)k)->name) + 1;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Test Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+void test_darray_usage() {
+    printf("--- Test DArray Memory Usage ---\n");
+
+    MSCounter before = ms_registry_get(MS_DARRAY);
+
+    DArray* da = da_new_with_capacity(sizeof(int), 100);
+    da->copier = int_copier;
+    for (int i = 0; i < 30; i++) da_push(da, &i);
+
+    MemUsage mu = da_memory_usage(da, NULL);
+    assert(mu.payload == 30 * sizeof(int));
+    assert(mu.slack == 70 * sizeof(int));
+    assert(mu.metadata == sizeof(DArray));
+    assert(mu.owned == 0);
+    assert(mu_total(&mu) >= 100 * sizeof(int) + sizeof(DArray));
+
+    MSCounter during = ms_registry_get(MS_DARRAY);
+    assert(during.containers == before.containers + 1);
+    assert(during.bytes == before.bytes + (int64_t)(sizeof(DArray) + 100 * sizeof(int)));
+
+    da_shrink(da);
+    assert(ms_registry_get(MS_DARRAY).bytes == before.bytes + (int64_t)(sizeof(DArray) + 30 * sizeof(int)));
+    assert(da_memory_usage(da, NULL).slack == 0);
+
+    da_free(da);
+    assert(ms_registry_get(MS_DARRAY).containers == before.containers);
+    assert(ms_registry_get(MS_DARRAY).bytes == before.bytes);
+
+    // Owned memory through copier-allocated fields
+    DArray* named = da_new(sizeof(Named));
+    named->copier = named_copier;
+    named->deallocator = named_deallocator;
+
+    Named a = {"alpha"}, b = {"be"};
+    da_push(named, &a);
+    da_push(named, &b);
+
+    assert(da_memory_usage(named, named_owned_size).owned == 6 + 3);
+    da_free(named);
+
+    printf("da_memory_usage passed.\n");
+
+    printf("Test DArray Memory Usage done.\n\n");
+}
+
+void test_hashset_usage() {
+    printf("--- Test HSet Memory Usage ---\n");
+
+    MSCounter before = ms_registry_get(MS_HSET);
+
+    HSet* hs = hs_new(sizeof(int), int_cmp, int_hasher, int_copier, int_deallocator);
+    for (int i = 0; i < 100; i++) hs_insert(hs, &i);
+
+    MemUsage mu = hs_memory_usage(hs, NULL);
+    assert(mu.payload == 100 * sizeof(int));
+    const size_t stats_bytes = hs->_stats ? sizeof(HSStats) : 0;  // only allocated with `HS_STATS`
+    assert(mu.slack + mu.metadata == hs->capacity * sizeof(HSNode*) + sizeof(HSet) + stats_bytes + 100 * sizeof(HSNode));
+    assert(mu.owned == 0);
+
+    MSCounter during = ms_registry_get(MS_HSET);
+    assert(during.containers == before.containers + 1);
+#ifdef HS_TRACK_NODES
+    const size_t node_bytes = 100 * (sizeof(HSNode) + sizeof(int));
+#else
+    const size_t node_bytes = 0;  // nodes stay out of the shared counters by default
+#endif
+    assert(during.bytes == before.bytes + (int64_t)(sizeof(HSet) + stats_bytes + hs->capacity * sizeof(HSNode*) + node_bytes));
+
+    for (int i = 0; i < 50; i++) hs_remove(hs, &i);
+    assert(hs_memory_usage(hs, NULL).payload == 50 * sizeof(int));
+
+    HSet* copy = hs_copy(hs);
+    assert(ms_registry_get(MS_HSET).containers == before.containers + 2);
+
+    hs_free(copy);
+    hs_free(hs);
+    assert(ms_registry_get(MS_HSET).containers == before.containers);
+    assert(ms_registry_get(MS_HSET).bytes == before.bytes);
+
+    printf("hs_memory_usage passed.\n");
+
+    // Registry JSON
+    FILE* f = tmpfile();
+    ms_fprint_registry_json(f);
+    rewind(f);
+
+    char buf[512] = {0};
+    size_t read = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+
+    assert(read > 0 && strstr(buf, "\"hashset\"") != NULL && strstr(buf, "\"total\"") != NULL);
+    printf("ms_fprint_registry_json passed.\n");
+
+    printf("Test HSet Memory Usage done.\n\n");
+}
+
+int main() {
+    printf("Starting Memory Accounting Test Suite...\n\n");
+
+    test_darray_usage();
+    test_hashset_usage();
+
+    printf("All tests passed!\n");
+
+    return 0;
+}
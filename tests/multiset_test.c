@@ -0,0 +1,231 @@
+#define _DEFAULT_SOURCE
+
+#include "../lib/multiset.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+size_t hash_calls = 0;
+
+int int_cmp(const void* a, const void* b) {
+    return *(const int*)a - *(const int*)b;
+}
+
+uint64_t int_hasher(const void* k, uint64_t s0, uint64_t s1) {
+    hash_calls++;
+
+    uint64_t x = (uint64_t)*(const int*)k ^ s0;
+    x *= 0x9E3779B97F4A7C15ULL;
+
+    return (x ^ (x >> 29)) + s1;
+}
+
+void int_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(int));
+}
+
+void int_deallocator(void* k) {
+    (void)k;
+}
+
+// Keys are `char*`, owned by the multiset.
+int str_cmp(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+uint64_t str_hasher(const void* k, uint64_t s0, uint64_t s1) {
+    uint64_t h = 1469598103934665603ULL ^ s0;
+
+    for (const char* s = *(char* const*)k; *s; s++) h = (h ^ (unsigned char)*s) * 1099511628211ULL;
+
+    return h ^ s1;
+}
+
+void str_copier(void* dest, const void* src) {
+    *(char**)dest = strdup(*(char* const*)src);
+}
+
+void str_deallocator(void* k) {
+    free(*(char**)k);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Test Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+void test_counts() {
+    printf("--- Test Counts ---\n");
+
+    HMultiset* hms = hms_new(sizeof(int), int_cmp, int_hasher, int_copier, int_deallocator);
+    assert(hms != NULL && hms_is_empty(hms));
+
+    // count(i) = i % 7 + 1
+    for (int i = 0; i < 5000; i++) {
+        for (int j = 0; j <= i % 7; j++) {
+            size_t c = hms_add(hms, &i, 1);
+            assert(c == (size_t)j + 1);
+        }
+    }
+    assert(hms_distinct(hms) == 5000);
+
+    size_t total = 0;
+    for (int i = 0; i < 5000; i++) {
+        assert(hms_count(hms, &i) == (size_t)(i % 7) + 1);
+        total += (size_t)(i % 7) + 1;
+    }
+    assert(hms_total(hms) == total);
+
+    int absent = -1;
+    assert(hms_count(hms, &absent) == 0 && !hms_contains(hms, &absent));
+    assert(hms_add(hms, &absent, 0) == 0 && !hms_contains(hms, &absent));
+    assert(hms_add(hms, &absent, 10) == 10 && hms_add(hms, &absent, 5) == 15);
+    printf("hms_add/hms_count passed.\n");
+
+    // A single probe per call: one hash each
+    hash_calls = 0;
+    int k = 42;
+    hms_add(hms, &k, 3);
+    hms_count(hms, &k);
+    hms_remove(hms, &k, 1);
+    assert(hash_calls == 3);
+
+    assert(hms_remove(hms, &absent, 4) == 4 && hms_count(hms, &absent) == 11);
+    assert(hms_remove(hms, &absent, SIZE_MAX) == 11 && !hms_contains(hms, &absent));
+    assert(hms_remove(hms, &absent, 1) == 0);
+
+    // Remove every other key entirely; backward shifts keep the rest reachable
+    for (int i = 0; i < 5000; i += 2) assert(hms_remove(hms, &i, 100) > 0);
+    assert(hms_distinct(hms) == 2500);
+
+    for (int i = 0; i < 5000; i++) {
+        size_t expected = i % 2 ? (size_t)(i % 7) + 1 + (i == 42 ? 2 : 0) : 0;
+        assert(hms_count(hms, &i) == expected);
+    }
+    printf("hms_remove passed.\n");
+
+    size_t it = 0, count, seen = 0, sum = 0;
+    for (const int* key; (key = (const int*)hms_next(hms, &it, &count));) {
+        assert(hms_count(hms, key) == count);
+        seen++;
+        sum += count;
+    }
+    assert(seen == hms_distinct(hms) && sum == hms_total(hms));
+    printf("hms_next passed.\n");
+
+    MemUsage mu = hms_memory_usage(hms, NULL);
+    assert(mu.payload == hms_distinct(hms) * sizeof(int));
+    assert(mu.payload + mu.slack + mu.metadata == sizeof(HMultiset) + hms->capacity * hms->stride);
+
+    hms_clear(hms);
+    assert(hms_is_empty(hms) && hms_total(hms) == 0);
+    hms_free(hms);
+    printf("hms_clear passed.\n");
+
+    printf("Test Counts done.\n\n");
+}
+
+void test_most_common() {
+    printf("--- Test Most Common ---\n");
+
+    HMultiset* hms = hms_new(sizeof(char*), str_cmp, str_hasher, str_copier, str_deallocator);
+
+    const char* words[] = {"the", "of", "and", "to", "a", "in", "is", "it"};
+    for (int i = 0; i < 8; i++) {
+        const char* w = words[i];
+        assert(hms_add(hms, &w, (size_t)(100 - i * 10)) == (size_t)(100 - i * 10));
+    }
+
+    // Noise: many rare keys
+    char buf[32];
+    for (int i = 0; i < 1000; i++) {
+        snprintf(buf, sizeof(buf), "w%d", i);
+        char* p = buf;
+        hms_add(hms, &p, (size_t)(i % 3) + 1);
+    }
+
+    HMSEntry top[5];
+    assert(hms_most_common(hms, 5, top) == 5);
+    for (int i = 0; i < 5; i++) {
+        assert(strcmp(*(char* const*)top[i].key, words[i]) == 0);
+        assert(top[i].count == (size_t)(100 - i * 10));
+    }
+
+    HMSEntry all[2000];
+    size_t n = hms_most_common(hms, 2000, all);
+    assert(n == hms_distinct(hms));
+    for (size_t i = 1; i < n; i++) assert(all[i - 1].count >= all[i].count);
+
+    assert(hms_most_common(hms, 0, top) == 0);
+    printf("hms_most_common passed.\n");
+
+    hms_free(hms);
+
+    printf("Test Most Common done.\n\n");
+}
+
+void test_merge() {
+    printf("--- Test Merge ---\n");
+
+    HMultiset* a = hms_new(sizeof(int), int_cmp, int_hasher, int_copier, int_deallocator);
+    HMultiset* b = hms_copy_metadata(a);
+    HMultiset* c = hms_new(sizeof(int), int_cmp, int_hasher, int_copier, int_deallocator);
+
+    for (int i = 0; i < 1000; i++) {
+        hms_add(a, &i, 1);
+        hms_add(b, &i, 2);
+        hms_add(c, &i, 4);
+    }
+    for (int i = 1000; i < 3000; i++) hms_add(b, &i, 1);
+
+    // Shared seeds: no hashing at all, even across resizes
+    hash_calls = 0;
+    assert(hms_merge(a, b));
+    assert(hash_calls == 0);
+
+    for (int i = 0; i < 3000; i++) assert(hms_count(a, &i) == (i < 1000 ? 3u : 1u));
+    assert(hms_total(a) == 1000 * 3 + 2000);
+
+    // Different seeds: the keys are rehashed
+    hash_calls = 0;
+    assert(hms_merge(a, c));
+    assert(hash_calls == hms_distinct(c));
+    for (int i = 0; i < 1000; i++) assert(hms_count(a, &i) == 7);
+
+    HMultiset* copy = hms_copy(a);
+    assert(copy->seed_0 == a->seed_0 && copy->capacity == a->capacity);
+    assert(hms_total(copy) == hms_total(a) && hms_distinct(copy) == hms_distinct(a));
+    for (int i = 0; i < 3000; i++) assert(hms_count(copy, &i) == hms_count(a, &i));
+
+    assert(!hms_merge(a, a));
+
+    hms_free(copy);
+    hms_free(a);
+    hms_free(b);
+    hms_free(c);
+    printf("hms_merge/hms_copy passed.\n");
+
+    printf("Test Merge done.\n\n");
+}
+
+int main() {
+    printf("Starting Multiset Test Suite...\n\n");
+
+    test_counts();
+    test_most_common();
+    test_merge();
+
+    printf("All tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,271 @@
+#include "../lib/ntheory.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+uint64_t xorshift(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state;
+}
+
+bool naive_is_prime(uint64_t n) {
+    if (n < 2) return false;
+    for (uint64_t d = 2; d * d <= n; d++) {
+        if (n % d == 0) return false;
+    }
+    return true;
+}
+
+uint64_t naive_powmod(uint64_t a, uint64_t e, uint64_t n) {
+    uint64_t r = 1 % n;
+    a %= n;
+    while (e) {
+        if (e & 1) r = (uint64_t)(((nt_u128)r * a) % n);
+        a = (uint64_t)(((nt_u128)a * a) % n);
+        e >>= 1;
+    }
+    return r;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Test Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+void test_reduction() {
+    printf("--- Test Montgomery & Barrett ---\n");
+
+    uint64_t state = 0x0123456789ABCDEFULL;
+    NTMont m;
+    NTBarrett b;
+
+    assert(!nt_mont_init(&m, 1) && !nt_mont_init(&m, 10) && !nt_mont_init(NULL, 7));
+    assert(!nt_barrett_init(&b, 1) && nt_barrett_init(&b, 2));
+
+    const uint64_t moduli[] = {3, 5, 7, 1000000007, 998244353, (1ULL << 61) - 1, UINT64_MAX, UINT64_MAX - 58,
+                               1ULL << 32, 1ULL << 63, 6, 12345678910ULL};
+
+    for (size_t i = 0; i < sizeof(moduli) / sizeof(moduli[0]); i++) {
+        const uint64_t n = moduli[i];
+        const bool odd = n & 1;
+
+        if (odd) assert(nt_mont_init(&m, n));
+        assert(nt_barrett_init(&b, n));
+
+        for (int t = 0; t < 2000; t++) {
+            uint64_t x = xorshift(&state) % n, y = xorshift(&state) % n;
+            if (t == 0) x = y = n - 1;  // largest product
+
+            const uint64_t expected = (uint64_t)(((nt_u128)x * y) % n);
+
+            assert(nt_mulmod(x, y, n) == expected);
+            assert(nt_barrett_mul(&b, x, y) == expected);
+
+            if (odd) {
+                assert(nt_mont_from(&m, nt_mont_to(&m, x)) == x);
+                assert(nt_mont_from(&m, nt_mont_mul(&m, nt_mont_to(&m, x), nt_mont_to(&m, y))) == expected);
+            }
+
+            const uint64_t e = xorshift(&state) >> (t % 64);
+            assert(nt_powmod(x, e, n) == naive_powmod(x, e, n));
+        }
+    }
+
+    assert(nt_powmod(5, 0, 7) == 1 && nt_powmod(0, 0, 8) == 1 && nt_powmod(3, 4, 1) == 0);
+
+    printf("Test Montgomery & Barrett done.\n\n");
+}
+
+void test_modular() {
+    printf("--- Test Modular Arithmetic ---\n");
+
+    assert(nt_gcd(0, 0) == 0 && nt_gcd(0, 9) == 9 && nt_gcd(12, 18) == 6 && nt_gcd(17, 5) == 1);
+    assert(nt_gcd(1ULL << 40, 3ULL << 20) == 1ULL << 20);
+
+    uint64_t state = 0xFEEDFACECAFEBEEFULL;
+
+    const uint64_t moduli[] = {2, 97, 1000000007, 1ULL << 20, 360, UINT64_MAX, (1ULL << 61) - 1};
+    for (size_t i = 0; i < sizeof(moduli) / sizeof(moduli[0]); i++) {
+        const uint64_t n = moduli[i];
+
+        for (int t = 0; t < 1000; t++) {
+            const uint64_t a = xorshift(&state);
+            const uint64_t inv = nt_invmod(a, n);
+
+            if (nt_gcd(a % n, n) == 1) {
+                assert(nt_mulmod(a, inv, n) == 1 % n);
+            } else {
+                assert(inv == 0);
+            }
+        }
+    }
+
+    assert(nt_invmod(3, 1) == 0 && nt_invmod(0, 7) == 0 && nt_invmod(4, 8) == 0);
+
+    printf("nt_invmod passed.\n");
+
+    // Batch inverses agree with single ones, odd and even moduli
+    const size_t count = 1000;
+    uint64_t* a = malloc(count * sizeof(uint64_t));
+    uint64_t* out = malloc(count * sizeof(uint64_t));
+
+    const uint64_t batch_moduli[] = {1000000007, (1ULL << 61) - 1, 1ULL << 40};
+    for (size_t i = 0; i < 3; i++) {
+        const uint64_t n = batch_moduli[i];
+
+        for (size_t j = 0; j < count; j++) {
+            do a[j] = xorshift(&state); while (nt_gcd(a[j] % n, n) != 1);
+        }
+
+        assert(nt_invmod_batch(a, count, n, out));
+        for (size_t j = 0; j < count; j++) assert(out[j] == nt_invmod(a[j], n));
+
+        a[count / 2] = n * 3;  // not invertible
+        assert(!nt_invmod_batch(a, count, n, out));
+    }
+
+    assert(nt_invmod_batch(a, 0, 7, out));
+    assert(!nt_invmod_batch(a, 5, 1, out));
+
+    free(a);
+    free(out);
+
+    printf("nt_invmod_batch passed.\n");
+
+    // CRT, coprime and not
+    uint64_t x, lcm;
+    const uint64_t r1[] = {2, 3, 2}, m1[] = {3, 5, 7};
+    assert(nt_crt(r1, m1, 3, &x, &lcm) && x == 23 && lcm == 105);
+
+    const uint64_t r2[] = {3, 5}, m2[] = {4, 6};
+    assert(nt_crt(r2, m2, 2, &x, &lcm) && x == 11 && lcm == 12);
+
+    const uint64_t r3[] = {1, 2}, m3[] = {4, 6};
+    assert(!nt_crt(r3, m3, 2, &x, NULL));
+
+    const uint64_t r4[] = {5, 7}, m4[] = {1ULL << 31, (1ULL << 31) + 1};
+    assert(nt_crt(r4, m4, 2, &x, &lcm));
+    assert(x % m4[0] == 5 && x % m4[1] == 7 && lcm == m4[0] * m4[1]);
+
+    const uint64_t r5[] = {0, 0}, m5[] = {1ULL << 40, (1ULL << 40) + 1};
+    assert(!nt_crt(r5, m5, 2, &x, NULL));  // overflow
+
+    assert(nt_crt(r1, m1, 0, &x, &lcm) && x == 0 && lcm == 1);
+
+    printf("nt_crt passed.\n");
+    printf("Test Modular Arithmetic done.\n\n");
+}
+
+void test_primality() {
+    printf("--- Test Primality ---\n");
+
+    for (uint64_t n = 0; n < 100000; n++) assert(nt_is_prime(n) == naive_is_prime(n));
+
+    uint64_t state = 0xA5A5A5A55A5A5A5AULL;
+    for (int t = 0; t < 500; t++) {
+        const uint64_t n = xorshift(&state) % 10000000000ULL;
+        assert(nt_is_prime(n) == naive_is_prime(n));
+    }
+
+    // Strong pseudoprimes to several small bases, Carmichael numbers and large primes
+    assert(!nt_is_prime(3215031751ULL));
+    assert(!nt_is_prime(3825123056546413051ULL));
+    assert(!nt_is_prime(561) && !nt_is_prime(41041) && !nt_is_prime(3778118040573702001ULL));
+    assert(nt_is_prime(UINT64_MAX - 58) && nt_is_prime((1ULL << 61) - 1) && nt_is_prime(1000000007));
+    assert(!nt_is_prime(UINT64_MAX) && !nt_is_prime(((1ULL << 61) - 1) * 3));
+    assert(!nt_is_prime(4294967291ULL * 4294967279ULL));
+
+    printf("Test Primality done.\n\n");
+}
+
+void test_sieve() {
+    printf("--- Test Sieve ---\n");
+
+    // Reference: a plain sieve up to 3 000 000
+    const size_t limit = 3000000;
+    uint8_t* composite = calloc(limit, 1);
+    composite[0] = composite[1] = 1;
+    for (size_t i = 2; i * i < limit; i++) {
+        if (composite[i]) continue;
+        for (size_t j = i * i; j < limit; j += i) composite[j] = 1;
+    }
+
+    uint64_t state = 0x1111222233334444ULL;
+    size_t threads[] = {1, 2, 7};
+
+    for (int t = 0; t < 60; t++) {
+        uint64_t lo = xorshift(&state) % limit, hi = xorshift(&state) % limit;
+        if (t < 12) lo = (uint64_t)t;  // ranges touching 0..11
+        if (lo > hi) {
+            const uint64_t tmp = lo;
+            lo = hi;
+            hi = tmp;
+        }
+
+        uint64_t expected = 0;
+        for (uint64_t i = lo; i < hi; i++) expected += !composite[i];
+
+        const size_t th = threads[t % 3];
+        assert(nt_prime_count(lo, hi, th) == expected);
+
+        DArray* primes = nt_primes(lo, hi, th);
+        assert(primes && primes->length == expected);
+
+        uint64_t* arr = (uint64_t*)primes->arr;
+        for (size_t i = 0; i < primes->length; i++) {
+            assert(arr[i] >= lo && arr[i] < hi && !composite[arr[i]]);
+            if (i) assert(arr[i - 1] < arr[i]);
+        }
+
+        da_free(primes);
+    }
+
+    assert(nt_prime_count(0, 0, 1) == 0 && nt_prime_count(5, 3, 1) == 0 && nt_prime_count(0, 3, 1) == 1);
+    assert(nt_prime_count(2, 8, 1) == 4 && nt_prime_count(7, 8, 1) == 1 && nt_prime_count(7, 7, 1) == 0);
+
+    free(composite);
+
+    printf("nt_prime_count / nt_primes vs plain sieve passed.\n");
+
+    // Known values of pi(x)
+    assert(nt_prime_count(0, 10000000, 1) == 664579);
+    assert(nt_prime_count(0, 100000000, 4) == 5761455);
+
+    // A window far from 0, checked against Miller-Rabin
+    const uint64_t base = 1000000000000ULL;
+    DArray* far = nt_primes(base, base + 100000, 2);
+    uint64_t expected = 0;
+    for (uint64_t n = base; n < base + 100000; n++) expected += nt_is_prime(n);
+    assert(far->length == expected && nt_prime_count(base, base + 100000, 3) == expected);
+    for (size_t i = 0; i < far->length; i++) assert(nt_is_prime(((uint64_t*)far->arr)[i]));
+    da_free(far);
+
+    printf("Known prime counts passed.\n");
+    printf("Test Sieve done.\n\n");
+}
+
+int main() {
+    printf("Starting Number Theory Test Suite...\n\n");
+
+    test_reduction();
+    test_modular();
+    test_primality();
+    test_sieve();
+
+    printf("All tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include "../lib/pool.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../lib/memstat.h"
+
+/******************************************************************************
+ *                                                                            *
+ *                               Test Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+void test_alloc_free() {
+    printf("--- Test Allocation & Freeing ---\n");
+
+    MSCounter before = ms_registry_get(MS_POOL);
+
+    Pool* pool = pool_new(40, 64, 8);
+    assert(pool != NULL);
+    assert(pool->block_size == 64 && pool_bytes(pool) == 0);
+
+    void* blocks[100];
+    for (int i = 0; i < 100; i++) {
+        blocks[i] = pool_alloc(pool);
+        assert(blocks[i] != NULL);
+        assert((uintptr_t)blocks[i] % 64 == 0);
+        memset(blocks[i], i, 64);
+    }
+    assert(pool_live(pool) == 100);
+    assert(pool->slab_count == 13);  // ceil(100 / 8)
+
+    // Blocks never overlap
+    for (int i = 0; i < 100; i++) {
+        for (int j = 0; j < 64; j++) assert(((unsigned char*)blocks[i])[j] == i);
+    }
+    printf("pool_alloc passed.\n");
+
+    // Freed blocks are reused before any new slab
+    for (int i = 0; i < 100; i += 2) pool_free(pool, blocks[i]);
+    assert(pool_live(pool) == 50);
+
+    for (int i = 0; i < 50; i++) assert(pool_alloc(pool) != NULL);
+    assert(pool->slab_count == 13);
+    assert(pool_live(pool) == 100);
+    printf("pool_free passed.\n");
+
+    assert(ms_registry_get(MS_POOL).bytes == before.bytes + (int64_t)(sizeof(Pool) + pool_bytes(pool)));
+
+    // Shared ownership
+    assert(pool_retain(pool) == pool && pool->refs == 2);
+    pool_release(pool);
+    assert(pool->refs == 1);
+    pool_release(pool);
+
+    assert(ms_registry_get(MS_POOL).containers == before.containers);
+    assert(ms_registry_get(MS_POOL).bytes == before.bytes);
+    printf("pool_retain/pool_release passed.\n");
+
+    // Invalid arguments
+    assert(pool_new(0, 64, 8) == NULL);
+    assert(pool_new(16, 48, 8) == NULL);
+    assert(pool_new(16, 16, 0) == NULL);
+
+    // Small alignments are raised to hold the free-list link
+    pool = pool_new(1, 1, 4);
+    assert(pool->block_size >= sizeof(void*) && pool->align >= sizeof(void*));
+    pool_free(pool, pool_alloc(pool));
+    pool_release(pool);
+    printf("argument validation passed.\n");
+
+    printf("Test Allocation & Freeing done.\n\n");
+}
+
+int main() {
+    printf("Starting Pool Test Suite...\n\n");
+
+    test_alloc_free();
+
+    printf("All tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,265 @@
+#include "../lib/rbtree.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+// A map entry: ordered by `key`, `value` is payload.
+typedef struct {
+    int key;
+    int value;
+} Entry;
+
+int entry_cmp(const void* a, const void* b) {
+    int x = ((const Entry*)a)->key, y = ((const Entry*)b)->key;
+    return (x > y) - (x < y);
+}
+
+void entry_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(Entry));
+}
+
+int live_entries = 0;
+
+void entry_deallocator(void* k) {
+    (void)k;
+    live_entries--;
+}
+
+void counting_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(Entry));
+    live_entries++;
+}
+
+uint64_t xorshift(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state;
+}
+
+// Checks the red-black properties, the parent links and (if maintained) the subtree sizes; returns the black height.
+size_t check_subtree(const RBTree* rb, const RBNode* node, const RBNode* parent) {
+    if (!node) return 1;
+
+    assert(node->parent == parent);
+    if (node->red) assert(!(node->left && node->left->red) && !(node->right && node->right->red));
+
+    size_t left = check_subtree(rb, node->left, node);
+    size_t right = check_subtree(rb, node->right, node);
+    assert(left == right);
+
+    if (rb->order_stats) {
+        size_t size = 1 + (node->left ? node->left->size : 0) + (node->right ? node->right->size : 0);
+        assert(node->size == size);
+    }
+
+    return left + (node->red ? 0 : 1);
+}
+
+void check_tree(const RBTree* rb) {
+    assert(!rb->root || !rb->root->red);
+    check_subtree(rb, rb->root, NULL);
+
+    // In-order walk is strictly increasing and has `count` elements
+    size_t n = 0;
+    const Entry* prev = NULL;
+
+    for (const Entry* e = (const Entry*)rb_first(rb); e; e = (const Entry*)rb_next(rb, e)) {
+        if (prev) assert(prev->key < e->key);
+        prev = e;
+        n++;
+    }
+
+    assert(n == rb_count(rb));
+    assert(rb->pool->live == n);
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Test Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+void test_insert_remove() {
+    printf("--- Test Insertion & Removal ---\n");
+
+    RBTree* rb = rb_new_with_order_stats(sizeof(Entry), entry_cmp, counting_copier, entry_deallocator);
+    assert(rb != NULL && rb_is_empty(rb));
+
+    const int n = 20000;
+    char* present = (char*)calloc((size_t)n, 1);
+    uint64_t state = 0x2545F4914F6CDD1DULL;
+
+    for (int i = 0; i < n; i++) {
+        Entry e = {(int)(xorshift(&state) % (uint64_t)n), i};
+        bool inserted = rb_insert(rb, &e);
+
+        assert(inserted == !present[e.key]);
+        present[e.key] = 1;
+    }
+    check_tree(rb);
+    assert(live_entries == (int)rb_count(rb));
+    printf("rb_insert passed.\n");
+
+    for (int k = 0; k < n; k++) {
+        Entry key = {k, 0};
+        Entry* e = (Entry*)rb_find(rb, &key);
+
+        assert((e != NULL) == present[k]);
+        if (e) e->value = -k;  // values are mutable in place
+    }
+    printf("rb_find passed.\n");
+
+    // Element pointers are stable across unrelated insertions and removals
+    Entry probe = {n / 2, 0};
+    Entry* anchor = (Entry*)rb_lower_bound(rb, &probe);
+    assert(anchor != NULL);
+    int anchor_key = anchor->key;
+
+    for (int i = 0; i < n; i++) {
+        Entry e = {(int)(xorshift(&state) % (uint64_t)n), 0};
+        if (e.key == anchor_key) continue;
+
+        if (xorshift(&state) & 1) {
+            if (rb_remove(rb, &e)) {
+                assert(present[e.key]);
+                present[e.key] = 0;
+            }
+        } else if (rb_insert(rb, &e)) {
+            present[e.key] = 1;
+        }
+
+        if (i % 2000 == 0) check_tree(rb);
+    }
+    check_tree(rb);
+    assert(anchor->key == anchor_key);
+    assert(rb_find(rb, anchor) == anchor);
+    printf("rb_remove (stable pointers) passed.\n");
+
+    // Erase through iterators while walking
+    for (Entry* e = (Entry*)rb_first(rb); e;) {
+        Entry* next = (Entry*)rb_next(rb, e);
+
+        if (e->key % 3 == 0) {
+            present[e->key] = 0;
+            rb_erase(rb, e);
+        }
+
+        e = next;
+    }
+    check_tree(rb);
+    assert(live_entries == (int)rb_count(rb));
+    printf("rb_erase passed.\n");
+
+    // Bounds, order statistics and backward iteration against the reference
+    size_t rank = 0;
+    for (int k = 0; k < n; k++) {
+        Entry key = {k, 0};
+        Entry* lb = (Entry*)rb_lower_bound(rb, &key);
+        Entry* ub = (Entry*)rb_upper_bound(rb, &key);
+
+        int expected_lb = k;
+        while (expected_lb < n && !present[expected_lb]) expected_lb++;
+        int expected_ub = k + 1;
+        while (expected_ub < n && !present[expected_ub]) expected_ub++;
+
+        assert(expected_lb == n ? lb == NULL : lb->key == expected_lb);
+        assert(expected_ub == n ? ub == NULL : ub->key == expected_ub);
+
+        assert(rb_rank(rb, &key) == rank);
+        if (present[k]) {
+            assert(((Entry*)rb_select(rb, rank))->key == k);
+            rank++;
+        }
+    }
+    assert(rb_select(rb, rb_count(rb)) == NULL);
+
+    size_t back = 0;
+    for (Entry* e = (Entry*)rb_last(rb); e; e = (Entry*)rb_prev(rb, e)) back++;
+    assert(back == rb_count(rb));
+    printf("rb_lower_bound/rb_upper_bound/rb_rank/rb_select passed.\n");
+
+    MemUsage mu = rb_memory_usage(rb, NULL);
+    assert(mu.payload == rb_count(rb) * sizeof(Entry));
+
+    rb_free(rb);
+    free(present);
+    assert(live_entries == 0);
+
+    // Without order statistics
+    rb = rb_new(sizeof(Entry), entry_cmp, counting_copier, entry_deallocator);
+    Entry e = {1, 1};
+    rb_insert(rb, &e);
+    assert(rb_rank(rb, &e) == (size_t)-1 && rb_select(rb, 0) == NULL);
+    rb_free(rb);
+    assert(live_entries == 0);
+    printf("order statistics option passed.\n");
+
+    printf("Test Insertion & Removal done.\n\n");
+}
+
+void test_bulk_build() {
+    printf("--- Test Bulk Build ---\n");
+
+    for (size_t n = 0; n < 300; n++) {
+        DArray* da = da_new_with_capacity(sizeof(Entry), n);
+        da->copier = entry_copier;
+
+        for (size_t i = 0; i < n; i++) {
+            Entry e = {(int)(i * 2), (int)i};
+            da_push(da, &e);
+        }
+
+        RBTree* rb = rb_new_from_sorted(da, entry_cmp, entry_deallocator, true);
+        assert(rb != NULL && rb_count(rb) == n);
+        check_tree(rb);
+
+        for (size_t i = 0; i < n; i++) assert(((Entry*)rb_select(rb, i))->key == (int)(i * 2));
+
+        // The tree stays valid under further updates
+        Entry odd = {(int)n | 1, 0};
+        assert(rb_insert(rb, &odd));
+        if (n > 0) {
+            Entry first = {0, 0};
+            assert(rb_remove(rb, &first));
+        }
+        check_tree(rb);
+
+        rb_free(rb);
+        da_free(da);
+    }
+
+    // Unsorted (or duplicated) input is rejected
+    DArray* da = da_new(sizeof(Entry));
+    da->copier = entry_copier;
+    Entry a = {1, 0}, b = {1, 0};
+    da_push(da, &a);
+    da_push(da, &b);
+    assert(rb_new_from_sorted(da, entry_cmp, entry_deallocator, false) == NULL);
+    da_free(da);
+
+    printf("rb_new_from_sorted passed.\n");
+
+    printf("Test Bulk Build done.\n\n");
+}
+
+int main() {
+    printf("Starting Red-Black Tree Test Suite...\n\n");
+
+    test_insert_remove();
+    test_bulk_build();
+
+    printf("All tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,263 @@
+#include "../lib/strdist.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+uint64_t xorshift(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state;
+}
+
+// `n` bytes drawn from the first `sigma` letters of the alphabet (`sigma == 0` uses all 256 byte values)
+void random_string(char* s, size_t n, unsigned sigma, uint64_t* state) {
+    for (size_t i = 0; i < n; i++) {
+        const uint64_t r = xorshift(state);
+        s[i] = sigma ? (char)('a' + r % sigma) : (char)(r & 0xFF);
+    }
+}
+
+// a copy of `src` with about `edits` random insertions, deletions and substitutions
+size_t mutate(char* dst, const char* src, size_t n, size_t edits, uint64_t* state) {
+    size_t len = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        const uint64_t r = xorshift(state);
+
+        if (r % (n + 1) >= edits) dst[len++] = src[i];
+        else if (r % 3 == 0) dst[len++] = (char)('a' + (r >> 8) % 26);
+        else if (r % 3 == 1) {
+            dst[len++] = src[i];
+            dst[len++] = (char)('a' + (r >> 8) % 26);
+        }
+    }
+
+    return len;
+}
+
+size_t naive_levenshtein(const char* a, size_t m, const char* b, size_t n) {
+    size_t* row = malloc((n + 1) * sizeof(size_t));
+    for (size_t j = 0; j <= n; j++) row[j] = j;
+
+    for (size_t i = 1; i <= m; i++) {
+        size_t diag = row[0];
+        row[0] = i;
+
+        for (size_t j = 1; j <= n; j++) {
+            const size_t up = row[j];
+            size_t best = diag + (a[i - 1] != b[j - 1]);
+            if (up + 1 < best) best = up + 1;
+            if (row[j - 1] + 1 < best) best = row[j - 1] + 1;
+
+            row[j] = best;
+            diag = up;
+        }
+    }
+
+    const size_t d = row[n];
+    free(row);
+
+    return d;
+}
+
+size_t naive_lcs(const char* a, size_t m, const char* b, size_t n) {
+    size_t* row = calloc(n + 1, sizeof(size_t));
+
+    for (size_t i = 1; i <= m; i++) {
+        size_t diag = 0;
+
+        for (size_t j = 1; j <= n; j++) {
+            const size_t up = row[j];
+            row[j] = a[i - 1] == b[j - 1] ? diag + 1 : (up > row[j - 1] ? up : row[j - 1]);
+            diag = up;
+        }
+    }
+
+    const size_t l = row[n];
+    free(row);
+
+    return l;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Test Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+void test_levenshtein() {
+    printf("--- Test Levenshtein ---\n");
+
+    assert(sd_levenshtein("kitten", 6, "sitting", 7) == 3);
+    assert(sd_levenshtein("flaw", 4, "lawn", 4) == 2);
+    assert(sd_levenshtein("", 0, "abc", 3) == 3);
+    assert(sd_levenshtein(NULL, 0, NULL, 0) == 0);
+    assert(sd_levenshtein("same", 4, "same", 4) == 0);
+    assert(sd_levenshtein("a\0b", 3, "a\0c", 3) == 1);
+    assert(sd_levenshtein(NULL, 2, "ab", 2) == SIZE_MAX);
+
+    // Single-word and multi-word patterns, across alphabet sizes and around the 64-byte block edges
+    const size_t lengths[] = {1, 7, 63, 64, 65, 127, 128, 129, 300};
+    const unsigned sigmas[] = {2, 4, 26, 0};
+    char a[320], b[640];
+    uint64_t state = 0x2545F4914F6CDD1DULL;
+
+    for (size_t li = 0; li < sizeof(lengths) / sizeof(lengths[0]); li++) {
+        for (size_t si = 0; si < sizeof(sigmas) / sizeof(sigmas[0]); si++) {
+            for (int round = 0; round < 4; round++) {
+                const size_t m = lengths[li], n = 1 + xorshift(&state) % 310;
+                random_string(a, m, sigmas[si], &state);
+                random_string(b, n, sigmas[si], &state);
+
+                const size_t expected = naive_levenshtein(a, m, b, n);
+                assert(sd_levenshtein(a, m, b, n) == expected);
+                assert(sd_levenshtein(b, n, a, m) == expected);
+            }
+        }
+    }
+
+    // Close pairs, where the common prefix and suffix stripping and the band matter
+    for (int round = 0; round < 200; round++) {
+        const size_t m = 1 + xorshift(&state) % 300;
+        random_string(a, m, 26, &state);
+        const size_t n = mutate(b, a, m, xorshift(&state) % 12, &state);
+
+        assert(sd_levenshtein(a, m, b, n) == naive_levenshtein(a, m, b, n));
+    }
+
+    printf("Test Levenshtein done.\n\n");
+}
+
+void test_bounded() {
+    printf("--- Test Bounded ---\n");
+
+    assert(sd_levenshtein_bounded("kitten", 6, "sitting", 7, 3) == 3);
+    assert(sd_levenshtein_bounded("kitten", 6, "sitting", 7, 2) == 3);
+    assert(sd_levenshtein_bounded("kitten", 6, "sitting", 7, 0) == 1);
+    assert(sd_levenshtein_bounded("abc", 3, "abcdef", 6, 2) == 3);
+    assert(sd_levenshtein_bounded("abc", 3, "abc", 3, 0) == 0);
+
+    // Every threshold around the true distance
+    char a[320], b[640];
+    uint64_t state = 0xDEADBEEFULL;
+
+    for (int round = 0; round < 300; round++) {
+        const size_t m = 1 + xorshift(&state) % 300;
+        const unsigned sigma = round % 3 == 0 ? 2 : 26;
+        random_string(a, m, sigma, &state);
+
+        size_t n;
+        if (round % 2) n = mutate(b, a, m, xorshift(&state) % 40, &state);
+        else {
+            n = 1 + xorshift(&state) % 300;
+            random_string(b, n, sigma, &state);
+        }
+
+        const size_t d = naive_levenshtein(a, m, b, n);
+        const size_t maxes[] = {0, 1, d / 2, d > 0 ? d - 1 : 0, d, d + 1, 2 * d + 5, SIZE_MAX};
+
+        for (size_t k = 0; k < sizeof(maxes) / sizeof(maxes[0]); k++) {
+            const size_t expected = d <= maxes[k] ? d : maxes[k] + 1;
+            assert(sd_levenshtein_bounded(a, m, b, n, maxes[k]) == expected);
+            assert(sd_levenshtein_bounded(b, n, a, m, maxes[k]) == expected);
+        }
+    }
+
+    printf("Test Bounded done.\n\n");
+}
+
+void test_lcs() {
+    printf("--- Test LCS ---\n");
+
+    assert(sd_lcs("ABCBDAB", 7, "BDCABA", 6) == 4);
+    assert(sd_lcs("AGGTAB", 6, "GXTXAYB", 7) == 4);
+    assert(sd_lcs("", 0, "abc", 3) == 0);
+    assert(sd_lcs("abc", 3, "abc", 3) == 3);
+    assert(sd_lcs("abc", 3, NULL, 1) == SIZE_MAX);
+
+    const unsigned sigmas[] = {2, 4, 26, 0};
+    char a[400], b[400];
+    uint64_t state = 0x1234567ULL;
+
+    for (int round = 0; round < 200; round++) {
+        const unsigned sigma = sigmas[round % 4];
+        const size_t m = 1 + xorshift(&state) % 400, n = 1 + xorshift(&state) % 400;
+        random_string(a, m, sigma, &state);
+        random_string(b, n, sigma, &state);
+
+        const size_t expected = naive_lcs(a, m, b, n);
+        assert(sd_lcs(a, m, b, n) == expected);
+        assert(sd_lcs(b, n, a, m) == expected);
+    }
+
+    printf("Test LCS done.\n\n");
+}
+
+void test_batch() {
+    printf("--- Test Batch ---\n");
+
+    const size_t count = 500;
+    char* text = malloc(count * 2 * 200);
+    SDPair* pairs = malloc(count * sizeof(SDPair));
+    size_t* out = malloc(count * sizeof(size_t));
+    uint64_t state = 0xFEEDULL;
+
+    for (size_t i = 0; i < count; i++) {
+        char *a = text + i * 400, *b = a + 200;
+        const size_t m = xorshift(&state) % 150;
+        random_string(a, m, 4, &state);
+
+        pairs[i] = (SDPair){a, m, b, mutate(b, a, m, xorshift(&state) % 10, &state)};
+    }
+
+    const size_t maxes[] = {3, SIZE_MAX};
+    for (size_t k = 0; k < 2; k++) {
+        for (size_t threads = 1; threads <= 4; threads += 3) {
+            assert(sd_levenshtein_batch(pairs, count, maxes[k], out, threads));
+
+            for (size_t i = 0; i < count; i++) {
+                assert(out[i] == sd_levenshtein_bounded(pairs[i].a, pairs[i].a_len, pairs[i].b, pairs[i].b_len,
+                                                        maxes[k]));
+            }
+        }
+    }
+
+    // A broken pair is reported without stopping the others
+    pairs[7].a = NULL;
+    pairs[7].a_len = 5;
+    assert(!sd_levenshtein_batch(pairs, count, SIZE_MAX, out, 2));
+    assert(out[7] == SIZE_MAX);
+    assert(out[8] == sd_levenshtein(pairs[8].a, pairs[8].a_len, pairs[8].b, pairs[8].b_len));
+
+    assert(sd_levenshtein_batch(pairs, 0, 1, out, 4));
+    assert(!sd_levenshtein_batch(NULL, 1, 1, out, 1));
+
+    free(text);
+    free(pairs);
+    free(out);
+
+    printf("Test Batch done.\n\n");
+}
+
+int main() {
+    printf("Starting String Distance Test Suite...\n\n");
+
+    test_levenshtein();
+    test_bounded();
+    test_lcs();
+    test_batch();
+
+    printf("All tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,258 @@
+#include "../lib/treap.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+// A map entry: ordered by `key`, `origin` tells which treap it came from.
+typedef struct {
+    int key;
+    int origin;
+} Entry;
+
+int entry_cmp(const void* a, const void* b) {
+    int x = ((const Entry*)a)->key, y = ((const Entry*)b)->key;
+    return (x > y) - (x < y);
+}
+
+int live_entries = 0;
+
+void entry_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(Entry));
+    live_entries++;
+}
+
+void entry_deallocator(void* k) {
+    (void)k;
+    live_entries--;
+}
+
+uint64_t xorshift(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state;
+}
+
+// Checks the heap order on priorities and the subtree sizes; returns the subtree size.
+size_t check_subtree(const TPNode* node) {
+    if (!node) return 0;
+
+    if (node->left) assert(node->left->priority <= node->priority);
+    if (node->right) assert(node->right->priority <= node->priority);
+
+    size_t size = 1 + check_subtree(node->left) + check_subtree(node->right);
+    assert(node->size == size);
+
+    return size;
+}
+
+void collect(void* e, void* ctx) {
+    Entry** out = (Entry**)ctx;
+    **out = *(Entry*)e;
+    (*out)++;
+}
+
+// Checks the structure, and that the in-order contents are strictly increasing; returns them (caller frees).
+Entry* check_treap(const Treap* tp) {
+    assert(check_subtree(tp->root) == tp_count(tp));
+
+    Entry* all = (Entry*)malloc((tp_count(tp) + 1) * sizeof(Entry));
+    Entry* cursor = all;
+    tp_for_each(tp, collect, &cursor);
+
+    assert((size_t)(cursor - all) == tp_count(tp));
+    for (size_t i = 1; i < tp_count(tp); i++) assert(all[i - 1].key < all[i].key);
+
+    return all;
+}
+
+Treap* random_treap(uint64_t* state, size_t n, int modulo, int origin) {
+    Treap* tp = tp_new(sizeof(Entry), entry_cmp, entry_copier, entry_deallocator);
+
+    for (size_t i = 0; i < n; i++) {
+        Entry e = {(int)(xorshift(state) % (uint64_t)modulo), origin};
+        tp_insert(tp, &e);
+    }
+
+    return tp;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Test Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+void test_basic() {
+    printf("--- Test Basic Operations ---\n");
+
+    Treap* tp = tp_new(sizeof(Entry), entry_cmp, entry_copier, entry_deallocator);
+    assert(tp != NULL && tp_is_empty(tp));
+
+    for (int i = 0; i < 1000; i++) {
+        Entry e = {(i * 7919) % 1000, 0};
+        assert(tp_insert(tp, &e));
+        assert(!tp_insert(tp, &e));
+    }
+    assert(tp_count(tp) == 1000);
+    free(check_treap(tp));
+
+    for (int i = 0; i < 1000; i++) {
+        Entry key = {i, 0};
+        assert(((Entry*)tp_find(tp, &key))->key == i);
+        assert(tp_rank(tp, &key) == (size_t)i);
+        assert(((Entry*)tp_at(tp, (size_t)i))->key == i);
+    }
+    assert(tp_at(tp, 1000) == NULL);
+    printf("tp_insert/tp_find/tp_rank/tp_at passed.\n");
+
+    for (int i = 0; i < 1000; i += 2) {
+        Entry key = {i, 0};
+        assert(tp_remove(tp, &key));
+        assert(!tp_remove(tp, &key));
+    }
+    assert(tp_count(tp) == 500);
+    free(check_treap(tp));
+    printf("tp_remove passed.\n");
+
+    tp_free(tp);
+    assert(live_entries == 0);
+
+    printf("Test Basic Operations done.\n\n");
+}
+
+void test_split_merge() {
+    printf("--- Test Split, Merge & Range Extraction ---\n");
+
+    Treap* tp = tp_new(sizeof(Entry), entry_cmp, entry_copier, entry_deallocator);
+    for (int i = 0; i < 10000; i++) {
+        Entry e = {i, 0};
+        tp_insert(tp, &e);
+    }
+
+    Entry mid = {6000, 0};
+    Treap* right = tp_split(tp, &mid);
+    assert(right->pool == tp->pool);
+    assert(tp_count(tp) == 6000 && tp_count(right) == 4000);
+    assert(((Entry*)tp_at(right, 0))->key == 6000);
+    free(check_treap(tp));
+    free(check_treap(right));
+    printf("tp_split passed.\n");
+
+    // Overlapping ranges are rejected
+    assert(!tp_merge(right, tp));
+
+    size_t live = tp->pool->live;
+    assert(tp_merge(tp, right));
+    assert(tp_count(tp) == 10000 && tp_is_empty(right));
+    assert(tp->pool->live == live);  // relinked, not copied
+    free(check_treap(tp));
+    tp_free(right);
+    printf("tp_merge passed.\n");
+
+    Entry lo = {2500, 0}, hi = {7500, 0};
+    Treap* range = tp_extract_range(tp, &lo, &hi);
+    assert(tp_count(range) == 5000 && tp_count(tp) == 5000);
+    assert(((Entry*)tp_at(range, 0))->key == 2500);
+    assert(((Entry*)tp_at(range, 4999))->key == 7499);
+    assert(((Entry*)tp_at(tp, 2500))->key == 7500);
+    free(check_treap(range));
+    free(check_treap(tp));
+
+    // Empty range
+    Treap* empty = tp_extract_range(tp, &hi, &lo);
+    assert(tp_is_empty(empty) && tp_count(tp) == 5000);
+    tp_free(empty);
+    printf("tp_extract_range passed.\n");
+
+    // Merging treaps with different pools moves the nodes over
+    Treap* other = tp_new(sizeof(Entry), entry_cmp, entry_copier, entry_deallocator);
+    for (int i = 20000; i < 20100; i++) {
+        Entry e = {i, 0};
+        tp_insert(other, &e);
+    }
+
+    int before = live_entries;
+    assert(tp_merge(tp, other));
+    assert(live_entries == before);  // elements moved, not copied
+    assert(tp_count(tp) == 5100 && other->pool->live == 0);
+    free(check_treap(tp));
+    printf("tp_merge (different pools) passed.\n");
+
+    tp_free(other);
+    tp_free(range);
+    tp_free(tp);
+    assert(live_entries == 0);
+
+    printf("Test Split, Merge & Range Extraction done.\n\n");
+}
+
+void test_union() {
+    printf("--- Test Union ---\n");
+
+    uint64_t state = 0xDEADBEEFCAFEBABEULL;
+
+    size_t threads[] = {1, 2, 4, 8};
+
+    for (size_t t = 0; t < 4; t++) {
+        Treap* a = random_treap(&state, 20000, 50000, 1);
+        Treap* b = random_treap(&state, 30000, 50000, 2);
+
+        // Expected result: every key of either, `a`'s entry winning on ties
+        char* in_a = (char*)calloc(50000, 1);
+        char* in_b = (char*)calloc(50000, 1);
+        Entry* ea = check_treap(a);
+        Entry* eb = check_treap(b);
+        for (size_t i = 0; i < tp_count(a); i++) in_a[ea[i].key] = 1;
+        for (size_t i = 0; i < tp_count(b); i++) in_b[eb[i].key] = 1;
+        free(ea);
+        free(eb);
+
+        size_t expected = 0;
+        for (int k = 0; k < 50000; k++) expected += in_a[k] || in_b[k];
+
+        assert(tp_union_parallel(a, b, threads[t]));
+        assert(tp_is_empty(b));
+        assert(tp_count(a) == expected);
+        assert(live_entries == (int)expected);
+
+        Entry* all = check_treap(a);
+        for (size_t i = 0; i < expected; i++) {
+            int k = all[i].key;
+            assert(in_a[k] || in_b[k]);
+            assert(all[i].origin == (in_a[k] ? 1 : 2));
+        }
+
+        free(all);
+        free(in_a);
+        free(in_b);
+        tp_free(a);
+        tp_free(b);
+        assert(live_entries == 0);
+    }
+    printf("tp_union/tp_union_parallel passed.\n");
+
+    printf("Test Union done.\n\n");
+}
+
+int main() {
+    printf("Starting Treap Test Suite...\n\n");
+
+    test_basic();
+    test_split_merge();
+    test_union();
+
+    printf("All tests passed!\n");
+
+    return 0;
+}
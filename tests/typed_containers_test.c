@@ -0,0 +1,257 @@
+#include "typed_darray.h"
+#include "typed_hashset.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+#define INT_CMP(a, b) (((a) > (b)) - ((a) < (b)))
+
+static inline uint64_t int_hash(int k, uint64_t s0, uint64_t s1) {
+    uint64_t x = ((uint64_t)(uint32_t)k ^ s0) * UINT64_C(0x9E3779B97F4A7C15);
+    return (x ^ (x >> 29)) + s1;
+}
+
+static inline bool int_eq(int a, int b) {
+    return a == b;
+}
+
+// Deliberately terrible hash: every key lands on the last slot, so probe runs wrap around the table.
+static inline uint64_t bad_hash(int k, uint64_t s0, uint64_t s1) {
+    (void)k;
+    (void)s0;
+    (void)s1;
+    return UINT64_MAX;
+}
+
+typedef struct {
+    double x, y;
+} Point;
+
+DEFINE_DARRAY(IntArr, int)
+DEFINE_DARRAY_CMP(IntArr, int, INT_CMP)
+
+DEFINE_DARRAY(PointArr, Point)
+
+DEFINE_HSET(IntSet, int, int_hash, int_eq)
+DEFINE_HSET(BadSet, int, bad_hash, int_eq)
+
+bool is_even(const int* k) {
+    return *k % 2 == 0;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Test Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+void test_typed_darray() {
+    printf("--- Test Typed DArray ---\n");
+
+    IntArr* a = IntArr_new();
+    assert(IntArr_is_empty(a));
+
+    for (int i = 0; i < 1000; i++) assert(IntArr_push(a, i));
+    assert(IntArr_length(a) == 1000);
+    assert(*IntArr_get(a, 999) == 999);
+    assert(IntArr_get(a, 1000) == NULL);
+
+    assert(IntArr_push_front(a, -1));
+    assert(IntArr_insert_at(a, 500, 12345));
+    assert(*IntArr_get_first(a) == -1);
+    assert(*IntArr_get(a, 500) == 12345);
+    assert(IntArr_remove_at(a, 500));
+    assert(IntArr_find(a, 12345) == (size_t)-1);
+
+    int out;
+    assert(IntArr_pop_front(a, &out) && out == -1);
+    assert(IntArr_pop(a, &out) && out == 999);
+    assert(IntArr_remove(a, 10) == 10);
+    assert(!IntArr_contains(a, 10));
+    printf("push/insert/pop/remove passed.\n");
+
+    IntArr_reverse(a);
+    assert(*IntArr_get_first(a) == 998);
+
+    // Sort: random values with many duplicates, and an already-sorted input.
+    IntArr* r = IntArr_new_with_capacity(0);
+    uint64_t x = 88172645463325252ULL;
+    for (int i = 0; i < 100000; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        IntArr_push(r, (int)(x % 1000));
+    }
+
+    IntArr_sort(r);
+    for (size_t i = 1; i < r->length; i++) assert(r->arr[i - 1] <= r->arr[i]);
+
+    size_t idx = IntArr_binary_search(r, 500);
+    assert(idx != (size_t)-1 && r->arr[idx] == 500 && (idx == 0 || r->arr[idx - 1] < 500));
+    assert(!IntArr_contains_bsearch(r, 1000));
+
+    IntArr_sort(a);
+    for (size_t i = 1; i < a->length; i++) assert(a->arr[i - 1] <= a->arr[i]);
+    printf("sort/binary_search passed.\n");
+
+    IntArr* c = IntArr_copy(a);
+    assert(IntArr_are_eq(a, c));
+    IntArr_set(c, 0, 42);
+    assert(!IntArr_are_eq(a, c));
+
+    IntArr* cat = IntArr_concat(a, c);
+    assert(cat->length == a->length + c->length);
+
+    IntArr* evens = IntArr_filter(a, is_even);
+    for (size_t i = 0; i < evens->length; i++) assert(evens->arr[i] % 2 == 0);
+
+    // Popping most elements shrinks the storage.
+    while (IntArr_length(cat) > 10) IntArr_pop(cat, NULL);
+    assert(IntArr_capacity(cat) < 100);
+
+    MemUsage mu = IntArr_memory_usage(cat);
+    assert(mu.payload == 10 * sizeof(int));
+
+    IntArr_free(a);
+    IntArr_free(r);
+    IntArr_free(c);
+    IntArr_free(cat);
+    IntArr_free(evens);
+    printf("copy/concat/filter/shrink passed.\n");
+
+    // Struct elements are plain assignments.
+    PointArr* pts = PointArr_new();
+    for (int i = 0; i < 100; i++) PointArr_push(pts, (Point){i, -i});
+    assert(PointArr_get(pts, 42)->y == -42.0);
+    PointArr_swap(pts, 0, 99);
+    assert(PointArr_get_first(pts)->x == 99.0);
+    PointArr_free(pts);
+    printf("struct elements passed.\n");
+
+    printf("Test Typed DArray done.\n\n");
+}
+
+void test_typed_hashset() {
+    printf("--- Test Typed HSet ---\n");
+
+    MSCounter before = ms_registry_get(MS_HSET);
+
+    IntSet* s = IntSet_new();
+    for (int i = 0; i < 10000; i++) assert(IntSet_insert(s, i));
+    assert(!IntSet_insert(s, 5));
+    assert(IntSet_count(s) == 10000);
+
+    for (int i = 0; i < 10000; i++) assert(IntSet_contains(s, i));
+    assert(!IntSet_contains(s, 10000));
+
+    for (int i = 0; i < 10000; i += 2) assert(IntSet_remove(s, i));
+    assert(!IntSet_remove(s, 0));
+    assert(IntSet_count(s) == 5000);
+    for (int i = 0; i < 10000; i++) assert(IntSet_contains(s, i) == (i % 2 == 1));
+    printf("insert/contains/remove passed.\n");
+
+    // A duplicate at the load threshold must not grow the table
+    IntSet* full = IntSet_new();
+    for (int i = 0; IntSet_count(full) < full->capacity - full->capacity / 4; i++) assert(IntSet_insert(full, i));
+    const size_t full_capacity = full->capacity;
+    assert(!IntSet_insert(full, 0));
+    assert(full->capacity == full_capacity);
+    assert(IntSet_insert(full, -1) && full->capacity == 2 * full_capacity);
+    IntSet_free(full);
+
+    // Duplicates in the source array are not failures
+    int dups[] = {3, 1, 3, 2, 1};
+    IntSet* dedup = IntSet_new_from_array(dups, 5);
+    assert(dedup && IntSet_count(dedup) == 3);
+    IntSet_free(dedup);
+    printf("duplicates passed.\n");
+
+    size_t seen = 0;
+    int* k;
+    for (size_t it = 0; (k = IntSet_next(s, &it));) {
+        assert(*k % 2 == 1);
+        seen++;
+    }
+    assert(seen == 5000);
+
+    int* keys = IntSet_extract(s);
+    IntSet* from = IntSet_new_from_array(keys, 5000);
+    assert(IntSet_are_eq(s, from));
+    free(keys);
+    IntSet_free(from);
+    printf("iterator/extract passed.\n");
+
+    int a_vals[] = {1, 2, 3, 4, 5};
+    int b_vals[] = {4, 5, 6, 7};
+    IntSet* A = IntSet_new_from_array(a_vals, 5);
+    IntSet* B = IntSet_new_from_array(b_vals, 4);
+
+    IntSet* U = IntSet_union(A, B);
+    IntSet* I = IntSet_intersection(A, B);
+    IntSet* D = IntSet_difference(A, B);
+    IntSet* SD = IntSet_sym_difference(A, B);
+
+    assert(IntSet_count(U) == 7);
+    assert(IntSet_count(I) == 2 && IntSet_contains(I, 4) && IntSet_contains(I, 5));
+    assert(IntSet_count(D) == 3 && !IntSet_contains(D, 4));
+    assert(IntSet_count(SD) == 5 && !IntSet_contains(SD, 5) && IntSet_contains(SD, 7));
+    assert(IntSet_is_subset(I, A) && IntSet_is_supset(U, B));
+    assert(IntSet_are_disjoint(D, B) && !IntSet_are_disjoint(A, B));
+
+    IntSet* F = IntSet_filter(U, is_even);
+    assert(IntSet_count(F) == 3);
+
+    IntSet* copy = IntSet_copy(U);
+    assert(IntSet_are_eq(copy, U));
+    IntSet_retain(copy, is_even);
+    assert(IntSet_are_eq(copy, F));
+
+    IntSet_free(A);
+    IntSet_free(B);
+    IntSet_free(U);
+    IntSet_free(I);
+    IntSet_free(D);
+    IntSet_free(SD);
+    IntSet_free(F);
+    IntSet_free(copy);
+    printf("set algebra passed.\n");
+
+    // Full collisions: long probe runs that wrap around the table.
+    BadSet* bad = BadSet_new();
+    for (int i = 0; i < 200; i++) assert(BadSet_insert(bad, i));
+    for (int i = 0; i < 200; i += 3) assert(BadSet_remove(bad, i));
+    for (int i = 0; i < 200; i++) assert(BadSet_contains(bad, i) == (i % 3 != 0));
+
+    BadSet_retain(bad, is_even);
+    for (int i = 0; i < 200; i++) assert(BadSet_contains(bad, i) == (i % 3 != 0 && i % 2 == 0));
+    BadSet_free(bad);
+    printf("collisions passed.\n");
+
+    IntSet_clear(s);
+    assert(IntSet_is_empty(s) && !IntSet_contains(s, 1));
+    IntSet_free(s);
+
+    MSCounter after = ms_registry_get(MS_HSET);
+    assert(after.containers == before.containers && after.bytes == before.bytes);
+    printf("registry passed.\n");
+
+    printf("Test Typed HSet done.\n\n");
+}
+
+int main() {
+    printf("Starting Typed Containers Test Suite...\n\n");
+
+    test_typed_darray();
+    test_typed_hashset();
+
+    printf("All tests passed!\n");
+
+    return 0;
+}
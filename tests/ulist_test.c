@@ -0,0 +1,287 @@
+#include "../lib/ulist.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../lib/darray.h"
+
+/******************************************************************************
+ *                                                                            *
+ *                     Helper Data Structures & Functions                     *
+ *                                                                            *
+ ******************************************************************************/
+
+int freed_count = 0;
+
+void int_copier(void* dest, const void* src) {
+    memcpy(dest, src, sizeof(int));
+}
+
+void counting_deallocator(void* k) {
+    (void)k;
+    freed_count++;
+}
+
+// Checks the structural invariants: links, counts, and the fill factor of interior nodes.
+void check_invariants(const ULList* ul) {
+    size_t length = 0, nodes = 0;
+    const ULNode* prev = NULL;
+
+    for (const ULNode* node = ul->head; node; node = node->next) {
+        assert(node->prev == prev);
+        assert(node->count > 0 && node->count <= ul->node_capacity);
+
+        if (node != ul->head && node != ul->tail) assert(node->count >= ul->node_capacity / 2);
+
+        length += node->count;
+        nodes++;
+        prev = node;
+    }
+
+    assert(ul->tail == prev);
+    assert(ul->length == length);
+    assert(ul->node_count == nodes);
+    assert(ul->pool->live >= nodes);
+}
+
+// Checks that `ul` holds exactly the ints of `da`, in order.
+void check_matches(const ULList* ul, DArray* da) {
+    assert(ul_length(ul) == da->length);
+
+    ULIterator it;
+    ul_iter_init(&it, ul);
+
+    for (size_t i = 0; i < da->length; i++) {
+        int* e = (int*)ul_iter_next(&it);
+        assert(e && *e == *(int*)da_index(da, i));
+    }
+
+    assert(ul_iter_next(&it) == NULL);
+}
+
+uint64_t xorshift(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state;
+}
+
+/******************************************************************************
+ *                                                                            *
+ *                               Test Functions                               *
+ *                                                                            *
+ ******************************************************************************/
+
+void test_layout() {
+    printf("--- Test Layout ---\n");
+
+    ULList* ul = ul_new(sizeof(int));
+    assert(ul != NULL && ul_is_empty(ul));
+
+    // Nodes are cache-line multiples, and cache-line aligned
+    assert(ul->pool->block_size % 64 == 0);
+    assert(ul->node_capacity >= 2);
+
+    for (int i = 0; i < 1000; i++) assert(ul_push_back(ul, &i));
+
+    for (const ULNode* node = ul->head; node; node = node->next) {
+        assert((uintptr_t)node % 64 == 0);
+        if (node != ul->tail) assert(node->count == ul->node_capacity);  // appends fill nodes completely
+    }
+    check_invariants(ul);
+    ul_free(ul);
+
+    // Large elements still fit two per node
+    ul = ul_new_with_node_size(200, 64);
+    assert(ul->node_capacity == 2 && ul->pool->block_size % 64 == 0);
+    ul_free(ul);
+
+    assert(ul_new(0) == NULL);
+    printf("node layout passed.\n");
+
+    printf("Test Layout done.\n\n");
+}
+
+void test_operations() {
+    printf("--- Test Operations ---\n");
+
+    ULList* ul = ul_new_with_node_size(sizeof(int), 64);  // small nodes, to exercise splits and merges
+    DArray* ref = da_new(sizeof(int));
+    ref->copier = int_copier;
+
+    for (int i = 0; i < 100; i++) {
+        ul_push_back(ul, &i);
+        da_push(ref, &i);
+    }
+    for (int i = -1; i > -50; i--) {
+        ul_push_front(ul, &i);
+        da_insert_at(ref, 0, &i);
+    }
+    check_invariants(ul);
+    check_matches(ul, ref);
+
+    assert(*(int*)ul_get_first(ul) == -49);
+    assert(*(int*)ul_get_last(ul) == 99);
+    for (size_t i = 0; i < ref->length; i++) assert(*(int*)ul_get(ul, i) == *(int*)da_index(ref, i));
+    assert(ul_get(ul, ref->length) == NULL);
+    printf("ul_push/ul_get passed.\n");
+
+    // Randomized inserts and removals in the middle, checked against a DArray
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+    for (int round = 0; round < 20000; round++) {
+        uint64_t r = xorshift(&state);
+        size_t len = ref->length;
+
+        if (r % 3 != 0 || len == 0) {
+            size_t idx = (size_t)(r >> 8) % (len + 1);
+            int v = round;
+
+            assert(ul_insert_at(ul, idx, &v));
+            da_insert_at(ref, idx, &v);
+        } else {
+            size_t idx = (size_t)(r >> 8) % len;
+            int out;
+
+            assert(ul_remove_at(ul, idx, &out));
+            assert(out == *(int*)da_index(ref, idx));
+            da_remove_at(ref, idx);
+        }
+
+        if (round % 1000 == 0) check_invariants(ul);
+    }
+    check_invariants(ul);
+    check_matches(ul, ref);
+    printf("ul_insert_at/ul_remove_at passed.\n");
+
+    int v = 12345;
+    assert(ul_set(ul, 7, &v) && *(int*)ul_get(ul, 7) == v);
+    assert(!ul_set(ul, ul_length(ul), &v));
+    assert(!ul_insert_at(ul, ul_length(ul) + 1, &v));
+
+    int out;
+    size_t len = ul_length(ul);
+    assert(ul_pop_front(ul, &out) && out == *(int*)da_index(ref, 0));
+    assert(ul_pop_back(ul, &out) && out == *(int*)da_index(ref, ref->length - 1));
+    assert(ul_length(ul) == len - 2);
+
+    while (ul_pop_back(ul, NULL));
+    assert(ul_is_empty(ul) && ul->head == NULL && ul->node_count == 0);
+    assert(ul->pool->live == 0);
+    printf("ul_pop passed.\n");
+
+    // Blocks cover the whole sequence
+    for (int i = 0; i < 1000; i++) ul_push_back(ul, &i);
+
+    ULIterator it;
+    ul_iter_init(&it, ul);
+
+    size_t n, seen = 0;
+    long long sum = 0;
+    for (int* block; (block = (int*)ul_iter_next_block(&it, &n));) {
+        for (size_t i = 0; i < n; i++) sum += block[i];
+        seen += n;
+    }
+    assert(seen == 1000 && sum == 999 * 1000 / 2);
+    printf("ul_iter_next_block passed.\n");
+
+    // Deallocator and memory accounting
+    ul->deallocator = counting_deallocator;
+    freed_count = 0;
+
+    assert(ul_remove_at(ul, 10, NULL) && freed_count == 1);
+    assert(ul_pop_front(ul, &out) && freed_count == 1);
+
+    MemUsage mu = ul_memory_usage(ul, NULL);
+    assert(mu.payload == ul_length(ul) * sizeof(int));
+    assert(mu.payload + mu.slack + mu.metadata == sizeof(ULList) + ul->node_count * ul->pool->block_size);
+
+    ul_clear(ul);
+    assert(freed_count == 999 && ul_is_empty(ul));
+    printf("ul_clear/ul_memory_usage passed.\n");
+
+    ul_free(ul);
+    da_free(ref);
+
+    printf("Test Operations done.\n\n");
+}
+
+void test_splice() {
+    printf("--- Test Splice ---\n");
+
+    MSCounter before = ms_registry_get(MS_POOL);
+
+    ULList* a = ul_new_with_node_size(sizeof(int), 64);
+    ULList* b = ul_new_sharing_pool(a);
+    ULList* c = ul_new_with_node_size(sizeof(int), 128);  // own pool
+    assert(b->pool == a->pool && c->pool != a->pool);
+
+    DArray* ref = da_new(sizeof(int));
+    ref->copier = int_copier;
+
+    for (int i = 0; i < 37; i++) {
+        ul_push_back(a, &i);
+        da_push(ref, &i);
+    }
+    for (int i = 100; i < 103; i++) {
+        ul_push_back(b, &i);
+        da_push(ref, &i);
+    }
+
+    size_t live = a->pool->live;
+    assert(ul_splice_back(a, b));
+    assert(ul_is_empty(b) && b->head == NULL);
+    assert(a->pool->live <= live);  // nodes relinked (and possibly merged), never copied
+    check_invariants(a);
+    check_matches(a, ref);
+    printf("ul_splice_back (shared pool) passed.\n");
+
+    for (int i = 200; i < 300; i++) {
+        ul_push_back(c, &i);
+        da_push(ref, &i);
+    }
+
+    assert(ul_splice_back(a, c));
+    assert(ul_is_empty(c) && c->pool->live == 0);
+    check_invariants(a);
+    check_matches(a, ref);
+    printf("ul_splice_back (copy) passed.\n");
+
+    // Splicing into an empty list, and an empty list into another
+    assert(ul_splice_back(b, a) && ul_is_empty(a));
+    check_matches(b, ref);
+    assert(ul_splice_back(b, a));
+    check_matches(b, ref);
+
+    ULList* wide = ul_new(sizeof(double));
+    assert(!ul_splice_back(b, wide));
+    ul_free(wide);
+
+    ul_free(a);
+    assert(b->pool->refs == 1);
+    ul_free(b);
+    ul_free(c);
+    da_free(ref);
+
+    assert(ms_registry_get(MS_POOL).containers == before.containers);
+    assert(ms_registry_get(MS_POOL).bytes == before.bytes);
+    printf("shared pool release passed.\n");
+
+    printf("Test Splice done.\n\n");
+}
+
+int main() {
+    printf("Starting Unrolled List Test Suite...\n\n");
+
+    test_layout();
+    test_operations();
+    test_splice();
+
+    printf("All tests passed!\n");
+
+    return 0;
+}